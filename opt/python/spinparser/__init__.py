@@ -18,6 +18,7 @@ The following Python packages are prerequisite:
 
 The prerequisites can be installed via invoking `python -m pip install h5py numpy matplotlib`.
 
-Once installed, the Python tools provide access to two modules: `spinparser.ldf` and `spinparser.obs`. 
+Once installed, the Python tools provide access to three modules: `spinparser.ldf`, `spinparser.obs`, and `spinparser.solver`. 
+The module `spinparser.solver` additionally requires the shared library `lib/libSpinParser.so`, which is built alongside the SpinParser executable. 
 Their functionality is documented below. 
 """
\ No newline at end of file
@@ -1,9 +1,10 @@
 """
-Visualization tools for lattice graphs that are stored in the ".ldf" file format. 
+Visualization tools for lattice graphs that are stored in the ".ldf" file format, or in its binary HDF5 counterpart ".ldf.h5". 
 Useful to inspect lattice spin models used in SpinParser calculations.
 """
 
 import re
+import h5py
 import matplotlib.pyplot as plt
 from matplotlib.patches import FancyArrowPatch
 from mpl_toolkits.mplot3d import proj3d
@@ -25,9 +26,60 @@ class _Arrow3D(FancyArrowPatch):
         self.set_positions((xs[0],ys[0]),(xs[1],ys[1]))
         return np.min(zs)
 
+def read(filename):
+    """
+    Read the contents of an ldf file. 
+    Both the xml-type ".ldf" file and its binary HDF5 counterpart ".ldf.h5" are supported; the format is detected automatically. 
+
+    Parameters
+    ----------
+    filename : string
+        Input file path. 
+
+    Returns
+    -------
+    tuple
+        Tuple (sites, bonds, interactions) of lists. 
+        Each site is a dict with the keys "id", "x", "y", "z", and "parametrized". 
+        Each bond is a dict with the keys "from" and "to". 
+        Each interaction is a dict with the keys "from", "to", and "value", where value is the 3x3 interaction matrix. 
+    """
+    sites = []
+    bonds = []
+    interacs = []
+    if h5py.is_hdf5(filename):
+        with h5py.File(filename, "r") as file:
+            for id, position, parametrized in zip(file["siteIds"][()], file["sitePositions"][()], file["siteParametrized"][()]):
+                sites.append({"id":int(id), "x":float(position[0]), "y":float(position[1]), "z":float(position[2]), "parametrized":bool(parametrized)})
+            for fromId, toId in file["bonds"][()]:
+                bonds.append({"from":int(fromId), "to":int(toId)})
+            for (fromId, toId), value in zip(file["interactions"][()], file["interactionValues"][()]):
+                interacs.append({"from":int(fromId), "to":int(toId), "value":value.tolist()})
+    else:
+        with open(filename, "r") as file:
+            for line in file:
+                if re.search(r'(?<=<)site', line):
+                    id = int(re.search(r'(?<=\W)id="(\d+)"', line)[1])
+                    x = float(re.search(r'(?<=\W)x="(-?\d+\.\d*)"', line)[1])
+                    y = float(re.search(r'(?<=\W)y="(-?\d+\.\d*)"', line)[1])
+                    z = float(re.search(r'(?<=\W)z="(-?\d+\.\d*)"', line)[1])
+                    parametrized = True if re.search(r'(?<=\W)parametrized="(true|false)"', line)[1] == "true" else False
+                    sites.append({"id":id, "x":x, "y":y, "z":z, "parametrized":parametrized})
+                elif re.search(r'(?<=<)bond', line):
+                    fromId = int(re.search(r'(?<=\W)from="(\d+)"', line)[1])
+                    toId = int(re.search(r'(?<=\W)to="(\d+)"', line)[1])
+                    bonds.append({"from":fromId, "to":toId})
+                elif re.search(r'(?<=<)interaction', line):
+                    fromId = int(re.search(r'(?<=\W)from="(\d+)"', line)[1])
+                    toId = int(re.search(r'(?<=\W)to="(\d+)"', line)[1])
+                    value = eval(re.search(r'(?<=\W)value="([\[\d\.\]\,\-]+)"', line)[1])
+                    interacs.append({"from":fromId, "to":toId, "value":value})
+    return sites, bonds, interacs
+
 def plot(filename, interactions="all"):
     """
     Plot the contents of an ldf file. 
+    Both the xml-type ".ldf" file and its binary HDF5 counterpart ".ldf.h5" are supported. 
 
     Parameters
     ----------
@@ -42,27 +94,10 @@ def plot(filename, interactions="all"):
         Note that the reference site at the lattice center typically has the identifier "0". 
     """
     #read ldf file
-    sites = []
-    bonds = []
-    interacs = []
-    with open(filename, "r") as file:
-        for line in file:
-            if re.search(r'(?<=<)site', line):
-                id = int(re.search(r'(?<=\W)id="(\d+)"', line)[1])
-                x = float(re.search(r'(?<=\W)x="(-?\d+\.\d*)"', line)[1])
-                y = float(re.search(r'(?<=\W)y="(-?\d+\.\d*)"', line)[1])
-                z = float(re.search(r'(?<=\W)z="(-?\d+\.\d*)"', line)[1])
-                parametrized = True if re.search(r'(?<=\W)parametrized="(true|false)"', line)[1] == "true" else False
-                sites.append({"id":id, "x":x, "y":y, "z":z, "parametrized":parametrized})
-            elif re.search(r'(?<=<)bond', line):
-                fromId = int(re.search(r'(?<=\W)from="(\d+)"', line)[1])
-                toId = int(re.search(r'(?<=\W)to="(\d+)"', line)[1])
-                bonds.append({"from":fromId, "to":toId})
-            elif re.search(r'(?<=<)interaction', line):
-                fromId = int(re.search(r'(?<=\W)from="(\d+)"', line)[1])
-                toId = int(re.search(r'(?<=\W)to="(\d+)"', line)[1])
-                value = eval(re.search(r'(?<=\W)value="([\[\d\.\]\,\-]+)"', line)[1])
-                interacs.append({"from":fromId, "to":toId, "value":value})
+    sites, bonds, interacs = read(filename)
+
+    #index sites by their identifier
+    sitesById = { i["id"]:i for i in sites }
 
     #prepare plot
     fig = plt.figure()
@@ -71,8 +106,8 @@ def plot(filename, interactions="all"):
 
     #plot lattice bonds
     for bond in bonds:
-        s1 = next(i for i in sites if i["id"]==bond["from"])
-        s2 = next(i for i in sites if i["id"]==bond["to"])
+        s1 = sitesById[bond["from"]]
+        s2 = sitesById[bond["to"]]
         ax.plot3D([s1["x"],s2["x"]], [s1["y"],s2["y"]], [s1["z"],s2["z"]], 'gray')
 
     #plot lattice sites
@@ -80,8 +115,8 @@ def plot(filename, interactions="all"):
 
     #plot interactions
     for interaction in interacs:
-        s1 = next(i for i in sites if i["id"]==interaction["from"])
-        s2 = next(i for i in sites if i["id"]==interaction["to"])
+        s1 = sitesById[interaction["from"]]
+        s2 = sitesById[interaction["to"]]
 
         if interactions == "all" or interaction["from"] == interactions or interaction["to"] == interactions:
             a = _Arrow3D([s1["x"], s2["x"]], [s1["y"], s2["y"]], [s1["z"], s2["z"]], mutation_scale=10, lw=3, arrowstyle="-|>", color="r")
@@ -37,6 +37,14 @@ def _getObsAttributes(obsIdentifier):
 		return [ "CorrelationZY", "LatticeData" ]
 	elif (obsIdentifier == "TRICorZZ"):
 		return [ "CorrelationZZ", "LatticeData" ]
+	elif (obsIdentifier == "U1CorDD"):
+		return [ "CorrelationDD", "LatticeData" ]
+	elif (obsIdentifier == "U1CorXX"):
+		return [ "CorrelationXX", "LatticeData" ]
+	elif (obsIdentifier == "U1CorXY"):
+		return [ "CorrelationXY", "LatticeData" ]
+	elif (obsIdentifier == "U1CorZZ"):
+		return [ "CorrelationZZ", "LatticeData" ]
 	elif (obsIdentifier == "XYZCorDD"):
 		return [ "CorrelationDD", "LatticeData" ]
 	elif (obsIdentifier == "XYZCorXX"):
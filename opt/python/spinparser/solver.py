@@ -0,0 +1,146 @@
+"""
+In-process interface to the SpinParser solver.
+Tasks are solved within the Python process via the shared SpinParser library, and the results of the most recent measurements are exposed as NumPy arrays which share memory with the solver.
+"""
+
+import os
+import ctypes
+import numpy as np
+
+def _loadLibrary(library=None):
+	"""
+	Load the shared SpinParser library.
+
+	Args:
+		library (str): Path to the shared library. If not specified, the path is taken from the environment variable `SPINPARSER_LIBRARY`, or otherwise the library is searched in the `lib` directory of the SpinParser installation.
+
+	Returns:
+		ctypes.CDLL: Shared library with declared function signatures.
+	"""
+	if library is None:
+		library = os.environ.get("SPINPARSER_LIBRARY", os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "..", "lib", "libSpinParser.so"))
+	lib = ctypes.CDLL(library, mode=ctypes.RTLD_GLOBAL)
+
+	lib.spinparser_error.restype = ctypes.c_char_p
+	lib.spinparser_error.argtypes = []
+	lib.spinparser_solver_new.restype = ctypes.c_void_p
+	lib.spinparser_solver_new.argtypes = [ctypes.c_int, ctypes.POINTER(ctypes.c_char_p)]
+	lib.spinparser_solver_delete.restype = None
+	lib.spinparser_solver_delete.argtypes = [ctypes.c_void_p]
+	lib.spinparser_solver_step.restype = ctypes.c_int
+	lib.spinparser_solver_step.argtypes = [ctypes.c_void_p]
+	lib.spinparser_solver_is_finished.restype = ctypes.c_int
+	lib.spinparser_solver_is_finished.argtypes = [ctypes.c_void_p]
+	lib.spinparser_solver_cutoff.restype = ctypes.c_float
+	lib.spinparser_solver_cutoff.argtypes = [ctypes.c_void_p]
+	lib.spinparser_solver_observables.restype = ctypes.c_int
+	lib.spinparser_solver_observables.argtypes = [ctypes.c_void_p]
+	lib.spinparser_solver_observable_name.restype = ctypes.c_char_p
+	lib.spinparser_solver_observable_name.argtypes = [ctypes.c_int]
+	lib.spinparser_solver_observable_data.restype = ctypes.POINTER(ctypes.c_float)
+	lib.spinparser_solver_observable_data.argtypes = [ctypes.c_int, ctypes.POINTER(ctypes.c_int)]
+	lib.spinparser_solver_write_checkpoint.restype = ctypes.c_int
+	lib.spinparser_solver_write_checkpoint.argtypes = [ctypes.c_void_p]
+	return lib
+
+class Solver:
+	"""
+	Solver for a SpinParser task file.
+	At most one solver can exist at any time; a solver is released by calling `close()` or by using it as a context manager.
+
+	Example:
+		>>> import spinparser.solver as s
+		>>> with s.Solver("square-Heisenberg.xml", "-f") as solver:
+		>>> 	while solver.step():
+		>>> 		print(solver.cutoff, solver.observables()["SU2CorZZ"][:4])
+	"""
+
+	def __init__(self, taskfile, *options, library=None):
+		"""
+		Set up the task.
+
+		Args:
+			taskfile (str): Path to the task file.
+			*options (str): Additional command line arguments, with the same syntax as for the SpinParser executable, e.g. `"-f"` or `"--resourcePath", "res"`.
+			library (str): Path to the shared SpinParser library. See `_loadLibrary()`.
+		"""
+		self._lib = _loadLibrary(library)
+		arguments = [ str(o).encode() for o in options ] + [ str(taskfile).encode() ]
+		argv = (ctypes.c_char_p * len(arguments))(*arguments)
+		self._solver = self._lib.spinparser_solver_new(len(arguments), argv)
+		if not self._solver:
+			raise RuntimeError(self._lib.spinparser_error().decode())
+
+	def __enter__(self):
+		return self
+
+	def __exit__(self, exc_type, exc_value, traceback):
+		self.close()
+
+	def __del__(self):
+		self.close()
+
+	def close(self):
+		"""
+		Release the task. Arrays returned by `observables()` must not be accessed after the solver has been released.
+		"""
+		if getattr(self, "_solver", None):
+			self._lib.spinparser_solver_delete(self._solver)
+			self._solver = None
+
+	def step(self):
+		"""
+		Compute a single cutoff step, including all measurements which are due.
+		Once the flow has finished, the calculation is finalized, including the final measurement and checkpoint.
+
+		Returns:
+			bool: True if more steps remain to be computed, False if the task has finished.
+		"""
+		status = self._lib.spinparser_solver_step(self._solver)
+		if status < 0:
+			raise RuntimeError(self._lib.spinparser_error().decode())
+		return status == 1
+
+	def run(self):
+		"""
+		Compute all remaining cutoff steps.
+		"""
+		while self.step():
+			pass
+
+	@property
+	def finished(self):
+		"""
+		bool: True if no more steps remain to be computed.
+		"""
+		return self._lib.spinparser_solver_is_finished(self._solver) == 1
+
+	@property
+	def cutoff(self):
+		"""
+		float: Current value of the RG cutoff.
+		"""
+		return self._lib.spinparser_solver_cutoff(self._solver)
+
+	def observables(self):
+		"""
+		Retrieve the results of the most recent measurements.
+		The arrays share memory with the solver; they are overwritten by subsequent measurements and must be copied if they are to be retained.
+		Correlations are given in the frame of the FRG core, and are ordered as the correlation datasets in the observable file.
+
+		Returns:
+			dict[str, numpy.ndarray]: Result buffers, indexed by the observable identifier, e.g. "SU2CorZZ".
+		"""
+		observables = {}
+		for n in range(self._lib.spinparser_solver_observables(self._solver)):
+			size = ctypes.c_int(0)
+			data = self._lib.spinparser_solver_observable_data(n, ctypes.byref(size))
+			observables[self._lib.spinparser_solver_observable_name(n).decode()] = np.ctypeslib.as_array(data, shape=(size.value,))
+		return observables
+
+	def writeCheckpoint(self):
+		"""
+		Write the current state of the flow to the checkpoint file, such that the task can be continued later.
+		"""
+		if self._lib.spinparser_solver_write_checkpoint(self._solver) < 0:
+			raise RuntimeError(self._lib.spinparser_error().decode())
@@ -6,6 +6,7 @@
  * @copyright Copyright (c) 2020
  */
 
+#include <cstdlib>
 #include <iostream>
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
@@ -29,14 +30,21 @@ CommandLineOptions::CommandLineOptions(int argc, char **argv)
 	po::options_description outputOptions("Output options");
 	outputOptions.add_options()
 		("verbose,v", po::bool_switch(), "enable verbose output")
-		("debugLattice", po::bool_switch(), "print lattice debug information in .ldf format");
+		("debugLattice", po::bool_switch(), "print lattice debug information in .ldf format")
+		("profile", po::value<int>()->default_value(0)->value_name("STEPS"), "write a profile of vertex magnitude and compute time every STEPS cutoff steps");
+
+	po::options_description performanceOptions("Performance options");
+	performanceOptions.add_options()
+		("tuneKernels", po::bool_switch(), "time kernel variants on the first cutoff step and select the fastest ones")
+		("kernelCache", po::value<std::string>()->value_name("FILE"), "cache file for kernel tuning decisions (default: ~/.spinparser/kernels.cache)")
+		("measureEnergy", po::bool_switch(), "report the energy consumption per cutoff step and phase from the RAPL counters");
 
 	po::options_description hiddenOptions("Hidden options");
 	hiddenOptions.add_options()
 		("taskFile", po::value<std::string>()->required(), "taskFile");
 
 	po::options_description allOptions;
-	allOptions.add(generalOptions).add(checkpointingOptions).add(outputOptions).add(hiddenOptions);
+	allOptions.add(generalOptions).add(checkpointingOptions).add(outputOptions).add(performanceOptions).add(hiddenOptions);
 
 	po::positional_options_description positionalOptions;
 	positionalOptions.add("taskFile", -1);
@@ -50,6 +58,11 @@ CommandLineOptions::CommandLineOptions(int argc, char **argv)
 	_forceRestart = vm["forceRestart"].as<bool>();
 	_deferMeasurements = vm["defer"].as<bool>();
 	_debugLattice = vm["debugLattice"].as<bool>();
+	_profile = vm["profile"].as<int>();
+	_tuneKernels = vm["tuneKernels"].as<bool>();
+	if (vm.count("kernelCache")) _kernelCache = vm["kernelCache"].as<std::string>();
+	else if (getenv("HOME") != nullptr) _kernelCache = boost::filesystem::path(getenv("HOME")).append(".spinparser").append("kernels.cache").string();
+	_measureEnergy = vm["measureEnergy"].as<bool>();
 	_taskFile = (vm.count("taskFile")) ? vm["taskFile"].as<std::string>() : "";
 	if (vm.count("resourcePath")) _resourcePath = vm["resourcePath"].as<std::string>();
 	else
@@ -68,7 +81,7 @@ CommandLineOptions::CommandLineOptions(int argc, char **argv)
 		std::cout << "\tThe SpinParser allows to solve pf-FRG flow equations with model parameters specified in FILE. " << std::endl << std::endl;
 		std::cout << "\tMandatory arguments to long options are mandatory for short options too. " << std::endl << std::endl;
 
-		std::cout << generalOptions << std::endl << outputOptions << std::endl << checkpointingOptions << std::endl;
+		std::cout << generalOptions << std::endl << outputOptions << std::endl << checkpointingOptions << std::endl << performanceOptions << std::endl;
 	}
 	else po::notify(vm);
 }
@@ -103,6 +116,26 @@ bool CommandLineOptions::debugLattice() const
 	return _debugLattice;
 }
 
+int CommandLineOptions::profile() const
+{
+	return _profile;
+}
+
+bool CommandLineOptions::tuneKernels() const
+{
+	return _tuneKernels;
+}
+
+std::string CommandLineOptions::kernelCache() const
+{
+	return _kernelCache;
+}
+
+bool CommandLineOptions::measureEnergy() const
+{
+	return _measureEnergy;
+}
+
 std::string CommandLineOptions::taskFile() const
 {
 	return _taskFile;
@@ -65,6 +65,34 @@ public:
 	 */
 	bool debugLattice() const;
 
+	/**
+	 * @brief Retrieve the value of the '--profile' flag. 
+	 * 
+	 * @return int Value of the '--profile' flag. 
+	 */
+	int profile() const;
+
+	/**
+	 * @brief Retrieve the '--tuneKernels' flag setting. 
+	 * 
+	 * @return bool Return true, if the '--tuneKernels' flag is set. Otherwise, return false.
+	 */
+	bool tuneKernels() const;
+
+	/**
+	 * @brief Retrieve the value of the '--kernelCache' flag. 
+	 * 
+	 * @return std::string Value of the '--kernelCache' flag. 
+	 */
+	std::string kernelCache() const;
+
+	/**
+	 * @brief Retrieve the '--measureEnergy' flag setting. 
+	 * 
+	 * @return bool Return true, if the '--measureEnergy' flag is set. Otherwise, return false.
+	 */
+	bool measureEnergy() const;
+
 	/**
 	 * @brief Retrieve the value of the '--taskFile' flag.
 	 * 
@@ -86,6 +114,10 @@ protected:
 	bool _forceRestart; ///< Force flag '--forceRestart' is set. 
 	bool _deferMeasurements; ///< Defer flag '--defer' is set. 
 	bool _debugLattice; ///< Lattice debug flag '--debugLattice' is set. 
+	int _profile; ///< Value of the '--profile' argument. 
+	bool _tuneKernels; ///< Tuning flag '--tuneKernels' is set. 
+	std::string _kernelCache; ///< Value of the '--kernelCache' argument. 
+	bool _measureEnergy; ///< Energy measurement flag '--measureEnergy' is set. 
 	std::string _taskFile; ///< Value of the '--taskFile' argument. 
 	std::string _resourcePath; ///< Value of the '--resourcePath' argument. 
 };
\ No newline at end of file
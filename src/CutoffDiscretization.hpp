@@ -78,12 +78,21 @@ private:
 struct CutoffDiscretization
 {
 public:
+	/**
+	 * @brief Integration scheme for the flow equations. 
+	 */
+	enum struct Integrator
+	{
+		Euler, ///< Explicit Euler integration. 
+		Implicit ///< Linearly implicit Euler integration of the two-particle vertex. 
+	};
+
 	/**
 	 * @brief Construct a new CutoffDiscretization object from a list of cutoff values. 
 	 * 
 	 * @param values List of cutoff values to use for discretization. 
 	 */
-	CutoffDiscretization(const std::vector<float> &values)
+	CutoffDiscretization(const std::vector<float> &values) : refinement(1), refinementThreshold(3.0f), integrator(Integrator::Euler), multirate(1), multirateTolerance(0.01f)
 	{
 		//Ensure that discretization contains sufficiently many cutoff values
 		if (values.size() < 2) throw Exception(Exception::Type::ArgumentError, "CutoffDiscretization must contain at least two frequency values");
@@ -146,6 +155,12 @@ public:
 		return end();
 	}
 
+	int refinement; ///< Number of substeps into which a cutoff step is divided when it is re-integrated in the refinement pass. A value of one disables the refinement pass. 
+	float refinementThreshold; ///< A cutoff step is re-integrated in the refinement pass if the rate of change of the observables exceeds the median rate by this factor. 
+	Integrator integrator; ///< Integration scheme for the flow equations. 
+	int multirate; ///< Maximal number of cutoff steps between two evaluations of slowly varying blocks of the two-particle vertex flow. A value of one evaluates the entire flow at every step. 
+	float multirateTolerance; ///< Largest relative deviation of the extrapolated flow of slowly varying blocks from the computed flow. 
+
 private:
 	int _size; ///< Number of cutoff values in the discretization. 
 	float *_data; ///< Internal storage for discretization values. 
@@ -7,6 +7,10 @@
  */
 
 #pragma once
+#include <vector>
+#include <map>
+#include <mutex>
+#include <fstream>
 #include <hdf5.h>
 #include "lib/Log.hpp"
 #include "lib/Exception.hpp"
@@ -56,5 +60,104 @@ public:
 	 */
 	virtual bool isDiverged() const = 0;
 
+	/**
+	 * @brief Sample the frequency dependence of the effective action on the positive frequency mesh. 
+	 * @details Each profile contains one value per mesh point. Profiles are used to estimate the discretization error of the frequency mesh. 
+	 *
+	 * @return std::vector<std::vector<float>> List of frequency profiles. 
+	 */
+	virtual std::vector<std::vector<float>> getFrequencyProfiles() const = 0;
+
+	/**
+	 * @brief Compute the magnitude of the two-particle vertex for every parametrized frequency triplet and lattice site. 
+	 * @details The magnitude is the Euclidean norm over all spin and density channels. 
+	 * The result is indexed by frequencyIterator * FrgCommon::lattice().size + rid, where frequencyIterator is a linear iterator over all parametrized frequency triplets and rid is the representative lattice site id. 
+	 *
+	 * @return std::vector<float> Vertex magnitudes. 
+	 */
+	virtual std::vector<float> getTwoParticleMagnitudes() const = 0;
+
+	/**
+	 * @brief Read a data file into memory, such that the next call to EffectiveAction::readCheckpoint() for the same file path does not access the file system. 
+	 * @details The function is thread safe, which allows to read the checkpoint file concurrently with the construction of the lattice. 
+	 * The memory image is released once it has been opened. If the file cannot be read, do nothing. 
+	 * 
+	 * @param dataFilePath Data file path. 
+	 */
+	static void prefetchDataFile(const std::string &dataFilePath)
+	{
+		std::ifstream file(dataFilePath, std::ios::binary | std::ios::ate);
+		if (!file) return;
+		std::vector<char> image(size_t(file.tellg()));
+		file.seekg(0);
+		if (!file.read(image.data(), image.size())) return;
+
+		std::lock_guard<std::mutex> lock(_prefetchMutex());
+		_prefetchedImages()[dataFilePath].swap(image);
+	}
+
+	/**
+	 * @brief Release all memory images which have been prefetched by EffectiveAction::prefetchDataFile() but not yet opened. 
+	 */
+	static void discardPrefetchedDataFiles()
+	{
+		std::lock_guard<std::mutex> lock(_prefetchMutex());
+		_prefetchedImages().clear();
+	}
+
 	float cutoff; ///< Value of the RG cutoff. 
+
+protected:
+	/**
+	 * @brief Open a data file for reading. If a memory image of the file has been prefetched, the file is opened from memory. 
+	 * 
+	 * @param dataFilePath Data file path. 
+	 * @return hid_t HDF5 file identifier, or a negative value if the file could not be opened. 
+	 */
+	static hid_t _openDataFile(const std::string &dataFilePath)
+	{
+		std::vector<char> image;
+		{
+			std::lock_guard<std::mutex> lock(_prefetchMutex());
+			auto prefetched = _prefetchedImages().find(dataFilePath);
+			if (prefetched != _prefetchedImages().end())
+			{
+				image.swap(prefetched->second);
+				_prefetchedImages().erase(prefetched);
+			}
+		}
+		if (image.size() == 0) return H5Fopen(dataFilePath.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+
+		//the core driver copies the image, which is released afterwards
+		hid_t accessProperties = H5Pcreate(H5P_FILE_ACCESS);
+		H5Pset_fapl_core(accessProperties, 1 << 20, 0);
+		H5Pset_file_image(accessProperties, image.data(), image.size());
+		hid_t file = H5Fopen(dataFilePath.c_str(), H5F_ACC_RDONLY, accessProperties);
+		H5Pclose(accessProperties);
+		if (file < 0) file = H5Fopen(dataFilePath.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+		return file;
+	}
+
+private:
+	/**
+	 * @brief Retrieve the memory images which have been prefetched by EffectiveAction::prefetchDataFile(). 
+	 * 
+	 * @return std::map<std::string, std::vector<char>>& Memory images, indexed by file path. 
+	 */
+	static std::map<std::string, std::vector<char>> &_prefetchedImages()
+	{
+		static std::map<std::string, std::vector<char>> images;
+		return images;
+	}
+
+	/**
+	 * @brief Retrieve the mutex which guards the prefetched memory images. 
+	 * 
+	 * @return std::mutex& Mutex. 
+	 */
+	static std::mutex &_prefetchMutex()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
 };
\ No newline at end of file
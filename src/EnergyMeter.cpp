@@ -0,0 +1,180 @@
+/**
+ * @file EnergyMeter.cpp
+ * @author Finn Lasse Buessen
+ * @brief Energy consumption instrumentation via the Linux powercap interface to the RAPL counters. 
+ * 
+ * @copyright Copyright (c) 2020
+ */
+
+#include <fstream>
+#include <iomanip>
+#include <boost/filesystem.hpp>
+#include "lib/Log.hpp"
+#include "EnergyMeter.hpp"
+#ifndef DISABLE_MPI
+#include "mpi.h"
+#endif
+
+namespace
+{
+	const int numPhases = 4;
+	const int numDomains = 2;
+	const char *phaseNames[numPhases] = { "flow", "measurements", "integration", "checkpoints" };
+}
+
+EnergyMeter::EnergyMeter(const bool isEnabled, const std::string &powercapPath) : _isEnabled(isEnabled), _nodes(0), _phase(Phase::Flow), _step(numPhases * numDomains, 0.0), _total(numPhases * numDomains, 0.0)
+{
+	if (!_isEnabled) return;
+
+	//the counters are read by the first rank on every node
+	bool isNodeLeader = true;
+	#ifndef DISABLE_MPI
+	int rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm nodeCommunicator;
+	MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &nodeCommunicator);
+	int nodeRank;
+	MPI_Comm_rank(nodeCommunicator, &nodeRank);
+	MPI_Comm_free(&nodeCommunicator);
+	isNodeLeader = (nodeRank == 0);
+	#endif
+
+	//locate readable package and DRAM counters; core, uncore, and platform domains are skipped, since they overlap with the package domain
+	boost::system::error_code error;
+	if (isNodeLeader && boost::filesystem::is_directory(powercapPath, error))
+	{
+		for (auto &entry : boost::filesystem::directory_iterator(powercapPath, error))
+		{
+			if (entry.path().filename().string().compare(0, 11, "intel-rapl:") != 0) continue;
+
+			std::string name;
+			std::ifstream nameFile((entry.path() / "name").string());
+			if (!std::getline(nameFile, name)) continue;
+
+			Counter counter;
+			if (name.compare(0, 7, "package") == 0) counter.domain = Domain::Package;
+			else if (name == "dram") counter.domain = Domain::Dram;
+			else continue;
+
+			counter.file = (entry.path() / "energy_uj").string();
+			std::ifstream energyFile(counter.file);
+			std::ifstream rangeFile((entry.path() / "max_energy_range_uj").string());
+			unsigned long long value;
+			if (!(energyFile >> value) || !(rangeFile >> counter.range)) continue;
+			_counters.push_back(counter);
+		}
+	}
+
+	_nodes = (_counters.size() > 0) ? 1 : 0;
+	#ifndef DISABLE_MPI
+	MPI_Allreduce(MPI_IN_PLACE, &_nodes, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+	#endif
+	if (_nodes == 0)
+	{
+		Log::log << Log::LogLevel::Warning << "No readable RAPL energy counters found in [" << powercapPath << "]. Energy instrumentation is disabled." << Log::endl;
+		_isEnabled = false;
+		return;
+	}
+	Log::log << Log::LogLevel::Info << "Measuring energy consumption on " << _nodes << " node(s)." << Log::endl;
+
+	_runBegin = _read();
+}
+
+bool EnergyMeter::isEnabled() const
+{
+	return _isEnabled;
+}
+
+void EnergyMeter::beginPhase(const Phase phase)
+{
+	if (!_isEnabled) return;
+
+	_phase = phase;
+	_phaseBegin = _read();
+}
+
+void EnergyMeter::endPhase()
+{
+	if (!_isEnabled) return;
+
+	std::vector<double> energies = _difference(_phaseBegin, _read());
+	for (int d = 0; d < numDomains; ++d)
+	{
+		_step[numDomains * int(_phase) + d] += energies[d];
+		_total[numDomains * int(_phase) + d] += energies[d];
+	}
+}
+
+void EnergyMeter::endStep(const bool isMasterTask)
+{
+	if (!_isEnabled) return;
+
+	std::vector<double> step = _aggregate(_step, isMasterTask);
+	_step.assign(numPhases * numDomains, 0.0);
+	if (!isMasterTask) return;
+
+	double sum = 0.0;
+	for (auto e : step) sum += e;
+	Log::log << Log::LogLevel::Info << "Energy consumption of the cutoff step was " << std::fixed << std::setprecision(2) << sum << " J (";
+	for (int p = 0; p < numPhases; ++p) Log::log << ((p == 0) ? "" : ", ") << phaseNames[p] << " " << step[numDomains * p] + step[numDomains * p + 1] << " J";
+	Log::log << ")." << Log::endl;
+}
+
+void EnergyMeter::report(const bool isMasterTask) const
+{
+	if (!_isEnabled) return;
+
+	//energy which has not been attributed to any phase is reported separately
+	std::vector<double> energies(_total);
+	std::vector<double> run = _difference(_runBegin, _read());
+	for (int d = 0; d < numDomains; ++d)
+	{
+		double other = run[d];
+		for (int p = 0; p < numPhases; ++p) other -= _total[numDomains * p + d];
+		energies.push_back(other);
+	}
+	energies.insert(energies.end(), run.begin(), run.end());
+	energies = _aggregate(energies, isMasterTask);
+	if (!isMasterTask) return;
+
+	Log::log << Log::LogLevel::Info << "Energy consumption on " << _nodes << " node(s) was " << std::fixed << std::setprecision(2) << energies[numDomains * (numPhases + 1)] + energies[numDomains * (numPhases + 1) + 1] << " J (package " << energies[numDomains * (numPhases + 1)] << " J, DRAM " << energies[numDomains * (numPhases + 1) + 1] << " J). " << Log::endl;
+	for (int p = 0; p <= numPhases; ++p) Log::log << Log::LogLevel::Info << "\t..." << ((p < numPhases) ? phaseNames[p] : "other") << ": " << std::fixed << std::setprecision(2) << energies[numDomains * p] + energies[numDomains * p + 1] << " J (package " << energies[numDomains * p] << " J, DRAM " << energies[numDomains * p + 1] << " J)" << Log::endl;
+}
+
+double EnergyMeter::energy(const Phase phase, const Domain domain) const
+{
+	return _total[numDomains * int(phase) + int(domain)];
+}
+
+std::vector<unsigned long long> EnergyMeter::_read() const
+{
+	std::vector<unsigned long long> values(_counters.size(), 0);
+	for (int i = 0; i < int(_counters.size()); ++i)
+	{
+		std::ifstream file(_counters[i].file);
+		file >> values[i];
+	}
+	return values;
+}
+
+std::vector<double> EnergyMeter::_difference(const std::vector<unsigned long long> &begin, const std::vector<unsigned long long> &end) const
+{
+	//counters wrap around at their maximum range
+	std::vector<double> energies(numDomains, 0.0);
+	for (int i = 0; i < int(_counters.size()); ++i)
+	{
+		unsigned long long delta = (end[i] >= begin[i]) ? end[i] - begin[i] : _counters[i].range - begin[i] + end[i];
+		energies[int(_counters[i].domain)] += double(delta) * 1e-6;
+	}
+	return energies;
+}
+
+std::vector<double> EnergyMeter::_aggregate(const std::vector<double> &energies, const bool isMasterTask) const
+{
+	std::vector<double> sum(energies);
+	#ifndef DISABLE_MPI
+	if (isMasterTask) MPI_Reduce(MPI_IN_PLACE, sum.data(), int(sum.size()), MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+	else MPI_Reduce(sum.data(), nullptr, int(sum.size()), MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+	#endif
+	return sum;
+}
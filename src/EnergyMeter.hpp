@@ -0,0 +1,137 @@
+/**
+ * @file EnergyMeter.hpp
+ * @author Finn Lasse Buessen
+ * @brief Energy consumption instrumentation via the Linux powercap interface to the RAPL counters. 
+ * @details The energy meter reads the package and DRAM energy counters which the Linux powercap interface exposes in /sys/class/powercap, and attributes the consumed energy to the phases of a cutoff step. 
+ * The counters measure the energy consumption of an entire node, such that they are read by a single MPI rank per node, and the results of all nodes are summed. 
+ * 
+ * @copyright Copyright (c) 2020
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+
+/**
+ * @brief Energy meter, which attributes the energy consumption of the RAPL package and DRAM domains to the phases of the calculation. 
+ * @details The meter is disabled by default. If enabled, the SpinParser wraps each phase of a cutoff step in EnergyMeter::beginPhase() and EnergyMeter::endPhase(), and invokes EnergyMeter::endStep() after every cutoff step. 
+ * If no counters are readable on any node, e.g. because the counters are restricted to the root user, the meter disables itself. 
+ */
+class EnergyMeter
+{
+public:
+	/**
+	 * @brief Phase of the calculation. 
+	 */
+	enum class Phase
+	{
+		Flow, ///< Computation of the flow.
+		Measurement, ///< Measurements.
+		Integration, ///< Integration step.
+		Checkpoint ///< Checkpoint I/O.
+	};
+
+	/**
+	 * @brief RAPL domain. 
+	 */
+	enum class Domain
+	{
+		Package, ///< Processor package.
+		Dram ///< Memory attached to the processor package.
+	};
+
+	/**
+	 * @brief Construct a new EnergyMeter object and locate the energy counters. Must be called on all MPI ranks. 
+	 * 
+	 * @param isEnabled If set to false, the meter is disabled. 
+	 * @param powercapPath Directory of the powercap interface. 
+	 */
+	EnergyMeter(const bool isEnabled = false, const std::string &powercapPath = "/sys/class/powercap");
+
+	/**
+	 * @brief Query whether the meter is enabled. 
+	 * 
+	 * @return bool Return true if the meter is enabled and energy counters are available on at least one node, return false otherwise. 
+	 */
+	bool isEnabled() const;
+
+	/**
+	 * @brief Begin a phase of the calculation. 
+	 * 
+	 * @param phase Phase to begin. 
+	 */
+	void beginPhase(const Phase phase);
+
+	/**
+	 * @brief End the current phase and attribute the energy which has been consumed since EnergyMeter::beginPhase() to it. 
+	 */
+	void endPhase();
+
+	/**
+	 * @brief Complete the current cutoff step and report its energy consumption, aggregated over all nodes, on the MPI master rank. Must be called on all MPI ranks. 
+	 * 
+	 * @param isMasterTask If set to true, the function call is responsible for reporting. 
+	 */
+	void endStep(const bool isMasterTask);
+
+	/**
+	 * @brief Report the energy consumption of the entire run, aggregated over all nodes and resolved by phase, on the MPI master rank. Must be called on all MPI ranks. 
+	 * 
+	 * @param isMasterTask If set to true, the function call is responsible for reporting. 
+	 */
+	void report(const bool isMasterTask) const;
+
+	/**
+	 * @brief Retrieve the energy which has been attributed to a phase on the current node. 
+	 * 
+	 * @param phase Phase of the calculation. 
+	 * @param domain RAPL domain. 
+	 * @return double Energy in Joule. 
+	 */
+	double energy(const Phase phase, const Domain domain) const;
+
+private:
+	/**
+	 * @brief Energy counter of a RAPL domain. 
+	 */
+	struct Counter
+	{
+		std::string file; ///< File which holds the counter value in microjoules.
+		Domain domain; ///< RAPL domain of the counter.
+		unsigned long long range; ///< Counter value at which the counter wraps around.
+	};
+
+	/**
+	 * @brief Read all counters. 
+	 * 
+	 * @return std::vector<unsigned long long> Counter values in microjoules. 
+	 */
+	std::vector<unsigned long long> _read() const;
+
+	/**
+	 * @brief Calculate the energy per domain which has been consumed between two readings of the counters. 
+	 * 
+	 * @param begin First reading. 
+	 * @param end Second reading. 
+	 * @return std::vector<double> Energy in Joule per domain. 
+	 */
+	std::vector<double> _difference(const std::vector<unsigned long long> &begin, const std::vector<unsigned long long> &end) const;
+
+	/**
+	 * @brief Sum an array of energies over all nodes on the MPI master rank. 
+	 * 
+	 * @param energies Energies of the current node. 
+	 * @param isMasterTask If set to true, the sum is returned. 
+	 * @return std::vector<double> Energies summed over all nodes. 
+	 */
+	std::vector<double> _aggregate(const std::vector<double> &energies, const bool isMasterTask) const;
+
+	bool _isEnabled; ///< Set to true if the meter is enabled.
+	int _nodes; ///< Number of nodes on which counters are available.
+	std::vector<Counter> _counters; ///< Energy counters of the current node. Empty on all but one MPI rank per node.
+	Phase _phase; ///< Current phase.
+	std::vector<unsigned long long> _phaseBegin; ///< Counter values at the beginning of the current phase.
+	std::vector<unsigned long long> _runBegin; ///< Counter values at the construction of the meter.
+	std::vector<double> _step; ///< _step[2*phase+domain] is the energy in Joule which has been consumed in the current cutoff step.
+	std::vector<double> _total; ///< _total[2*phase+domain] is the energy in Joule which has been consumed since the construction of the meter.
+};
@@ -0,0 +1,156 @@
+/**
+ * @file FlowProfiler.cpp
+ * @author Finn Lasse Buessen
+ * @brief Per-block profiling of vertex magnitude, flow magnitude, and compute time.
+ *
+ * @copyright Copyright (c) 2020
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <hdf5.h>
+#include "lib/Assert.hpp"
+#include "lib/Exception.hpp"
+#include "FlowProfiler.hpp"
+#include "FrgCommon.hpp"
+#include "EffectiveAction.hpp"
+#ifndef DISABLE_MPI
+#include "mpi.h"
+#endif
+
+FlowProfiler::FlowProfiler(const int interval, const std::string &outfile) : _interval(interval), _outfile(outfile), _step(0), _isActive(false)
+{
+	if (interval < 0) throw Exception(Exception::Type::ArgumentError, "Profiling interval must not be negative.");
+}
+
+bool FlowProfiler::isEnabled() const
+{
+	return _interval > 0;
+}
+
+bool FlowProfiler::isActive() const
+{
+	return _isActive;
+}
+
+void FlowProfiler::beginStep()
+{
+	if (!isEnabled()) return;
+
+	_isActive = (_step++ % _interval == 0);
+	if (_isActive)
+	{
+		int sizeFrequency = FrgCommon::frequency().size * FrgCommon::frequency().size * (FrgCommon::frequency().size + 1) / 2;
+		_times.assign(sizeFrequency, 0.0);
+		if (_siteShells.size() == 0) _initShells();
+	}
+}
+
+void FlowProfiler::endStep(const EffectiveAction &state, const EffectiveAction &flow, const bool isMasterTask)
+{
+	if (!_isActive) return;
+	_isActive = false;
+
+	//collect compute times from all ranks
+	#ifndef DISABLE_MPI
+	if (isMasterTask) MPI_Reduce(MPI_IN_PLACE, _times.data(), int(_times.size()), MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+	else MPI_Reduce(_times.data(), nullptr, int(_times.size()), MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+	#endif
+	if (!isMasterTask) return;
+
+	//aggregate profile
+	int frequencyCount = FrgCommon::frequency().size;
+	int shellCount = int(_shellDistances.size());
+	std::vector<double> vertex = aggregate(state.getTwoParticleMagnitudes());
+	std::vector<double> vertexFlow = aggregate(flow.getTwoParticleMagnitudes());
+	std::vector<double> count = aggregate(std::vector<float>(_times.size() * FrgCommon::lattice().size, 1.0f));
+	std::vector<double> time(frequencyCount, 0.0);
+	for (int i = 0; i < int(_times.size()); ++i) time[frequencyRegion(i, frequencyCount)] += _times[i];
+
+	//open report
+	H5Eset_auto(H5E_DEFAULT, NULL, NULL);
+	hid_t file = (H5Fis_hdf5(_outfile.c_str()) > 0) ? H5Fopen(_outfile.c_str(), H5F_ACC_RDWR, H5P_DEFAULT) : H5Fcreate(_outfile.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+	if (file < 0) throw Exception(Exception::Type::IOError, "Could not open profiling report file for writing");
+
+	auto writeDataset = [](hid_t location, const std::string &name, const std::vector<double> &values, const std::vector<hsize_t> &dimensions)
+	{
+		hid_t dataSpace = H5Screate_simple(int(dimensions.size()), dimensions.data(), NULL);
+		hid_t dataset = H5Dcreate(location, name.c_str(), H5T_NATIVE_DOUBLE, dataSpace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+		H5Dwrite(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data());
+		H5Dclose(dataset);
+		H5Sclose(dataSpace);
+	};
+
+	//write header
+	if (H5Lexists(file, "meta", H5P_DEFAULT) == 0)
+	{
+		hid_t meta = H5Gcreate(file, "meta", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+		writeDataset(meta, "shells", _shellDistances, { hsize_t(shellCount) });
+		writeDataset(meta, "frequencies", std::vector<double>(FrgCommon::frequency()._data, FrgCommon::frequency()._data + frequencyCount), { hsize_t(frequencyCount) });
+		writeDataset(meta, "count", count, { hsize_t(shellCount), hsize_t(frequencyCount) });
+		H5Gclose(meta);
+	}
+	hid_t data = (H5Lexists(file, "data", H5P_DEFAULT) > 0) ? H5Gopen(file, "data", H5P_DEFAULT) : H5Gcreate(file, "data", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+
+	//write profile; a report of a previous run is continued
+	hsize_t profileCount;
+	H5Gget_num_objs(data, &profileCount);
+	hid_t profile = H5Gcreate(data, ("profile_" + std::to_string(profileCount)).c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+
+	const hsize_t attrSpaceSize[1] = { 1 };
+	hid_t attrSpace = H5Screate_simple(1, attrSpaceSize, NULL);
+	hid_t attr = H5Acreate(profile, "cutoff", H5T_NATIVE_FLOAT, attrSpace, H5P_DEFAULT, H5P_DEFAULT);
+	H5Awrite(attr, H5T_NATIVE_FLOAT, &state.cutoff);
+	H5Aclose(attr);
+	H5Sclose(attrSpace);
+
+	writeDataset(profile, "vertex", vertex, { hsize_t(shellCount), hsize_t(frequencyCount) });
+	writeDataset(profile, "flow", vertexFlow, { hsize_t(shellCount), hsize_t(frequencyCount) });
+	writeDataset(profile, "time", time, { hsize_t(frequencyCount) });
+
+	H5Gclose(profile);
+	H5Gclose(data);
+	H5Fclose(file);
+}
+
+std::vector<double> FlowProfiler::aggregate(const std::vector<float> &values) const
+{
+	int frequencyCount = FrgCommon::frequency().size;
+	int latticeSize = FrgCommon::lattice().size;
+	ASSERT(int(values.size()) % latticeSize == 0);
+
+	std::vector<double> blocks(_shellDistances.size() * frequencyCount, 0.0);
+	for (int f = 0; f < int(values.size()) / latticeSize; ++f)
+	{
+		int region = frequencyRegion(f, frequencyCount);
+		for (int rid = 0; rid < latticeSize; ++rid) blocks[_siteShells[rid] * frequencyCount + region] += values[f * latticeSize + rid];
+	}
+	return blocks;
+}
+
+int FlowProfiler::frequencyRegion(const int frequencyIterator, const int frequencyCount)
+{
+	//the linear frequency iterator is (s * (s + 1) / 2 + u) * frequencyCount + t, where u <= s
+	int su = frequencyIterator / frequencyCount;
+	int t = frequencyIterator % frequencyCount;
+	int s = int((sqrt(8.0 * su + 1.0) - 1.0) / 2.0);
+	while (s * (s + 1) / 2 > su) --s;
+	while ((s + 1) * (s + 2) / 2 <= su) ++s;
+	return std::max(s, t);
+}
+
+void FlowProfiler::_initShells()
+{
+	//group representative sites by their real-space distance to the reference site
+	int latticeSize = FrgCommon::lattice().size;
+	std::vector<double> distances(latticeSize);
+	for (int rid = 0; rid < latticeSize; ++rid) distances[rid] = (FrgCommon::lattice().getSitePosition(FrgCommon::lattice().fromParametrization(rid)) - FrgCommon::lattice().getSitePosition(FrgCommon::lattice().zero())).norm();
+
+	std::vector<double> sorted(distances);
+	std::sort(sorted.begin(), sorted.end());
+	_shellDistances.clear();
+	for (double d : sorted) if (_shellDistances.size() == 0 || d - _shellDistances.back() > 1e-6 * std::max(1.0, d)) _shellDistances.push_back(d);
+
+	_siteShells.resize(latticeSize);
+	for (int rid = 0; rid < latticeSize; ++rid) _siteShells[rid] = int(std::lower_bound(_shellDistances.begin(), _shellDistances.end(), distances[rid] - 1e-6 * std::max(1.0, distances[rid])) - _shellDistances.begin());
+}
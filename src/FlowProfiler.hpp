@@ -0,0 +1,115 @@
+/**
+ * @file FlowProfiler.hpp
+ * @author Finn Lasse Buessen
+ * @brief Per-block profiling of vertex magnitude, flow magnitude, and compute time.
+ * @details The two-particle vertex is parametrized by a frequency triplet (s,t,u) and a representative lattice site.
+ * At selected cutoff steps, the profiler aggregates the magnitude of the vertex and of its flow in blocks of equal real-space distance between the two lattice sites (distance shells) and of equal frequency region.
+ * The frequency region of a frequency triplet is defined as the index of the largest of the three frequency arguments on the frequency mesh.
+ * In addition, the compute time which is spent on the flow equations of each frequency triplet is recorded and aggregated per frequency region.
+ *
+ * @copyright Copyright (c) 2020
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <chrono>
+
+struct EffectiveAction;
+
+/**
+ * @brief Per-block profiler for the two-particle vertex.
+ * @details The profiler is disabled by default. If enabled, the SpinParser invokes FlowProfiler::beginStep() before and FlowProfiler::endStep() after the computation of the flow at every cutoff step.
+ * FrgCore implementations wrap the calculation of each frequency block of the two-particle vertex in FlowProfiler::profile().
+ */
+class FlowProfiler
+{
+public:
+	/**
+	 * @brief Construct a new FlowProfiler object.
+	 *
+	 * @param interval Profile every interval-th cutoff step. If set to zero, the profiler is disabled.
+	 * @param outfile Output file for the profiling report.
+	 */
+	FlowProfiler(const int interval = 0, const std::string &outfile = "");
+
+	/**
+	 * @brief Query whether the profiler is enabled.
+	 *
+	 * @return bool Return true if the profiler is enabled, return false otherwise.
+	 */
+	bool isEnabled() const;
+
+	/**
+	 * @brief Query whether the current cutoff step is profiled.
+	 *
+	 * @return bool Return true if the current step is profiled, return false otherwise.
+	 */
+	bool isActive() const;
+
+	/**
+	 * @brief Begin a new cutoff step and decide whether it is profiled. Must be called on all MPI ranks.
+	 */
+	void beginStep();
+
+	/**
+	 * @brief Invoke a function which computes the flow of a frequency block of the two-particle vertex, and record its compute time if the current step is profiled.
+	 * @details Different frequency blocks may be calculated concurrently; each frequency block must be calculated at most once per cutoff step.
+	 *
+	 * @tparam F Function type.
+	 * @param frequencyIterator Linear frequency iterator in the range [0,sizeFrequency) of the two-particle vertex.
+	 * @param f Function to invoke.
+	 */
+	template <typename F> void profile(const int frequencyIterator, F &&f)
+	{
+		if (!_isActive)
+		{
+			f();
+			return;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		f();
+		_times[frequencyIterator] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	/**
+	 * @brief Complete the current cutoff step. If the step is profiled, aggregate the profile and append it to the report on the MPI master rank. Must be called on all MPI ranks.
+	 *
+	 * @param state Current state of the effective action.
+	 * @param flow Flow of the effective action at the current cutoff.
+	 * @param isMasterTask If set to true, the function call is responsible for writing the report.
+	 */
+	void endStep(const EffectiveAction &state, const EffectiveAction &flow, const bool isMasterTask);
+
+	/**
+	 * @brief Aggregate per-site and per-frequency values into blocks of distance shells and frequency regions.
+	 *
+	 * @param values Values indexed by frequencyIterator * lattice size + representative site id.
+	 * @return std::vector<double> Aggregated values indexed by shell * frequency size + frequency region.
+	 */
+	std::vector<double> aggregate(const std::vector<float> &values) const;
+
+	/**
+	 * @brief Determine the frequency region of a linear frequency iterator, i.e. the index of the largest of its three frequency arguments.
+	 *
+	 * @param frequencyIterator Linear frequency iterator.
+	 * @param frequencyCount Number of frequency mesh points.
+	 * @return int Frequency region.
+	 */
+	static int frequencyRegion(const int frequencyIterator, const int frequencyCount);
+
+private:
+	/**
+	 * @brief Assign each representative lattice site to a distance shell.
+	 */
+	void _initShells();
+
+	int _interval; ///< Profile every interval-th cutoff step.
+	std::string _outfile; ///< Output file for the profiling report.
+	int _step; ///< Number of cutoff steps since the profiler has been created.
+	bool _isActive; ///< Set to true if the current cutoff step is profiled.
+	std::vector<double> _times; ///< Compute time per linear frequency iterator.
+	std::vector<int> _siteShells; ///< Distance shell of every representative lattice site.
+	std::vector<double> _shellDistances; ///< Real-space distance of every shell.
+};
@@ -8,6 +8,7 @@
 
 #pragma once
 #include <vector>
+#include <array>
 #include <algorithm>
 #include <cstdlib>
 #include "lib/Exception.hpp"
@@ -158,20 +159,31 @@ struct FrequencyIterator
 /**
  * @brief Discretization of Matsubara frequency space. 
  * @details This structure represents a discretization of Matsubara frequency space base on a list of specified mesh points. 
- * It provides methods to iterate the frequency mesh, to find closest mesh points, and to linearly interpolate arbitrary values inbetween the mesh points. 
+ * It provides methods to iterate the frequency mesh, to find closest mesh points, and to interpolate arbitrary values inbetween the mesh points. 
+ * The interpolation is either linear or a cubic Hermite spline. 
  * The mesh is mirror symmetric around the origin.  
  */
 struct FrequencyDiscretization
 {
 public:
+	/**
+	 * @brief Interpolation scheme between mesh points. 
+	 */
+	enum struct Interpolation
+	{
+		Linear, ///< Linear interpolation between the two adjacent mesh points. 
+		Cubic ///< Cubic Hermite interpolation, where the slopes are estimated from the four surrounding mesh points. 
+	};
+
 	/**
 	 * @brief Construct a frequency discretization based on a list of specified mesh points. 
 	 * The list of specified mesh points must be in ascending order and positive definite. 
 	 * The symmetry-related negative values are automatically generated. 
 	 * 
 	 * @param values List of mesh points. 
+	 * @param interpolation Interpolation scheme between mesh points. 
 	 */
-	FrequencyDiscretization(const std::vector<float> &values)
+	FrequencyDiscretization(const std::vector<float> &values, const Interpolation interpolation = Interpolation::Linear) : interpolation(interpolation)
 	{
 		//Ensure that the frequency values are in ascending order
 		ASSERT(std::is_sorted(values.begin(), values.end()));
@@ -191,6 +203,29 @@ public:
 			_data[i] = values[i];
 		}
 
+		//precompute slope coefficients; the slope at each mesh point is a linear combination of the values at the neighboring mesh points
+		std::vector<std::array<float, 3>> slope(size);
+		slope[0] = { 0.0f, -1.0f / (_data[1] - _data[0]), 1.0f / (_data[1] - _data[0]) };
+		slope[size - 1] = { -1.0f / (_data[size - 1] - _data[size - 2]), 1.0f / (_data[size - 1] - _data[size - 2]), 0.0f };
+		for (int i = 1; i < size - 1; ++i)
+		{
+			float hl = _data[i] - _data[i - 1];
+			float hr = _data[i + 1] - _data[i];
+			slope[i] = { -hr / (hl * (hl + hr)), (hr - hl) / (hl * hr), hl / (hr * (hl + hr)) };
+		}
+
+		//precompute the cubic coefficients per mesh interval, scaled by the interval width
+		_cubicCoefficients.resize(size - 1);
+		for (int i = 0; i < size - 1; ++i)
+		{
+			float h = _data[i + 1] - _data[i];
+			for (int j = 0; j < 3; ++j)
+			{
+				_cubicCoefficients[i][j] = h * slope[i][j];
+				_cubicCoefficients[i][3 + j] = h * slope[i + 1][j];
+			}
+		}
+
 		Log::log << Log::LogLevel::Debug<< "Initialized frequency grid with mesh values" << Log::endl;
 		for (auto i = beginNegative(); i != end(); ++i)	Log::log << "\t" << *i << Log::endl;
 	}
@@ -261,11 +296,8 @@ public:
 		else
 		{
 			if (w <= _data[0]) return FrequencyIterator(_data);
-			for (int i = 1; i < size; ++i)
-			{
-				if (_data[i] > w) return FrequencyIterator(_data + i - 1);
-			}
-			return FrequencyIterator(_data + size - 1);
+			int i = _upperBound(w);
+			return FrequencyIterator(_data + ((i < size) ? i - 1 : size - 1));
 		}
 	}
 
@@ -287,11 +319,7 @@ public:
 		else
 		{
 			if (w <= _data[0]) return FrequencyIterator(_data);
-			for (int i = 1; i < size; ++i)
-			{
-				if (_data[i] > w) return FrequencyIterator(_data + i);
-			}
-			return FrequencyIterator(_data + size - 1);
+			return FrequencyIterator(_data + std::min(_upperBound(w), size - 1));
 		}
 	}
 
@@ -308,11 +336,7 @@ public:
 		ASSERT(w >= 0);
 
 		if (w <= _data[0]) return 0;
-		for (int i = 1; i < size; ++i)
-		{
-			if (_data[i] >= w) return i;
-		}
-		return size - 1;
+		return std::min(int(std::lower_bound(_data + 1, _data + size, w) - _data), size - 1);
 	}	
 
 	/**
@@ -335,15 +359,13 @@ public:
 			bias = 0.0f;
 			return;
 		}
-		for (int i = 1; i < size; ++i)
+		int i = _upperBound(w);
+		if (i < size)
 		{
-			if (_data[i] > w)
-			{
-				upperOffset = i;
-				lowerOffset = i - 1;
-				bias = (w - _data[lowerOffset]) / (_data[upperOffset] - _data[lowerOffset]);
-				return;
-			}
+			upperOffset = i;
+			lowerOffset = i - 1;
+			bias = (w - _data[lowerOffset]) / (_data[upperOffset] - _data[lowerOffset]);
+			return;
 		}
 		lowerOffset = size - 1;
 		upperOffset = size - 1;
@@ -355,7 +377,88 @@ public:
 		ASSERT(bias >= 0.0f && bias <= 1.0f);
 	}
 
+	/**
+	 * @brief Perform an interpolation between mesh points for an arbitrary positive frequency, using a stencil of k mesh points. 
+	 * For k=2, the interpolation is linear. For k=4, the interpolation is a cubic Hermite spline. 
+	 * Out-of-range stencil points are clamped to the boundary of the mesh and carry zero weight. 
+	 * 
+	 * @tparam k Number of mesh points in the stencil. Must be either 2 or 4. 
+	 * @param[in] w Frequency value to interpolate to. Must be positive. 
+	 * @param[out] offsets Number of iterator increments of the stencil points, relative to the first positive mesh point. 
+	 * @param[out] weights Interpolation weights of the stencil points. 
+	 */
+	template <int k> void interpolateStencil(const float w, int *offsets, float *weights) const
+	{
+		static_assert(k == 2 || k == 4, "Interpolation stencil must have either 2 or 4 points");
+
+		if (k == 2)
+		{
+			interpolateOffset(w, offsets[0], offsets[1], weights[1]);
+			weights[0] = 1.0f - weights[1];
+		}
+		else _interpolateCubic(w, offsets, weights);
+	}
+
+	/**
+	 * @brief Perform a cubic Hermite interpolation between mesh points for an arbitrary positive frequency. 
+	 * Outside the mesh range, the value of the closest mesh point is returned. 
+	 * 
+	 * @param[in] w Frequency value to interpolate to. Must be positive. 
+	 * @param[out] offsets Number of iterator increments of the four stencil points, relative to the first positive mesh point. 
+	 * @param[out] weights Interpolation weights of the four stencil points. 
+	 */
+	void _interpolateCubic(const float w, int *offsets, float *weights) const
+	{
+		ASSERT(w >= 0);
+
+		int lowerOffset, upperOffset;
+		float bias;
+		interpolateOffset(w, lowerOffset, upperOffset, bias);
+
+		if (lowerOffset == upperOffset)
+		{
+			for (int i = 0; i < 4; ++i) offsets[i] = lowerOffset;
+			weights[0] = 0.0f;
+			weights[1] = 1.0f;
+			weights[2] = 0.0f;
+			weights[3] = 0.0f;
+			return;
+		}
+
+		//Hermite basis functions
+		float t2 = bias * bias;
+		float t3 = t2 * bias;
+		float h00 = 2.0f * t3 - 3.0f * t2 + 1.0f;
+		float h10 = t3 - 2.0f * t2 + bias;
+		float h01 = -2.0f * t3 + 3.0f * t2;
+		float h11 = t3 - t2;
+
+		const std::array<float, 6> &c = _cubicCoefficients[lowerOffset];
+		offsets[0] = std::max(lowerOffset - 1, 0);
+		offsets[1] = lowerOffset;
+		offsets[2] = upperOffset;
+		offsets[3] = std::min(upperOffset + 1, size - 1);
+		weights[0] = h10 * c[0];
+		weights[1] = h00 + h10 * c[1] + h11 * c[3];
+		weights[2] = h01 + h10 * c[2] + h11 * c[4];
+		weights[3] = h11 * c[5];
+	}
+
+	/**
+	 * @brief Find the first positive mesh point which is greater than the specified frequency value by binary search. 
+	 * Vertex accessors locate their interpolation stencils on every access, such that the lookup cost is logarithmic in the number of mesh points. 
+	 * 
+	 * @param w Frequency value. Must be greater than the first positive mesh point. 
+	 * @return int Index of the mesh point, relative to the first positive mesh point. Returns FrequencyDiscretization::size if no greater mesh point exists. 
+	 */
+	int _upperBound(const float w) const
+	{
+		return int(std::upper_bound(_data + 1, _data + size, w) - _data);
+	}
+
+	Interpolation interpolation; ///< Interpolation scheme which is used by the vertex accessors. 
 	int size; ///< Number of positive mesh points. 
 	float *_data; ///< Pointer to the first positive mesh point. Stored contiuously after FrequencyDiscretization::_dataNegative. 
 	float *_dataNegative; ///< Pointer to the first negative mesh point. 
+	std::vector<std::array<float, 6>> _cubicCoefficients; ///< Slope coefficients for the cubic interpolation on each mesh interval, scaled by the interval width. The first (last) three values determine the slope at the lower (upper) mesh point as a linear combination of its neighboring values. 
 };
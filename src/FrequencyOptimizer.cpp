@@ -0,0 +1,131 @@
+/**
+ * @file FrequencyOptimizer.cpp
+ * @author Finn Lasse Buessen
+ * @brief Automatic placement of frequency mesh points based on pilot flows.
+ *
+ * @copyright Copyright (c) 2020
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "lib/Log.hpp"
+#include "lib/Assert.hpp"
+#include "lib/Exception.hpp"
+#include "FrequencyOptimizer.hpp"
+#include "FrgCommon.hpp"
+#include "EffectiveAction.hpp"
+
+std::vector<float> FrequencyOptimizer::curvature(const std::vector<float> &frequencies, const std::vector<std::vector<float>> &profiles)
+{
+	int n = int(frequencies.size());
+	if (n < 3) throw Exception(Exception::Type::ArgumentError, "Curvature estimate requires at least three frequency mesh points.");
+
+	std::vector<float> x(n);
+	for (int i = 0; i < n; ++i) x[i] = logf(frequencies[i]);
+
+	std::vector<float> intervalCurvature(n - 1, 0.0f);
+	for (auto &profile : profiles)
+	{
+		ASSERT(int(profile.size()) == n);
+
+		//normalize profile
+		float norm = 0.0f;
+		for (float f : profile) norm = std::max(norm, fabsf(f));
+		if (norm == 0.0f) continue;
+
+		//second derivative at mesh points from a three-point parabola, extrapolated to the boundaries
+		std::vector<float> d2(n);
+		for (int i = 1; i < n - 1; ++i)
+		{
+			float hl = x[i] - x[i - 1];
+			float hr = x[i + 1] - x[i];
+			d2[i] = 2.0f * (hl * profile[i + 1] - (hl + hr) * profile[i] + hr * profile[i - 1]) / (hl * hr * (hl + hr) * norm);
+		}
+		d2[0] = d2[1];
+		d2[n - 1] = d2[n - 2];
+
+		for (int i = 0; i < n - 1; ++i) intervalCurvature[i] = std::max(intervalCurvature[i], std::max(fabsf(d2[i]), fabsf(d2[i + 1])));
+	}
+
+	return intervalCurvature;
+}
+
+float FrequencyOptimizer::error(const std::vector<float> &frequencies, const std::vector<float> &curvature)
+{
+	ASSERT(curvature.size() + 1 == frequencies.size());
+
+	float maxError = 0.0f;
+	for (int i = 0; i < int(curvature.size()); ++i)
+	{
+		float h = logf(frequencies[i + 1]) - logf(frequencies[i]);
+		maxError = std::max(maxError, 0.125f * h * h * curvature[i]);
+	}
+	return maxError;
+}
+
+std::vector<float> FrequencyOptimizer::equidistribute(const std::vector<float> &frequencies, const std::vector<float> &curvature, const int count)
+{
+	ASSERT(curvature.size() + 1 == frequencies.size());
+	if (count < 2) throw Exception(Exception::Type::ArgumentError, "Frequency mesh requires at least two mesh points.");
+
+	int n = int(frequencies.size());
+	std::vector<float> x(n);
+	for (int i = 0; i < n; ++i) x[i] = logf(frequencies[i]);
+
+	//regularize curvature
+	float meanCurvature = 0.0f;
+	for (int i = 0; i < n - 1; ++i) meanCurvature += curvature[i] * (x[i + 1] - x[i]);
+	meanCurvature /= x[n - 1] - x[0];
+	if (meanCurvature == 0.0f) meanCurvature = 1.0f;
+
+	//cumulative mesh density; the optimal density for an h^2 |f''| error is proportional to |f''|^(1/2)
+	std::vector<float> density(n - 1);
+	std::vector<float> cumulative(n, 0.0f);
+	for (int i = 0; i < n - 1; ++i)
+	{
+		density[i] = sqrtf(curvature[i] + 0.1f * meanCurvature);
+		cumulative[i + 1] = cumulative[i] + density[i] * (x[i + 1] - x[i]);
+	}
+
+	//place mesh points at equal fractions of the cumulative density
+	std::vector<float> optimizedFrequencies(count);
+	optimizedFrequencies[0] = frequencies[0];
+	optimizedFrequencies[count - 1] = frequencies[n - 1];
+	int interval = 0;
+	for (int k = 1; k < count - 1; ++k)
+	{
+		float target = cumulative[n - 1] * float(k) / float(count - 1);
+		while (interval < n - 2 && cumulative[interval + 1] < target) ++interval;
+		optimizedFrequencies[k] = expf(x[interval] + (target - cumulative[interval]) / density[interval]);
+	}
+
+	return optimizedFrequencies;
+}
+
+std::vector<float> FrequencyOptimizer::pilotFlow(FrgCore *core)
+{
+	std::vector<float> frequencies(FrgCommon::frequency()._data, FrgCommon::frequency()._data + FrgCommon::frequency().size);
+	std::vector<float> maxCurvature(frequencies.size() - 1, 0.0f);
+
+	CutoffIterator cutoff = FrgCommon::cutoff().begin();
+	while (cutoff != FrgCommon::cutoff().last())
+	{
+		//compute flow
+		core->computeStep();
+		if (core->flow()->isDiverged())
+		{
+			Log::log << Log::LogLevel::Debug << "Pilot flow has diverged at cutoff " << core->flowingFunctional()->cutoff << "." << Log::endl;
+			break;
+		}
+
+		//monitor curvature
+		std::vector<float> stepCurvature = curvature(frequencies, core->flowingFunctional()->getFrequencyProfiles());
+		for (int i = 0; i < int(maxCurvature.size()); ++i) maxCurvature[i] = std::max(maxCurvature[i], stepCurvature[i]);
+
+		//perform integration step
+		++cutoff;
+		core->finalizeStep(*cutoff);
+	}
+
+	return maxCurvature;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file FrequencyOptimizer.hpp
+ * @author Finn Lasse Buessen
+ * @brief Automatic placement of frequency mesh points based on pilot flows.
+ * @details The discretization error of the frequency mesh is dominated by the linear interpolation of vertex functions between mesh points and by the trapezoidal quadrature of frequency integrals.
+ * Both contributions are, to leading order, proportional to h^2 |f''| on every mesh interval, where h is the interval width and f'' is the curvature of the vertex along the frequency axis.
+ * The curvature is estimated from short pilot flows, and mesh points are subsequently placed such that the estimated error is equally distributed across all intervals.
+ *
+ * @copyright Copyright (c) 2020
+ */
+
+#pragma once
+#include <vector>
+#include "FrgCore.hpp"
+#include "CutoffDiscretization.hpp"
+
+namespace FrequencyOptimizer
+{
+	/**
+	 * @brief Estimate the curvature of a set of frequency profiles on every interval of a frequency mesh.
+	 * @details Curvatures are computed with respect to the logarithm of the frequency, such that a constant curvature is optimally resolved by an exponential mesh.
+	 * Each profile is normalized to its maximal absolute value before the curvature is estimated. The curvature on each interval is the largest curvature of any profile.
+	 *
+	 * @param frequencies Frequency mesh points in ascending order.
+	 * @param profiles List of functions sampled on the frequency mesh.
+	 * @return std::vector<float> Curvature estimate on each of the frequencies.size()-1 intervals.
+	 */
+	std::vector<float> curvature(const std::vector<float> &frequencies, const std::vector<std::vector<float>> &profiles);
+
+	/**
+	 * @brief Estimate the maximal relative discretization error of a frequency mesh, given the curvature on each mesh interval.
+	 *
+	 * @param frequencies Frequency mesh points in ascending order.
+	 * @param curvature Curvature estimate on each mesh interval, as returned by FrequencyOptimizer::curvature.
+	 * @return float Estimated maximal relative error.
+	 */
+	float error(const std::vector<float> &frequencies, const std::vector<float> &curvature);
+
+	/**
+	 * @brief Place a given number of mesh points such that the estimated discretization error is equally distributed across all mesh intervals.
+	 * @details The first and last mesh point are retained. The curvature is regularized by a fraction of its mean value, such that no region of the frequency axis is left without mesh points.
+	 * For a constant curvature, the resulting mesh is exponential.
+	 *
+	 * @param frequencies Frequency mesh points in ascending order, on which the curvature has been estimated.
+	 * @param curvature Curvature estimate on each mesh interval, as returned by FrequencyOptimizer::curvature.
+	 * @param count Number of mesh points to place.
+	 * @return std::vector<float> New frequency mesh in ascending order.
+	 */
+	std::vector<float> equidistribute(const std::vector<float> &frequencies, const std::vector<float> &curvature, const int count);
+
+	/**
+	 * @brief Solve the flow equations of an FrgCore without taking measurements, and monitor the curvature of the effective action along the frequency axis.
+	 * @details The FrgCore must have been created with the frequency discretization, lattice, and cutoff discretization which are currently active in FrgCommon.
+	 * The flow is terminated early if the vertex diverges.
+	 *
+	 * @param core FrgCore to run.
+	 * @return std::vector<float> Largest curvature on each frequency mesh interval encountered throughout the flow.
+	 */
+	std::vector<float> pilotFlow(FrgCore *core);
+}
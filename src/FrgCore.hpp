@@ -8,12 +8,26 @@
 
 #pragma once
 #include <vector>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <functional>
 #include "EffectiveAction.hpp"
 #include "Measurement.hpp"
+#include "FrgCommon.hpp"
+#include "KernelTuner.hpp"
+#include "MultirateScheduler.hpp"
+#include "lib/Log.hpp"
+#include "lib/ValueBundle.hpp"
 #include "SpinModel.hpp"
 #include "SpinParser.hpp"
+#ifndef DISABLE_OMP
+#include "omp.h"
+#endif
 
 class SpinParser;
+class TaskFileParser;
 
 /**
  * @brief Virtual implementation of a pf-FRG numerics core. 
@@ -29,34 +43,34 @@ class SpinParser;
 class FrgCore
 {
 	friend class SpinParser;
+	friend class TaskFileParser;
 public:
 	/**
-	 * @brief Invoke all associated measurement protocols. 
+	 * @brief Invoke all associated measurement protocols whose scheduler requests a measurement at the current cutoff. 
+	 * @details Must be called on all MPI ranks, since adaptive schedulers synchronize their decisions. 
+	 * All measurements which are due are taken as a single batch, such that their load managed calculations share one LoadManager epoch. 
+	 * 
+	 * @param forced If set to true, all eligible measurement protocols are invoked irrespective of their schedule, unless they have been invoked at the same cutoff already. 
 	 */
-	void takeMeasurements() const
+	void takeMeasurements(const bool forced = false) const
 	{
-		if (SpinParser::spinParser()->getComputationStatus().statusIdentifier == ComputationStatus::Identifier::Postprocessing)
+		//deferred measurements are performed in the postprocessing phase, all other measurements during the flow
+		bool isPostprocessing = SpinParser::spinParser()->getComputationStatus().statusIdentifier == ComputationStatus::Identifier::Postprocessing;
+
+		//collect measurements which are due
+		std::vector<Measurement *> batch;
+		for (auto m : _measurements)
 		{
-			//perform deferred measurements
-			for (auto m : _measurements)
+			if (_flowingFunctional->cutoff <= m->maxCutoff() && _flowingFunctional->cutoff >= m->minCutoff())
 			{
-				if (_flowingFunctional->cutoff <= m->maxCutoff() && _flowingFunctional->cutoff >= m->minCutoff())
-				{
-					if (SpinParser::spinParser()->getCommandLineOptions()->deferMeasurements() || m->isDeferred()) m->takeMeasurement(*_flowingFunctional, SpinParser::spinParser()->isMasterRank());
-				}
+				bool isDeferred = SpinParser::spinParser()->getCommandLineOptions()->deferMeasurements() || m->isDeferred();
+				if (isDeferred == isPostprocessing && m->scheduler().isDue(_flowingFunctional->cutoff, forced)) batch.push_back(m);
 			}
 		}
-		else
-		{
-			//perform non-deferred measurements
-			for (auto m : _measurements)
-			{
-				if (_flowingFunctional->cutoff <= m->maxCutoff() && _flowingFunctional->cutoff >= m->minCutoff())
-				{
-					if (!SpinParser::spinParser()->getCommandLineOptions()->deferMeasurements() && !m->isDeferred()) m->takeMeasurement(*_flowingFunctional, SpinParser::spinParser()->isMasterRank());
-				}
-			}
+		Measurement::takeMeasurementBatch(batch, *_flowingFunctional, SpinParser::spinParser()->isMasterRank());
 
+		if (!isPostprocessing)
+		{
 			//write vertex output, if deferred measurements are specified
 			bool postprocessingRequired = false;
 			if (SpinParser::spinParser()->getCommandLineOptions()->deferMeasurements()) postprocessingRequired = true;
@@ -85,6 +99,106 @@ public:
 	 */
 	virtual void finalizeStep(float newCutoff) = 0;
 
+	/**
+	 * @brief Advance the two-particle vertex, or any other data array, by one cutoff step, given its flow. 
+	 * @details The explicit Euler integrator performs the update v += h*f with the cutoff step h. 
+	 * The implicit integrator performs a linearly implicit Euler step v += h*f/(1-h*J), where the flow of each component is assumed to be dominated by a bubble term which is quadratic in the vertex. 
+	 * The Jacobian is approximated by its secant J = f/v, for which the step reproduces the exact solution of the model equation v' = a*v^2. 
+	 * Quickly decaying components are thereby damped without overshooting, and quickly growing components, as found in the RPA-like channel close to an instability, are extrapolated beyond the explicit step. 
+	 * The extrapolation is capped at twice the explicit step. Components which are small compared to the largest component of the array are integrated explicitly. 
+	 * 
+	 * @param data Data array to update. 
+	 * @param flow Flow of the data array. 
+	 * @param size Number of elements. 
+	 * @param cutoffStep Cutoff step h. 
+	 * @param integrator Integration scheme. 
+	 */
+	static void integrateStep(float *data, const float *flow, const int size, const float cutoffStep, const CutoffDiscretization::Integrator integrator)
+	{
+		if (integrator == CutoffDiscretization::Integrator::Euler)
+		{
+			#ifndef DISABLE_OMP
+			#pragma omp parallel for schedule(static)
+			#endif
+			for (int i = 0; i < size; ++i) data[i] += cutoffStep * flow[i];
+			return;
+		}
+
+		//determine scale of the data array
+		float maxValue = 0.0f;
+		#ifndef DISABLE_OMP
+		#pragma omp parallel for schedule(static) reduction(max:maxValue)
+		#endif
+		for (int i = 0; i < size; ++i) maxValue = std::max(maxValue, fabsf(data[i]));
+		float threshold = 1e-3f * maxValue;
+
+		//linearly implicit step with secant Jacobian
+		#ifndef DISABLE_OMP
+		#pragma omp parallel for schedule(static)
+		#endif
+		for (int i = 0; i < size; ++i)
+		{
+			float hJ = (fabsf(data[i]) > threshold) ? cutoffStep * flow[i] / data[i] : 0.0f;
+			data[i] += cutoffStep * flow[i] / (1.0f - std::min(hJ, 0.5f));
+		}
+	}
+
+	/**
+	 * @brief Query whether the flow of the two-particle vertex is computed for a representative lattice site. 
+	 * @details Sites beyond the active range are kept at their bare vertex and do not contribute to the cost of the flow equations. 
+	 * 
+	 * @param rid Representative lattice site. 
+	 * @return bool Return true if the bond distance of the site does not exceed the active range, return false otherwise. 
+	 */
+	bool isSiteActive(const int rid) const
+	{
+		return FrgCommon::lattice().getBondDistance(rid) <= _activeRange;
+	}
+
+	/**
+	 * @brief Extend the active range of the lattice as long as the vertex at the boundary shell is not negligible. 
+	 * @details The boundary shell is formed by all sites whose bond distance equals the active range. 
+	 * Its largest vertex magnitude is compared to the largest vertex magnitude of all non-local sites within the active range. 
+	 * If the ratio exceeds the range threshold, the active range is increased by one bond, and the multi-rate evaluation starts over, since the flow of the newly active sites has not been evaluated before. 
+	 * Must be called on all MPI ranks after the flowing functional has been updated. 
+	 */
+	void updateActiveRange()
+	{
+		if (_activeRange >= FrgCommon::lattice().range) return;
+
+		std::vector<float> magnitudes = _flowingFunctional->getTwoParticleMagnitudes();
+		int latticeSize = FrgCommon::lattice().size;
+		while (_activeRange < FrgCommon::lattice().range)
+		{
+			float boundaryMagnitude = 0.0f;
+			float referenceMagnitude = 0.0f;
+			for (int i = 0; i < int(magnitudes.size()); ++i)
+			{
+				int distance = FrgCommon::lattice().getBondDistance(i % latticeSize);
+				if (distance == 0 || distance > _activeRange) continue;
+				if (distance == _activeRange) boundaryMagnitude = std::max(boundaryMagnitude, magnitudes[i]);
+				else referenceMagnitude = std::max(referenceMagnitude, magnitudes[i]);
+			}
+			if (boundaryMagnitude <= _rangeThreshold * referenceMagnitude) break;
+
+			++_activeRange;
+			_multirate.reset();
+			Log::log << Log::LogLevel::Info << "Extended active lattice range to " << _activeRange << "." << Log::endl;
+		}
+	}
+
+	/**
+	 * @brief Select the fastest variants of the kernels which compute the flow of the two-particle vertex. 
+	 * @details FrgCore implementations which provide kernel variants override the method and invoke FrgCore::_tuneKernels(). 
+	 * The default implementation leaves the default variants active. 
+	 * Must be called on all MPI ranks after FrgCore::computeStep(). 
+	 * 
+	 * @param tuner Kernel tuner. 
+	 */
+	virtual void tuneKernels(KernelTuner &tuner)
+	{
+	}
+
 	/**
 	 * @brief Retrieve the flowing functional.
 	 *
@@ -122,7 +236,56 @@ protected:
 	 *
 	 * @param measurements List of measurement protocols to invoke during the solution of the flow equations.
 	 */
-	FrgCore(const std::vector<Measurement *> &measurements) : _flowingFunctional(nullptr), _flow(nullptr), _measurements(measurements) {};
+	FrgCore(const std::vector<Measurement *> &measurements) : _flowingFunctional(nullptr), _flow(nullptr), _measurements(measurements), _activeRange(FrgCommon::lattice().range), _rangeThreshold(0.0f), _multirate(FrgCommon::cutoff().multirate, FrgCommon::cutoff().multirateTolerance) {};
+
+	/**
+	 * @brief Register the kernel variants and time them on a sample of frequency iterators of the two-particle vertex. 
+	 * @details The sample is spread evenly across the frequency mesh and computed in parallel, as in the solution of the flow equations. 
+	 * Its size is doubled until a single evaluation takes at least 20ms, or until it covers the entire frequency mesh. 
+	 * All variants perform identical floating point operations in the same order, such that recomputing the sample reproduces the flow of the current cutoff step exactly. 
+	 * 
+	 * @param tuner Kernel tuner. 
+	 * @param identifier FrgCore identifier, which is part of the problem shape. 
+	 * @param calculateVertexTwoParticle Function which calculates the two-particle vertex flow for a linear frequency iterator. 
+	 * @param hasOverlapTraversal If set to true, the calculation supports all variants of KernelTuner::OverlapTraversal. 
+	 */
+	void _tuneKernels(KernelTuner &tuner, const std::string &identifier, const std::function<void(int)> &calculateVertexTwoParticle, const bool hasOverlapTraversal)
+	{
+		tuner.addKernel("getValueSuperbundle", { "frequencyMajor", "siteMajor" }, [](int v) { KernelTuner::gatherOrder = static_cast<KernelTuner::GatherOrder>(v); });
+		tuner.addKernel("ValueBundle", { "width1", "width4", "width16" }, [](int v) { ValueBundleLayout::width() = (v == 0) ? 1 : ((v == 1) ? 4 : 16); });
+		if (hasOverlapTraversal) tuner.addKernel("calculateVertexTwoParticle", { "split", "fused" }, [](int v) { KernelTuner::overlapTraversal = static_cast<KernelTuner::OverlapTraversal>(v); });
+
+		int threads = 1;
+		#ifndef DISABLE_OMP
+		threads = omp_get_max_threads();
+		#endif
+
+		//sample frequency iterators evenly across the frequency mesh; the sample is doubled until it is long enough to be timed reliably
+		int sizeFrequency = FrgCommon::frequency().size * FrgCommon::frequency().size * (FrgCommon::frequency().size + 1) / 2;
+		int sampleSize = std::min(sizeFrequency, std::max(16, 2 * threads));
+		std::vector<int> sample;
+		auto runSample = [&]()
+		{
+			#ifndef DISABLE_OMP
+			#pragma omp parallel for schedule(dynamic)
+			#endif
+			for (int i = 0; i < int(sample.size()); ++i) calculateVertexTwoParticle(sample[i]);
+		};
+		while (true)
+		{
+			sample.resize(sampleSize);
+			for (int i = 0; i < sampleSize; ++i) sample[i] = int((long long)(i) * sizeFrequency / sampleSize);
+			if (sampleSize == sizeFrequency) break;
+
+			auto start = std::chrono::steady_clock::now();
+			runSample();
+			if (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >= 0.02) break;
+			sampleSize = std::min(sizeFrequency, 2 * sampleSize);
+		}
+
+		std::string shape = identifier + " sites=" + std::to_string(FrgCommon::lattice().size) + " range=" + std::to_string(FrgCommon::lattice().getRangeIds(0).size()) + " frequencies=" + std::to_string(FrgCommon::frequency().size) + " interpolation=" + ((FrgCommon::frequency().interpolation == FrequencyDiscretization::Interpolation::Cubic) ? "cubic" : "linear") + " threads=" + std::to_string(threads);
+		tuner.tune(shape, runSample);
+	}
 
 	/**
 	 * @brief Destroy the FrgCore object and delete any associated measurement protocols.
@@ -139,4 +302,7 @@ protected:
 	EffectiveAction *_flowingFunctional; ///< Representation of the current state of the effective action. 
 	EffectiveAction *_flow; ///< Representation of the RG flow associated with the current state of the effective action. 
 	std::vector<Measurement *> _measurements; ///< List of measurement protocols to invoke throughout the solution of the flow equations. 
+	int _activeRange; ///< Bond distance up to which the flow of the two-particle vertex is computed. 
+	float _rangeThreshold; ///< Relative vertex magnitude at the boundary shell above which the active range is extended. 
+	MultirateScheduler _multirate; ///< Scheduler which decides which frequency blocks of the two-particle vertex flow are evaluated at every cutoff step. 
 };
\ No newline at end of file
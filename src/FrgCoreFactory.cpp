@@ -10,6 +10,7 @@
 #include "lib/Exception.hpp"
 #include "lib/InputParser.hpp"
 #include "FrgCoreFactory.hpp"
+#include "MeasurementPlugin.hpp"
 
 //SU2
 #include "SU2/SU2FrgCore.hpp"
@@ -20,6 +21,9 @@
 //TRI
 #include "TRI/TRIFrgCore.hpp"
 #include "TRI/TRIMeasurementCorrelation.hpp"
+//U1
+#include "U1/U1FrgCore.hpp"
+#include "U1/U1MeasurementCorrelation.hpp"
 
 
 FrgCore *FrgCoreFactory::newFrgCore(const std::string &identifier, const SpinModel &model, const std::vector<MeasurementSpecification> &measurements, const std::map<std::string, std::string> &options)
@@ -36,11 +40,29 @@ FrgCore *FrgCoreFactory::newFrgCore(const std::string &identifier, const SpinMod
 			if (identifier == "SU2") m = new SU2MeasurementCorrelation(specification.output, specification.minCutoff, specification.maxCutoff, specification.defer);
 			else if (identifier == "XYZ") m = new XYZMeasurementCorrelation(specification.output, specification.minCutoff, specification.maxCutoff, specification.defer);
 			else if (identifier == "TRI") m = new TRIMeasurementCorrelation(specification.output, specification.minCutoff, specification.maxCutoff, specification.defer);
+			else if (identifier == "U1") m = new U1MeasurementCorrelation(specification.output, specification.minCutoff, specification.maxCutoff, specification.defer);
 			else throw Exception(Exception::Type::InitializationError, "Measurement [correlation]: Unknown model symmetry '" + identifier + "'.");
 
+			m->setScheduler(specification.scheduler);
 			Log::log << Log::LogLevel::Info << "Added measurement [correlation]." << Log::endl;
 			measurementObjects.push_back(m);
 		}
+		//measurement implemented by a plugin library
+		else if (specification.identifier == "plugin")
+		{
+			MeasurementPlugin::Specification pluginSpecification;
+			pluginSpecification.symmetry = identifier;
+			pluginSpecification.output = specification.output;
+			pluginSpecification.minCutoff = specification.minCutoff;
+			pluginSpecification.maxCutoff = specification.maxCutoff;
+			pluginSpecification.defer = specification.defer;
+			pluginSpecification.options = specification.options;
+			Measurement *m = MeasurementPlugin::newMeasurement(specification.library, pluginSpecification);
+
+			m->setScheduler(specification.scheduler);
+			Log::log << Log::LogLevel::Info << "Added measurement [plugin] from library [" << specification.library << "]." << Log::endl;
+			measurementObjects.push_back(m);
+		}
 		else throw Exception(Exception::Type::InitializationError, "Measurement: Unknown measurement type '" + identifier + "'.");
 
 	}
@@ -48,5 +70,15 @@ FrgCore *FrgCoreFactory::newFrgCore(const std::string &identifier, const SpinMod
 	if (identifier == "SU2") return new SU2FrgCore(model, measurementObjects, options);
 	else if (identifier == "XYZ") return new XYZFrgCore(model, measurementObjects, options);
 	else if (identifier == "TRI") return new TRIFrgCore(model, measurementObjects, options);
+	else if (identifier == "U1")
+	{
+		//verify that the spin model is invariant under spin rotations about the z-axis
+		for (auto i : model.interactions)
+		{
+			const float(&J)[3][3] = i.second.interactionStrength;
+			if (J[0][0] != J[1][1] || J[0][1] != -J[1][0] || J[0][2] != 0.0f || J[2][0] != 0.0f || J[1][2] != 0.0f || J[2][1] != 0.0f) throw Exception(Exception::Type::InitializationError, "Spin model is not U(1)-symmetric. The U1 core requires Jxx=Jyy, Jxy=-Jyx, and vanishing xz, yz, zx, and zy interactions.");
+		}
+		return new U1FrgCore(model, measurementObjects, options);
+	}
 	else throw Exception(Exception::Type::ArgumentError, "Spin model identifier '" + identifier + "' does not exist.");
 }
\ No newline at end of file
@@ -26,6 +26,8 @@ namespace FrgCoreFactory
 		float maxCutoff; ///< Maximal cutoff value for the protocol to be invoked. 
 		bool defer; ///< Defer flag. If set to true, the measurement will only be invoked in the postprocessing stage. 
 		std::vector<std::pair<std::string, std::string>> options; ///< String-form protocol modifiers as specified in the task file. 
+		MeasurementScheduler scheduler; ///< Scheduler which decides at which cutoff steps the protocol is invoked. 
+		std::string library; ///< Shared library which implements the protocol. Only used for plugin measurements. 
 	};
 
 	/**
@@ -0,0 +1,210 @@
+/**
+ * @file KernelTuner.cpp
+ * @author Finn Lasse Buessen
+ * @brief Runtime selection of the fastest implementation variants of the hot kernels. 
+ * 
+ * @copyright Copyright (c) 2020
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include "lib/Log.hpp"
+#include "KernelTuner.hpp"
+#ifndef DISABLE_MPI
+#include "mpi.h"
+#endif
+
+KernelTuner::GatherOrder KernelTuner::gatherOrder = KernelTuner::GatherOrder::FrequencyMajor;
+KernelTuner::OverlapTraversal KernelTuner::overlapTraversal = KernelTuner::OverlapTraversal::Split;
+
+KernelTuner::KernelTuner(const bool isEnabled, const std::string &cacheFile) : _isEnabled(isEnabled), _isTuned(false), _cacheFile(cacheFile)
+{
+}
+
+KernelTuner::~KernelTuner()
+{
+	for (auto &kernel : _kernels) kernel.select(0);
+}
+
+bool KernelTuner::isEnabled() const
+{
+	return _isEnabled;
+}
+
+bool KernelTuner::isPending() const
+{
+	return _isEnabled && !_isTuned;
+}
+
+void KernelTuner::addKernel(const std::string &name, const std::vector<std::string> &variants, const std::function<void(int)> &select)
+{
+	Kernel kernel;
+	kernel.name = name;
+	kernel.variants = variants;
+	kernel.select = select;
+	kernel.selection = 0;
+	_kernels.push_back(kernel);
+}
+
+void KernelTuner::tune(const std::string &shape, const std::function<void()> &sample)
+{
+	_isTuned = true;
+
+	int rank = 0;
+	#ifndef DISABLE_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	#endif
+
+	//the master rank takes all decisions; kernels with cached decisions are not timed
+	std::string key = cpuModel() + "|" + shape;
+	std::vector<int> selections(_kernels.size(), 0);
+	std::vector<int> isCached(_kernels.size(), 0);
+	std::vector<double> times(_kernels.size(), 0.0);
+	if (rank == 0)
+	{
+		for (auto &decision : _readCache(key))
+		{
+			for (int k = 0; k < int(_kernels.size()); ++k)
+			{
+				auto v = std::find(_kernels[k].variants.begin(), _kernels[k].variants.end(), decision.second);
+				if (_kernels[k].name == decision.first && v != _kernels[k].variants.end())
+				{
+					selections[k] = int(v - _kernels[k].variants.begin());
+					isCached[k] = 1;
+				}
+			}
+		}
+		for (int k = 0; k < int(_kernels.size()); ++k) _kernels[k].select(selections[k]);
+
+		//tune kernels one after another, such that each kernel is timed with the best variants of all previous kernels
+		bool isWarm = false;
+		for (int k = 0; k < int(_kernels.size()); ++k)
+		{
+			if (isCached[k]) continue;
+			if (!isWarm)
+			{
+				sample();
+				isWarm = true;
+			}
+
+			times[k] = -1.0;
+			for (int v = 0; v < int(_kernels[k].variants.size()); ++v)
+			{
+				_kernels[k].select(v);
+				double t = _time(sample);
+				if (times[k] < 0.0 || t < times[k])
+				{
+					times[k] = t;
+					selections[k] = v;
+				}
+			}
+			_kernels[k].select(selections[k]);
+		}
+	}
+
+	//share decisions
+	#ifndef DISABLE_MPI
+	MPI_Bcast(selections.data(), int(selections.size()), MPI_INT, 0, MPI_COMM_WORLD);
+	#endif
+	for (int k = 0; k < int(_kernels.size()); ++k)
+	{
+		_kernels[k].selection = selections[k];
+		_kernels[k].select(selections[k]);
+	}
+
+	//report choices
+	if (rank != 0) return;
+	for (int k = 0; k < int(_kernels.size()); ++k)
+	{
+		if (isCached[k]) Log::log << Log::LogLevel::Info << "Kernel [" << _kernels[k].name << "] uses variant [" << _kernels[k].variants[selections[k]] << "] (cached)." << Log::endl;
+		else Log::log << Log::LogLevel::Info << "Kernel [" << _kernels[k].name << "] uses variant [" << _kernels[k].variants[selections[k]] << "] (" << std::fixed << std::setprecision(3) << times[k] * 1000.0 << " ms per sample)." << Log::endl;
+	}
+	if (std::find(isCached.begin(), isCached.end(), 0) != isCached.end()) _writeCache(key);
+}
+
+std::string KernelTuner::variant(const std::string &name) const
+{
+	for (auto &kernel : _kernels) if (kernel.name == name) return kernel.variants[kernel.selection];
+	return "";
+}
+
+std::string KernelTuner::cpuModel()
+{
+	std::ifstream cpuinfo("/proc/cpuinfo");
+	std::string line;
+	while (std::getline(cpuinfo, line))
+	{
+		if (line.compare(0, 10, "model name") != 0) continue;
+		size_t separator = line.find(':');
+		if (separator == std::string::npos) break;
+		size_t begin = line.find_first_not_of(" \t", separator + 1);
+		if (begin == std::string::npos) break;
+		return line.substr(begin);
+	}
+	return "unknown";
+}
+
+double KernelTuner::_time(const std::function<void()> &sample) const
+{
+	//the shortest run is least affected by noise
+	double best = -1.0;
+	for (int r = 0; r < 3; ++r)
+	{
+		auto start = std::chrono::steady_clock::now();
+		sample();
+		double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (best < 0.0 || t < best) best = t;
+	}
+	return best;
+}
+
+std::vector<std::pair<std::string, std::string>> KernelTuner::_readCache(const std::string &key) const
+{
+	//each line of the cache file holds a key, a kernel name, and a variant name, separated by tabs
+	std::vector<std::pair<std::string, std::string>> decisions;
+	if (_cacheFile == "") return decisions;
+
+	std::ifstream cache(_cacheFile);
+	std::string line;
+	while (std::getline(cache, line))
+	{
+		size_t first = line.find('\t');
+		size_t second = (first == std::string::npos) ? std::string::npos : line.find('\t', first + 1);
+		if (second == std::string::npos) continue;
+		if (line.substr(0, first) == key) decisions.push_back(std::make_pair(line.substr(first + 1, second - first - 1), line.substr(second + 1)));
+	}
+	return decisions;
+}
+
+void KernelTuner::_writeCache(const std::string &key) const
+{
+	if (_cacheFile == "") return;
+
+	//keep decisions for other keys and other kernels
+	std::vector<std::string> lines;
+	std::ifstream cache(_cacheFile);
+	std::string line;
+	while (std::getline(cache, line))
+	{
+		bool isReplaced = false;
+		for (auto &kernel : _kernels) if (line.compare(0, key.size() + kernel.name.size() + 2, key + "\t" + kernel.name + "\t") == 0) isReplaced = true;
+		if (!isReplaced) lines.push_back(line);
+	}
+	cache.close();
+	for (auto &kernel : _kernels) lines.push_back(key + "\t" + kernel.name + "\t" + kernel.variants[kernel.selection]);
+
+	//a cache which cannot be written is not an error, since decisions can always be recomputed
+	boost::system::error_code error;
+	boost::filesystem::path parent = boost::filesystem::path(_cacheFile).parent_path();
+	if (!parent.empty()) boost::filesystem::create_directories(parent, error);
+	std::ofstream out(_cacheFile, std::ios::trunc);
+	if (!out)
+	{
+		Log::log << Log::LogLevel::Warning << "Could not write kernel tuning cache [" << _cacheFile << "]." << Log::endl;
+		return;
+	}
+	for (auto &l : lines) out << l << std::endl;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file KernelTuner.hpp
+ * @author Finn Lasse Buessen
+ * @brief Runtime selection of the fastest implementation variants of the hot kernels. 
+ * @details Which implementation of a kernel performs best depends on the lattice size, the number of frequencies, the FrgCore, and the CPU. 
+ * The KernelTuner times all registered variants of each kernel on a representative sample workload and selects the fastest one. 
+ * Decisions are cached in a local file, keyed by the CPU model and the problem shape, such that subsequent runs of the same problem skip the timing. 
+ * 
+ * @copyright Copyright (c) 2020
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+
+/**
+ * @brief Autotuner for implementation variants of the hot kernels. 
+ * @details Kernels are registered via KernelTuner::addKernel() with a list of named variants and a function which activates a variant. 
+ * Upon KernelTuner::tune(), the kernels are tuned one after another: each variant of a kernel is activated, the sample workload is timed, and the fastest variant remains active while the next kernel is tuned. 
+ * All variants of a kernel must produce identical results. 
+ * 
+ * The active variants of the kernels which are provided by the SpinParser are stored in static members, such that they can be accessed from the kernels without indirection. 
+ */
+class KernelTuner
+{
+public:
+	/**
+	 * @brief Loop order of the vertex gather in the getValueSuperbundle() routines of the two-particle vertices. 
+	 */
+	enum class GatherOrder
+	{
+		FrequencyMajor, ///< Loop over frequency support values outermost and accumulate into the bundles.
+		SiteMajor ///< Loop over lattice sites outermost and accumulate all frequency support values in registers.
+	};
+
+	/**
+	 * @brief Traversal of the lattice overlap in the RPA bubble of the two-particle flow. 
+	 */
+	enum class OverlapTraversal
+	{
+		Split, ///< Traverse the overlap once per spin component.
+		Fused ///< Traverse the overlap once and accumulate all spin components simultaneously.
+	};
+
+	/**
+	 * @brief Construct a new KernelTuner object. 
+	 * 
+	 * @param isEnabled If set to false, the tuner is disabled and the default variants remain active. 
+	 * @param cacheFile File in which tuning decisions are cached. If empty, decisions are not cached. 
+	 */
+	KernelTuner(const bool isEnabled = false, const std::string &cacheFile = "");
+
+	/**
+	 * @brief Destroy the KernelTuner object and activate the default variants of all registered kernels. 
+	 */
+	~KernelTuner();
+
+	/**
+	 * @brief Query whether the tuner is enabled. 
+	 * 
+	 * @return bool Return true if the tuner is enabled, return false otherwise. 
+	 */
+	bool isEnabled() const;
+
+	/**
+	 * @brief Query whether the tuner is enabled and has not tuned the kernels yet. 
+	 * 
+	 * @return bool Return true if tuning is pending, return false otherwise. 
+	 */
+	bool isPending() const;
+
+	/**
+	 * @brief Register a kernel. 
+	 * 
+	 * @param name Name of the kernel. 
+	 * @param variants Names of the kernel variants. The first variant is the default. 
+	 * @param select Function which activates the n-th variant. 
+	 */
+	void addKernel(const std::string &name, const std::vector<std::string> &variants, const std::function<void(int)> &select);
+
+	/**
+	 * @brief Select the fastest variant of each registered kernel and report the choices. Must be called on all MPI ranks. 
+	 * @details Decisions are looked up in the cache file first. Kernels without cached decisions are timed on the MPI master rank, and the decisions are broadcast to all ranks. 
+	 * 
+	 * @param shape Problem shape, which identifies the decisions in the cache file together with the CPU model. 
+	 * @param sample Representative sample workload, which exercises all registered kernels. 
+	 */
+	void tune(const std::string &shape, const std::function<void()> &sample);
+
+	/**
+	 * @brief Retrieve the name of the active variant of a kernel. 
+	 * 
+	 * @param name Name of the kernel. 
+	 * @return std::string Name of the active variant. Empty if the kernel has not been registered. 
+	 */
+	std::string variant(const std::string &name) const;
+
+	/**
+	 * @brief Retrieve the CPU model of the host. 
+	 * 
+	 * @return std::string CPU model as reported by the operating system, or "unknown". 
+	 */
+	static std::string cpuModel();
+
+	static GatherOrder gatherOrder; ///< Active variant of the vertex gather.
+	static OverlapTraversal overlapTraversal; ///< Active variant of the overlap traversal.
+
+private:
+	/**
+	 * @brief Registered kernel. 
+	 */
+	struct Kernel
+	{
+		std::string name; ///< Name of the kernel.
+		std::vector<std::string> variants; ///< Names of the kernel variants.
+		std::function<void(int)> select; ///< Function which activates a variant.
+		int selection; ///< Active variant.
+	};
+
+	/**
+	 * @brief Time the sample workload with the currently active kernel variants. 
+	 * 
+	 * @param sample Sample workload. 
+	 * @return double Shortest of several runs in seconds. 
+	 */
+	double _time(const std::function<void()> &sample) const;
+
+	/**
+	 * @brief Read cached decisions for the specified key. 
+	 * 
+	 * @param key Cache key. 
+	 * @return std::vector<std::pair<std::string, std::string>> List of kernel names and variant names. 
+	 */
+	std::vector<std::pair<std::string, std::string>> _readCache(const std::string &key) const;
+
+	/**
+	 * @brief Write decisions for the specified key to the cache file, replacing previous decisions for the same key. 
+	 * 
+	 * @param key Cache key. 
+	 */
+	void _writeCache(const std::string &key) const;
+
+	bool _isEnabled; ///< Set to true if the tuner is enabled.
+	bool _isTuned; ///< Set to true once the kernels have been tuned.
+	std::string _cacheFile; ///< File in which tuning decisions are cached.
+	std::vector<Kernel> _kernels; ///< Registered kernels.
+};
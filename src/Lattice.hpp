@@ -46,6 +46,7 @@ enum struct SpinComponent : int
  * Similarly, it contains a list of representative ids to which the second vertex v(j,i2) is mapped. 
  * Furthermore, the spin permutations required for the symmetry transformations are stored. 
  * Each tuple of (rid1[i],rid2[i],transformedX1[i],transformedY1[i],transformedZ1[i],transformedX2[i],transformedY2[i],transformedZ2[i]) describes the transformations for a single term in the sum over overlapping lattice sites j. 
+ * If the transformation of a vertex is not a plain permutation of spin components, spinRotation1[i] or spinRotation2[i] refer to its matrix form, see LatticeSiteDescriptor::spinRotation. 
  */
 struct LatticeOverlap
 {
@@ -53,7 +54,7 @@ struct LatticeOverlap
 	friend struct Lattice;
 
 public:
-	LatticeOverlap() : rid1(nullptr), rid2(nullptr), transformedX1(nullptr), transformedY1(nullptr), transformedZ1(nullptr), transformedX2(nullptr), transformedY2(nullptr), transformedZ2(nullptr), size(0) {}
+	LatticeOverlap() : rid1(nullptr), rid2(nullptr), transformedX1(nullptr), transformedY1(nullptr), transformedZ1(nullptr), transformedX2(nullptr), transformedY2(nullptr), transformedZ2(nullptr), spinRotation1(nullptr), spinRotation2(nullptr), size(0) {}
 
 	/**
 	 * @brief Construct a new LatticeOverlap object for a given number of sites. 
@@ -70,12 +71,14 @@ public:
 		transformedX2 = new SpinComponent[size];
 		transformedY2 = new SpinComponent[size];
 		transformedZ2 = new SpinComponent[size];
+		spinRotation1 = new int[size];
+		spinRotation2 = new int[size];
 	}
 
 	/**
-	 * @brief Construct a new LatticeOverlap object from an existing one.
-	 *
-	 * @param rhs LatticeOverlap object.
+	 * @brief Construct a new LatticeOverlap object from an existing one. 
+	 * 
+	 * @param rhs LatticeOverlap object. 
 	 */
 	LatticeOverlap(const LatticeOverlap &rhs) : LatticeOverlap(rhs.size)
 	{
@@ -87,6 +90,8 @@ public:
 		memcpy(transformedX2, rhs.transformedX2, size * sizeof(SpinComponent));
 		memcpy(transformedY2, rhs.transformedY2, size * sizeof(SpinComponent));
 		memcpy(transformedZ2, rhs.transformedZ2, size * sizeof(SpinComponent));
+		memcpy(spinRotation1, rhs.spinRotation1, size * sizeof(int));
+		memcpy(spinRotation2, rhs.spinRotation2, size * sizeof(int));
 	}
 
 	int *rid1;
@@ -97,6 +102,8 @@ public:
 	SpinComponent *transformedX2;
 	SpinComponent *transformedY2;
 	SpinComponent *transformedZ2;
+	int *spinRotation1;
+	int *spinRotation2;
 	int size;
 
 protected:
@@ -113,6 +120,8 @@ protected:
 		delete[] transformedX2;
 		delete[] transformedY2;
 		delete[] transformedZ2;
+		delete[] spinRotation1;
+		delete[] spinRotation2;
 	}
 
 	/**
@@ -148,6 +157,12 @@ protected:
 		delete[] transformedZ2;
 		transformedZ2 = new SpinComponent[size];
 		memcpy(transformedZ2, rhs.transformedZ2, size * sizeof(SpinComponent));
+		delete[] spinRotation1;
+		spinRotation1 = new int[size];
+		memcpy(spinRotation1, rhs.spinRotation1, size * sizeof(int));
+		delete[] spinRotation2;
+		spinRotation2 = new int[size];
+		memcpy(spinRotation2, rhs.spinRotation2, size * sizeof(int));
 
 		return *this;
 	}
@@ -155,17 +170,20 @@ protected:
 
 /**
  * @brief Structure to specify a symmetry-transformed lattice site. 
- * @details The symmetry transformation combines a mapping to a different lattice site and a permutation of spin components.
- * The spin permuation is stored in LatticeSiteDescriptor::spinPermutation, where transformedComponent=spinPermutation[originalComponent].
+ * @details The symmetry transformation combines a mapping to a different lattice site and a permutation of spin components. 
+ * The spin permuation is stored in LatticeSiteDescriptor::spinPermutation, where transformedComponent=spinPermutation[originalComponent]. 
+ * Lattice symmetries may also act on the spin components by a general orthogonal transformation M, such that the vertex transforms as v^{ab}(i1,i2)=M[a][c]*M[b][d]*v^{cd}(0,rid). 
+ * Whenever the transformation is not a plain permutation, i.e. if it involves sign changes or a general rotation, its matrix form is stored in the lattice and referenced by LatticeSiteDescriptor::spinRotation. 
  */
 struct LatticeSiteDescriptor
 {
 	int rid; ///< Representative id of the transformed lattice site. 
-	SpinComponent spinPermutation[3]; ///< Spin permutation involved in the transformation. 
+	SpinComponent spinPermutation[3]; ///< Spin permutation involved in the transformation. Not meaningful for general rotations. 
+	int spinRotation; ///< Index of the matrix form of the transformation, see Lattice::getSpinRotation(), or -1 if the transformation is a plain permutation of spin components. 
 };
 
 /**
- * @brief Lattice iterator object
+ * @brief Lattice iterator object 
  */
 struct LatticeIterator
 {
@@ -222,7 +240,7 @@ public:
 	 * 
 	 * @return LatticeIterator& Reference to self. 
 	 */
-	virtual LatticeIterator& operator++()
+	LatticeIterator& operator++()
 	{
 		++id;
 		return *this;
@@ -233,7 +251,7 @@ public:
 	 * 
 	 * @return LatticeIterator& Reference to self. 
 	 */
-	virtual LatticeIterator& operator--()
+	LatticeIterator& operator--()
 	{
 		--id;
 		return *this;
@@ -245,6 +263,8 @@ protected:
 
 /**
  * @brief Sublattice iterator object. 
+ * @details The increment and decrement operators hide those of LatticeIterator; they are not virtual, such that the iterator must not be used via a reference to LatticeIterator. 
+ * Performance-critical loops should iterate over the flat id lists provided by Lattice::getRangeIds() and Lattice::getBasisIds() instead. 
  */
 struct SublatticeIterator : public LatticeIterator
 {
@@ -286,11 +306,73 @@ protected:
 	int *allowedIds; ///< List of representative ids that make up the sublattice. Memory is not owned by the iterator. 
 };
 
+/**
+ * @brief Flat list of lattice site ids, which supports range-based for loops. 
+ * @details The list does not own its memory. Each id can be passed wherever a LatticeIterator is expected. 
+ */
+struct LatticeIdRange
+{
+public:
+	/**
+	 * @brief Construct a new LatticeIdRange object from a contiguous array of ids. 
+	 * 
+	 * @param ids Pointer to the first id. 
+	 * @param size Number of ids. 
+	 */
+	LatticeIdRange(const int *ids, const int size) : _ids(ids), _size(size) {}
+
+	/**
+	 * @brief Retrieve pointer to the first id. 
+	 * 
+	 * @return const int* Pointer to the first id. 
+	 */
+	const int *begin() const
+	{
+		return _ids;
+	}
+
+	/**
+	 * @brief Retrieve pointer to the last+1 id. 
+	 * 
+	 * @return const int* Pointer to the last+1 id. 
+	 */
+	const int *end() const
+	{
+		return _ids + _size;
+	}
+
+	/**
+	 * @brief Retrieve the number of ids. 
+	 * 
+	 * @return int Number of ids. 
+	 */
+	int size() const
+	{
+		return _size;
+	}
+
+	/**
+	 * @brief Access operator. 
+	 * 
+	 * @param n Position in the list. 
+	 * @return int Id at position n. 
+	 */
+	int operator[](const int n) const
+	{
+		ASSERT(n >= 0 && n < _size);
+		return _ids[n];
+	}
+
+protected:
+	const int *_ids; ///< Pointer to the first id. 
+	int _size; ///< Number of ids. 
+};
+
 /**
  * @brief Representation of a physical lattice, with symmetry information on two-point correlators. 
  * @details The lattice representation exploits symmetries. A given lattice contains a finite number of sites, which depends on the selected lattice range parameter. 
  * The lattice would store all sites within the specified range (distance measured in units of lattice bonds) around any of the basis sites. 
- *
+ * 
  * Using lattice symmetries, out of any pair of lattice sites (any two-point correlator), one site can always be mapped to a fixed reference si te at the origin. 
  * The second lattice site, under this mapping, would then be mapped to some other site. 
  * Therefore, the two-point correlators after symmetry reduction only depend on a single lattice site. 
@@ -307,7 +389,7 @@ protected:
 	 * @brief Create an uninitialized lattice object. 
 	 * @details Constructor should not be called directly. Use LatticeModelFactory::newLatticeModel() to create a new lattice. 
 	 */
-	Lattice() : size(0), _dataSize(0), _symmetryTable(nullptr), _bufferSites(nullptr), _bufferInvertedSites(nullptr), _bufferOverlapMatrices(nullptr), _bufferBasis(nullptr), _bufferLatticeRange(nullptr) {};
+	Lattice() : size(0), range(0), _dataSize(0), _symmetryTable(nullptr), _bufferSites(nullptr), _bufferInvertedSites(nullptr), _bufferOverlapMatrices(nullptr), _bufferTransformedSites(nullptr), _bufferTransformedOverlapMatrices(nullptr), _transformedSitesSize(0), _bufferBasis(nullptr), _bufferLatticeRange(nullptr), _basisSize(0) {};
 
 public:
 	/**
@@ -322,6 +404,8 @@ public:
 		delete[] _bufferSites;
 		delete[] _bufferInvertedSites;
 		delete[] _bufferOverlapMatrices;
+		delete[] _bufferTransformedSites;
+		delete[] _bufferTransformedOverlapMatrices;
 	}
 
 	/**
@@ -335,9 +419,9 @@ public:
 	}
 
 	/**
-	 * @brief Retrieve iterator to the lattice site i1=(0,0,0,0).
+	 * @brief Retrieve iterator to the lattice site i1=(0,0,0,0). 
 	 * 
-	 * @return LatticeIterator Iterator to the lattice site i1=(0,0,0,0).
+	 * @return LatticeIterator Iterator to the lattice site i1=(0,0,0,0). 
 	 */
 	LatticeIterator zero() const
 	{
@@ -406,7 +490,7 @@ public:
 
 	/**
 	 * @brief Transform a pair of lattice sites (i1,i2) and transform it to (0,i2'). 
-	 * The transformation may involve a permutation of spin components, in which case the transformation is applied to the spinComponent argument. 
+	 * The transformation may involve a permutation of spin components, in which case the transformation is applied to the spinComponent argument. General spin rotations are not supported by this overload. 
 	 * 
 	 * @param[in] i1 Input lattice site. 
 	 * @param[in] i2 Input lattice site. 
@@ -440,7 +524,7 @@ public:
 
 	/**
 	 * @brief Transform a pair of lattice sites (i1,i2) and transform it to (0,i2'). 
-	 * The transformation may involve a permutation of spin components, in which case the transformation is applied to the spinComponent1 and spinComponent2 arguments. 
+	 * The transformation may involve a permutation of spin components, in which case the transformation is applied to the spinComponent1 and spinComponent2 arguments. General spin rotations are not supported by this overload. 
 	 * 
 	 * @param[in] i1 Input lattice site. 
 	 * @param[in] i2 Input lattice site. 
@@ -496,7 +580,7 @@ public:
 
 	/**
 	 * @brief Transform a pair of lattice sites (i1,i2) and transform it to (0,i2'). 
-	 * The transformation may involve a permutation of spin components, in which case the transformation is applied to the spinComponent1, spinComponent2, and spinComponent3 arguments. 
+	 * The transformation may involve a permutation of spin components, in which case the transformation is applied to the spinComponent1, spinComponent2, and spinComponent3 arguments. General spin rotations are not supported by this overload. 
 	 * 
 	 * @param[in] i1 Input lattice site. 
 	 * @param[in] i2 Input lattice site. 
@@ -572,6 +656,78 @@ public:
 		return _symmetryTable[i1.id * _dataSize + i2.id].rid;
 	}
 
+	/**
+	 * @brief Transform a pair of lattice sites (i1,i2) and transform it to (0,i2'). 
+	 * The action of the transformation on the spin components is returned in matrix form M, such that the vertex transforms as v^{ab}(i1,i2)=M[a][c]*M[b][d]*v^{cd}(0,i2'). 
+	 * Unlike the overloads which transform individual spin components, this overload also supports general spin rotations. 
+	 * 
+	 * @param[in] i1 Input lattice site. 
+	 * @param[in] i2 Input lattice site. 
+	 * @param[out] spinTransformation Transformation matrix in row-major order, i.e. M[a][c] is stored at position 3*a+c. 
+	 * @return int Representative id of i2'. 
+	 */
+	int symmetryTransform(const LatticeIterator &i1, const LatticeIterator &i2, float (&spinTransformation)[9]) const
+	{
+		const LatticeSiteDescriptor &descriptor = _symmetryTable[i1.id * _dataSize + i2.id];
+		ASSERT(descriptor.rid != -1);
+		getSpinTransformation(descriptor.spinPermutation, descriptor.spinRotation, spinTransformation);
+		return descriptor.rid;
+	}
+
+	/**
+	 * @brief Determine whether the transformation of a pair of lattice sites (i1,i2) to (0,i2') involves sign changes or a general rotation of spin components. 
+	 * In this case, the transformation is described in matrix form, which is available via Lattice::symmetryTransform(i1, i2, spinTransformation). 
+	 * 
+	 * @param i1 Input lattice site. 
+	 * @param i2 Input lattice site. 
+	 * @return bool Returns true if the transformation is not a plain permutation of spin components. Returns false otherwise. 
+	 */
+	bool hasSpinRotation(const LatticeIterator &i1, const LatticeIterator &i2) const
+	{
+		ASSERT(_symmetryTable[i1.id * _dataSize + i2.id].rid != -1);
+		return _symmetryTable[i1.id * _dataSize + i2.id].spinRotation >= 0;
+	}
+
+	/**
+	 * @brief Express a spin transformation, which is given either as a plain spin permutation or as a reference to its matrix form, in matrix form. 
+	 * 
+	 * @param[in] spinPermutation Spin permutation, where transformedComponent=spinPermutation[originalComponent]. 
+	 * @param[in] spinRotation Index of the matrix form of the transformation, or -1 if the transformation is a plain permutation. 
+	 * @param[out] spinTransformation Transformation matrix in row-major order, i.e. M[a][c] is stored at position 3*a+c. 
+	 */
+	void getSpinTransformation(const SpinComponent *spinPermutation, const int spinRotation, float (&spinTransformation)[9]) const
+	{
+		if (spinRotation >= 0)
+		{
+			memcpy(spinTransformation, getSpinRotation(spinRotation), 9 * sizeof(float));
+			return;
+		}
+		for (int i = 0; i < 9; ++i) spinTransformation[i] = 0.0f;
+		for (int a = 0; a < 3; ++a) spinTransformation[3 * a + static_cast<int>(spinPermutation[a])] = 1.0f;
+	}
+
+	/**
+	 * @brief Retrieve the matrix form of a spin transformation which is not a plain permutation of spin components. 
+	 * 
+	 * @param index Index of the transformation, as referenced by LatticeSiteDescriptor::spinRotation, LatticeOverlap::spinRotation1, or LatticeOverlap::spinRotation2. 
+	 * @return const float* Transformation matrix M in row-major order, i.e. M[a][c] is stored at position 3*a+c. 
+	 */
+	const float *getSpinRotation(const int index) const
+	{
+		ASSERT(index >= 0 && 9 * index < int(_spinRotations.size()));
+		return _spinRotations.data() + 9 * index;
+	}
+
+	/**
+	 * @brief Determine whether any lattice symmetry acts on the spin components by a transformation other than a plain permutation. 
+	 * 
+	 * @return bool Returns true if sign changes or general spin rotations are involved. Returns false otherwise. 
+	 */
+	bool hasSpinRotations() const
+	{
+		return _spinRotations.size() > 0;
+	}
+
 	/**
 	 * @brief Retrieve the lattice overlap of the reference site i1=(0,0,0,0) with some other representative lattice site. 
 	 * The overlap is defined as all lattice sites which are within range of both lattice site. 
@@ -585,6 +741,56 @@ public:
 		return _bufferOverlapMatrices[rid];
 	}
 
+	/**
+	 * @brief List of all transformed lattice sites, i.e. pairs of a representative id and a spin transformation, which occur in the lattice overlaps. 
+	 * Vertex values which have been transformed explicitly for every entry of the list can be combined via Lattice::getTransformedOverlap(). 
+	 * Only available if the lattice involves spin transformations other than plain permutations, see Lattice::hasSpinRotations(). 
+	 * 
+	 * @return const LatticeSiteDescriptor* List of transformed lattice sites. 
+	 */
+	const LatticeSiteDescriptor *getTransformedSites() const
+	{
+		ASSERT(_bufferTransformedSites != nullptr);
+		return _bufferTransformedSites;
+	}
+
+	/**
+	 * @brief Number of transformed lattice sites, see Lattice::getTransformedSites(). 
+	 * 
+	 * @return int Number of transformed lattice sites. 
+	 */
+	int getTransformedSitesSize() const
+	{
+		return _transformedSitesSize;
+	}
+
+	/**
+	 * @brief Retrieve the lattice overlap of the reference site i1=(0,0,0,0) with some other representative lattice site in terms of transformed lattice sites. 
+	 * The overlap comprises the same terms as the overlap returned by Lattice::getOverlap(), but rid1 and rid2 refer to entries of Lattice::getTransformedSites() and no further spin transformation is involved. 
+	 * Only available if the lattice involves spin transformations other than plain permutations, see Lattice::hasSpinRotations(). 
+	 * 
+	 * @param rid Representative lattice site to determine overlap with i1. 
+	 * @return const LatticeOverlap& Lattice overlap descriptor. 
+	 */
+	const LatticeOverlap &getTransformedOverlap(const int rid) const
+	{
+		ASSERT(rid < size);
+		ASSERT(_bufferTransformedOverlapMatrices != nullptr);
+		return _bufferTransformedOverlapMatrices[rid];
+	}
+
+	/**
+	 * @brief Retrieve the distance between the reference site i1=(0,0,0,0) and some other representative lattice site, measured in units of lattice bonds. 
+	 * 
+	 * @param rid Representative lattice site. 
+	 * @return int Bond distance, which ranges from zero for the reference site itself up to Lattice::range. 
+	 */
+	int getBondDistance(const int rid) const
+	{
+		ASSERT(rid < size);
+		return _bondDistances[rid];
+	}
+
 	/**
 	 * @brief List of two-spin correlators (i2,i1), where i1=(0,0,0,0) is the reference site and the list includes all reference sites i2. 
 	 * 
@@ -607,7 +813,7 @@ public:
 
 	/**
 	 * @brief Retrieve an iterator over all sites which are within range of the lattice site b, where b must describe one of the basis sites. 
-	 * @see Lattice::getBasis()
+	 * @see Lattice::getBasis() 
 	 * 
 	 * @param b Iterator to a basis site.  
 	 * @return SublatticeIterator Iterator over all sites in range. 
@@ -644,10 +850,67 @@ public:
 		return SublatticeIterator(_bufferBasis);
 	}
 
+	/**
+	 * @brief Retrieve the ids of all sites which are within range of the lattice site (0,0,0,b). 
+	 * @details The ids are enumerated in the same order as by Lattice::getRange(). 
+	 * 
+	 * @param b Basis site index. 
+	 * @return LatticeIdRange List of ids of all sites in range. 
+	 */
+	LatticeIdRange getRangeIds(const int b) const
+	{
+		ASSERT(b >= 0 && b < _basisSize);
+		return LatticeIdRange(_bufferLatticeRange[b], _rangeSizes[b]);
+	}
+
+	/**
+	 * @brief Retrieve the ids of all basis sites. 
+	 * @details The ids are enumerated in the same order as by Lattice::getBasis(), such that the n-th entry is the id of the basis site (0,0,0,n). 
+	 * 
+	 * @return LatticeIdRange List of ids of all basis sites. 
+	 */
+	LatticeIdRange getBasisIds() const
+	{
+		return LatticeIdRange(_bufferBasis, _basisSize);
+	}
+
+	/**
+	 * @brief Determine whether the spin model has been mapped onto a rotated spin frame by a sublattice-dependent spin rotation. 
+	 * @see LatticeModelFactory::rotateSpinModel() 
+	 * 
+	 * @return bool Returns true if a sublattice rotation is active. Returns false otherwise. 
+	 */
+	bool hasSublatticeRotation() const
+	{
+		return _sublatticeRotation.size() > 0;
+	}
+
+	/**
+	 * @brief Express a spin component of the original spin model in terms of the rotated spin frame at a given lattice site, in which the flow is computed. 
+	 * @details If no sublattice rotation is active, the spin component is left unchanged. 
+	 * 
+	 * @param[in] site Lattice site. 
+	 * @param[in,out] spinComponent Spin component in the original frame, which is replaced by the corresponding component in the rotated frame. 
+	 * @return float Sign acquired under the rotation. 
+	 */
+	float sublatticeRotation(const LatticeIterator &site, SpinComponent &spinComponent) const
+	{
+		if (_sublatticeRotation.size() == 0 || spinComponent == SpinComponent::None) return 1.0f;
+
+		spinComponent = _sublatticeRotation[std::get<3>(getSiteParameters(site))][static_cast<int>(spinComponent)];
+		if (static_cast<int>(spinComponent) > static_cast<int>(SpinComponent::None))
+		{
+			spinComponent = static_cast<SpinComponent>(static_cast<int>(spinComponent) - static_cast<int>(SpinComponent::MinusX));
+			return -1.0f;
+		}
+		return 1.0f;
+	}
+
 	std::vector<geometry::Vec3<double> > _bravaisLattice; ///< List of the three bravais lattice vectors.  
 	std::vector<geometry::Vec3<double> > _basis; ///< List of the positions of all basis sites within a lattice unit cell. 
 
 	int size; ///< Number representative sites. 
+	int range; ///< Truncation range of the lattice, measured in units of lattice bonds. 
 
 protected: 
 	std::vector<std::tuple<int, int, int, int>> _geometryTable; ///< Internal storage of real space lattice site positions, stored as tuples (a0, a1, a2, b).
@@ -658,7 +921,16 @@ protected:
 	LatticeSiteDescriptor *_bufferSites; ///< List of transformed sites (0, rid), for all representatives rid. 
 	LatticeSiteDescriptor *_bufferInvertedSites; ///< List of transformed sites (rid, 0), for all representatives rid. 
 	LatticeOverlap *_bufferOverlapMatrices; ///< List of lattice overlaps, where the i-th entry is the overlap of the two tuples (0,j)(j,i). 
+	LatticeSiteDescriptor *_bufferTransformedSites; ///< List of all transformed lattice sites which occur in the lattice overlaps, see Lattice::getTransformedSites(). Only allocated if the lattice involves spin transformations other than plain permutations. 
+	LatticeOverlap *_bufferTransformedOverlapMatrices; ///< List of lattice overlaps which refer to transformed lattice sites, see Lattice::getTransformedOverlap(). Only allocated if the lattice involves spin transformations other than plain permutations. 
+	int _transformedSitesSize; ///< Number of transformed lattice sites. 
 
 	int *_bufferBasis; ///< List of representative ids of all basis sites. 
-	int **_bufferLatticeRange; ///< Table of lists of all site ids in range of site (0,0,0,b). 
+	int **_bufferLatticeRange; ///< Table of lists of all site ids in range of site (0,0,0,b).
+	std::vector<int> _rangeSizes; ///< Number of sites in range of site (0,0,0,b), i.e. length of the lists in Lattice::_bufferLatticeRange without the terminating entry. 
+	int _basisSize; ///< Number of basis sites, i.e. length of Lattice::_bufferBasis without the terminating entry. 
+	std::vector<int> _bondDistances; ///< Bond distance between the reference site (0,0,0,0) and every representative site. 
+
+	std::vector<float> _spinRotations; ///< Matrix forms of all spin transformations which are not plain permutations, stored consecutively as 3x3 matrices in row-major order. 
+	std::vector<std::array<SpinComponent, 3>> _sublatticeRotation; ///< Sublattice-dependent spin rotation for every basis site b, where _sublatticeRotation[b][originalComponent] is the corresponding component in the rotated frame. Empty if no rotation is active. 
 };
\ No newline at end of file
@@ -8,11 +8,16 @@
 
 #include "LatticeModelFactory.hpp"
 #include <algorithm>
+#include <functional>
+#include <fstream>
+#include <cstdio>
+#include <map>
+#include <tuple>
 #include <boost/filesystem.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 #include <boost/regex.hpp>
-#include <boost/format.hpp>
+#include <hdf5.h>
 #include "lib/Geometry.hpp"
 #include "lib/InputParser.hpp"
 #include "lib/Exception.hpp"
@@ -234,9 +239,9 @@ namespace LatticeModelFactory
 	#pragma endregion
 
 	#pragma region SpinModelUnitCell definition
-	SpinModelUnitCell::SpinModelUnitCell() {}
+	SpinModelUnitCell::SpinModelUnitCell() : spinRotationSymmetry(false) {}
 
-	SpinModelUnitCell::SpinModelUnitCell(const std::string &modelName, const std::string &bundle, const std::map<std::string, std::string> &modelOptions)
+	SpinModelUnitCell::SpinModelUnitCell(const std::string &modelName, const std::string &bundle, const std::map<std::string, std::string> &modelOptions) : spinRotationSymmetry(false)
 	{
 		if (!_initFromResBundle(modelName, bundle, modelOptions)) throw Exception(Exception::Type::InitializationError, "Invalid spin model definition.");
 	}
@@ -288,6 +293,7 @@ namespace LatticeModelFactory
 							float interactionStrength;
 							if (modelOptions.count(parameter)) interactionStrength = InputParser::stringToFloat(modelOptions.at(parameter));
 							else throw Exception(Exception::Type::InitializationError, "Interaction parameter '" + parameter + "' is not defined in the taskfile");
+							if (i.second.get_optional<std::string>("<xmlattr>.coefficient")) interactionStrength *= InputParser::stringToFloat(i.second.get<std::string>("<xmlattr>.coefficient"));
 
 							//generate interaction
 							SpinInteraction interaction(LatticeSite(std::stoi(matchSite1[1].str()), std::stoi(matchSite1[2].str()), std::stoi(matchSite1[3].str()), std::stoi(matchSite1[4].str())), LatticeSite(std::stoi(matchSite2[1].str()), std::stoi(matchSite2[2].str()), std::stoi(matchSite2[3].str()), std::stoi(matchSite2[4].str())));
@@ -664,6 +670,103 @@ namespace LatticeModelFactory
 		SpinComponent transformedComponent[3];
 	};
 
+	//action of a lattice symmetry on the spin components in matrix form, such that the vertex transforms as v^{ab}(i1,i2)=m[a][c]*m[b][d]*v^{cd}(f(i1),f(i2))
+	struct SpinTransformation
+	{
+	public:
+		SpinTransformation()
+		{
+			for (int a = 0; a < 3; ++a)
+			{
+				for (int c = 0; c < 3; ++c) m[a][c] = (a == c) ? 1.0f : 0.0f;
+			}
+		}
+
+		SpinTransformation(const SpinPermutation &permutation)
+		{
+			for (int a = 0; a < 3; ++a)
+			{
+				for (int c = 0; c < 3; ++c) m[a][c] = 0.0f;
+
+				int c = static_cast<int>(permutation.transformedComponent[a]);
+				if (c > static_cast<int>(SpinComponent::None)) m[a][c - static_cast<int>(SpinComponent::MinusX)] = -1.0f;
+				else m[a][c] = 1.0f;
+			}
+		}
+
+		static SpinTransformation inverse(const SpinTransformation &rhs)
+		{
+			SpinTransformation t;
+			for (int a = 0; a < 3; ++a)
+			{
+				for (int c = 0; c < 3; ++c) t.m[a][c] = rhs.m[c][a];
+			}
+			return t;
+		}
+
+		SpinTransformation operator*(const SpinTransformation &rhs) const
+		{
+			SpinTransformation t;
+			for (int a = 0; a < 3; ++a)
+			{
+				for (int c = 0; c < 3; ++c)
+				{
+					t.m[a][c] = 0.0f;
+					for (int b = 0; b < 3; ++b) t.m[a][c] += m[a][b] * rhs.m[b][c];
+				}
+			}
+			return t;
+		}
+
+		bool operator==(const SpinTransformation &rhs) const
+		{
+			for (int a = 0; a < 3; ++a)
+			{
+				for (int c = 0; c < 3; ++c) if (fabs(m[a][c] - rhs.m[a][c]) > __EPSILON) return false;
+			}
+			return true;
+		}
+
+		float determinant() const
+		{
+			return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+		}
+
+		//return true and write the result to permutation if the transformation is a signed permutation of spin components
+		bool toPermutation(SpinPermutation &permutation) const
+		{
+			for (int a = 0; a < 3; ++a)
+			{
+				int n = 0;
+				for (int c = 0; c < 3; ++c)
+				{
+					if (fabs(fabs(m[a][c]) - 1.0f) < __EPSILON)
+					{
+						permutation.transformedComponent[a] = static_cast<SpinComponent>((m[a][c] > 0.0f) ? c : c + static_cast<int>(SpinComponent::MinusX));
+						++n;
+					}
+					else if (fabs(m[a][c]) > __EPSILON) return false;
+				}
+				if (n != 1) return false;
+			}
+			return true;
+		}
+
+		//return true if the transformation is a permutation of spin components without sign changes
+		bool isPlainPermutation() const
+		{
+			SpinPermutation permutation;
+			if (!toPermutation(permutation)) return false;
+			for (int a = 0; a < 3; ++a)
+			{
+				if (static_cast<int>(permutation.transformedComponent[a]) > static_cast<int>(SpinComponent::None)) return false;
+			}
+			return true;
+		}
+
+		float m[3][3];
+	};
+
 	//return a list of all nearest neighbors of given lattice site
 	std::vector<LatticeSite> getNeighbors(const LatticeUnitCell& uc, const LatticeSite& site)
 	{
@@ -680,10 +783,11 @@ namespace LatticeModelFactory
 		return neighbors;
 	}
 
-	//return a list of all neighbors of given lattice site within a specified range
-	std::vector<LatticeSite> constructRangeAroundSite(const LatticeUnitCell& uc, const LatticeSite& site, int range)
+	//return a list of all neighbors of given lattice site within a specified range; if distances is specified, the bond distance of every returned site is written to distances
+	std::vector<LatticeSite> constructRangeAroundSite(const LatticeUnitCell& uc, const LatticeSite& site, int range, std::vector<int> *distances = nullptr)
 	{
 		std::vector<LatticeSite> sites({ site });
+		if (distances != nullptr) distances->assign(1, 0);
 		for (int i = 0; i < range; ++i)
 		{
 			//for each site of the set, add all neighbors
@@ -693,7 +797,14 @@ namespace LatticeModelFactory
 				std::vector<LatticeSite> ns = getNeighbors(uc, site);
 				for (auto n : ns) if (std::find(neighbors.begin(), neighbors.end(), n) == neighbors.end()) neighbors.push_back(n);
 			}
-			for (auto n : neighbors) if (std::find(sites.begin(), sites.end(), n) == sites.end()) sites.push_back(n);
+			for (auto n : neighbors)
+			{
+				if (std::find(sites.begin(), sites.end(), n) == sites.end())
+				{
+					sites.push_back(n);
+					if (distances != nullptr) distances->push_back(i + 1);
+				}
+			}
 		}
 		return sites;
 	}
@@ -723,7 +834,8 @@ namespace LatticeModelFactory
 	};
 
 	//searches lattice automorphisms f_i that map site2 onto (0,0,0,0). Return f_i(site1). If reducedSearch==true, return after the first f_i has been found. 
-	std::vector<std::pair<LatticeSite, SpinPermutation>> symmetryReduce(const LatticeUnitCell& uc, const SpinModelUnitCell& spinModel, const LatticeSite& site1, const LatticeSite& site2, bool reducedSearch = false)
+	//the action of f_i on the spin components is a signed permutation, or a general rotation if spinModel.spinRotationSymmetry is set
+	std::vector<std::pair<LatticeSite, SpinTransformation>> symmetryReduce(const LatticeUnitCell& uc, const SpinModelUnitCell& spinModel, const LatticeSite& site1, const LatticeSite& site2, bool reducedSearch = false)
 	{
 		//define reference site ref
 		LatticeSite ref = LatticeSite(0, 0, 0, 0);
@@ -744,6 +856,17 @@ namespace LatticeModelFactory
 		//collect minimal set of spin interactions which need to be considered in order to verify symmetry transformations
 		std::vector<SpinInteraction> preImageInteractions = spinModel.interactions; //TODO select only those that are within neighborhood[site2.b]
 
+		//spin couplings are compared up to a tolerance relative to the largest coupling, since general spin rotations are subject to rounding errors
+		float tolerance = 1.0f;
+		for (auto interaction : spinModel.interactions)
+		{
+			for (int s1 = 0; s1 < 3; ++s1)
+			{
+				for (int s2 = 0; s2 < 3; ++s2) tolerance = std::max(tolerance, float(fabs(interaction.interactionStrength[s1][s2])));
+			}
+		}
+		tolerance *= float(__EPSILON);
+
 		//choose two neighbors (n1, n2) of site2 such that the sites are non-collinear
 		LatticeSite n1, n2;
 		std::vector<LatticeSite> neighbors = getNeighbors(uc, site2);
@@ -760,7 +883,7 @@ namespace LatticeModelFactory
 		}
 
 		//container to store all valid transformations f_i
-		std::vector<std::pair<geometry::Mat4<double>, SpinPermutation>> validTransformations;
+		std::vector<std::pair<geometry::Mat4<double>, SpinTransformation>> validTransformations;
 
 		//try to match (site2, n1, n2) with any combination of neighbors (ref, c1, c2) where c1 and c2 are neighbors of ref
 		std::vector<LatticeSite> refNeighbors = getNeighbors(uc, ref);
@@ -777,7 +900,7 @@ namespace LatticeModelFactory
 
 					//init transformation
 					geometry::Mat4<double> transformation = (inversion) ? geometry::Mat4<double>::inversion() : geometry::Mat4<double>::identity();
-					SpinPermutation spinTransformation;
+					SpinTransformation spinTransformation;
 
 					//move site2 to ref
 					transformation = geometry::Mat4<double>::translation(getSitePosition(uc, ref) - transformation * getSitePosition(uc, site2)) * transformation;
@@ -843,126 +966,134 @@ namespace LatticeModelFactory
 					}
 					if (!validTransformation) continue;
 
-					//check if spin couplings are invariant under transformation up to a global permutation of spin components
-					bool spinTransformationExists = false;
-					for (int i = 0; i < 48; ++i)  // Extend this to all 48 permutations.
+					//collect the interactions before and after the transformation
+					std::vector<std::array<float, 9>> interactionStrengths;
+					std::vector<std::array<float, 9>> targetInteractionStrengths;
+					for (auto interaction : preImageInteractions)
 					{
-						SpinPermutation permutation(i);
-						bool validPermutation = true;
-
-						//check whether permutation is compatible with all interactions in the model
-						for (auto interaction : preImageInteractions)
+						//determine transformed interaction
+						LatticeSite fromTransformed;
+						siteAtPosition(uc, transformation * getSitePosition(uc, interaction.from), fromTransformed);
+						LatticeSite toTransformed;
+						siteAtPosition(uc, transformation * getSitePosition(uc, interaction.to), toTransformed);
+
+						std::array<float, 9> targetInteractionStrength;
+						targetInteractionStrength.fill(0.0f);
+						for (auto i : spinModel.interactions)
 						{
-							//determine transformed interaction
-							LatticeSite fromTransformed;
-							siteAtPosition(uc, transformation * getSitePosition(uc, interaction.from), fromTransformed);
-							LatticeSite toTransformed;
-							siteAtPosition(uc, transformation * getSitePosition(uc, interaction.to), toTransformed);
+							int connection = i.isConnectingSites(fromTransformed, toTransformed);
 
-							float targetInteractionStrength[3][3];
-							for (int s1 = 0; s1 < 3; ++s1)
+							if (connection == 1)
 							{
-								for (int s2 = 0; s2 < 3; ++s2)
+								for (int s1 = 0; s1 < 3; ++s1)
 								{
-									targetInteractionStrength[s1][s2] = 0.0f;
-								}
-							}
-
-							for (auto i : spinModel.interactions)
-							{
-								int connection = i.isConnectingSites(fromTransformed, toTransformed);
-
-								if (connection == 1)
-								{
-									for (int s1 = 0; s1 < 3; ++s1)
+									for (int s2 = 0; s2 < 3; ++s2)
 									{
-										for (int s2 = 0; s2 < 3; ++s2)
-										{
-											targetInteractionStrength[s1][s2] = i.interactionStrength[s1][s2];
-										}
+										targetInteractionStrength[3 * s1 + s2] = i.interactionStrength[s1][s2];
 									}
 								}
-								else if (connection == -1)
+							}
+							else if (connection == -1)
+							{
+								for (int s1 = 0; s1 < 3; ++s1)
 								{
-									for (int s1 = 0; s1 < 3; ++s1)
+									for (int s2 = 0; s2 < 3; ++s2)
 									{
-										for (int s2 = 0; s2 < 3; ++s2)
-										{
-											targetInteractionStrength[s1][s2] = i.interactionStrength[s2][s1];
-										}
+										targetInteractionStrength[3 * s1 + s2] = i.interactionStrength[s2][s1];
 									}
 								}
 							}
+						}
 
-							//verify transformation
+						std::array<float, 9> interactionStrength;
+						for (int s1 = 0; s1 < 3; ++s1)
+						{
+							for (int s2 = 0; s2 < 3; ++s2) interactionStrength[3 * s1 + s2] = interaction.interactionStrength[s1][s2];
+						}
+						interactionStrengths.push_back(interactionStrength);
+						targetInteractionStrengths.push_back(targetInteractionStrength);
+					}
+
+					//check whether a global transformation t of spin components maps the transformed interactions J' onto the original interactions J, i.e. J=t*J'*t^T
+					auto isSpinTransformation = [&](const SpinTransformation &t)->bool
+					{
+						for (int n = 0; n < int(interactionStrengths.size()); ++n)
+						{
 							for (int s1 = 0; s1 < 3; ++s1)
 							{
 								for (int s2 = 0; s2 < 3; ++s2)
 								{
-
-									SpinComponent transformedComponent1 = permutation.transformedComponent[s1];
-									SpinComponent transformedComponent2 = permutation.transformedComponent[s2];
-									// Spincomponets  can be X,Y,Z ,and MinusX,MinusY, MinusZ.
-
-									// Now we need to perform the mapping from MinusX->X,etc.
-							
-								 	float sign =1.0f;
-									if(transformedComponent1 == SpinComponent::MinusX)    
-									{
-										transformedComponent1  = SpinComponent::X;
-										sign =-sign;
-									}
-									if(transformedComponent1  == SpinComponent::MinusY)
+									float value = 0.0f;
+									for (int a = 0; a < 3; ++a)
 									{
-										transformedComponent1  = SpinComponent::Y;
-										sign=-sign;
+										for (int b = 0; b < 3; ++b) value += t.m[s1][a] * t.m[s2][b] * targetInteractionStrengths[n][3 * a + b];
 									}
-									if(transformedComponent1  == SpinComponent::MinusZ)
-									{
-										transformedComponent1  == SpinComponent::Z;
-										sign = -sign;
-									}
-
-									if(transformedComponent2 == SpinComponent::MinusX)
-									{
-										transformedComponent2 = SpinComponent::X;
-										sign =-sign;
-									}
-									if(transformedComponent2 == SpinComponent::MinusY)
-									{
-										transformedComponent2 = SpinComponent::Y;
-										sign=-sign;
-									}
-									if(transformedComponent2 == SpinComponent::MinusZ)
-									{
-										transformedComponent2 = SpinComponent::Z;
-										sign = -sign;
-									}
-								// here the transformed components must be X,Y,Z
-
-									if (interaction.interactionStrength[s1][s2] != sign*targetInteractionStrength[static_cast<int>(transformedComponent1)][static_cast<int>(transformedComponent2)]) validPermutation = false;
-									//if (interaction.interactionStrength[s1][s2] != targetInteractionStrength[static_cast<int>(permutation.transformedComponent[s1])][static_cast<int>(permutation.transformedComponent[s2])]) validPermutation = false;
+									if (fabs(interactionStrengths[n][3 * s1 + s2] - value) > tolerance) return false;
 								}
 							}
 						}
+						return true;
+					};
 
-						if (validPermutation)
+					//check if spin couplings are invariant under transformation up to a global permutation of spin components
+					bool spinTransformationExists = false;
+					for (int i = 0; i < 48; ++i)
+					{
+						SpinTransformation permutation = SpinTransformation(SpinPermutation(i));
+						if (isSpinTransformation(permutation))
 						{
 							spinTransformationExists = true;
 							spinTransformation = permutation;
 							break;
 						}
 					}
+
+					//otherwise, try general spin rotations which are composed of the rotational part of the lattice transformation and a signed permutation
+					if (!spinTransformationExists && spinModel.spinRotationSymmetry)
+					{
+						SpinTransformation rotation;
+						for (int a = 0; a < 3; ++a)
+						{
+							for (int c = 0; c < 3; ++c) rotation.m[a][c] = float(transformation.data[a][c]);
+						}
+						//remove rounding residues of vanishing matrix elements, which would otherwise couple spin components that are separated by symmetry
+						for (auto &row : rotation.m)
+						{
+							for (float &x : row) if (fabs(x) < __EPSILON) x = 0.0f;
+						}
+
+						for (int i = 0; i < 48 && !spinTransformationExists; ++i)
+						{
+							SpinTransformation permutation = SpinTransformation(SpinPermutation(i));
+							for (SpinTransformation candidate : { permutation * rotation, permutation * SpinTransformation::inverse(rotation), rotation * permutation, SpinTransformation::inverse(rotation) * permutation })
+							{
+								//the interactions do not distinguish t from -t; choose the proper rotation, which also acts correctly on mixed spin-density vertices
+								if (candidate.determinant() < 0.0f)
+								{
+									for (auto &row : candidate.m)
+									{
+										for (float &x : row) x = -x;
+									}
+								}
+								if (isSpinTransformation(candidate))
+								{
+									spinTransformationExists = true;
+									spinTransformation = candidate;
+									break;
+								}
+							}
+						}
+					}
 					if (!spinTransformationExists) validTransformation = false;
 
 					if (!validTransformation) continue;
-					else validTransformations.push_back(std::pair<geometry::Mat4<double>, SpinPermutation>(transformation, spinTransformation));
+					else validTransformations.push_back(std::pair<geometry::Mat4<double>, SpinTransformation>(transformation, spinTransformation));
 				}
 			}
 		}
 
 		//compute f_i(site1) and return
-		std::vector<std::pair<LatticeSite, SpinPermutation>> fsite1;
+		std::vector<std::pair<LatticeSite, SpinTransformation>> fsite1;
 		if (validTransformations.size() > 0)
 		{
 			fsite1.reserve(validTransformations.size());
@@ -972,7 +1103,7 @@ namespace LatticeModelFactory
 			{
 				LatticeSite ts1;
 				if (!siteAtPosition(uc, t.first * getSitePosition(uc, site1), ts1)) throw Exception(Exception::Type::InternalError, "Lattice symmetry calculation has failed. (Internal error. Unexpected outcome of an allegedly valid symmetry)");
-				std::pair<LatticeSite, SpinPermutation> transformation(ts1, t.second);
+				std::pair<LatticeSite, SpinTransformation> transformation(ts1, t.second);
 
 				if (std::find(fsite1.begin(), fsite1.end(), transformation) == fsite1.end()) fsite1.push_back(transformation);
 			}
@@ -980,6 +1111,178 @@ namespace LatticeModelFactory
 		else throw Exception(Exception::Type::InternalError, "Lattice symmetry calculation has failed. (Internal error. Could not establish identity as a valid symmetry operation)");
 		return fsite1;
 	}
+
+	//dense index of all unit cells spanned by a list of sites, which looks up the position of a site in the list in constant time
+	struct SiteIndex
+	{
+		SiteIndex(const std::vector<LatticeSite> &sites, const int numBasis) : numBasis(numBasis)
+		{
+			for (int d = 0; d < 3; ++d)
+			{
+				cellMin[d] = 0;
+				cellMax[d] = 0;
+			}
+			for (const LatticeSite &s : sites)
+			{
+				int a[3] = { s.a0, s.a1, s.a2 };
+				for (int d = 0; d < 3; ++d)
+				{
+					cellMin[d] = std::min(cellMin[d], a[d]);
+					cellMax[d] = std::max(cellMax[d], a[d]);
+				}
+			}
+			for (int d = 0; d < 3; ++d) cellExtent[d] = cellMax[d] - cellMin[d] + 1;
+			index.assign(size_t(cellExtent[0]) * cellExtent[1] * cellExtent[2] * numBasis, -1);
+			for (int n = 0; n < int(sites.size()); ++n) index[offset(sites[n])] = n;
+		}
+
+		//return the position of the site in the list, or -1 if the site is not in the list
+		int find(const LatticeSite &s) const
+		{
+			int o = offset(s);
+			return (o < 0) ? -1 : index[o];
+		}
+
+		int offset(const LatticeSite &s) const
+		{
+			if (s.a0 < cellMin[0] || s.a0 > cellMax[0] || s.a1 < cellMin[1] || s.a1 > cellMax[1] || s.a2 < cellMin[2] || s.a2 > cellMax[2]) return -1;
+			return (((s.a0 - cellMin[0]) * cellExtent[1] + (s.a1 - cellMin[1])) * cellExtent[2] + (s.a2 - cellMin[2])) * numBasis + s.b;
+		}
+
+		int numBasis;
+		int cellMin[3];
+		int cellMax[3];
+		int cellExtent[3];
+		std::vector<int> index;
+	};
+
+	//write lattice debug information on all sites in range of the reference site to an xml-type ldf file and to a binary HDF5 counterpart, which is stored alongside as ldfPath + ".h5"; 
+	//bonds and interactions are found by looking up the other end of every bond in a dense index of all unit cells in range, such that the cost is linear in the number of sites
+	void writeLatticeDebugFile(const LatticeUnitCell &uc, const SpinModelUnitCell &spinModelDefinition, const Lattice &lattice, const std::string &ldfPath)
+	{
+		LatticeIdRange range = lattice.getRangeIds(0);
+		int numSites = range.size();
+		int numBasis = int(uc.basisSites.size());
+
+		//build cell index
+		std::vector<LatticeSite> sites(numSites);
+		for (int n = 0; n < numSites; ++n)
+		{
+			auto p = lattice.getSiteParameters(range[n]);
+			sites[n] = LatticeSite(std::get<0>(p), std::get<1>(p), std::get<2>(p), std::get<3>(p));
+		}
+		SiteIndex siteIndex(sites, numBasis);
+
+		//find bonds and interactions which emanate from every site, as pairs (target site, bond or interaction index), in the same order as a search over all pairs of sites
+		std::vector<std::vector<std::pair<int, int>>> bonds(numSites);
+		std::vector<std::vector<std::pair<int, int>>> interactions(numSites);
+		#ifndef DISABLE_OMP
+		#pragma omp parallel for schedule(static)
+		#endif
+		for (int n = 0; n < numSites; ++n)
+		{
+			const LatticeSite &s = sites[n];
+			for (int i = 0; i < int(uc.latticeBonds.size()); ++i)
+			{
+				const LatticeBond &bond = uc.latticeBonds[i];
+				if (bond.fromB != s.b) continue;
+				int target = siteIndex.find(LatticeSite(s.a0 + bond.da0, s.a1 + bond.da1, s.a2 + bond.da2, bond.toB));
+				if (target >= 0) bonds[n].push_back(std::make_pair(target, i));
+			}
+			std::sort(bonds[n].begin(), bonds[n].end());
+
+			for (int i = 0; i < int(spinModelDefinition.interactions.size()); ++i)
+			{
+				const SpinInteraction &interaction = spinModelDefinition.interactions[i];
+				if (interaction.from.b != s.b) continue;
+				int target = siteIndex.find(LatticeSite(s.a0 + interaction.to.a0 - interaction.from.a0, s.a1 + interaction.to.a1 - interaction.from.a1, s.a2 + interaction.to.a2 - interaction.from.a2, interaction.to.b));
+				if (target >= 0) interactions[n].push_back(std::make_pair(target, i));
+			}
+			std::sort(interactions[n].begin(), interactions[n].end());
+		}
+
+		//write ldf file
+		std::ofstream ldfFile(ldfPath, std::ios::out);
+		if (!ldfFile.is_open()) throw Exception(Exception::Type::IOError, "Could not write lattice debug information to file. ");
+		ldfFile << "<lattice>" << std::endl;
+		char line[512];
+		for (int n = 0; n < numSites; ++n)
+		{
+			geometry::Vec3<double> p = lattice.getSitePosition(range[n]);
+			snprintf(line, sizeof(line), "\t<site id=\"%d\" x=\"%f\" y=\"%f\" z=\"%f\" parametrized=\"%s\"/>\n", range[n], p.x, p.y, p.z, (range[n] < lattice.size) ? "true" : "false");
+			ldfFile << line;
+		}
+		for (int n = 0; n < numSites; ++n)
+		{
+			for (auto &b : bonds[n])
+			{
+				snprintf(line, sizeof(line), "\t<bond from=\"%d\" to=\"%d\" />\n", range[n], range[b.first]);
+				ldfFile << line;
+			}
+		}
+		for (int n = 0; n < numSites; ++n)
+		{
+			for (auto &i : interactions[n])
+			{
+				const float (&v)[3][3] = spinModelDefinition.interactions[i.second].interactionStrength;
+				snprintf(line, sizeof(line), "\t<interaction from=\"%d\" to=\"%d\" value=\"[[%f,%f,%f],[%f,%f,%f],[%f,%f,%f]]\" />\n", range[n], range[i.first], v[0][0], v[0][1], v[0][2], v[1][0], v[1][1], v[1][2], v[2][0], v[2][1], v[2][2]);
+				ldfFile << line;
+			}
+		}
+		ldfFile << "</lattice>" << std::endl;
+		ldfFile.close();
+
+		//collect binary data
+		std::vector<int> siteIds(numSites);
+		std::vector<double> sitePositions(3 * numSites);
+		std::vector<int> siteParametrized(numSites);
+		std::vector<int> bondSites;
+		std::vector<int> interactionSites;
+		std::vector<float> interactionValues;
+		for (int n = 0; n < numSites; ++n)
+		{
+			geometry::Vec3<double> p = lattice.getSitePosition(range[n]);
+			siteIds[n] = range[n];
+			sitePositions[3 * n] = p.x;
+			sitePositions[3 * n + 1] = p.y;
+			sitePositions[3 * n + 2] = p.z;
+			siteParametrized[n] = (range[n] < lattice.size) ? 1 : 0;
+			for (auto &b : bonds[n])
+			{
+				bondSites.push_back(range[n]);
+				bondSites.push_back(range[b.first]);
+			}
+			for (auto &i : interactions[n])
+			{
+				interactionSites.push_back(range[n]);
+				interactionSites.push_back(range[i.first]);
+				for (int s1 = 0; s1 < 3; ++s1)
+				{
+					for (int s2 = 0; s2 < 3; ++s2) interactionValues.push_back(spinModelDefinition.interactions[i.second].interactionStrength[s1][s2]);
+				}
+			}
+		}
+
+		//write HDF5 file
+		H5Eset_auto(H5E_DEFAULT, NULL, NULL);
+		hid_t file = H5Fcreate((ldfPath + ".h5").c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+		if (file < 0) throw Exception(Exception::Type::IOError, "Could not write lattice debug information to file. ");
+		auto writeDataset = [&](const std::string &name, hid_t type, const std::vector<hsize_t> &dims, const void *data)
+		{
+			hid_t dataSpace = H5Screate_simple(int(dims.size()), dims.data(), NULL);
+			hid_t dataset = H5Dcreate(file, name.c_str(), type, dataSpace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+			if (dims[0] > 0) H5Dwrite(dataset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+			H5Dclose(dataset);
+			H5Sclose(dataSpace);
+		};
+		writeDataset("siteIds", H5T_NATIVE_INT, { hsize_t(numSites) }, siteIds.data());
+		writeDataset("sitePositions", H5T_NATIVE_DOUBLE, { hsize_t(numSites), 3 }, sitePositions.data());
+		writeDataset("siteParametrized", H5T_NATIVE_INT, { hsize_t(numSites) }, siteParametrized.data());
+		writeDataset("bonds", H5T_NATIVE_INT, { hsize_t(bondSites.size() / 2), 2 }, bondSites.data());
+		writeDataset("interactions", H5T_NATIVE_INT, { hsize_t(interactionSites.size() / 2), 2 }, interactionSites.data());
+		writeDataset("interactionValues", H5T_NATIVE_FLOAT, { hsize_t(interactionValues.size() / 9), 3, 3 }, interactionValues.data());
+		H5Fclose(file);
+	}
 	#pragma endregion
 
 	std::pair<Lattice *, SpinModel *> newLatticeModel(const LatticeUnitCell &uc, const SpinModelUnitCell &spinModelDefinition, const int latticeRange, const std::string &ldfPath)
@@ -991,7 +1294,11 @@ namespace LatticeModelFactory
 
 		//construct neighborhoods around basis sites
 		std::vector<std::vector<LatticeSite> > neighborhoods;
-		for (int b = 0; b < int(uc.basisSites.size()); ++b) neighborhoods.push_back(constructRangeAroundSite(uc, LatticeSite(0, 0, 0, b), latticeRange));
+		std::vector<int> distances;
+		for (int b = 0; b < int(uc.basisSites.size()); ++b) neighborhoods.push_back(constructRangeAroundSite(uc, LatticeSite(0, 0, 0, b), latticeRange, (b == 0) ? &distances : nullptr));
+
+		//set lattice->range
+		lattice->range = latticeRange;
 
 		//set lattice->_bravaisLattice
 		lattice->_bravaisLattice = uc.latticeVectors;
@@ -999,11 +1306,14 @@ namespace LatticeModelFactory
 		//set lattice->_basis
 		lattice->_basis = uc.basisSites;
 
+		//set lattice->_sublatticeRotation
+		lattice->_sublatticeRotation = spinModelDefinition.sublatticeRotation;
+
 		//construct lattice parametrization
 		Log::log << Log::LogLevel::Info << "\t...finding lattice parametrization" << Log::endl;
-		std::vector<std::pair<int, SpinPermutation>> equivalenceClasses;
+		std::vector<std::pair<int, SpinTransformation>> equivalenceClasses;
 		equivalenceClasses.resize(neighborhoods[0].size());
-		for (int i = 0; i < int(equivalenceClasses.size()); ++i) equivalenceClasses[i] = std::pair<int, SpinPermutation>(-1, SpinPermutation());
+		for (int i = 0; i < int(equivalenceClasses.size()); ++i) equivalenceClasses[i] = std::pair<int, SpinTransformation>(-1, SpinTransformation());
 		int rid = 0;
 		for (int i = 0; i < int(equivalenceClasses.size()); ++i)
 		{
@@ -1015,7 +1325,7 @@ namespace LatticeModelFactory
 
 			//define trivial representative of the group
 			equivalenceClasses[i].first = rid;
-			equivalenceClasses[i].second = SpinPermutation::identity();
+			equivalenceClasses[i].second = SpinTransformation();
 
 			//assign the same representative id (rid) to all equivalent sites
 			for (auto e : equiv)
@@ -1026,16 +1336,19 @@ namespace LatticeModelFactory
 
 				//e contains a symmetry transformation of site(i) to site(j), i.e. we need to store the inverse transformation for site(j)
 				equivalenceClasses[j].first = rid;
-				equivalenceClasses[j].second = SpinPermutation::inverse(e.second);
+				equivalenceClasses[j].second = SpinTransformation::inverse(e.second);
 			}
 			++rid;
 		}
+		//set lattice->_bondDistances; symmetry related sites share the same bond distance to the reference site
+		lattice->_bondDistances.resize(rid);
+		for (int i = 0; i < int(equivalenceClasses.size()); ++i) lattice->_bondDistances[equivalenceClasses[i].first] = distances[i];
 		//sort lattice parametrization to store the trivial representative of each equivalence class upfront
 		for (int r = 0; r < rid; ++r)
 		{
 			for (int i = 0; i < int(equivalenceClasses.size()); ++i)
 			{
-				if (equivalenceClasses[i].first == r && equivalenceClasses[i].second == SpinPermutation::identity())
+				if (equivalenceClasses[i].first == r && equivalenceClasses[i].second == SpinTransformation())
 				{
 					std::swap(equivalenceClasses[r], equivalenceClasses[i]);
 					std::swap(neighborhoods[0][r], neighborhoods[0][i]);
@@ -1069,6 +1382,7 @@ namespace LatticeModelFactory
 			for (int i = 0; i < int(sites.size()); ++i) if (sites[i] == LatticeSite(0, 0, 0, b)) lattice->_bufferBasis[b] = i;
 		}
 		lattice->_bufferBasis[uc.basisSites.size()] = int(sites.size());
+		lattice->_basisSize = int(uc.basisSites.size());
 
 		//set lattice->_bufferLatticeRange
 		lattice->_bufferLatticeRange = new int*[uc.basisSites.size()];
@@ -1080,6 +1394,7 @@ namespace LatticeModelFactory
 				for (int i = 0; i < int(sites.size()); ++i) if (neighborhoods[b][n] == sites[i]) lattice->_bufferLatticeRange[b][n] = i;
 			}
 			lattice->_bufferLatticeRange[b][neighborhoods[b].size()] = int(sites.size());
+			lattice->_rangeSizes.push_back(int(neighborhoods[b].size()));
 		}
 
 		//generate lattice->_symmetryTable
@@ -1091,14 +1406,36 @@ namespace LatticeModelFactory
 			lattice->_symmetryTable[i].spinPermutation[0] = SpinComponent::X;
 			lattice->_symmetryTable[i].spinPermutation[1] = SpinComponent::Y;
 			lattice->_symmetryTable[i].spinPermutation[2] = SpinComponent::Z;
+			lattice->_symmetryTable[i].spinRotation = -1;
 		}
+		//store the spin transformation of a descriptor; transformations which are not plain permutations are additionally stored in matrix form, where identical matrices are shared
+		auto setSpinTransformation = [&](LatticeSiteDescriptor &descriptor, const SpinTransformation &transformation)->void
+		{
+			SpinPermutation permutation;
+			if (!transformation.toPermutation(permutation)) permutation = SpinPermutation::identity();
+			for (int a = 0; a < 3; ++a) descriptor.spinPermutation[a] = permutation.transformedComponent[a];
+			descriptor.spinRotation = -1;
+			if (transformation.isPlainPermutation()) return;
+
+			int numRotations = int(lattice->_spinRotations.size()) / 9;
+			for (int r = 0; r < numRotations; ++r)
+			{
+				SpinTransformation t;
+				memcpy(&t.m[0][0], lattice->_spinRotations.data() + 9 * r, 9 * sizeof(float));
+				if (t == transformation)
+				{
+					descriptor.spinRotation = r;
+					return;
+				}
+			}
+			lattice->_spinRotations.insert(lattice->_spinRotations.end(), &transformation.m[0][0], &transformation.m[0][0] + 9);
+			descriptor.spinRotation = numRotations;
+		};
 		//init entries related to lattice parametrization (transformations with site1=LatticeSite(0,0,0,0))
 		for (int n = 0; n < int(neighborhoods[0].size()); ++n)
 		{
 			lattice->_symmetryTable[0 * sites.size() + n].rid = equivalenceClasses[n].first;
-			lattice->_symmetryTable[0 * sites.size() + n].spinPermutation[0] = equivalenceClasses[n].second.transformedComponent[0];
-			lattice->_symmetryTable[0 * sites.size() + n].spinPermutation[1] = equivalenceClasses[n].second.transformedComponent[1];
-			lattice->_symmetryTable[0 * sites.size() + n].spinPermutation[2] = equivalenceClasses[n].second.transformedComponent[2];
+			setSpinTransformation(lattice->_symmetryTable[0 * sites.size() + n], equivalenceClasses[n].second);
 		}
 		//init entries related to fundamental transformations with site1=LatticeSite(0,0,0,b) for b non-zero)
 		for (int b = 1; b < int(uc.basisSites.size()); ++b)
@@ -1112,22 +1449,33 @@ namespace LatticeModelFactory
 				int eid = int(std::find(sites.begin(), sites.end(), equiv[0].first) - sites.begin());
 
 				lattice->_symmetryTable[bid * sites.size() + nid].rid = lattice->_symmetryTable[0 * sites.size() + eid].rid;
-				lattice->_symmetryTable[bid * sites.size() + nid].spinPermutation[0] = equivalenceClasses[eid].second.transformedComponent[static_cast<int>(equiv[0].second.transformedComponent[static_cast<int>(SpinComponent::X)])];
-				lattice->_symmetryTable[bid * sites.size() + nid].spinPermutation[1] = equivalenceClasses[eid].second.transformedComponent[static_cast<int>(equiv[0].second.transformedComponent[static_cast<int>(SpinComponent::Y)])];
-				lattice->_symmetryTable[bid * sites.size() + nid].spinPermutation[2] = equivalenceClasses[eid].second.transformedComponent[static_cast<int>(equiv[0].second.transformedComponent[static_cast<int>(SpinComponent::Z)])];
+				setSpinTransformation(lattice->_symmetryTable[bid * sites.size() + nid], equiv[0].second * equivalenceClasses[eid].second);
 			}
 		}
-		//init remaining entries of all overlapping pairs of sites
+		if (lattice->hasSpinRotations()) Log::log << Log::LogLevel::Debug << "\t...lattice symmetries involve " << lattice->_spinRotations.size() / 9 << " spin transformations other than plain permutations" << Log::endl;
+		//init remaining entries of all overlapping pairs of sites; sites and neighborhood membership are looked up in a cell index, 
+		//and rows of the sites LatticeSite(0,0,0,b) are complete and only read, such that the remaining rows can be filled concurrently
+		SiteIndex siteIndex(sites, int(uc.basisSites.size()));
+		std::vector<std::vector<bool>> isNeighbor(uc.basisSites.size(), std::vector<bool>(sites.size(), false));
+		for (int b = 0; b < int(uc.basisSites.size()); ++b)
+		{
+			for (const LatticeSite &n : neighborhoods[b]) isNeighbor[b][siteIndex.find(n)] = true;
+		}
+		#ifndef DISABLE_OMP
+		#pragma omp parallel for schedule(dynamic)
+		#endif
 		for (int s1 = 0; s1 < int(sites.size()); ++s1)
 		{
+			LatticeSite s1p(0, 0, 0, sites[s1].b);
+			int s1pid = siteIndex.find(s1p);
+			if (s1 == s1pid) continue;
+
 			for (int s2 = 0; s2 < int(sites.size()); ++s2)
 			{
-				LatticeSite s1p(0, 0, 0, sites[s1].b);
 				LatticeSite s2p(sites[s2].a0 - sites[s1].a0, sites[s2].a1 - sites[s1].a1, sites[s2].a2 - sites[s1].a2, sites[s2].b);
-				if (std::find(neighborhoods[s1p.b].begin(), neighborhoods[s1p.b].end(), s2p) == neighborhoods[s1p.b].end()) continue;
+				int s2pid = siteIndex.find(s2p);
+				if (s2pid < 0 || !isNeighbor[s1p.b][s2pid]) continue;
 
-				int s1pid = int(std::find(sites.begin(), sites.end(), s1p) - sites.begin());
-				int s2pid = int(std::find(sites.begin(), sites.end(), s2p) - sites.begin());
 				lattice->_symmetryTable[s1 * sites.size() + s2] = lattice->_symmetryTable[s1pid * sites.size() + s2pid];
 			}
 		}
@@ -1158,6 +1506,8 @@ namespace LatticeModelFactory
 			std::vector<SpinComponent> overlapTX2;
 			std::vector<SpinComponent> overlapTY2;
 			std::vector<SpinComponent> overlapTZ2;
+			std::vector<int> overlapRotation1;
+			std::vector<int> overlapRotation2;
 
 			//generate overlap buffer
 			LatticeSite i1 = sites[0];
@@ -1183,6 +1533,8 @@ namespace LatticeModelFactory
 				overlapTX2.push_back(t2.spinPermutation[0]);
 				overlapTY2.push_back(t2.spinPermutation[1]);
 				overlapTZ2.push_back(t2.spinPermutation[2]);
+				overlapRotation1.push_back(t1.spinRotation);
+				overlapRotation2.push_back(t2.spinRotation);
 			}
 
 			LatticeOverlap overlap(int(overlapRid1.size()));
@@ -1194,12 +1546,58 @@ namespace LatticeModelFactory
 			memcpy(overlap.transformedX2, overlapTX2.data(), overlapTX2.size() * sizeof(SpinComponent));
 			memcpy(overlap.transformedY2, overlapTY2.data(), overlapTY2.size() * sizeof(SpinComponent));
 			memcpy(overlap.transformedZ2, overlapTZ2.data(), overlapTZ2.size() * sizeof(SpinComponent));
+			memcpy(overlap.spinRotation1, overlapRotation1.data(), overlapRotation1.size() * sizeof(int));
+			memcpy(overlap.spinRotation2, overlapRotation2.data(), overlapRotation2.size() * sizeof(int));
 
 			return overlap;
 		};
 		lattice->_bufferOverlapMatrices = new LatticeOverlap[lattice->size];
 		for (int rid = 0; rid < lattice->size; ++rid) lattice->_bufferOverlapMatrices[rid] = bufferNewOverlapTable(rid);
 
+		//generate lattice->_bufferTransformedSites and lattice->_bufferTransformedOverlapMatrices
+		if (lattice->hasSpinRotations())
+		{
+			std::vector<LatticeSiteDescriptor> transformedSites;
+			std::map<std::tuple<int, int, int, int, int>, int> transformedSiteIds;
+			auto transformedSiteId = [&](const int rid, const SpinComponent x, const SpinComponent y, const SpinComponent z, const int spinRotation) -> int
+			{
+				std::tuple<int, int, int, int, int> key(rid, static_cast<int>(x), static_cast<int>(y), static_cast<int>(z), spinRotation);
+				auto id = transformedSiteIds.find(key);
+				if (id != transformedSiteIds.end()) return id->second;
+
+				LatticeSiteDescriptor site;
+				site.rid = rid;
+				site.spinPermutation[0] = x;
+				site.spinPermutation[1] = y;
+				site.spinPermutation[2] = z;
+				site.spinRotation = spinRotation;
+				transformedSites.push_back(site);
+				transformedSiteIds[key] = int(transformedSites.size()) - 1;
+				return int(transformedSites.size()) - 1;
+			};
+
+			lattice->_bufferTransformedOverlapMatrices = new LatticeOverlap[lattice->size];
+			for (int rid = 0; rid < lattice->size; ++rid)
+			{
+				const LatticeOverlap &o = lattice->_bufferOverlapMatrices[rid];
+				LatticeOverlap overlap(o.size);
+				for (int i = 0; i < o.size; ++i)
+				{
+					overlap.rid1[i] = transformedSiteId(o.rid1[i], o.transformedX1[i], o.transformedY1[i], o.transformedZ1[i], o.spinRotation1[i]);
+					overlap.rid2[i] = transformedSiteId(o.rid2[i], o.transformedX2[i], o.transformedY2[i], o.transformedZ2[i], o.spinRotation2[i]);
+					overlap.transformedX1[i] = overlap.transformedX2[i] = SpinComponent::X;
+					overlap.transformedY1[i] = overlap.transformedY2[i] = SpinComponent::Y;
+					overlap.transformedZ1[i] = overlap.transformedZ2[i] = SpinComponent::Z;
+					overlap.spinRotation1[i] = overlap.spinRotation2[i] = -1;
+				}
+				lattice->_bufferTransformedOverlapMatrices[rid] = overlap;
+			}
+
+			lattice->_transformedSitesSize = int(transformedSites.size());
+			lattice->_bufferTransformedSites = new LatticeSiteDescriptor[transformedSites.size()];
+			memcpy(lattice->_bufferTransformedSites, transformedSites.data(), transformedSites.size() * sizeof(LatticeSiteDescriptor));
+		}
+
 		//init SpinModel
 		SpinModel* spinModel = new SpinModel();
 
@@ -1239,62 +1637,145 @@ namespace LatticeModelFactory
 		//print ldf file
 		if (ldfPath != "")
 		{
-			//open file file
-			std::ofstream ldfFile(ldfPath, std::ios::out);
-			if (!ldfFile.is_open()) throw Exception(Exception::Type::IOError, "Could not write lattice debug information to file. ");
-			ldfFile << "<lattice>" << std::endl;
+			Log::log << Log::LogLevel::Info << "\t...writing lattice debug information" << Log::endl;
+			writeLatticeDebugFile(uc, spinModelDefinition, *lattice, ldfPath);
+		}
+
+		//return lattice
+		return std::pair<Lattice*, SpinModel*>(lattice, spinModel);
+	}
+	std::string rotateSpinModel(const LatticeUnitCell &uc, SpinModelUnitCell &spinModelDefinition)
+	{
+		typedef std::array<std::array<float, 3>, 3> Matrix;
 
-			//write sites
-			for (auto i1 = lattice->getRange(0); i1 != lattice->end(); ++i1)
+		//collect all proper rotations among the signed permutations of spin components, such that the rotated spin is S'[c] = R[c][a] * S[a]
+		std::vector<Matrix> rotations;
+		std::vector<SpinPermutation> permutations;
+		for (int n = 0; n < 48; ++n)
+		{
+			SpinPermutation p(n);
+			Matrix r = {};
+			for (int a = 0; a < 3; ++a)
 			{
-				geometry::Vec3<double> p = lattice->getSitePosition(i1);
-				std::string parametrized = (i1 - lattice->begin() < lattice->size) ? "true" : "false";
-				ldfFile << boost::format("\t<site id=\"%d\" x=\"%f\" y=\"%f\" z=\"%f\" parametrized=\"%s\"/>") % (i1 - lattice->begin()) % p.x % p.y % p.z % parametrized << std::endl;
+				int c = static_cast<int>(p.transformedComponent[a]);
+				float sign = 1.0f;
+				if (c > static_cast<int>(SpinComponent::None))
+				{
+					c -= static_cast<int>(SpinComponent::MinusX);
+					sign = -1.0f;
+				}
+				r[c][a] = sign;
 			}
+			float det = r[0][0] * (r[1][1] * r[2][2] - r[1][2] * r[2][1]) - r[0][1] * (r[1][0] * r[2][2] - r[1][2] * r[2][0]) + r[0][2] * (r[1][0] * r[2][1] - r[1][1] * r[2][0]);
+			if (det < 0.0f) continue;
 
-			//write bonds
-			for (auto i1 = lattice->getRange(0); i1 != lattice->end(); ++i1)
+			rotations.push_back(r);
+			permutations.push_back(p);
+		}
+
+		//order basis sites such that every site is visited after a site which it interacts with, if possible
+		int basisSize = int(uc.basisSites.size());
+		std::vector<int> order;
+		std::vector<bool> isRoot(basisSize, false);
+		for (int root = 0; root < basisSize; ++root)
+		{
+			if (std::find(order.begin(), order.end(), root) != order.end()) continue;
+			isRoot[root] = true;
+			order.push_back(root);
+			for (int k = int(order.size()) - 1; k < int(order.size()); ++k)
 			{
-				for (auto i2 = lattice->getRange(0); i2 != lattice->end(); ++i2)
+				for (auto interaction : spinModelDefinition.interactions)
 				{
-					auto s1Parm = lattice->getSiteParameters(i1);
-					auto s2Parm = lattice->getSiteParameters(i2);
-					LatticeSite s1 = LatticeSite(std::get<0>(s1Parm), std::get<1>(s1Parm), std::get<2>(s1Parm), std::get<3>(s1Parm));
-					LatticeSite s2 = LatticeSite(std::get<0>(s2Parm), std::get<1>(s2Parm), std::get<2>(s2Parm), std::get<3>(s2Parm));
+					int neighbor = -1;
+					if (interaction.from.b == order[k]) neighbor = interaction.to.b;
+					else if (interaction.to.b == order[k]) neighbor = interaction.from.b;
+					if (neighbor >= 0 && std::find(order.begin(), order.end(), neighbor) == order.end()) order.push_back(neighbor);
+				}
+			}
+		}
 
-					for (auto bond : uc.latticeBonds)
+		//rotate an interaction for a given assignment of rotations to basis sites
+		std::vector<int> assignment(basisSize, -1);
+		auto rotateInteraction = [&](const SpinInteraction &interaction, float (&rotated)[3][3])->void
+		{
+			const Matrix &r1 = rotations[assignment[interaction.from.b]];
+			const Matrix &r2 = rotations[assignment[interaction.to.b]];
+			for (int c = 0; c < 3; ++c)
+			{
+				for (int d = 0; d < 3; ++d)
+				{
+					rotated[c][d] = 0.0f;
+					for (int a = 0; a < 3; ++a)
 					{
-						if (bond.isConnectingFromTo(s1, s2)) ldfFile << boost::format("\t<bond from=\"%d\" to=\"%d\" />") % (i1 - lattice->begin()) % (i2 - lattice->begin()) << std::endl;
+						for (int b = 0; b < 3; ++b) rotated[c][d] += r1[c][a] * interaction.interactionStrength[a][b] * r2[d][b];
 					}
 				}
 			}
+		};
 
-			//write interactions
-			for (auto i1 = lattice->getRange(0); i1 != lattice->end(); ++i1)
+		//check whether the rotated interactions are diagonal (or isotropic) on all bonds between assigned basis sites
+		auto isAdmissible = [&](const int b, const bool isotropic)->bool
+		{
+			for (auto interaction : spinModelDefinition.interactions)
 			{
-				for (auto i2 = lattice->getRange(0); i2 != lattice->end(); ++i2)
-				{
-					auto s1Parm = lattice->getSiteParameters(i1);
-					auto s2Parm = lattice->getSiteParameters(i2);
-					LatticeSite s1 = LatticeSite(std::get<0>(s1Parm), std::get<1>(s1Parm), std::get<2>(s1Parm), std::get<3>(s1Parm));
-					LatticeSite s2 = LatticeSite(std::get<0>(s2Parm), std::get<1>(s2Parm), std::get<2>(s2Parm), std::get<3>(s2Parm));
+				if (interaction.from.b != b && interaction.to.b != b) continue;
+				if (assignment[interaction.from.b] == -1 || assignment[interaction.to.b] == -1) continue;
 
-					for (auto i : spinModelDefinition.interactions)
+				float rotated[3][3];
+				rotateInteraction(interaction, rotated);
+				for (int c = 0; c < 3; ++c)
+				{
+					for (int d = 0; d < 3; ++d)
 					{
-						if (i.isConnectingFromTo(s1, s2))
-						{
-							ldfFile << boost::format("\t<interaction from=\"%d\" to=\"%d\" value=\"[[%f,%f,%f],[%f,%f,%f],[%f,%f,%f]]\" />") % (i1 - lattice->begin()) % (i2 - lattice->begin()) % i.interactionStrength[0][0] % i.interactionStrength[0][1] % i.interactionStrength[0][2] % i.interactionStrength[1][0] % i.interactionStrength[1][1] % i.interactionStrength[1][2] % i.interactionStrength[2][0] % i.interactionStrength[2][1] % i.interactionStrength[2][2] << std::endl;
-						}
+						if (c != d && fabs(rotated[c][d]) > __EPSILON) return false;
 					}
+					if (isotropic && fabs(rotated[c][c] - rotated[0][0]) > __EPSILON) return false;
 				}
 			}
+			return true;
+		};
+
+		//backtracking search, where the rotation of the first site in each connected cluster is fixed to the identity
+		std::function<bool(int, bool)> search = [&](const int k, const bool isotropic)->bool
+		{
+			if (k == basisSize) return true;
+
+			int b = order[k];
+			int candidates = (isRoot[b]) ? 1 : int(rotations.size());
+			for (int n = 0; n < candidates; ++n)
+			{
+				assignment[b] = n;
+				if (isAdmissible(b, isotropic) && search(k + 1, isotropic)) return true;
+			}
+			assignment[b] = -1;
+			return false;
+		};
+
+		std::string coreIdentifier = "";
+		if (search(0, true)) coreIdentifier = "SU2";
+		else if (search(0, false)) coreIdentifier = "XYZ";
+		else return coreIdentifier;
+
+		//apply rotation to the spin model
+		for (auto &interaction : spinModelDefinition.interactions)
+		{
+			float rotated[3][3];
+			rotateInteraction(interaction, rotated);
+			memcpy(&interaction.interactionStrength[0][0], &rotated[0][0], 9 * sizeof(float));
+		}
 
-			//finalize file
-			ldfFile << "</lattice>" << std::endl;
-			ldfFile.close();
+		//store rotation if it is non-trivial
+		bool isTrivial = true;
+		for (int b = 0; b < basisSize; ++b) if (assignment[b] != 0) isTrivial = false;
+		if (!isTrivial)
+		{
+			spinModelDefinition.sublatticeRotation.resize(basisSize);
+			for (int b = 0; b < basisSize; ++b)
+			{
+				for (int a = 0; a < 3; ++a) spinModelDefinition.sublatticeRotation[b][a] = permutations[assignment[b]].transformedComponent[a];
+			}
 		}
 
-		//return lattice
-		return std::pair<Lattice*, SpinModel*>(lattice, spinModel);
+		return coreIdentifier;
 	}
 }
\ No newline at end of file
@@ -165,7 +165,7 @@ namespace LatticeModelFactory
 
 		/**
 		 * @brief Construct a two-spin interaction between two lattice sites and set the interaction strength to zero. 
-		 *
+		 * 
 		 * @param from First interaction site. 
 		 * @param to Second interaction site. 
 		 */
@@ -226,6 +226,8 @@ namespace LatticeModelFactory
 
 		std::vector<SpinInteraction> interactions; ///< List of spin interactions in the unit cell. 
 		std::set<std::string> interactionParameters; ///< List of interaction parameter names as used in the specification file. 
+		std::vector<std::array<SpinComponent, 3>> sublatticeRotation; ///< Sublattice-dependent spin rotation which has been applied to the interactions, where sublatticeRotation[b][originalComponent] is the rotated component on basis site b. Empty if the interactions are given in the original frame. 
+		bool spinRotationSymmetry; ///< If set, lattice symmetries may act on the spin components by general orthogonal transformations. Otherwise, only signed permutations of the spin components are considered. 
 
 	private:
 		/**
@@ -250,4 +252,17 @@ namespace LatticeModelFactory
 	 * @return std::pair<Lattice *, SpinModel *> Newly created Lattice and SpinModel objects. 
 	 */
 	std::pair<Lattice *, SpinModel *> newLatticeModel(const LatticeUnitCell &uc, const SpinModelUnitCell &spinModelDefinition, const int latticeRange, const std::string &ldfPath = "");
+
+	/**
+	 * @brief Search for a sublattice-dependent spin rotation which maps the spin model onto a model with diagonal interactions. 
+	 * @details Every basis site b is assigned a proper rotation R_b from the group of signed permutations of the spin components, such that the rotated interactions R_i J_ij R_j^T become diagonal. 
+	 * Rotations which render all interactions isotropic are preferred. 
+	 * If a rotation is found, the interactions of spinModelDefinition are replaced by their rotated counterparts and the rotation is stored in SpinModelUnitCell::sublatticeRotation. 
+	 * Since the rotation is constant on each basis site, mappings which require an enlarged unit cell are not detected. 
+	 * 
+	 * @param uc Lattice unit cell representation. 
+	 * @param[in,out] spinModelDefinition Spin model representation. 
+	 * @return std::string Identifier of the FrgCore which is applicable to the rotated model ("SU2" or "XYZ"). Returns an empty string if no suitable rotation exists. 
+	 */
+	std::string rotateSpinModel(const LatticeUnitCell &uc, SpinModelUnitCell &spinModelDefinition);
 };
\ No newline at end of file
@@ -6,9 +6,11 @@
  * @copyright Copyright (c) 2020
  */
 
+#include <hdf5.h>
 #include "Measurement.hpp"
 #include "lib/Exception.hpp"
 #include "FrgCommon.hpp"
+#include "SpinParser.hpp"
 
 Measurement::Measurement(const std::string &outfile, const float minCutoff, const float maxCutoff, const bool isDeferred) : _isLoadManaged(false), _outfile(outfile), _minCutoff(minCutoff), _maxCutoff(maxCutoff), _isDeferred(isDeferred) {}
 
@@ -16,6 +18,44 @@ Measurement::Measurement(const std::string &outfile, const float minCutoff, cons
 
 Measurement::~Measurement() {};
 
+std::vector<float> Measurement::observables() const
+{
+	return std::vector<float>();
+}
+
+std::vector<Measurement::Observable> Measurement::observableBuffers() const
+{
+	return std::vector<Observable>();
+}
+
+bool Measurement::isCalculated(const EffectiveAction &state) const
+{
+	return !_isLoadManaged;
+}
+
+void Measurement::takeMeasurementBatch(const std::vector<Measurement *> &measurements, const EffectiveAction &state, const bool isMasterTask)
+{
+	//calculate all outstanding load managed stacks in a single epoch
+	std::vector<HMP::StackIdentifier> stacks;
+	for (auto m : measurements)
+	{
+		if (m->isLoadManaged() && !m->isCalculated(state)) stacks.insert(stacks.end(), m->_loadManagedStacks.begin(), m->_loadManagedStacks.end());
+	}
+	if (stacks.size() > 0) SpinParser::spinParser()->getLoadManager()->calculate(stacks.data(), int(stacks.size()));
+
+	//write results
+	for (auto m : measurements) m->takeMeasurement(state, isMasterTask);
+
+	//update schedules
+	std::vector<MeasurementScheduler *> schedulers;
+	for (auto m : measurements)
+	{
+		m->scheduler().record(m->observables());
+		schedulers.push_back(&m->scheduler());
+	}
+	MeasurementScheduler::synchronize(schedulers);
+}
+
 std::string Measurement::outfile() const
 {
 	return _outfile;
@@ -44,4 +84,83 @@ bool Measurement::isLoadManaged() const
 std::vector<int> Measurement::getLoadManagedStacks() const
 {
 	return _loadManagedStacks;
-}
\ No newline at end of file
+}
+
+MeasurementScheduler &Measurement::scheduler()
+{
+	return _scheduler;
+}
+
+void Measurement::setScheduler(const MeasurementScheduler &scheduler)
+{
+	_scheduler = scheduler;
+}
+
+void Measurement::_writeOutfileData(const std::string &observableGroup, const float cutoff, const float *data, const std::vector<int> &dimensions) const
+{
+	H5Eset_auto(H5E_DEFAULT, NULL, NULL);
+
+	//open or create file
+	hid_t file = (H5Fis_hdf5(outfile().c_str()) > 0) ? H5Fopen(outfile().c_str(), H5F_ACC_RDWR, H5P_DEFAULT) : H5Fcreate(outfile().c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+	if (file < 0) throw Exception(Exception::Type::IOError, "Could not open observable file [" + outfile() + "] for writing");
+
+	//open or create groups
+	hid_t group = (H5Lexists(file, observableGroup.c_str(), H5P_DEFAULT) > 0) ? H5Gopen(file, observableGroup.c_str(), H5P_DEFAULT) : H5Gcreate(file, observableGroup.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+	if (group < 0) throw Exception(Exception::Type::IOError, "Could not open obsfile group [" + observableGroup + "] for writing");
+	hid_t collection = (H5Lexists(group, "data", H5P_DEFAULT) > 0) ? H5Gopen(group, "data", H5P_DEFAULT) : H5Gcreate(group, "data", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+	if (collection < 0) throw Exception(Exception::Type::IOError, "Could not open obsfile group [" + observableGroup + "/data] for writing");
+
+	//determine unique dataset name and check for duplicate dataset
+	int datasetId = 0;
+	hsize_t numDatasets;
+	H5Gget_num_objs(collection, &numDatasets);
+	for (int i = 0; i < int(numDatasets); ++i)
+	{
+		if (H5Gget_objtype_by_idx(collection, i) != H5G_GROUP) continue;
+		++datasetId;
+
+		const int datasetNameMaxLength = 32;
+		char datasetName[datasetNameMaxLength];
+		H5Gget_objname_by_idx(collection, i, datasetName, datasetNameMaxLength);
+
+		hid_t measurement = H5Gopen(collection, datasetName, H5P_DEFAULT);
+		hid_t attr = H5Aopen(measurement, "cutoff", H5P_DEFAULT);
+		float c;
+		H5Aread(attr, H5T_NATIVE_FLOAT, &c);
+		H5Aclose(attr);
+		H5Gclose(measurement);
+
+		if (c == cutoff)
+		{
+			Log::log << Log::LogLevel::Warning << "Found existing measurement [" + observableGroup + "] at cutoff " + std::to_string(cutoff) + ". Discarding duplicate entry." << Log::endl;
+			H5Gclose(collection);
+			H5Gclose(group);
+			H5Fclose(file);
+			return;
+		}
+	}
+	std::string datasetName = "measurement_" + std::to_string(datasetId);
+
+	//create new measurement group
+	hid_t measurement = H5Gcreate(collection, datasetName.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+	const hsize_t attrSpaceSize[1] = { 1 };
+	hid_t attrSpace = H5Screate_simple(1, attrSpaceSize, NULL);
+	hid_t attr = H5Acreate(measurement, "cutoff", H5T_NATIVE_FLOAT, attrSpace, H5P_DEFAULT, H5P_DEFAULT);
+	H5Awrite(attr, H5T_NATIVE_FLOAT, &cutoff);
+	H5Aclose(attr);
+	H5Sclose(attrSpace);
+
+	//write data
+	std::vector<hsize_t> dataSpaceSize(dimensions.begin(), dimensions.end());
+	hid_t dataSpace = H5Screate_simple(int(dataSpaceSize.size()), dataSpaceSize.data(), NULL);
+	hid_t dataset = H5Dcreate(measurement, "data", H5T_NATIVE_FLOAT, dataSpace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+	H5Dwrite(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+	H5Dclose(dataset);
+	H5Sclose(dataSpace);
+
+	//clean up
+	H5Gclose(measurement);
+	H5Gclose(collection);
+	H5Gclose(group);
+	H5Fclose(file);
+}
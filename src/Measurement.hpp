@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 #include "lib/LoadManager.hpp"
+#include "MeasurementScheduler.hpp"
 
 struct EffectiveAction;
 
@@ -27,10 +28,23 @@ struct EffectiveAction;
  * Instead, it can provide a list of LoadManager::DataStack ids, which are then calculated in the FrgCore::computeStep() phase. 
  * This allows the FrgCore to perform better load balancing between the different flow equations and the calculations required for the measurements. 
  * The `load managed` propery is inherent to the measurement. Derived measurement classes should initialize the member variable Meausrement::_isLoadManaged with the desired value. 
+ * 
+ * All measurements which are due at a given cutoff step are taken as a batch via Measurement::takeMeasurementBatch(). 
+ * Load managed stacks which have not been calculated in the FrgCore::computeStep() phase are calculated in a single LoadManager epoch for all measurements of the batch, before any output is written. 
  */
 class Measurement
 {
 public:
+	/**
+	 * @brief Named view of a result buffer of a measurement protocol. 
+	 */
+	struct Observable
+	{
+		std::string name; ///< Identifier of the observable. 
+		const float *data; ///< Pointer to the result buffer, which is owned by the measurement protocol. 
+		int size; ///< Number of values in the result buffer. 
+	};
+
 	/**
 	 * @brief Construct a non load managed Measurement object.
 	 *
@@ -55,6 +69,45 @@ public:
 	 */
 	virtual void takeMeasurement(const EffectiveAction &state, const bool isMasterTask) const = 0;
 
+	/**
+	 * @brief Retrieve the result of the most recent measurement as a flat list of values. The result is only required to be complete on the MPI master rank. 
+	 * @details The result is used to detect cutoff windows in which observables change rapidly. Measurement protocols which do not expose their results return an empty list. 
+	 * 
+	 * @return std::vector<float> Result of the most recent measurement. 
+	 */
+	virtual std::vector<float> observables() const;
+
+	/**
+	 * @brief Retrieve views of the result buffers which hold the most recent measurement. The buffers are only required to be complete on the MPI master rank. 
+	 * @details In contrast to Measurement::observables(), no data is copied. The buffers remain valid for the lifetime of the measurement protocol and are overwritten by subsequent measurements. 
+	 * Measurement protocols which do not expose their results return an empty list. 
+	 * 
+	 * @return std::vector<Observable> List of result buffers. 
+	 */
+	virtual std::vector<Observable> observableBuffers() const;
+
+	/**
+	 * @brief Query whether the load managed stacks of the measurement have already been calculated for the specified effective action. 
+	 * @details If the function returns true, Measurement::takeMeasurement() is expected not to invoke any further LoadManager calculations. 
+	 * Load managed measurements which do not override this method are recalculated in every measurement batch. 
+	 * 
+	 * @param state Effective action object to perform the measurement on. 
+	 * @return bool Return true if the load managed stacks are up to date, return false otherwise. 
+	 */
+	virtual bool isCalculated(const EffectiveAction &state) const;
+
+	/**
+	 * @brief Take a batch of measurements on the specified effective action. 
+	 * @details The load managed stacks of all measurements in the batch which are not yet calculated are registered and calculated in a single LoadManager epoch. 
+	 * Subsequently, the measurement results are written and the measurement schedulers are updated, where all schedulers are synchronized in a single collective operation. 
+	 * Must be called on all MPI ranks with the same list of measurements. 
+	 * 
+	 * @param measurements List of measurement protocols to invoke. 
+	 * @param state Effective action object to perform the measurements on. 
+	 * @param isMasterTask If set to true, the function call should be responsible for writing the output files. 
+	 */
+	static void takeMeasurementBatch(const std::vector<Measurement *> &measurements, const EffectiveAction &state, const bool isMasterTask);
+
 	/**
 	 * @brief Return the filename of the output file.
 	 *
@@ -100,6 +153,20 @@ public:
 	 */
 	std::vector<HMP::StackIdentifier> getLoadManagedStacks() const;
 
+	/**
+	 * @brief Return the scheduler which decides at which cutoff steps the measurement protocol is invoked. 
+	 * 
+	 * @return MeasurementScheduler& Measurement scheduler. 
+	 */
+	MeasurementScheduler &scheduler();
+
+	/**
+	 * @brief Replace the measurement scheduler. By default, the measurement protocol is invoked at every cutoff step. 
+	 * 
+	 * @param scheduler New measurement scheduler. 
+	 */
+	void setScheduler(const MeasurementScheduler &scheduler);
+
 protected:
 	/**
 	 * @brief Construct a new Measurement object.
@@ -112,6 +179,18 @@ protected:
 	 */
 	Measurement(const std::string &outfile, const float minCutoff, const float maxCutoff, const bool isDeferred, const bool isLoadManaged);
 
+	/**
+	 * @brief Write a measurement result to the output file. 
+	 * @details The result is written to the dataset `observableGroup/data/measurement_n/data`, where n enumerates the measurements, and the cutoff is stored in the attribute `cutoff` of the group `measurement_n`. 
+	 * This is the same layout which is used by the built-in measurement protocols. If a measurement at the same cutoff already exists, the result is discarded. 
+	 * 
+	 * @param observableGroup Name of the observable group. 
+	 * @param cutoff Cutoff value at which the measurement has been taken. 
+	 * @param data Result buffer. 
+	 * @param dimensions Dimensions of the dataset. The result buffer must hold as many values as the product of all dimensions. 
+	 */
+	void _writeOutfileData(const std::string &observableGroup, const float cutoff, const float *data, const std::vector<int> &dimensions) const;
+
 	bool _isLoadManaged; ///< If set to true, the measurement protocol is considered to be load managed. Derived classes should initialize this variable with the desired value in the constructor. 
 	std::vector<HMP::StackIdentifier> _loadManagedStacks; ///< Contains a list of load managed stack identifiers. Derived classis should initialize this list in the constructor. 
 
@@ -120,4 +199,5 @@ private:
 	float _minCutoff; ///< Minimum cutoff above which to invoke the measurement protocol. 
 	float _maxCutoff; ///< Maximum cutoff below which to invoke the measurement protocol. 
 	bool _isDeferred; ///< If set to true, measurements are deferred to the postprocessing stage. 
+	MeasurementScheduler _scheduler; ///< Scheduler which decides at which cutoff steps the measurement protocol is invoked. 
 };
\ No newline at end of file
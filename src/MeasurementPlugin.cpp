@@ -0,0 +1,42 @@
+/**
+ * @file MeasurementPlugin.cpp
+ * @author Finn Lasse Buessen
+ * @brief Runtime interface for measurement protocols which are loaded from shared libraries. 
+ * 
+ * @copyright Copyright (c) 2020
+ */
+
+#include <map>
+#include <dlfcn.h>
+#include "lib/Exception.hpp"
+#include "MeasurementPlugin.hpp"
+
+Measurement *MeasurementPlugin::newMeasurement(const std::string &library, const Specification &specification)
+{
+	//libraries are never unloaded, since the measurement protocols refer to their code
+	static std::map<std::string, void *> handles;
+
+	void *handle;
+	auto h = handles.find(library);
+	if (h != handles.end()) handle = h->second;
+	else
+	{
+		handle = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+		if (handle == nullptr) throw Exception(Exception::Type::InitializationError, "Could not load measurement plugin [" + library + "]: " + std::string(dlerror()));
+		handles[library] = handle;
+	}
+
+	//verify interface version
+	VersionQuery versionQuery = reinterpret_cast<VersionQuery>(dlsym(handle, "spinparserMeasurementPluginVersion"));
+	Factory factory = reinterpret_cast<Factory>(dlsym(handle, "spinparserNewMeasurement"));
+	if (versionQuery == nullptr || factory == nullptr) throw Exception(Exception::Type::InitializationError, "Library [" + library + "] is not a measurement plugin.");
+
+	int version = 0;
+	int measurementSize = 0;
+	versionQuery(version, measurementSize);
+	if (version != SPINPARSER_MEASUREMENT_PLUGIN_VERSION || measurementSize != int(sizeof(Measurement))) throw Exception(Exception::Type::InitializationError, "Measurement plugin [" + library + "] has been compiled against an incompatible version of the plugin interface.");
+
+	Measurement *m = factory(specification);
+	if (m == nullptr) throw Exception(Exception::Type::InitializationError, "Measurement plugin [" + library + "] does not support the specified measurement.");
+	return m;
+}
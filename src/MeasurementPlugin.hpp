@@ -0,0 +1,85 @@
+/**
+ * @file MeasurementPlugin.hpp
+ * @author Finn Lasse Buessen
+ * @brief Runtime interface for measurement protocols which are loaded from shared libraries. 
+ * @details A measurement plugin is a shared library which implements a measurement protocol derived from the Measurement class and exports a factory function via the macro SPINPARSER_MEASUREMENT_PLUGIN. 
+ * Plugins are compiled against the SpinParser headers and resolve all SpinParser symbols from the executable at load time. 
+ * A minimal plugin reads 
+ * ``` 
+ * #include "MeasurementPlugin.hpp" 
+ * 
+ * class MyMeasurement : public Measurement { ... }; 
+ * 
+ * Measurement *newMyMeasurement(const MeasurementPlugin::Specification &specification) 
+ * { 
+ * 	return new MyMeasurement(specification.output, specification.minCutoff, specification.maxCutoff, specification.defer); 
+ * } 
+ * SPINPARSER_MEASUREMENT_PLUGIN(newMyMeasurement) 
+ * ``` 
+ * 
+ * @copyright Copyright (c) 2020
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include "Measurement.hpp"
+
+/**
+ * @brief Version of the plugin interface. Plugins which have been compiled against a different version are rejected. 
+ */
+#define SPINPARSER_MEASUREMENT_PLUGIN_VERSION 1
+
+namespace MeasurementPlugin
+{
+	/**
+	 * @brief Specification of a plugin measurement protocol, as defined in the task file. 
+	 */
+	struct Specification
+	{
+		std::string symmetry; ///< String-form symmetry identifier of the FrgCore, e.g. "SU2". 
+		std::string output; ///< Output file for the measurement results. 
+		float minCutoff; ///< Minimal cutoff value for the protocol to be invoked. 
+		float maxCutoff; ///< Maximal cutoff value for the protocol to be invoked. 
+		bool defer; ///< Defer flag. If set to true, the measurement will only be invoked in the postprocessing stage. 
+		std::vector<std::pair<std::string, std::string>> options; ///< String-form protocol modifiers as specified in the task file. 
+	};
+
+	/**
+	 * @brief Signature of the factory function which is exported by a plugin. 
+	 */
+	typedef Measurement *(*Factory)(const Specification &specification);
+
+	/**
+	 * @brief Signature of the function which reports the interface version and the size of the Measurement class that a plugin has been compiled against. 
+	 */
+	typedef void (*VersionQuery)(int &version, int &measurementSize);
+
+	/**
+	 * @brief Load a plugin library and create a new measurement protocol from it. 
+	 * @details The library remains loaded for the lifetime of the process, such that the measurement protocol may be destroyed at any point. 
+	 * Loading the same library multiple times does not duplicate it. 
+	 * Throws an exception if the library cannot be loaded, does not export the plugin interface, or has been compiled against an incompatible interface version. 
+	 * 
+	 * @param library Path to the shared library. 
+	 * @param specification Specification of the measurement protocol. 
+	 * @return Measurement* Pointer to the new measurement protocol. 
+	 */
+	Measurement *newMeasurement(const std::string &library, const Specification &specification);
+}
+
+/**
+ * @brief Export the plugin interface from a shared library. 
+ * 
+ * @param factory Function with the signature MeasurementPlugin::Factory which creates the measurement protocol. 
+ */
+#define SPINPARSER_MEASUREMENT_PLUGIN(factory) \
+	extern "C" void spinparserMeasurementPluginVersion(int &version, int &measurementSize) \
+	{ \
+		version = SPINPARSER_MEASUREMENT_PLUGIN_VERSION; \
+		measurementSize = int(sizeof(Measurement)); \
+	} \
+	extern "C" Measurement *spinparserNewMeasurement(const MeasurementPlugin::Specification &specification) \
+	{ \
+		return factory(specification); \
+	}
@@ -0,0 +1,113 @@
+/**
+ * @file MeasurementScheduler.cpp
+ * @author Finn Lasse Buessen
+ * @brief Decide at which cutoff steps a measurement protocol is invoked.
+ *
+ * @copyright Copyright (c) 2020
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include "MeasurementScheduler.hpp"
+#include "lib/Exception.hpp"
+#ifndef DISABLE_MPI
+#include "mpi.h"
+#endif
+
+MeasurementScheduler::MeasurementScheduler() : MeasurementScheduler(Policy::Fixed, 1, 0.0f, {}) {}
+
+MeasurementScheduler::MeasurementScheduler(const Policy policy, const int cadence, const float tolerance, const std::vector<float> &cutoffs) : _policy(policy), _cadence(cadence), _tolerance(tolerance), _cutoffs(cutoffs), _nextCutoff(0), _stepsSinceMeasurement(0), _stepsBetweenMeasurements(0), _hasMeasurement(false), _lastCutoff(0.0f)
+{
+	if (cadence < 1) throw Exception(Exception::Type::ArgumentError, "Measurement cadence must be a positive integer.");
+	if (policy == Policy::Adaptive && tolerance <= 0.0f) throw Exception(Exception::Type::ArgumentError, "Measurement tolerance must be positive.");
+
+	//adaptive schedules start out dense and relax once observables are found to change slowly
+	_interval = (policy == Policy::Fixed) ? cadence : 1;
+	std::sort(_cutoffs.begin(), _cutoffs.end(), std::greater<float>());
+}
+
+bool MeasurementScheduler::isDue(const float cutoff, const bool forced)
+{
+	++_stepsSinceMeasurement;
+	bool due = forced || !_hasMeasurement || _stepsSinceMeasurement >= _interval;
+
+	//guaranteed cutoffs are measured at the first step which reaches them
+	while (_nextCutoff < int(_cutoffs.size()) && cutoff <= _cutoffs[_nextCutoff])
+	{
+		due = true;
+		++_nextCutoff;
+	}
+
+	//never measure the same cutoff twice
+	if (_hasMeasurement && cutoff == _lastCutoff) due = false;
+
+	if (due)
+	{
+		_stepsBetweenMeasurements = _stepsSinceMeasurement;
+		_stepsSinceMeasurement = 0;
+		_hasMeasurement = true;
+		_lastCutoff = cutoff;
+	}
+	return due;
+}
+
+void MeasurementScheduler::record(const std::vector<float> &observables)
+{
+	if (_policy == Policy::Fixed) return;
+
+	if (observables.size() > 0 && observables.size() == _lastObservables.size())
+	{
+		//relative change between the two most recent measurements
+		float difference = 0.0f;
+		float norm0 = 0.0f;
+		float norm1 = 0.0f;
+		for (int i = 0; i < int(observables.size()); ++i)
+		{
+			difference += (observables[i] - _lastObservables[i]) * (observables[i] - _lastObservables[i]);
+			norm0 += _lastObservables[i] * _lastObservables[i];
+			norm1 += observables[i] * observables[i];
+		}
+		float change = (std::max(norm0, norm1) > 0.0f) ? sqrtf(difference / std::max(norm0, norm1)) : 0.0f;
+
+		//measure at every step if the change exceeds the tolerance; otherwise extrapolate the change per step, but at most double the interval
+		if (change > _tolerance) _interval = 1;
+		else
+		{
+			float changePerStep = change / float(std::max(_stepsBetweenMeasurements, 1));
+			int target = (changePerStep > 0.0f) ? int(std::min(float(_cadence), _tolerance / changePerStep)) : _cadence;
+			_interval = std::max(1, std::min({ 2 * _interval, target, _cadence }));
+		}
+	}
+	_lastObservables = observables;
+}
+
+void MeasurementScheduler::synchronize()
+{
+	#ifndef DISABLE_MPI
+	if (_policy == Policy::Adaptive) MPI_Bcast(&_interval, 1, MPI_INT, 0, MPI_COMM_WORLD);
+	#endif
+}
+
+void MeasurementScheduler::synchronize(const std::vector<MeasurementScheduler *> &schedulers)
+{
+	#ifndef DISABLE_MPI
+	std::vector<int> intervals;
+	for (auto s : schedulers) if (s->_policy == Policy::Adaptive) intervals.push_back(s->_interval);
+	if (intervals.size() == 0) return;
+
+	MPI_Bcast(intervals.data(), int(intervals.size()), MPI_INT, 0, MPI_COMM_WORLD);
+	auto i = intervals.begin();
+	for (auto s : schedulers) if (s->_policy == Policy::Adaptive) s->_interval = *(i++);
+	#endif
+}
+
+int MeasurementScheduler::interval() const
+{
+	return _interval;
+}
+
+MeasurementScheduler::Policy MeasurementScheduler::policy() const
+{
+	return _policy;
+}
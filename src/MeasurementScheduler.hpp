@@ -0,0 +1,104 @@
+/**
+ * @file MeasurementScheduler.hpp
+ * @author Finn Lasse Buessen
+ * @brief Decide at which cutoff steps a measurement protocol is invoked.
+ *
+ * @copyright Copyright (c) 2020
+ */
+
+#pragma once
+#include <vector>
+
+/**
+ * @brief Schedule of a single measurement protocol.
+ * @details The scheduler is queried at every cutoff step at which the measurement protocol is eligible to run.
+ * Under the fixed policy, the measurement is taken at every `cadence`-th step.
+ * Under the adaptive policy, the interval between two measurements is chosen according to the relative change of the observables between the two most recent measurements:
+ * If the observables change by more than `tolerance` per measurement interval, the measurement is taken at every step. Otherwise, the interval grows up to at most `cadence` steps.
+ *
+ * Irrespective of the policy, a measurement is always taken at the first step which reaches any of the guaranteed cutoff values, and whenever the measurement is explicitly forced (e.g. at the end of the flow).
+ * The default scheduler takes a measurement at every step.
+ */
+class MeasurementScheduler
+{
+public:
+	/**
+	 * @brief Scheduling policy.
+	 */
+	enum class Policy
+	{
+		Fixed, ///< Measure at a fixed cadence.
+		Adaptive ///< Measure densely only if observables change rapidly.
+	};
+
+	/**
+	 * @brief Construct a MeasurementScheduler which takes a measurement at every step.
+	 */
+	MeasurementScheduler();
+
+	/**
+	 * @brief Construct a new MeasurementScheduler object.
+	 *
+	 * @param policy Scheduling policy.
+	 * @param cadence Measurement interval for the fixed policy, or maximal measurement interval for the adaptive policy.
+	 * @param tolerance Largest relative change of the observables between two measurements which is tolerated by the adaptive policy before measurements become dense.
+	 * @param cutoffs List of cutoff values at which a measurement is guaranteed.
+	 */
+	MeasurementScheduler(const Policy policy, const int cadence, const float tolerance, const std::vector<float> &cutoffs);
+
+	/**
+	 * @brief Decide whether a measurement should be taken at the current step. Must be called exactly once per eligible cutoff step.
+	 *
+	 * @param cutoff Current cutoff value.
+	 * @param forced If set to true, a measurement is taken unless a measurement at the same cutoff has been taken already.
+	 * @return bool Return true if a measurement should be taken, return false otherwise.
+	 */
+	bool isDue(const float cutoff, const bool forced = false);
+
+	/**
+	 * @brief Record the result of a measurement which has just been taken, and update the measurement interval.
+	 * @details Observables are only required on the MPI master rank. The updated interval should subsequently be distributed via MeasurementScheduler::synchronize().
+	 *
+	 * @param observables Result of the measurement.
+	 */
+	void record(const std::vector<float> &observables);
+
+	/**
+	 * @brief Distribute the measurement interval from the MPI master rank to all other ranks.
+	 */
+	void synchronize();
+
+	/**
+	 * @brief Distribute the measurement intervals of several schedulers from the MPI master rank to all other ranks in a single collective operation.
+	 *
+	 * @param schedulers List of schedulers to synchronize.
+	 */
+	static void synchronize(const std::vector<MeasurementScheduler *> &schedulers);
+
+	/**
+	 * @brief Return the number of eligible steps between two regular measurements.
+	 *
+	 * @return int Measurement interval.
+	 */
+	int interval() const;
+
+	/**
+	 * @brief Return the scheduling policy.
+	 *
+	 * @return Policy Scheduling policy.
+	 */
+	Policy policy() const;
+
+private:
+	Policy _policy; ///< Scheduling policy.
+	int _cadence; ///< Measurement interval for the fixed policy, or maximal measurement interval for the adaptive policy.
+	float _tolerance; ///< Largest relative change between two measurements tolerated by the adaptive policy.
+	std::vector<float> _cutoffs; ///< Guaranteed cutoff values in descending order.
+	int _nextCutoff; ///< Index of the next guaranteed cutoff value which has not been reached yet.
+	int _interval; ///< Current measurement interval.
+	int _stepsSinceMeasurement; ///< Number of eligible steps since the last measurement.
+	int _stepsBetweenMeasurements; ///< Number of eligible steps between the two most recent measurements.
+	bool _hasMeasurement; ///< Set to true once the first measurement has been taken.
+	float _lastCutoff; ///< Cutoff value of the most recent measurement.
+	std::vector<float> _lastObservables; ///< Observables of the most recent measurement.
+};
@@ -0,0 +1,177 @@
+/**
+ * @file MultirateScheduler.cpp
+ * @author Finn Lasse Buessen
+ * @brief Multi-rate evaluation of the two-particle vertex flow. 
+ * 
+ * @copyright Copyright (c) 2020
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "lib/Log.hpp"
+#include "MultirateScheduler.hpp"
+#ifndef DISABLE_MPI
+#include "mpi.h"
+#endif
+
+MultirateScheduler::MultirateScheduler(const int maxInterval, const float tolerance) : _maxInterval(maxInterval), _tolerance(tolerance), _blockSize(0), _cutoff(0.0f), _evaluated(0)
+{
+}
+
+void MultirateScheduler::setBlocks(const int numBlocks, const int blockSize, const std::vector<float *> &flow)
+{
+	_blockSize = blockSize;
+	_arrays = flow;
+	_blocks.assign(numBlocks, Block());
+	reset();
+}
+
+bool MultirateScheduler::isEnabled() const
+{
+	return _maxInterval > 1 && _blocks.size() > 0;
+}
+
+void MultirateScheduler::reset()
+{
+	for (auto &b : _blocks)
+	{
+		b.isSlow = false;
+		b.interval = 1;
+		b.age = 0;
+		b.evaluations = 0;
+		b.cutoff = 0.0f;
+		b.norm = 0.0f;
+		b.exponent = 0.0f;
+		std::vector<float>().swap(b.flow);
+	}
+	_due.clear();
+	if (isEnabled()) _due.assign(_blocks.size(), 1);
+	_evaluated = int(_blocks.size());
+}
+
+void MultirateScheduler::beginStep(const float cutoff, const bool isMasterTask)
+{
+	if (!isEnabled()) return;
+
+	//slow blocks are due once their interval has elapsed
+	if (isMasterTask)
+	{
+		_cutoff = cutoff;
+		for (int b = 0; b < int(_blocks.size()); ++b)
+		{
+			if (_blocks[b].isSlow) ++_blocks[b].age;
+			_due[b] = (!_blocks[b].isSlow || _blocks[b].age >= _blocks[b].interval) ? 1 : 0;
+		}
+	}
+	#ifndef DISABLE_MPI
+	MPI_Bcast(_due.data(), int(_due.size()), MPI_CHAR, 0, MPI_COMM_WORLD);
+	#endif
+	_evaluated = int(std::count(_due.begin(), _due.end(), char(1)));
+}
+
+void MultirateScheduler::endStep(const bool isMasterTask)
+{
+	if (!isEnabled() || !isMasterTask) return;
+
+	//norms of the evaluated blocks; deviations are measured relative to the block norm, but at least relative to a small fraction of the largest block norm
+	std::vector<float> norms(_blocks.size(), 0.0f);
+	float maxNorm = 0.0f;
+	#ifndef DISABLE_OMP
+	#pragma omp parallel for schedule(static) reduction(max:maxNorm)
+	#endif
+	for (int b = 0; b < int(_blocks.size()); ++b)
+	{
+		if (!_due[b]) continue;
+		double sum = 0.0;
+		for (float *a : _arrays)
+		{
+			for (int i = b * _blockSize; i < (b + 1) * _blockSize; ++i) sum += double(a[i]) * double(a[i]);
+		}
+		norms[b] = float(std::sqrt(sum));
+		maxNorm = std::max(maxNorm, norms[b]);
+	}
+	float floor = 1e-3f * maxNorm;
+
+	int promoted = 0;
+	#ifndef DISABLE_OMP
+	#pragma omp parallel for schedule(dynamic) reduction(+:promoted)
+	#endif
+	for (int b = 0; b < int(_blocks.size()); ++b)
+	{
+		Block &block = _blocks[b];
+		float factor = (block.evaluations > 0) ? powf(_cutoff / block.cutoff, block.exponent) : 1.0f;
+
+		//extrapolate the flow of slow blocks which are not due
+		if (!_due[b])
+		{
+			std::vector<float> flow(block.flow);
+			for (float &f : flow) f *= factor;
+			_copy(b, flow, true);
+			continue;
+		}
+
+		std::vector<float> flow;
+		_copy(b, flow, false);
+		float scale = std::max(norms[b], floor);
+
+		//deviation of the computed flow from the power law extrapolation of the most recent evaluation
+		float error = 0.0f;
+		if (block.evaluations >= 2)
+		{
+			double deviation = 0.0;
+			for (int i = 0; i < int(flow.size()); ++i) deviation += double(flow[i] - factor * block.flow[i]) * double(flow[i] - factor * block.flow[i]);
+			error = (scale > 0.0f) ? float(std::sqrt(deviation)) / scale : 0.0f;
+		}
+
+		if (block.isSlow)
+		{
+			//promote the block if the deviation is too large, otherwise extend its interval if the deviation is small
+			block.age = 0;
+			if (error > _tolerance)
+			{
+				block.isSlow = false;
+				++promoted;
+			}
+			else if (error < 0.5f * _tolerance) block.interval = std::min(2 * block.interval, _maxInterval);
+		}
+		else if (block.evaluations >= 2 && error < _tolerance)
+		{
+			//demote fast blocks whose flow has followed the power law since the previous step
+			block.isSlow = true;
+			block.interval = std::min(2, _maxInterval);
+			block.age = 0;
+		}
+		block.flow.swap(flow);
+
+		//update the power law
+		block.exponent = (block.evaluations > 0 && block.norm > 0.0f && norms[b] > 0.0f && _cutoff != block.cutoff) ? logf(norms[b] / block.norm) / logf(_cutoff / block.cutoff) : 0.0f;
+		block.norm = norms[b];
+		block.cutoff = _cutoff;
+		++block.evaluations;
+	}
+
+	Log::log << Log::LogLevel::Info << "Multi-rate evaluation computed " << _evaluated << " of " << _blocks.size() << " frequency blocks (" << slowBlocks() << " slow, " << promoted << " promoted)." << Log::endl;
+}
+
+int MultirateScheduler::evaluatedBlocks() const
+{
+	return _evaluated;
+}
+
+int MultirateScheduler::slowBlocks() const
+{
+	int count = 0;
+	for (auto &b : _blocks) if (b.isSlow) ++count;
+	return count;
+}
+
+void MultirateScheduler::_copy(const int block, std::vector<float> &flow, const bool toArrays) const
+{
+	if (!toArrays) flow.resize(_arrays.size() * _blockSize);
+	for (int a = 0; a < int(_arrays.size()); ++a)
+	{
+		float *begin = _arrays[a] + size_t(block) * _blockSize;
+		if (toArrays) std::copy(flow.begin() + a * _blockSize, flow.begin() + (a + 1) * _blockSize, begin);
+		else std::copy(begin, begin + _blockSize, flow.begin() + a * _blockSize);
+	}
+}
@@ -0,0 +1,129 @@
+/**
+ * @file MultirateScheduler.hpp
+ * @author Finn Lasse Buessen
+ * @brief Multi-rate evaluation of the two-particle vertex flow. 
+ * 
+ * @copyright Copyright (c) 2020
+ */
+
+#pragma once
+#include <vector>
+
+/**
+ * @brief Decide which blocks of the two-particle vertex flow are evaluated at a cutoff step, and extrapolate the flow of all other blocks. 
+ * @details A block comprises all entries of the flow which are computed by a single frequency iterator, i.e. all lattice sites and vertex channels at one frequency triplet. 
+ * Blocks whose flow follows a power law in the cutoff to within the relative `tolerance` are classified as slow. 
+ * Slow blocks are only re-evaluated every few cutoff steps, and their flow is extrapolated from the most recent evaluation in between. 
+ * The re-evaluation interval starts at two steps and is doubled up to `maxInterval` steps as long as the extrapolation remains accurate. 
+ * Whenever a slow block is re-evaluated, the extrapolated flow is compared to the computed flow, and the block is promoted back to the set of fast blocks if the deviation exceeds the tolerance. 
+ * 
+ * The decisions and the extrapolation are made on the MPI master rank, where the flow is collected, and the set of blocks to evaluate is distributed to all other ranks. 
+ * To this end, the master rank holds a copy of the most recently computed flow of every block. 
+ * A maximal interval of one disables the multi-rate evaluation. 
+ */
+class MultirateScheduler
+{
+public:
+	/**
+	 * @brief Construct a new MultirateScheduler object. 
+	 * 
+	 * @param maxInterval Maximal number of cutoff steps between two evaluations of a slow block. A value of one evaluates every block at every step. 
+	 * @param tolerance Largest relative deviation of the extrapolated flow from the computed flow which is tolerated for slow blocks. 
+	 */
+	MultirateScheduler(const int maxInterval = 1, const float tolerance = 0.01f);
+
+	/**
+	 * @brief Define the blocks of the flow. The flow of block b is stored in the elements [b*blockSize, (b+1)*blockSize) of every data array. 
+	 * 
+	 * @param numBlocks Number of blocks. 
+	 * @param blockSize Number of elements per block and data array. 
+	 * @param flow Data arrays of the flow. 
+	 */
+	void setBlocks(const int numBlocks, const int blockSize, const std::vector<float *> &flow);
+
+	/**
+	 * @brief Query whether the multi-rate evaluation is enabled. 
+	 * 
+	 * @return bool Return true if the maximal interval exceeds one and the blocks have been defined, return false otherwise. 
+	 */
+	bool isEnabled() const;
+
+	/**
+	 * @brief Classify all blocks as fast and discard their history, e.g. because the flowing functional has been replaced. 
+	 */
+	void reset();
+
+	/**
+	 * @brief Decide which blocks are evaluated at the current cutoff step. Must be called on all MPI ranks before the flow is computed. 
+	 * 
+	 * @param cutoff Current cutoff value. 
+	 * @param isMasterTask If set to true, the function call is responsible for the decision. 
+	 */
+	void beginStep(const float cutoff, const bool isMasterTask);
+
+	/**
+	 * @brief Query whether a block is evaluated at the current cutoff step. 
+	 * 
+	 * @param block Block index. 
+	 * @return bool Return true if the block is evaluated, return false if its flow is extrapolated. 
+	 */
+	bool isDue(const int block) const
+	{
+		return _due.size() == 0 || _due[block] != 0;
+	}
+
+	/**
+	 * @brief Classify the evaluated blocks and extrapolate the flow of all other blocks. Must be called on all MPI ranks after the flow has been computed. 
+	 * 
+	 * @param isMasterTask If set to true, the function call is responsible for the classification and the extrapolation. 
+	 */
+	void endStep(const bool isMasterTask);
+
+	/**
+	 * @brief Retrieve the number of blocks which have been evaluated at the most recent cutoff step. 
+	 * 
+	 * @return int Number of evaluated blocks. 
+	 */
+	int evaluatedBlocks() const;
+
+	/**
+	 * @brief Retrieve the number of blocks which are currently classified as slow. Only available on the MPI master rank. 
+	 * 
+	 * @return int Number of slow blocks. 
+	 */
+	int slowBlocks() const;
+
+private:
+	/**
+	 * @brief Evaluation history of a block. 
+	 */
+	struct Block
+	{
+		bool isSlow; ///< Set to true if the block is classified as slow.
+		int interval; ///< Number of cutoff steps between two evaluations of a slow block.
+		int age; ///< Number of cutoff steps since the most recent evaluation.
+		int evaluations; ///< Number of consecutive evaluations which are available for the power law fit.
+		float cutoff; ///< Cutoff value of the most recent evaluation.
+		float norm; ///< Norm of the flow at the most recent evaluation.
+		float exponent; ///< Exponent of the power law which describes the norm of the flow as a function of the cutoff.
+		std::vector<float> flow; ///< Flow at the most recent evaluation.
+	};
+
+	/**
+	 * @brief Copy the flow of a block from the data arrays, or into the data arrays. 
+	 * 
+	 * @param block Block index. 
+	 * @param flow Flow of the block. 
+	 * @param toArrays If set to true, copy the flow into the data arrays, otherwise copy from the data arrays. 
+	 */
+	void _copy(const int block, std::vector<float> &flow, const bool toArrays) const;
+
+	int _maxInterval; ///< Maximal number of cutoff steps between two evaluations of a slow block.
+	float _tolerance; ///< Largest tolerated relative deviation of the extrapolated flow.
+	int _blockSize; ///< Number of elements per block and data array.
+	std::vector<float *> _arrays; ///< Data arrays of the flow.
+	std::vector<Block> _blocks; ///< Evaluation history of every block.
+	std::vector<char> _due; ///< Set to non-zero for blocks which are evaluated at the current cutoff step. Empty if the multi-rate evaluation is disabled.
+	float _cutoff; ///< Current cutoff value.
+	int _evaluated; ///< Number of blocks which have been evaluated at the current cutoff step.
+};
@@ -43,13 +43,16 @@ public:
 		//set initial value
 		this->cutoff = cutoff;
 
+		#ifndef DISABLE_OMP
+		#pragma omp parallel for schedule(static)
+		#endif
 		for (int linearIterator = 0; linearIterator < vertexTwoParticle->size; ++linearIterator)
 		{
 			float s, t, u;
 			LatticeIterator i1;
 			vertexTwoParticle->expandIterator(linearIterator, i1, s, t, u);
 
-			for (auto i : spinModel.interactions)
+			for (const auto &i : spinModel.interactions)
 			{
 				if (i.first == i1)
 				{
@@ -161,7 +164,7 @@ public:
 		H5Eset_auto(H5E_DEFAULT, NULL, NULL);
 
 		//open file
-		hid_t file = H5Fopen(dataFilePath.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+		hid_t file = _openDataFile(dataFilePath);
 		if (file < 0) throw Exception(Exception::Type::IOError, "Could not open data file for reading");
 
 		//find desired dataset name
@@ -229,6 +232,45 @@ public:
 		return false;
 	}
 
+	/**
+	 * @brief Sample the frequency dependence of the effective action on the positive frequency mesh. 
+	 * @details Profiles comprise the single-particle vertex and the local two-particle vertex in the spin and density channels along each transfer frequency, where the remaining transfer frequencies are set to the smallest mesh point. 
+	 *
+	 * @return std::vector<std::vector<float>> List of frequency profiles. 
+	 */
+	std::vector<std::vector<float>> getFrequencyProfiles() const override
+	{
+		int n = FrgCommon::frequency().size;
+		float w0 = FrgCommon::frequency()._data[0];
+		LatticeIterator i0 = FrgCommon::lattice().zero();
+
+		std::vector<std::vector<float>> profiles;
+		profiles.push_back(std::vector<float>(vertexSingleParticle->_data, vertexSingleParticle->_data + n));
+		for (SU2VertexTwoParticle::Symmetry c : { SU2VertexTwoParticle::Symmetry::Spin, SU2VertexTwoParticle::Symmetry::Density })
+		{
+			std::vector<float> profileS(n), profileT(n), profileU(n);
+			for (int i = 0; i < n; ++i)
+			{
+				float w = FrgCommon::frequency()._data[i];
+				profileS[i] = vertexTwoParticle->getValue(i0, i0, w, w0, w0, c, SU2VertexTwoParticle::FrequencyChannel::All);
+				profileT[i] = vertexTwoParticle->getValue(i0, i0, w0, w, w0, c, SU2VertexTwoParticle::FrequencyChannel::All);
+				profileU[i] = vertexTwoParticle->getValue(i0, i0, w0, w0, w, c, SU2VertexTwoParticle::FrequencyChannel::All);
+			}
+			profiles.push_back(profileS);
+			profiles.push_back(profileT);
+			profiles.push_back(profileU);
+		}
+
+		return profiles;
+	}
+
+	std::vector<float> getTwoParticleMagnitudes() const override
+	{
+		std::vector<float> magnitudes(vertexTwoParticle->size);
+		for (int i = 0; i < vertexTwoParticle->size; ++i) magnitudes[i] = sqrtf(vertexTwoParticle->_dataSS[i] * vertexTwoParticle->_dataSS[i] + vertexTwoParticle->_dataDD[i] * vertexTwoParticle->_dataDD[i]);
+		return magnitudes;
+	}
+
 	SU2VertexSingleParticle *vertexSingleParticle; ///< Single-particle vertex data. 
 	SU2VertexTwoParticle *vertexTwoParticle; ///< Two-particle vertex data. 
 };
\ No newline at end of file
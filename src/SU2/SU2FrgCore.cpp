@@ -56,7 +56,12 @@ SU2FrgCore::SU2FrgCore(const SpinModel &spinModel, const std::vector<Measurement
 	dataStacks[4] = SpinParser::spinParser()->getLoadManager()->addMasterStackImplicit<float>(
 		&_flow->cutoff,
 		1,
-		[&](int) { _flow->cutoff = static_cast<SU2EffectiveAction *>(_flowingFunctional)->cutoff; });
+		[&](int) { _flow->cutoff = static_cast<SU2EffectiveAction *>(_flowingFunctional)->cutoff; },
+		1,
+		1,
+		10,
+		false,
+		true);
 	//stack5
 	dataStacks[5] = SpinParser::spinParser()->getLoadManager()->addMasterStackImplicit<float>(
 		static_cast<SU2EffectiveAction *>(_flow)->vertexSingleParticle->_data,
@@ -64,12 +69,14 @@ SU2FrgCore::SU2FrgCore(const SpinModel &spinModel, const std::vector<Measurement
 		[&](int x) { _calculateVertexSingleParticle(x); },
 		1,
 		1,
-		1);
+		1,
+		false,
+		true);
 	//stack6
 	dataStacks[6] = SpinParser::spinParser()->getLoadManager()->addMasterStackImplicit<float>(
 		static_cast<SU2EffectiveAction *>(_flow)->vertexTwoParticle->_dataDD,
 		static_cast<SU2EffectiveAction *>(_flowingFunctional)->vertexTwoParticle->sizeFrequency,
-		[&](int x) { _calculateVertexTwoParticle(x); },
+		[&](int x) { if (_multirate.isDue(x)) SpinParser::spinParser()->getFlowProfiler()->profile(x, [&]() { if (FrgCommon::frequency().interpolation == FrequencyDiscretization::Interpolation::Cubic) _calculateVertexTwoParticle<16>(x); else _calculateVertexTwoParticle<4>(x); }); },
 		FrgCommon::lattice().size,
 		FrgCommon::frequency().size);
 	//stack7
@@ -78,6 +85,9 @@ SU2FrgCore::SU2FrgCore(const SpinModel &spinModel, const std::vector<Measurement
 		static_cast<SU2EffectiveAction *>(_flowingFunctional)->vertexTwoParticle->sizeFrequency,
 		dataStacks[6],
 		FrgCommon::lattice().size);
+
+	//blocks of the multi-rate evaluation are formed by the frequency iterators of the two-particle vertex flow
+	_multirate.setBlocks(static_cast<SU2EffectiveAction *>(_flowingFunctional)->vertexTwoParticle->sizeFrequency, FrgCommon::lattice().size, { static_cast<SU2EffectiveAction *>(_flow)->vertexTwoParticle->_dataDD, static_cast<SU2EffectiveAction *>(_flow)->vertexTwoParticle->_dataSS });
 }
 
 SU2FrgCore::~SU2FrgCore()
@@ -105,7 +115,9 @@ void SU2FrgCore::computeStep()
 		}
 	}
 	managedMeasurementStacks.push_back(dataStacks[6]);
+	_multirate.beginStep(_flowingFunctional->cutoff, SpinParser::spinParser()->isMasterRank());
 	SpinParser::spinParser()->getLoadManager()->calculate(managedMeasurementStacks.data(), int(managedMeasurementStacks.size()));
+	_multirate.endStep(SpinParser::spinParser()->isMasterRank());
 }
 
 void SU2FrgCore::finalizeStep(float newCutoff)
@@ -123,19 +135,18 @@ void SU2FrgCore::finalizeStep(float newCutoff)
 	for (int i = 0; i < static_cast<SU2EffectiveAction *>(_flowingFunctional)->vertexSingleParticle->size; ++i) static_cast<SU2EffectiveAction *>(_flowingFunctional)->vertexSingleParticle->_data[i] += cutoffStep * static_cast<SU2EffectiveAction *>(_flow)->vertexSingleParticle->_data[i];
 
 	//add _flow to two particle vertex
-	#ifndef DISABLE_OMP
-	#pragma omp parallel for schedule(static)
-	#endif
-	for (int i = 0; i < static_cast<SU2EffectiveAction *>(_flowingFunctional)->vertexTwoParticle->size; ++i) static_cast<SU2EffectiveAction *>(_flowingFunctional)->vertexTwoParticle->_dataDD[i] += cutoffStep * static_cast<SU2EffectiveAction *>(_flow)->vertexTwoParticle->_dataDD[i];
-	#ifndef DISABLE_OMP
-	#pragma omp parallel for schedule(static)
-	#endif
-	for (int i = 0; i < static_cast<SU2EffectiveAction *>(_flowingFunctional)->vertexTwoParticle->size; ++i) static_cast<SU2EffectiveAction *>(_flowingFunctional)->vertexTwoParticle->_dataSS[i] += cutoffStep * static_cast<SU2EffectiveAction *>(_flow)->vertexTwoParticle->_dataSS[i];
+	integrateStep(static_cast<SU2EffectiveAction *>(_flowingFunctional)->vertexTwoParticle->_dataDD, static_cast<SU2EffectiveAction *>(_flow)->vertexTwoParticle->_dataDD, static_cast<SU2EffectiveAction *>(_flowingFunctional)->vertexTwoParticle->size, cutoffStep, FrgCommon::cutoff().integrator);
+	integrateStep(static_cast<SU2EffectiveAction *>(_flowingFunctional)->vertexTwoParticle->_dataSS, static_cast<SU2EffectiveAction *>(_flow)->vertexTwoParticle->_dataSS, static_cast<SU2EffectiveAction *>(_flowingFunctional)->vertexTwoParticle->size, cutoffStep, FrgCommon::cutoff().integrator);
 
 	//broadcast updated effective action
 	SpinParser::spinParser()->getLoadManager()->broadcast({ dataStacks[0], dataStacks[1], dataStacks[2], dataStacks[3] });
 }
 
+void SU2FrgCore::tuneKernels(KernelTuner &tuner)
+{
+	_tuneKernels(tuner, "SU2", [&](int x) { if (FrgCommon::frequency().interpolation == FrequencyDiscretization::Interpolation::Cubic) _calculateVertexTwoParticle<16>(x); else _calculateVertexTwoParticle<4>(x); }, true);
+}
+
 void SU2FrgCore::_calculateVertexSingleParticle(const int iterator)
 {
 	float cutoff = _flowingFunctional->cutoff;
@@ -148,7 +159,7 @@ void SU2FrgCore::_calculateVertexSingleParticle(const int iterator)
 
 	//term1
 	float sum = 0;
-	for (auto j = FrgCommon::lattice().getRange(0); j != FrgCommon::lattice().end(); ++j)
+	for (int j : FrgCommon::lattice().getRangeIds(0))
 	{
 		sum += v4->getValue(FrgCommon::lattice().zero(), j, w + cutoff, 0.0f, w - cutoff, SU2VertexTwoParticle::Symmetry::Density, SU2VertexTwoParticle::FrequencyChannel::None);
 		sum -= v4->getValue(FrgCommon::lattice().zero(), j, w - cutoff, 0.0f, w + cutoff, SU2VertexTwoParticle::Symmetry::Density, SU2VertexTwoParticle::FrequencyChannel::None);
@@ -168,7 +179,7 @@ void SU2FrgCore::_calculateVertexSingleParticle(const int iterator)
 	static_cast<SU2EffectiveAction *>(_flow)->vertexSingleParticle->_data[iterator] = v2CurrentValue;
 }
 
-void SU2FrgCore::_calculateVertexTwoParticle(const int iterator)
+template <int n> void SU2FrgCore::_calculateVertexTwoParticle(const int iterator)
 {
 	float cutoff = _flowingFunctional->cutoff;
 	SU2VertexSingleParticle *v2 = static_cast<SU2EffectiveAction *>(_flowingFunctional)->vertexSingleParticle;
@@ -199,11 +210,11 @@ void SU2FrgCore::_calculateVertexTwoParticle(const int iterator)
 	auto integralKernelS = [&](const float wp, ValueSuperbundle<float, 2> &returnBuffer) -> void
 	{
 		//pp-ladder A and B (positive sign)
-		const SU2VertexTwoParticleAccessBuffer<4> ab0 = v4->generateAccessBuffer(s, -w1 - wp, -w2 - wp, SU2VertexTwoParticle::FrequencyChannel::S);
-		const SU2VertexTwoParticleAccessBuffer<4> ab1 = v4->generateAccessBuffer(s, w1p + wp, -w2p - wp, SU2VertexTwoParticle::FrequencyChannel::S);
+		const SU2VertexTwoParticleAccessBuffer<n> ab0 = v4->generateAccessBuffer<n>(s, -w1 - wp, -w2 - wp, SU2VertexTwoParticle::FrequencyChannel::S);
+		const SU2VertexTwoParticleAccessBuffer<n> ab1 = v4->generateAccessBuffer<n>(s, w1p + wp, -w2p - wp, SU2VertexTwoParticle::FrequencyChannel::S);
 		//pp-ladder A and B (positive sign)
-		const SU2VertexTwoParticleAccessBuffer<4> ab2 = v4->generateAccessBuffer(s, w2 + wp, w1 + wp, SU2VertexTwoParticle::FrequencyChannel::S);
-		const SU2VertexTwoParticleAccessBuffer<4> ab3 = v4->generateAccessBuffer(s, -w2p - wp, w1p + wp, SU2VertexTwoParticle::FrequencyChannel::S);
+		const SU2VertexTwoParticleAccessBuffer<n> ab2 = v4->generateAccessBuffer<n>(s, w2 + wp, w1 + wp, SU2VertexTwoParticle::FrequencyChannel::S);
+		const SU2VertexTwoParticleAccessBuffer<n> ab3 = v4->generateAccessBuffer<n>(s, -w2p - wp, w1p + wp, SU2VertexTwoParticle::FrequencyChannel::S);
 
 		v4->getValueSuperbundle(ab0, stackBuffers[0]);
 		v4->getValueSuperbundle(ab1, stackBuffers[1]);
@@ -230,13 +241,13 @@ void SU2FrgCore::_calculateVertexTwoParticle(const int iterator)
 	{
 		//RPA diagram A and B equal chalice diagram A and inverse chalice diagram B, respectively (negative sign)
 		//chalice diagram A (negative sign)
-		const SU2VertexTwoParticleAccessBuffer<4> ab0 = v4->generateAccessBuffer(w1 - wp, t, w1p + wp, SU2VertexTwoParticle::FrequencyChannel::T);
+		const SU2VertexTwoParticleAccessBuffer<n> ab0 = v4->generateAccessBuffer<n>(w1 - wp, t, w1p + wp, SU2VertexTwoParticle::FrequencyChannel::T);
 		//inverse chalice diagram B (negative sign)
-		const SU2VertexTwoParticleAccessBuffer<4> ab1 = v4->generateAccessBuffer(w2p - wp, t, -w2 - wp, SU2VertexTwoParticle::FrequencyChannel::T);
+		const SU2VertexTwoParticleAccessBuffer<n> ab1 = v4->generateAccessBuffer<n>(w2p - wp, t, -w2 - wp, SU2VertexTwoParticle::FrequencyChannel::T);
 		//chalice diagram A (negative sign)
-		const SU2VertexTwoParticleAccessBuffer<4> ab2 = v4->generateAccessBuffer(w1p + wp, t, w1 - wp, SU2VertexTwoParticle::FrequencyChannel::T);
+		const SU2VertexTwoParticleAccessBuffer<n> ab2 = v4->generateAccessBuffer<n>(w1p + wp, t, w1 - wp, SU2VertexTwoParticle::FrequencyChannel::T);
 		//inverse chalice diagram B (negative sign)
-		const SU2VertexTwoParticleAccessBuffer<4> ab3 = v4->generateAccessBuffer(w2 + wp, t, wp - w2p, SU2VertexTwoParticle::FrequencyChannel::T);
+		const SU2VertexTwoParticleAccessBuffer<n> ab3 = v4->generateAccessBuffer<n>(w2 + wp, t, wp - w2p, SU2VertexTwoParticle::FrequencyChannel::T);
 
 		v4->getValueSuperbundle(ab0, stackBuffers[0]);
 		v4->getValueSuperbundle(ab1, stackBuffers[1]);
@@ -249,9 +260,23 @@ void SU2FrgCore::_calculateVertexTwoParticle(const int iterator)
 		bufferRPA.reset();
 		for (int rid = 0; rid < FrgCommon::lattice().size; ++rid)
 		{
-			//lattice bubble
+			//lattice bubble; inactive sites remain at their bare vertex
+			if (!isSiteActive(rid)) continue;
 			const LatticeOverlap &overlap = FrgCommon::lattice().getOverlap(rid);
 
+			if (KernelTuner::overlapTraversal == KernelTuner::OverlapTraversal::Fused)
+			{
+				float valueS = 0.0f, valueD = 0.0f;
+				for (int i = 0; i < overlap.size; ++i)
+				{
+					valueS += stackBuffers[2].bundle(static_cast<int>(SU2VertexTwoParticle::Symmetry::Spin))[overlap.rid1[i]] * stackBuffers[3].bundle(static_cast<int>(SU2VertexTwoParticle::Symmetry::Spin))[overlap.rid2[i]];
+					valueD += stackBuffers[2].bundle(static_cast<int>(SU2VertexTwoParticle::Symmetry::Density))[overlap.rid1[i]] * stackBuffers[3].bundle(static_cast<int>(SU2VertexTwoParticle::Symmetry::Density))[overlap.rid2[i]];
+				}
+				bufferRPA.bundle(static_cast<int>(SU2VertexTwoParticle::Symmetry::Spin))[rid] = valueS;
+				bufferRPA.bundle(static_cast<int>(SU2VertexTwoParticle::Symmetry::Density))[rid] = valueD;
+				continue;
+			}
+
 			for (int i = 0; i < overlap.size; ++i)
 			{
 				bufferRPA.bundle(static_cast<int>(SU2VertexTwoParticle::Symmetry::Spin))[rid] += stackBuffers[2].bundle(static_cast<int>(SU2VertexTwoParticle::Symmetry::Spin))[overlap.rid1[i]] * stackBuffers[3].bundle(static_cast<int>(SU2VertexTwoParticle::Symmetry::Spin))[overlap.rid2[i]];
@@ -266,13 +291,13 @@ void SU2FrgCore::_calculateVertexTwoParticle(const int iterator)
 		returnBuffer.bundle(static_cast<int>(SU2VertexTwoParticle::Symmetry::Density)).multAdd(8.0f * spinLength, bufferRPA.bundle(static_cast<int>(SU2VertexTwoParticle::Symmetry::Density)));
 
 		//chalice diagram B (negative sign)
-		const SU2VertexTwoParticleAccessBuffer<4> ab4 = v4->generateAccessBuffer(w2p - wp, -w2 - wp, t, SU2VertexTwoParticle::FrequencyChannel::U);
+		const SU2VertexTwoParticleAccessBuffer<n> ab4 = v4->generateAccessBuffer<n>(w2p - wp, -w2 - wp, t, SU2VertexTwoParticle::FrequencyChannel::U);
 		//inverse chalice diagram A (negative sign)
-		const SU2VertexTwoParticleAccessBuffer<4> ab5 = v4->generateAccessBuffer(w1 - wp, -w1p - wp, -t, SU2VertexTwoParticle::FrequencyChannel::U);
+		const SU2VertexTwoParticleAccessBuffer<n> ab5 = v4->generateAccessBuffer<n>(w1 - wp, -w1p - wp, -t, SU2VertexTwoParticle::FrequencyChannel::U);
 		//chalice diagram B (negative sign)
-		const SU2VertexTwoParticleAccessBuffer<4> ab6 = v4->generateAccessBuffer(w2 + wp, wp - w2p, t, SU2VertexTwoParticle::FrequencyChannel::U);
+		const SU2VertexTwoParticleAccessBuffer<n> ab6 = v4->generateAccessBuffer<n>(w2 + wp, wp - w2p, t, SU2VertexTwoParticle::FrequencyChannel::U);
 		//inverse chalice diagram A (negative sign)
-		const SU2VertexTwoParticleAccessBuffer<4> ab7 = v4->generateAccessBuffer(w1p + wp, wp - w1, -t, SU2VertexTwoParticle::FrequencyChannel::U);
+		const SU2VertexTwoParticleAccessBuffer<n> ab7 = v4->generateAccessBuffer<n>(w1p + wp, wp - w1, -t, SU2VertexTwoParticle::FrequencyChannel::U);
 
 		const float valCbs = v4->getValueLocal(SU2VertexTwoParticle::Symmetry::Spin, ab4);
 		const float valCbd = v4->getValueLocal(SU2VertexTwoParticle::Symmetry::Density, ab4);
@@ -306,11 +331,11 @@ void SU2FrgCore::_calculateVertexTwoParticle(const int iterator)
 	{
 		//u-Channel, to be combined with P(wp, u + wp) + P(u + wp, wp)
 		//ph-ladder A and B, respectively (negative sign)
-		const SU2VertexTwoParticleAccessBuffer<4> ab0 = v4->generateAccessBuffer(w1 + wp, wp - w2p, u, SU2VertexTwoParticle::FrequencyChannel::U);
-		const SU2VertexTwoParticleAccessBuffer<4> ab1 = v4->generateAccessBuffer(w1p + wp, w2 - wp, u, SU2VertexTwoParticle::FrequencyChannel::U);
+		const SU2VertexTwoParticleAccessBuffer<n> ab0 = v4->generateAccessBuffer<n>(w1 + wp, wp - w2p, u, SU2VertexTwoParticle::FrequencyChannel::U);
+		const SU2VertexTwoParticleAccessBuffer<n> ab1 = v4->generateAccessBuffer<n>(w1p + wp, w2 - wp, u, SU2VertexTwoParticle::FrequencyChannel::U);
 		//ph-ladder A and B, respectively (negative sign)
-		const SU2VertexTwoParticleAccessBuffer<4> ab2 = v4->generateAccessBuffer(w2p - wp, -w1 - wp, u, SU2VertexTwoParticle::FrequencyChannel::U);
-		const SU2VertexTwoParticleAccessBuffer<4> ab3 = v4->generateAccessBuffer(w2 - wp, w1p + wp, u, SU2VertexTwoParticle::FrequencyChannel::U);
+		const SU2VertexTwoParticleAccessBuffer<n> ab2 = v4->generateAccessBuffer<n>(w2p - wp, -w1 - wp, u, SU2VertexTwoParticle::FrequencyChannel::U);
+		const SU2VertexTwoParticleAccessBuffer<n> ab3 = v4->generateAccessBuffer<n>(w2 - wp, w1p + wp, u, SU2VertexTwoParticle::FrequencyChannel::U);
 
 		v4->getValueSuperbundle(ab0, stackBuffers[0]);
 		v4->getValueSuperbundle(ab1, stackBuffers[1]);
@@ -426,6 +451,6 @@ void SU2FrgCore::_calculateVertexTwoParticle(const int iterator)
 	//prefactor
 	v4CurrentValue /= 2.0f * (float)M_PI;
 
-	for (int rid = 0; rid < FrgCommon::lattice().size; ++rid) static_cast<SU2EffectiveAction *>(_flow)->vertexTwoParticle->_dataSS[iterator * FrgCommon::lattice().size + rid] = v4CurrentValue.bundle(static_cast<int>(SU2VertexTwoParticle::Symmetry::Spin))[rid];
-	for (int rid = 0; rid < FrgCommon::lattice().size; ++rid) static_cast<SU2EffectiveAction *>(_flow)->vertexTwoParticle->_dataDD[iterator * FrgCommon::lattice().size + rid] = v4CurrentValue.bundle(static_cast<int>(SU2VertexTwoParticle::Symmetry::Density))[rid];
+	for (int rid = 0; rid < FrgCommon::lattice().size; ++rid) static_cast<SU2EffectiveAction *>(_flow)->vertexTwoParticle->_dataSS[iterator * FrgCommon::lattice().size + rid] = (isSiteActive(rid)) ? v4CurrentValue.bundle(static_cast<int>(SU2VertexTwoParticle::Symmetry::Spin))[rid] : 0.0f;
+	for (int rid = 0; rid < FrgCommon::lattice().size; ++rid) static_cast<SU2EffectiveAction *>(_flow)->vertexTwoParticle->_dataDD[iterator * FrgCommon::lattice().size + rid] = (isSiteActive(rid)) ? v4CurrentValue.bundle(static_cast<int>(SU2VertexTwoParticle::Symmetry::Density))[rid] : 0.0f;
 }
\ No newline at end of file
@@ -41,6 +41,13 @@ public:
 	 */
 	void finalizeStep(const float newCutoff) override;
 
+	/**
+	 * @brief Select the fastest variants of the kernels which compute the flow of the two-particle vertex. 
+	 * 
+	 * @param tuner Kernel tuner. 
+	 */
+	void tuneKernels(KernelTuner &tuner) override;
+
 	float spinLength; ///< Value of S, determining the spin length. 
 	float normalization; ///< Energy normalization factor. 
 
@@ -57,7 +64,8 @@ private:
 	/**
 	 * @brief Calculate the two-particle vertex flow for a specific linear iterator, which is expanded via SU2VertexTwoParticle::expandIterator().
 	 * 
+	 * @tparam n Number of support values in the frequency interpolation of vertices. Either 4 for linear or 16 for cubic interpolation. 
 	 * @param iterator Linear iterator. 
 	 */
-	void _calculateVertexTwoParticle(const int iterator);
+	template <int n> void _calculateVertexTwoParticle(const int iterator);
 };
\ No newline at end of file
@@ -19,9 +19,9 @@
 SU2MeasurementCorrelation::SU2MeasurementCorrelation(const std::string &outfile, const float minCutoff, const float maxCutoff, const bool defer) : Measurement(outfile, minCutoff, maxCutoff, defer, true)
 {
 	_currentCutoff = -1.0f;
-	int latticeSizeExtended = 0;
-	for (auto i = FrgCommon::lattice().getRange(0); i != FrgCommon::lattice().end(); ++i) ++latticeSizeExtended;
+	int latticeSizeExtended = FrgCommon::lattice().getRangeIds(0).size();
 	int latticeSizeBasis = int(FrgCommon::lattice()._basis.size());
+	_memoryStepLattice = latticeSizeBasis * latticeSizeExtended;
 
 	//prepare correlation buffer
 	_correlationsZZ = new float[latticeSizeBasis * latticeSizeExtended];
@@ -69,11 +69,64 @@ void SU2MeasurementCorrelation::takeMeasurement(const EffectiveAction &state, co
 
 	if (isMasterTask)
 	{
-		_writeOutfileCorrelation("SU2CorZZ", _correlationsZZ);
-		_writeOutfileCorrelation("SU2CorDD", _correlationsDD);
+		if (FrgCommon::lattice().hasSublatticeRotation())
+		{
+			//undo the sublattice spin rotation and write correlations in the frame of the original spin model
+			const std::string componentNames[3] = { "X", "Y", "Z" };
+			float *buffer = new float[_memoryStepLattice];
+			for (int a = 0; a < 3; ++a)
+			{
+				for (int b = 0; b < 3; ++b)
+				{
+					int offset = 0;
+					LatticeIdRange basis = FrgCommon::lattice().getBasisIds();
+					for (int nb = 0; nb < basis.size(); ++nb)
+					{
+						int i = basis[nb];
+						for (int j : FrgCommon::lattice().getRangeIds(nb))
+						{
+							SpinComponent component1 = static_cast<SpinComponent>(a);
+							SpinComponent component2 = static_cast<SpinComponent>(b);
+							float sign = FrgCommon::lattice().sublatticeRotation(i, component1) * FrgCommon::lattice().sublatticeRotation(j, component2);
+							buffer[offset] = (component1 == component2) ? sign * _correlationsZZ[offset] : 0.0f;
+							++offset;
+						}
+					}
+					_writeOutfileCorrelation("TRICor" + componentNames[a] + componentNames[b], buffer);
+				}
+			}
+			_writeOutfileCorrelation("TRICorDD", _correlationsDD);
+			delete[] buffer;
+		}
+		else
+		{
+			_writeOutfileCorrelation("SU2CorZZ", _correlationsZZ);
+			_writeOutfileCorrelation("SU2CorDD", _correlationsDD);
+		}
 	}
 }
 
+std::vector<float> SU2MeasurementCorrelation::observables() const
+{
+	std::vector<float> correlations;
+	correlations.insert(correlations.end(), _correlationsZZ, _correlationsZZ + _memoryStepLattice);
+	correlations.insert(correlations.end(), _correlationsDD, _correlationsDD + _memoryStepLattice);
+	return correlations;
+}
+
+std::vector<Measurement::Observable> SU2MeasurementCorrelation::observableBuffers() const
+{
+	return {
+		{ "SU2CorZZ", _correlationsZZ, _memoryStepLattice },
+		{ "SU2CorDD", _correlationsDD, _memoryStepLattice }
+	};
+}
+
+bool SU2MeasurementCorrelation::isCalculated(const EffectiveAction &state) const
+{
+	return _currentCutoff == state.cutoff;
+}
+
 void SU2MeasurementCorrelation::_calculateCorrelation(const int iterator) const
 {
 	//calculate real space susceptibility
@@ -159,9 +212,11 @@ void SU2MeasurementCorrelation::_calculateCorrelation(const int iterator) const
 	}
 
 	int offset = iterator * _memoryStepLattice;
-	for (auto i = FrgCommon::lattice().getBasis(); i != FrgCommon::lattice().end(); ++i)
+	LatticeIdRange basis = FrgCommon::lattice().getBasisIds();
+	for (int nb = 0; nb < basis.size(); ++nb)
 	{
-		for (auto j = FrgCommon::lattice().getRange(i); j != FrgCommon::lattice().end(); ++j)
+		int i = basis[nb];
+		for (int j : FrgCommon::lattice().getRangeIds(nb))
 		{
 			int rid;
 
@@ -219,7 +274,7 @@ void SU2MeasurementCorrelation::_writeOutfileHeader(const std::string &observabl
 		//write basis
 		float *basisBuffer = new float[3 * FrgCommon::lattice()._basis.size()];
 		i = 0;
-		for (auto b = FrgCommon::lattice().getBasis(); b != FrgCommon::lattice().end(); ++b)
+		for (int b : FrgCommon::lattice().getBasisIds())
 		{
 			basisBuffer[3 * i] = float(FrgCommon::lattice().getSitePosition(b).x);
 			basisBuffer[3 * i + 1] = float(FrgCommon::lattice().getSitePosition(b).y);
@@ -236,8 +291,7 @@ void SU2MeasurementCorrelation::_writeOutfileHeader(const std::string &observabl
 		delete[] basisBuffer;
 
 		//write sites
-		int inRangeCount = 0;
-		for (SublatticeIterator i = FrgCommon::lattice().getRange(0); i != FrgCommon::lattice().end(); ++i) ++inRangeCount;
+		int inRangeCount = FrgCommon::lattice().getRangeIds(0).size();
 
 		const int dataSpaceDimSitesReference = 2;
 		const hsize_t dataSpaceSizeSitesReference[dataSpaceDimSitesReference] = { FrgCommon::lattice()._basis.size(), hsize_t(inRangeCount) };
@@ -247,7 +301,7 @@ void SU2MeasurementCorrelation::_writeOutfileHeader(const std::string &observabl
 		int j = 0;
 		for (unsigned int b = 0; b < FrgCommon::lattice()._basis.size(); ++b)
 		{
-			for (SublatticeIterator i = FrgCommon::lattice().getRange(b); i != FrgCommon::lattice().end(); ++i)
+			for (int i : FrgCommon::lattice().getRangeIds(b))
 			{
 				*(SitesReferenceBuffer + 3 * j) = (float)FrgCommon::lattice().getSitePosition(i).x;
 				*(SitesReferenceBuffer + 3 * j + 1) = (float)FrgCommon::lattice().getSitePosition(i).y;
@@ -335,8 +389,7 @@ void SU2MeasurementCorrelation::_writeOutfileCorrelation(const std::string &obse
 	H5Sclose(attrSpace);
 
 	//write data
-	int inRangeCount = 0;
-	for (SublatticeIterator i = FrgCommon::lattice().getRange(0); i != FrgCommon::lattice().end(); ++i) ++inRangeCount;
+	int inRangeCount = FrgCommon::lattice().getRangeIds(0).size();
 	const int dataSpaceDim = 2;
 	const hsize_t dataSpaceSize[2] = { FrgCommon::lattice()._basis.size(), hsize_t(inRangeCount) };
 	hid_t dataSpace = H5Screate_simple(dataSpaceDim, dataSpaceSize, NULL);
@@ -65,7 +65,7 @@ public:
 	}
 
 	/**
-	 * @brief Access vertex value at arbitrary frequency value by performing a linear interpolation on the FrequencyDiscretization. 
+	 * @brief Access vertex value at arbitrary frequency value by performing an interpolation on the FrequencyDiscretization. 
 	 * 
 	 * @param w Frequency argument. 
 	 * @return float Vertex value. 
@@ -82,6 +82,14 @@ public:
 			sign = -1.0f;
 		}
 
+		if (FrgCommon::frequency().interpolation == FrequencyDiscretization::Interpolation::Cubic)
+		{
+			int offsets[4];
+			float weights[4];
+			FrgCommon::frequency().interpolateStencil<4>(w, offsets, weights);
+			return sign * (weights[0] * _directAccess(offsets[0]) + weights[1] * _directAccess(offsets[1]) + weights[2] * _directAccess(offsets[2]) + weights[3] * _directAccess(offsets[3]));
+		}
+
 		FrgCommon::frequency().interpolateOffset(w, lower, upper, bias);
 		return sign * ((1 - bias) * _directAccess(lower) + bias * _directAccess(upper));
 	}
@@ -11,6 +11,7 @@
 #include "lib/ValueBundle.hpp"
 #include "lib/Assert.hpp"
 #include "FrgCommon.hpp"
+#include "KernelTuner.hpp"
 
 /**
  * @brief Buffer for frequency interpolation information. 
@@ -77,8 +78,15 @@ public:
 		//alloc and init memory
 		_dataSS = new float[size];
 		_dataDD = new float[size];
-		memset(_dataSS, 0, sizeof(float) * size);
-		memset(_dataDD, 0, sizeof(float) * size);
+		//first touch in parallel, such that memory pages are placed close to the threads which compute the flow
+		#ifndef DISABLE_OMP
+		#pragma omp parallel for schedule(static)
+		#endif
+		for (int i = 0; i < size; ++i)
+		{
+			_dataSS[i] = 0.0f;
+			_dataDD[i] = 0.0f;
+		}
 	}
 
 	/**
@@ -184,6 +192,13 @@ public:
 	 */
 	float getValue(LatticeIterator i1, LatticeIterator i2, float s, float t, float u, const SU2VertexTwoParticle::Symmetry symmetry, const SU2VertexTwoParticle::FrequencyChannel channel) const
 	{
+		//higher-order interpolation is performed via access buffers
+		if (FrgCommon::frequency().interpolation == FrequencyDiscretization::Interpolation::Cubic && channel != SU2VertexTwoParticle::FrequencyChannel::All)
+		{
+			if (channel == SU2VertexTwoParticle::FrequencyChannel::None) return getValue(i1, i2, symmetry, generateAccessBuffer<64>(s, t, u));
+			else return getValue(i1, i2, symmetry, generateAccessBuffer<16>(s, t, u, channel));
+		}
+
 		//map to positive frequency sector
 		if (s < 0 && u < 0)
 		{
@@ -371,6 +386,26 @@ public:
 		superbundle.reset();
 		const LatticeSiteDescriptor *sites = (accessBuffer.siteExchange) ? FrgCommon::lattice().getInvertedSites() : FrgCommon::lattice().getSites();
 
+		if (KernelTuner::gatherOrder == KernelTuner::GatherOrder::SiteMajor)
+		{
+			int size = FrgCommon::lattice().size;
+			for (int j = 0; j < size; ++j)
+			{
+				const float *spin = _dataSS + sites[j].rid;
+				const float *density = _dataDD + sites[j].rid;
+
+				float valueS = 0.0f, valueD = 0.0f;
+				for (int i = 0; i < n; ++i)
+				{
+					valueS += accessBuffer.frequencyWeights[i] * spin[accessBuffer.frequencyOffsets[i]];
+					valueD += accessBuffer.signFlag[i] * accessBuffer.frequencyWeights[i] * density[accessBuffer.frequencyOffsets[i]];
+				}
+				superbundle.bundle(0)[j] = valueS;
+				superbundle.bundle(1)[j] = valueD;
+			}
+			return;
+		}
+
 		for (int i = 0; i < n; ++i)
 		{
 			float weight = accessBuffer.frequencyWeights[i];
@@ -390,17 +425,21 @@ public:
 	 * @brief Generate an access buffer for a set of frequencies where one of them (specified by channel) exactly lies on the frequency mesh. 
 	 * Frequency channel must be either FrequencyChannel::S, FrequencyChannel::T, FrequencyChannel::U. 
 	 * 
+	 * @tparam n Number of support values. Either 4 for linear or 16 for cubic interpolation. 
 	 * @param s First frequency argument. 
 	 * @param t Second frequency argument. 
 	 * @param u Third frequency argument. 
 	 * @param channel Frequency channel. 
-	 * @return SU2VertexTwoParticleAccessBuffer<4> Access buffer. 
+	 * @return SU2VertexTwoParticleAccessBuffer<n> Access buffer. 
 	 */
-	SU2VertexTwoParticleAccessBuffer<4> generateAccessBuffer(float s, float t, float u, const SU2VertexTwoParticle::FrequencyChannel channel) const
+	template <int n = 4> SU2VertexTwoParticleAccessBuffer<n> generateAccessBuffer(float s, float t, float u, const SU2VertexTwoParticle::FrequencyChannel channel) const
 	{
 		ASSERT(channel == FrequencyChannel::S || channel == FrequencyChannel::T || channel == FrequencyChannel::U);
 
-		SU2VertexTwoParticleAccessBuffer<4> accessBuffer;
+		static_assert(n == 4 || n == 16, "Access buffer must hold either 4 or 16 support values");
+		constexpr int k = (n == 16) ? 4 : 2;
+
+		SU2VertexTwoParticleAccessBuffer<n> accessBuffer;
 
 		//map to positive frequency sector
 		if (s < 0 && u < 0)
@@ -430,60 +469,53 @@ public:
 		if (channel == SU2VertexTwoParticle::FrequencyChannel::S)
 		{
 			int exactS = FrgCommon::frequency().offset(s);
-			int lowerT, upperT;
-			float biasT;
-			int lowerU, upperU;
-			float biasU;
-			FrgCommon::frequency().interpolateOffset(t, lowerT, upperT, biasT);
-			FrgCommon::frequency().interpolateOffset(u, lowerU, upperU, biasU);
+			int offsetsT[k], offsetsU[k];
+			float weightsT[k], weightsU[k];
+			FrgCommon::frequency().interpolateStencil<k>(t, offsetsT, weightsT);
+			FrgCommon::frequency().interpolateStencil<k>(u, offsetsU, weightsU);
 
-			accessBuffer.frequencyWeights[0] = (1 - biasU) * (1 - biasT);
-			accessBuffer.frequencyOffsets[0] = _generateAccessBufferOffset(exactS, lowerT, lowerU, accessBuffer.signFlag[0]);
-			accessBuffer.frequencyWeights[1] = (1 - biasU) * biasT;
-			accessBuffer.frequencyOffsets[1] = _generateAccessBufferOffset(exactS, upperT, lowerU, accessBuffer.signFlag[1]);
-			accessBuffer.frequencyWeights[2] = biasU * (1 - biasT);
-			accessBuffer.frequencyOffsets[2] = _generateAccessBufferOffset(exactS, lowerT, upperU, accessBuffer.signFlag[2]);
-			accessBuffer.frequencyWeights[3] = biasU * biasT;
-			accessBuffer.frequencyOffsets[3] = _generateAccessBufferOffset(exactS, upperT, upperU, accessBuffer.signFlag[3]);
+			for (int j = 0; j < k; ++j)
+			{
+				for (int i = 0; i < k; ++i)
+				{
+					accessBuffer.frequencyWeights[k * j + i] = weightsU[j] * weightsT[i];
+					accessBuffer.frequencyOffsets[k * j + i] = _generateAccessBufferOffset(exactS, offsetsT[i], offsetsU[j], accessBuffer.signFlag[k * j + i]);
+				}
+			}
 		}
 		else if (channel == SU2VertexTwoParticle::FrequencyChannel::T)
 		{
 			int exactT = FrgCommon::frequency().offset(t);
-			int lowerS, upperS;
-			float biasS;
-			int lowerU, upperU;
-			float biasU;
-			FrgCommon::frequency().interpolateOffset(s, lowerS, upperS, biasS);
-			FrgCommon::frequency().interpolateOffset(u, lowerU, upperU, biasU);
-
-			accessBuffer.frequencyWeights[0] = (1 - biasU) * (1 - biasS);
-			accessBuffer.frequencyOffsets[0] = _generateAccessBufferOffset(lowerS, exactT, lowerU, accessBuffer.signFlag[0]);
-			accessBuffer.frequencyWeights[1] = (1 - biasU) * biasS;
-			accessBuffer.frequencyOffsets[1] = _generateAccessBufferOffset(upperS, exactT, lowerU, accessBuffer.signFlag[1]);
-			accessBuffer.frequencyWeights[2] = biasU * (1 - biasS);
-			accessBuffer.frequencyOffsets[2] = _generateAccessBufferOffset(lowerS, exactT, upperU, accessBuffer.signFlag[2]);
-			accessBuffer.frequencyWeights[3] = biasU * biasS;
-			accessBuffer.frequencyOffsets[3] = _generateAccessBufferOffset(upperS, exactT, upperU, accessBuffer.signFlag[3]);
+			int offsetsS[k], offsetsU[k];
+			float weightsS[k], weightsU[k];
+			FrgCommon::frequency().interpolateStencil<k>(s, offsetsS, weightsS);
+			FrgCommon::frequency().interpolateStencil<k>(u, offsetsU, weightsU);
 
+			for (int j = 0; j < k; ++j)
+			{
+				for (int i = 0; i < k; ++i)
+				{
+					accessBuffer.frequencyWeights[k * j + i] = weightsU[j] * weightsS[i];
+					accessBuffer.frequencyOffsets[k * j + i] = _generateAccessBufferOffset(offsetsS[i], exactT, offsetsU[j], accessBuffer.signFlag[k * j + i]);
+				}
+			}
 		}
 		else if (channel == SU2VertexTwoParticle::FrequencyChannel::U)
 		{
 			int exactU = FrgCommon::frequency().offset(u);
-			int lowerS, upperS;
-			float biasS;
-			int lowerT, upperT;
-			float biasT;
-			FrgCommon::frequency().interpolateOffset(s, lowerS, upperS, biasS);
-			FrgCommon::frequency().interpolateOffset(t, lowerT, upperT, biasT);
+			int offsetsS[k], offsetsT[k];
+			float weightsS[k], weightsT[k];
+			FrgCommon::frequency().interpolateStencil<k>(s, offsetsS, weightsS);
+			FrgCommon::frequency().interpolateStencil<k>(t, offsetsT, weightsT);
 
-			accessBuffer.frequencyWeights[0] = (1 - biasT) * (1 - biasS);
-			accessBuffer.frequencyOffsets[0] = _generateAccessBufferOffset(lowerS, lowerT, exactU, accessBuffer.signFlag[0]);
-			accessBuffer.frequencyWeights[1] = (1 - biasT) * biasS;
-			accessBuffer.frequencyOffsets[1] = _generateAccessBufferOffset(upperS, lowerT, exactU, accessBuffer.signFlag[1]);
-			accessBuffer.frequencyWeights[2] = biasT * (1 - biasS);
-			accessBuffer.frequencyOffsets[2] = _generateAccessBufferOffset(lowerS, upperT, exactU, accessBuffer.signFlag[2]);
-			accessBuffer.frequencyWeights[3] = biasT * biasS;
-			accessBuffer.frequencyOffsets[3] = _generateAccessBufferOffset(upperS, upperT, exactU, accessBuffer.signFlag[3]);
+			for (int j = 0; j < k; ++j)
+			{
+				for (int i = 0; i < k; ++i)
+				{
+					accessBuffer.frequencyWeights[k * j + i] = weightsT[j] * weightsS[i];
+					accessBuffer.frequencyOffsets[k * j + i] = _generateAccessBufferOffset(offsetsS[i], offsetsT[j], exactU, accessBuffer.signFlag[k * j + i]);
+				}
+			}
 		}
 
 		return accessBuffer;
@@ -492,14 +524,18 @@ public:
 	/**
 	 * @brief Generate an access buffer for an arbitrary set of frequencies.  
 	 * 
+	 * @tparam n Number of support values. Either 8 for linear or 64 for cubic interpolation. 
 	 * @param s First frequency argument. 
 	 * @param t Second frequency argument. 
 	 * @param u Third frequency argument. 
-	 * @return SU2VertexTwoParticleAccessBuffer<8> Access buffer. 
+	 * @return SU2VertexTwoParticleAccessBuffer<n> Access buffer. 
 	 */
-	SU2VertexTwoParticleAccessBuffer<8> generateAccessBuffer(float s, float t, float u) const
+	template <int n = 8> SU2VertexTwoParticleAccessBuffer<n> generateAccessBuffer(float s, float t, float u) const
 	{
-		SU2VertexTwoParticleAccessBuffer<8> accessBuffer;
+		static_assert(n == 8 || n == 64, "Access buffer must hold either 8 or 64 support values");
+		constexpr int k = (n == 64) ? 4 : 2;
+
+		SU2VertexTwoParticleAccessBuffer<n> accessBuffer;
 
 		//map to positive frequency sector
 		if (s < 0 && u < 0)
@@ -525,33 +561,24 @@ public:
 			t = -t;
 		}
 
-		int lowerS, upperS;
-		float biasS;
-		int lowerT, upperT;
-		float biasT;
-		int lowerU, upperU;
-		float biasU;
-
-		FrgCommon::frequency().interpolateOffset(s, lowerS, upperS, biasS);
-		FrgCommon::frequency().interpolateOffset(t, lowerT, upperT, biasT);
-		FrgCommon::frequency().interpolateOffset(u, lowerU, upperU, biasU);
-
-		accessBuffer.frequencyWeights[0] = (1 - biasT) * (1 - biasS) * (1 - biasU);
-		accessBuffer.frequencyOffsets[0] = _generateAccessBufferOffset(lowerS, lowerT, lowerU, accessBuffer.signFlag[0]);
-		accessBuffer.frequencyWeights[1] = (1 - biasT) * biasS * (1 - biasU);
-		accessBuffer.frequencyOffsets[1] = _generateAccessBufferOffset(upperS, lowerT, lowerU, accessBuffer.signFlag[1]);
-		accessBuffer.frequencyWeights[2] = biasT * (1 - biasS) * (1 - biasU);
-		accessBuffer.frequencyOffsets[2] = _generateAccessBufferOffset(lowerS, upperT, lowerU, accessBuffer.signFlag[2]);
-		accessBuffer.frequencyWeights[3] = biasT * biasS * (1 - biasU);
-		accessBuffer.frequencyOffsets[3] = _generateAccessBufferOffset(upperS, upperT, lowerU, accessBuffer.signFlag[3]);
-		accessBuffer.frequencyWeights[4] = (1 - biasT) * (1 - biasS) * biasU;
-		accessBuffer.frequencyOffsets[4] = _generateAccessBufferOffset(lowerS, lowerT, upperU, accessBuffer.signFlag[4]);
-		accessBuffer.frequencyWeights[5] = (1 - biasT) * biasS * biasU;
-		accessBuffer.frequencyOffsets[5] = _generateAccessBufferOffset(upperS, lowerT, upperU, accessBuffer.signFlag[5]);
-		accessBuffer.frequencyWeights[6] = biasT * (1 - biasS) * biasU;
-		accessBuffer.frequencyOffsets[6] = _generateAccessBufferOffset(lowerS, upperT, upperU, accessBuffer.signFlag[6]);
-		accessBuffer.frequencyWeights[7] = biasT * biasS * biasU;
-		accessBuffer.frequencyOffsets[7] = _generateAccessBufferOffset(upperS, upperT, upperU, accessBuffer.signFlag[7]);
+		int offsetsS[k], offsetsT[k], offsetsU[k];
+		float weightsS[k], weightsT[k], weightsU[k];
+
+		FrgCommon::frequency().interpolateStencil<k>(s, offsetsS, weightsS);
+		FrgCommon::frequency().interpolateStencil<k>(t, offsetsT, weightsT);
+		FrgCommon::frequency().interpolateStencil<k>(u, offsetsU, weightsU);
+
+		for (int l = 0; l < k; ++l)
+		{
+			for (int j = 0; j < k; ++j)
+			{
+				for (int i = 0; i < k; ++i)
+				{
+					accessBuffer.frequencyWeights[k * k * l + k * j + i] = weightsT[j] * weightsS[i] * weightsU[l];
+					accessBuffer.frequencyOffsets[k * k * l + k * j + i] = _generateAccessBufferOffset(offsetsS[i], offsetsT[j], offsetsU[l], accessBuffer.signFlag[k * k * l + k * j + i]);
+				}
+			}
+		}
 
 		return accessBuffer;
 	}
@@ -0,0 +1,121 @@
+/**
+ * @file Solver.cpp
+ * @author Finn Lasse Buessen
+ * @brief Embeddable interface to the pf-FRG solver. 
+ * 
+ * @copyright Copyright (c) 2020
+ */
+
+#include <cstdlib>
+#include "lib/Exception.hpp"
+#include "Solver.hpp"
+#include "SpinParser.hpp"
+#include "FrgCore.hpp"
+#ifndef DISABLE_MPI
+#include "mpi.h"
+#endif
+
+bool Solver::_isActive = false;
+
+Solver::Solver(const std::vector<std::string> &arguments) : _isFinished(false), _isFlowing(false)
+{
+	if (_isActive) throw Exception(Exception::Type::InitializationError, "Only a single solver may exist at any time.");
+
+	//init MPI, unless the host application has done so already
+	#ifndef DISABLE_MPI
+	int isInitialized;
+	MPI_Initialized(&isInitialized);
+	if (!isInitialized)
+	{
+		int status = MPI_Init(nullptr, nullptr);
+		if (status != MPI_SUCCESS) throw Exception(Exception::Type::MpiError, status);
+		std::atexit([]() { MPI_Finalize(); });
+	}
+	#endif
+
+	//set up task
+	std::vector<char *> argv;
+	for (auto &a : arguments) argv.push_back(const_cast<char *>(a.c_str()));
+	argv.push_back(nullptr);
+	_isActive = true;
+	try
+	{
+		if (!SpinParser::spinParser()->initialize(int(arguments.size()), argv.data())) _isFinished = true;
+	}
+	catch (...)
+	{
+		SpinParser::spinParser()->release();
+		_isActive = false;
+		throw;
+	}
+}
+
+Solver::~Solver()
+{
+	SpinParser::spinParser()->release();
+	_isActive = false;
+}
+
+bool Solver::step()
+{
+	if (_isFinished) return false;
+
+	SpinParser *spinParser = SpinParser::spinParser();
+	ComputationStatus::Identifier status = spinParser->getComputationStatus().statusIdentifier;
+	if (status == ComputationStatus::Identifier::New || status == ComputationStatus::Identifier::Running)
+	{
+		if (!_isFlowing)
+		{
+			spinParser->beginFlow();
+			_isFlowing = true;
+		}
+		if (!spinParser->stepFlow())
+		{
+			spinParser->endFlow();
+			_isFlowing = false;
+			_isFinished = spinParser->getComputationStatus().statusIdentifier == ComputationStatus::Identifier::Finished;
+		}
+	}
+	else
+	{
+		spinParser->runCore();
+		_isFinished = true;
+	}
+	return !_isFinished;
+}
+
+void Solver::run()
+{
+	while (step());
+}
+
+bool Solver::isFinished() const
+{
+	return _isFinished;
+}
+
+float Solver::cutoff() const
+{
+	return SpinParser::spinParser()->getFrgCore()->flowingFunctional()->cutoff;
+}
+
+std::vector<Measurement::Observable> Solver::observables() const
+{
+	std::vector<Measurement::Observable> observables;
+	for (auto m : SpinParser::spinParser()->getFrgCore()->measurements())
+	{
+		std::vector<Measurement::Observable> o = m->observableBuffers();
+		observables.insert(observables.end(), o.begin(), o.end());
+	}
+	return observables;
+}
+
+void Solver::writeCheckpoint()
+{
+	if (!_isFlowing) return;
+
+	SpinParser *spinParser = SpinParser::spinParser();
+	spinParser->_computationStatus.checkpointTime = Timestamp::time();
+	spinParser->_computationStatus.statusIdentifier = ComputationStatus::Identifier::Running;
+	spinParser->writeCheckpoint();
+}
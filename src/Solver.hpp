@@ -0,0 +1,87 @@
+/**
+ * @file Solver.hpp
+ * @author Finn Lasse Buessen
+ * @brief Embeddable interface to the pf-FRG solver. 
+ * 
+ * @copyright Copyright (c) 2020
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include "Measurement.hpp"
+
+/**
+ * @brief Embeddable interface to the pf-FRG solver. 
+ * @details The Solver provides in-process access to the functionality of the SpinParser executable: 
+ * A task is constructed from a task file and a list of command line arguments, after which the flow equations can be solved step by step. 
+ * After each step, the results of the most recent measurements are accessible in memory via Solver::observables(), without reading back the observable files. 
+ * Output files, checkpoints, and postprocessing behave exactly as for the executable. 
+ * 
+ * The solver operates on the SpinParser singleton and its global state (see FrgCommon), such that at most one Solver may exist at any time. 
+ * Destroying the Solver releases the task, after which a new Solver can be constructed in the same process. 
+ * If MPI has not been initialized by the host application, it is initialized upon construction of the first Solver and finalized on program exit. 
+ */
+class Solver
+{
+public:
+	/**
+	 * @brief Construct a new Solver object and set up the task. 
+	 * 
+	 * @param arguments Command line arguments, with the same syntax as for the SpinParser executable. The first argument is the program path, which serves as the reference for the default resource path. 
+	 */
+	Solver(const std::vector<std::string> &arguments);
+
+	/**
+	 * @brief Destroy the Solver object and release the task. 
+	 */
+	~Solver();
+
+	/**
+	 * @brief Compute a single cutoff step, including all measurements which are due. 
+	 * @details Once the last cutoff step has been computed, or the flow has diverged, the calculation is finalized as for the executable, i.e. the final measurement is taken, the refinement pass is performed, and the final checkpoint is written. 
+	 * If the task is in the postprocessing stage, all postprocessing measurements are performed in a single step. 
+	 * 
+	 * @return bool Return true if more steps remain to be computed, return false if the task has finished. 
+	 */
+	bool step();
+
+	/**
+	 * @brief Compute all remaining cutoff steps. 
+	 */
+	void run();
+
+	/**
+	 * @brief Query whether the task has finished. 
+	 * 
+	 * @return bool Return true if no more steps remain to be computed, return false otherwise. 
+	 */
+	bool isFinished() const;
+
+	/**
+	 * @brief Retrieve the current value of the RG cutoff. 
+	 * 
+	 * @return float Cutoff. 
+	 */
+	float cutoff() const;
+
+	/**
+	 * @brief Retrieve the result buffers of all measurements. 
+	 * @details The buffers are owned by the measurement protocols. They hold the result of the most recent measurement and remain valid until the Solver is destroyed. 
+	 * 
+	 * @return std::vector<Measurement::Observable> List of result buffers. 
+	 */
+	std::vector<Measurement::Observable> observables() const;
+
+	/**
+	 * @brief Write the current state of the flow to the checkpoint file, such that the task can be continued by the executable or by a new Solver. 
+	 * @details Has no effect unless the solution of the flow equations is in progress. 
+	 */
+	void writeCheckpoint();
+
+private:
+	bool _isFinished; ///< Set to true if no more steps remain to be computed.
+	bool _isFlowing; ///< Set to true if the solution of the flow equations has begun.
+
+	static bool _isActive; ///< Set to true while a Solver exists.
+};
@@ -0,0 +1,112 @@
+/**
+ * @file SolverBindings.cpp
+ * @author Finn Lasse Buessen
+ * @brief C bindings of the Solver interface, which are exported by the shared SpinParser library. 
+ * @details The bindings are used by the Python module spinparser.solver via ctypes. 
+ * Functions which can fail return a negative value or a null pointer, in which case the error message can be retrieved via spinparser_error(). 
+ * 
+ * @copyright Copyright (c) 2020
+ */
+
+#include <string>
+#include <vector>
+#include <exception>
+#include <dlfcn.h>
+#include "Solver.hpp"
+
+namespace
+{
+	std::string lastError; ///< Message of the most recent error.
+	std::vector<Measurement::Observable> observables; ///< Result buffers retrieved by the most recent call to spinparser_solver_observables().
+
+	//path of the shared library, which serves as the reference for the default resource path
+	std::string libraryPath()
+	{
+		Dl_info info;
+		if (dladdr(reinterpret_cast<void *>(&libraryPath), &info) != 0 && info.dli_fname != nullptr) return std::string(info.dli_fname);
+		return "SpinParser";
+	}
+}
+
+extern "C"
+{
+	const char *spinparser_error()
+	{
+		return lastError.c_str();
+	}
+
+	void *spinparser_solver_new(const int argc, const char **argv)
+	{
+		try
+		{
+			std::vector<std::string> arguments({ libraryPath() });
+			for (int i = 0; i < argc; ++i) arguments.push_back(argv[i]);
+			return new Solver(arguments);
+		}
+		catch (std::exception &e)
+		{
+			lastError = e.what();
+			return nullptr;
+		}
+	}
+
+	void spinparser_solver_delete(void *solver)
+	{
+		observables.clear();
+		delete static_cast<Solver *>(solver);
+	}
+
+	int spinparser_solver_step(void *solver)
+	{
+		try
+		{
+			return static_cast<Solver *>(solver)->step() ? 1 : 0;
+		}
+		catch (std::exception &e)
+		{
+			lastError = e.what();
+			return -1;
+		}
+	}
+
+	int spinparser_solver_is_finished(void *solver)
+	{
+		return static_cast<Solver *>(solver)->isFinished() ? 1 : 0;
+	}
+
+	float spinparser_solver_cutoff(void *solver)
+	{
+		return static_cast<Solver *>(solver)->cutoff();
+	}
+
+	int spinparser_solver_observables(void *solver)
+	{
+		observables = static_cast<Solver *>(solver)->observables();
+		return int(observables.size());
+	}
+
+	const char *spinparser_solver_observable_name(const int n)
+	{
+		return observables[n].name.c_str();
+	}
+
+	const float *spinparser_solver_observable_data(const int n, int *size)
+	{
+		*size = observables[n].size;
+		return observables[n].data;
+	}
+
+	int spinparser_solver_write_checkpoint(void *solver)
+	{
+		try
+		{
+			static_cast<Solver *>(solver)->writeCheckpoint();
+			return 0;
+		}
+		catch (std::exception &e)
+		{
+			lastError = e.what();
+			return -1;
+		}
+	}
+}
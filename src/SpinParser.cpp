@@ -6,6 +6,10 @@
  * @copyright Copyright (c) 2020
  */
 
+#include <set>
+#include <cmath>
+#include <algorithm>
+#include <hdf5.h>
 #include <boost/filesystem.hpp>
 #include "SpinParser.hpp"
 #include "CommandLineOptions.hpp"
@@ -40,6 +44,10 @@ SpinParser::SpinParser()
 	_commandLineOptions = nullptr;
 	_taskFileParser = nullptr;
 	_loadManager = HMP::newLoadManager();
+	_flowProfiler = new FlowProfiler();
+	_kernelTuner = new KernelTuner();
+	_energyMeter = new EnergyMeter();
+	_startupPipeline = new StartupPipeline();
 	_frgCore = nullptr;
 }
 
@@ -47,6 +55,10 @@ SpinParser::~SpinParser()
 {
 	delete _commandLineOptions;
 	delete _frgCore;
+	delete _flowProfiler;
+	delete _kernelTuner;
+	delete _energyMeter;
+	delete _startupPipeline;
 }
 #pragma endregion
 
@@ -54,36 +66,14 @@ int SpinParser::run(int argc, char **argv)
 {
 	try
 	{
-		//read command line switches
-		_commandLineOptions = new CommandLineOptions(argc, argv);
-
-		//stop program if help is requested
-		if (_commandLineOptions->help()) return 0;
-
-		//set up log level
-		if (_isMasterRank) Log::log << Log::setDisplayLogLevel(_commandLineOptions->verbose() ? Log::LogLevel::Debug : Log::LogLevel::Info);
-
-		//set up paths
-		_fileset.taskFile = _commandLineOptions->taskFile();
-		_fileset.obsFile = boost::filesystem::path(_fileset.taskFile).replace_extension("obs").string();
-		_fileset.dataFile = boost::filesystem::path(_fileset.taskFile).replace_extension("data").string();
-		_fileset.checkpointFile = boost::filesystem::path(_fileset.taskFile).replace_extension("checkpoint").string();
-
-		//set up FrgCore via TaskFileParser
-		_taskFileParser = new TaskFileParser(_fileset.taskFile, FrgCommon::_frequency, FrgCommon::_cutoff, FrgCommon::_lattice, _frgCore, _computationStatus);
-
-		//stop program is only lattice debug output is requested
-		if (_commandLineOptions->debugLattice())
-		{
-			Log::log << Log::LogLevel::Info << "Lattice debug output complete. Shutting down." << Log::endl;
-			return 0;
-		}
+		if (!initialize(argc, argv)) return 0;
 
 		//run core
 		Log::log << Log::LogLevel::Info << "Launching FRG numerics core" << Log::endl;
 		boost::posix_time::ptime startTime = boost::posix_time::microsec_clock::local_time();
 		runCore();
 		Log::log << Log::LogLevel::Info << "Shutting down core. Computation took " << std::fixed << std::setprecision(2) << (boost::posix_time::microsec_clock::local_time() - startTime).total_microseconds() / 1000000.0 << " seconds. " << Log::endl;
+		_energyMeter->report(_isMasterRank);
 	}
 	catch (std::exception &e)
 	{
@@ -93,6 +83,93 @@ int SpinParser::run(int argc, char **argv)
 	return 0;
 }
 
+bool SpinParser::initialize(int argc, char **argv)
+{
+	//read command line switches
+	_commandLineOptions = new CommandLineOptions(argc, argv);
+
+	//stop program if help is requested
+	if (_commandLineOptions->help()) return false;
+
+	//set up log level
+	if (_isMasterRank) Log::log << Log::setDisplayLogLevel(_commandLineOptions->verbose() ? Log::LogLevel::Debug : Log::LogLevel::Info);
+
+	//set up paths
+	_fileset.taskFile = _commandLineOptions->taskFile();
+	_fileset.obsFile = boost::filesystem::path(_fileset.taskFile).replace_extension("obs").string();
+	_fileset.dataFile = boost::filesystem::path(_fileset.taskFile).replace_extension("data").string();
+	_fileset.checkpointFile = boost::filesystem::path(_fileset.taskFile).replace_extension("checkpoint").string();
+	_fileset.refinementFile = boost::filesystem::path(_fileset.taskFile).replace_extension("refinement").string();
+	_fileset.profileFile = boost::filesystem::path(_fileset.taskFile).replace_extension("profile").string();
+
+	//set up FrgCore via TaskFileParser; the startup is timed from here on
+	delete _startupPipeline;
+	_startupPipeline = new StartupPipeline();
+	_taskFileParser = new TaskFileParser(_fileset.taskFile, FrgCommon::_frequency, FrgCommon::_cutoff, FrgCommon::_lattice, _frgCore, _computationStatus);
+
+	//stop program is only lattice debug output is requested
+	if (_commandLineOptions->debugLattice())
+	{
+		Log::log << Log::LogLevel::Info << "Lattice debug output complete. Shutting down." << Log::endl;
+		return false;
+	}
+
+	//set up profiler; a new calculation starts a new profiling report
+	if (_commandLineOptions->profile() != 0)
+	{
+		delete _flowProfiler;
+		_flowProfiler = new FlowProfiler(_commandLineOptions->profile(), _fileset.profileFile);
+		if (_isMasterRank && _computationStatus.statusIdentifier == ComputationStatus::Identifier::New && boost::filesystem::exists(_fileset.profileFile)) boost::filesystem::remove(_fileset.profileFile);
+		Log::log << Log::LogLevel::Info << "Profiling every " << _commandLineOptions->profile() << " cutoff steps to [" << _fileset.profileFile << "]." << Log::endl;
+	}
+
+	//set up kernel tuner
+	if (_commandLineOptions->tuneKernels())
+	{
+		delete _kernelTuner;
+		_kernelTuner = new KernelTuner(true, _commandLineOptions->kernelCache());
+	}
+
+	//set up energy meter
+	if (_commandLineOptions->measureEnergy())
+	{
+		delete _energyMeter;
+		_energyMeter = new EnergyMeter(true);
+	}
+
+	return true;
+}
+
+void SpinParser::release()
+{
+	delete _frgCore;
+	_frgCore = nullptr;
+	delete _taskFileParser;
+	_taskFileParser = nullptr;
+	delete _commandLineOptions;
+	_commandLineOptions = nullptr;
+	delete _flowProfiler;
+	_flowProfiler = new FlowProfiler();
+	delete _kernelTuner;
+	_kernelTuner = new KernelTuner();
+	delete _energyMeter;
+	_energyMeter = new EnergyMeter();
+	delete _startupPipeline;
+	_startupPipeline = new StartupPipeline();
+	EffectiveAction::discardPrefetchedDataFiles();
+	_loadManager->releaseStacks(0);
+
+	delete FrgCommon::_lattice;
+	FrgCommon::_lattice = nullptr;
+	delete FrgCommon::_frequency;
+	FrgCommon::_frequency = nullptr;
+	delete FrgCommon::_cutoff;
+	FrgCommon::_cutoff = nullptr;
+
+	_computationStatus = ComputationStatus();
+	_flowState = FlowState();
+}
+
 bool SpinParser::isMasterRank() const
 {
 	return _isMasterRank;
@@ -123,90 +200,378 @@ HMP::LoadManager *SpinParser::getLoadManager() const
 	return _loadManager;
 }
 
+FlowProfiler *SpinParser::getFlowProfiler() const
+{
+	return _flowProfiler;
+}
+
+KernelTuner *SpinParser::getKernelTuner() const
+{
+	return _kernelTuner;
+}
+
+EnergyMeter *SpinParser::getEnergyMeter() const
+{
+	return _energyMeter;
+}
+
+StartupPipeline *SpinParser::getStartupPipeline() const
+{
+	return _startupPipeline;
+}
+
 void SpinParser::runCore()
 {
 	if (_computationStatus.statusIdentifier == ComputationStatus::Identifier::New || _computationStatus.statusIdentifier == ComputationStatus::Identifier::Running)
 	{
-		//read checkpoint, if we continue a previous calculation
-		CutoffIterator cutoff = FrgCommon::cutoff().begin();
-		if (_computationStatus.statusIdentifier == ComputationStatus::Identifier::Running)
+		beginFlow();
+		while (stepFlow());
+		endFlow();
+	}
+	else if (_computationStatus.statusIdentifier == ComputationStatus::Identifier::Postprocessing)
+	{
+		_startupPipeline->finish();
+		Log::log << Log::LogLevel::Info << "Entering post-processing stage." << Log::endl;
+
+		//count stored states, such that the last state is measured irrespective of the measurement schedule
+		hsize_t stateCount = 0;
+		H5Eset_auto(H5E_DEFAULT, NULL, NULL);
+		hid_t file = H5Fopen(_fileset.dataFile.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+		if (file >= 0)
 		{
-			_frgCore->_flowingFunctional->readCheckpoint(_fileset.checkpointFile);
-			cutoff = FrgCommon::cutoff().find(_frgCore->_flowingFunctional->cutoff);
+			H5Gget_num_objs(file, &stateCount);
+			H5Fclose(file);
 		}
 
-		//run calculation
-		if (_computationStatus.statusIdentifier == ComputationStatus::Identifier::New) _computationStatus.startTime = Timestamp::time();
+		int n = 0;
+		while (_frgCore->_flowingFunctional->readCheckpoint(_fileset.dataFile, n++))
+		{
+			Log::log << Log::LogLevel::Info << "Post-processing measurements at cutoff " + std::to_string(_frgCore->_flowingFunctional->cutoff) << Log::endl;
+			_energyMeter->beginPhase(EnergyMeter::Phase::Measurement);
+			_frgCore->takeMeasurements(hsize_t(n) == stateCount);
+			_energyMeter->endPhase();
+		}
+		if (FrgCommon::cutoff().refinement > 1) sortObservables();
+
+		_computationStatus.endTime = Timestamp::time();
+		_computationStatus.statusIdentifier = ComputationStatus::Identifier::Finished;
+		_taskFileParser->writeTaskFile(_computationStatus);
+
+		Log::log << Log::LogLevel::Info << "Post-processing done." << Log::endl;
+	}
+	else if (_computationStatus.statusIdentifier == ComputationStatus::Identifier::Finished)
+	{
+		Log::log << Log::LogLevel::Info << "Nothing left to do. Task had been finished already." << Log::endl;
+	}
+
+}
+
+void SpinParser::beginFlow()
+{
+	//read checkpoint, if we continue a previous calculation
+	_flowState.cutoff = FrgCommon::cutoff().begin();
+	if (_computationStatus.statusIdentifier == ComputationStatus::Identifier::Running)
+	{
+		_startupPipeline->wait("checkpoint prefetch");
+		_startupPipeline->beginPhase("checkpoint");
+		_frgCore->_flowingFunctional->readCheckpoint(_fileset.checkpointFile);
+		_flowState.cutoff = FrgCommon::cutoff().find(_frgCore->_flowingFunctional->cutoff);
+	}
+	_startupPipeline->finish();
+
+	//prepare refinement pass; intermediate states are only stored for the part of the flow which is computed in the current run
+	_flowState.refinement = FrgCommon::cutoff().refinement > 1;
+	_flowState.diverged = false;
+	_flowState.refinementCutoffs.clear();
+	_flowState.refinementObservables.clear();
+	if (_flowState.refinement && _isMasterRank && boost::filesystem::exists(_fileset.refinementFile)) boost::filesystem::remove(_fileset.refinementFile);
+
+	//start calculation
+	if (_computationStatus.statusIdentifier == ComputationStatus::Identifier::New) _computationStatus.startTime = Timestamp::time();
+	_computationStatus.checkpointTime = Timestamp::time();
+}
+
+bool SpinParser::stepFlow()
+{
+	if (_flowState.cutoff == FrgCommon::cutoff().last()) return false;
+
+	//compute flow and measurements
+	Log::log << Log::LogLevel::Debug << "Begin computation of flow." << Log::endl;
+	_energyMeter->beginPhase(EnergyMeter::Phase::Flow);
+	_flowProfiler->beginStep();
+	_frgCore->computeStep();
+	_flowProfiler->endStep(*_frgCore->_flowingFunctional, *_frgCore->_flow, _isMasterRank);
+	if (_kernelTuner->isPending())
+	{
+		Log::log << Log::LogLevel::Info << "Tuning kernel variants." << Log::endl;
+		_frgCore->tuneKernels(*_kernelTuner);
+	}
+	_energyMeter->endPhase();
+	Log::log << Log::LogLevel::Debug << "Begin computation of measurements." << Log::endl;
+	_energyMeter->beginPhase(EnergyMeter::Phase::Measurement);
+	_frgCore->takeMeasurements();
+	_energyMeter->endPhase();
+
+	//store intermediate state for the refinement pass
+	if (_flowState.refinement)
+	{
+		_flowState.refinementCutoffs.push_back(_frgCore->_flowingFunctional->cutoff);
+		_flowState.refinementObservables.push_back(collectObservables());
+		_energyMeter->beginPhase(EnergyMeter::Phase::Checkpoint);
+		if (_isMasterRank) _frgCore->_flowingFunctional->writeCheckpoint(_fileset.refinementFile, true);
+		_energyMeter->endPhase();
+	}
+
+	//check if flow has diverged
+	Log::log << Log::LogLevel::Debug << "Begin computation of vertex." << Log::endl;
+	if (_frgCore->_flow->isDiverged())
+	{
+		Log::log << Log::LogLevel::Info << "Vertex has diverged. Stopping calculation." << Log::endl;
+		_energyMeter->endStep(_isMasterRank);
+		_flowState.diverged = true;
+		return false;
+	}
+
+	//perform integration step
+	++_flowState.cutoff;
+	_energyMeter->beginPhase(EnergyMeter::Phase::Integration);
+	_frgCore->finalizeStep(*_flowState.cutoff);
+	_frgCore->updateActiveRange();
+	_energyMeter->endPhase();
+
+	//print progress and write checkpoint
+	Log::log << Log::LogLevel::Info << "Current cutoff is at " << std::fixed << std::setprecision(6) << _frgCore->_flowingFunctional->cutoff << Log::endl;
+	if (Timestamp::isOlder(_computationStatus.checkpointTime, _commandLineOptions->checkpointTime()))
+	{
 		_computationStatus.checkpointTime = Timestamp::time();
-		while (cutoff != FrgCommon::cutoff().last())
+		_computationStatus.statusIdentifier = ComputationStatus::Identifier::Running;
+		_energyMeter->beginPhase(EnergyMeter::Phase::Checkpoint);
+		writeCheckpoint();
+		_energyMeter->endPhase();
+	}
+	_energyMeter->endStep(_isMasterRank);
+	return true;
+}
+
+void SpinParser::endFlow()
+{
+	//perform final measurement, irrespective of the measurement schedule
+	_energyMeter->beginPhase(EnergyMeter::Phase::Measurement);
+	_frgCore->takeMeasurements(true);
+	_energyMeter->endPhase();
+
+	//re-integrate cutoff windows with rapidly changing observables
+	if (_flowState.refinement)
+	{
+		if (!_flowState.diverged)
 		{
-			//compute flow and measurements
-			Log::log << Log::LogLevel::Debug << "Begin computation of flow." << Log::endl;
-			_frgCore->computeStep();
-			Log::log << Log::LogLevel::Debug << "Begin computation of measurements." << Log::endl;
-			_frgCore->takeMeasurements();
+			_flowState.refinementCutoffs.push_back(_frgCore->_flowingFunctional->cutoff);
+			_flowState.refinementObservables.push_back(collectObservables());
+			if (_isMasterRank) _frgCore->_flowingFunctional->writeCheckpoint(_fileset.refinementFile, true);
+		}
+		refineCore(_flowState.refinementCutoffs, _flowState.refinementObservables, _flowState.diverged);
+	}
 
-			//check if flow has diverged
-			Log::log << Log::LogLevel::Debug << "Begin computation of vertex." << Log::endl;
-			if (_frgCore->_flow->isDiverged())
-			{
-				Log::log << Log::LogLevel::Info << "Vertex has diverged. Stopping calculation." << Log::endl;
-				break;
-			}
+	//finalize calculation and write last checkpoint
+	bool postprocessingRequired = false;
+	if (_commandLineOptions->deferMeasurements()) postprocessingRequired = true;
+	for (auto m : _frgCore->_measurements) if (m->isDeferred()) postprocessingRequired = true;
+	
+	if (postprocessingRequired) _computationStatus.statusIdentifier = ComputationStatus::Identifier::Postprocessing;
+	else
+	{
+		_computationStatus.endTime = Timestamp::time();
+		_computationStatus.statusIdentifier = ComputationStatus::Identifier::Finished;
+	}
+	_computationStatus.checkpointTime = Timestamp::time();
+	_energyMeter->beginPhase(EnergyMeter::Phase::Checkpoint);
+	writeCheckpoint();
+	_energyMeter->endPhase();
+}
 
-			//perform integration step
-			++cutoff;
-			_frgCore->finalizeStep(*cutoff);
+void SpinParser::refineCore(const std::vector<float> &cutoffs, const std::vector<std::vector<float>> &observables, const bool diverged)
+{
+	int steps = int(cutoffs.size()) - 1;
+	if (steps < 1)
+	{
+		Log::log << Log::LogLevel::Info << "Not enough cutoff steps have been computed in the current run to perform the refinement pass." << Log::endl;
+		if (_isMasterRank) boost::filesystem::remove(_fileset.refinementFile);
+		return;
+	}
+
+	//identify cutoff steps with rapidly changing observables; the decision is made on the master rank, where measurement results are available
+	std::vector<int> refine(steps, 0);
+	if (_isMasterRank)
+	{
+		std::vector<float> rate(steps, 0.0f);
+		for (int k = 0; k < steps; ++k)
+		{
+			if (observables[k].size() == 0 || observables[k].size() != observables[k + 1].size()) continue;
 
-			//print progress and write checkpoint
-			Log::log << Log::LogLevel::Info << "Current cutoff is at " << std::fixed << std::setprecision(6) << _frgCore->_flowingFunctional->cutoff << Log::endl;
-			if (Timestamp::isOlder(_computationStatus.checkpointTime, _commandLineOptions->checkpointTime()))
+			float difference = 0.0f;
+			float norm0 = 0.0f;
+			float norm1 = 0.0f;
+			for (int i = 0; i < int(observables[k].size()); ++i)
 			{
-				_computationStatus.checkpointTime = Timestamp::time();
-				_computationStatus.statusIdentifier = ComputationStatus::Identifier::Running;
-				writeCheckpoint();
+				difference += (observables[k + 1][i] - observables[k][i]) * (observables[k + 1][i] - observables[k][i]);
+				norm0 += observables[k][i] * observables[k][i];
+				norm1 += observables[k + 1][i] * observables[k + 1][i];
 			}
+			if (std::max(norm0, norm1) > 0.0f) rate[k] = sqrtf(difference / std::max(norm0, norm1)) / fabsf(logf(cutoffs[k + 1] / cutoffs[k]));
 		}
 
-		//perform final measurement
-		_frgCore->takeMeasurements();
+		std::vector<float> sortedRate(rate);
+		std::nth_element(sortedRate.begin(), sortedRate.begin() + steps / 2, sortedRate.end());
+		float medianRate = sortedRate[steps / 2];
+		for (int k = 0; k < steps; ++k) if (rate[k] > FrgCommon::cutoff().refinementThreshold * medianRate) refine[k] = 1;
+		if (diverged) refine[steps - 1] = 1;
+	}
+	#ifndef DISABLE_MPI
+	MPI_Bcast(refine.data(), steps, MPI_INT, 0, MPI_COMM_WORLD);
+	#endif
 
-		//finalize calculation and write last checkpoint
-		bool postprocessingRequired = false;
-		if (_commandLineOptions->deferMeasurements()) postprocessingRequired = true;
-		for (auto m : _frgCore->_measurements) if (m->isDeferred()) postprocessingRequired = true;
-		
-		if (postprocessingRequired) _computationStatus.statusIdentifier = ComputationStatus::Identifier::Postprocessing;
-		else
+	//re-integrate windows of consecutive refined steps, starting from the stored intermediate states
+	int n = FrgCommon::cutoff().refinement;
+	int refinedSteps = 0;
+	bool active = false;
+	for (int k = 0; k < steps; ++k)
+	{
+		if (!refine[k])
 		{
-			_computationStatus.endTime = Timestamp::time();
-			_computationStatus.statusIdentifier = ComputationStatus::Identifier::Finished;
+			active = false;
+			continue;
 		}
-		_computationStatus.checkpointTime = Timestamp::time();
-		writeCheckpoint();
-	}
-	else if (_computationStatus.statusIdentifier == ComputationStatus::Identifier::Postprocessing)
-	{
-		Log::log << Log::LogLevel::Info << "Entering post-processing stage." << Log::endl;
+		if (k == 0 || !refine[k - 1])
+		{
+			Log::log << Log::LogLevel::Info << "Refining cutoff window starting at cutoff " << std::fixed << std::setprecision(6) << cutoffs[k] << Log::endl;
+			_frgCore->_flowingFunctional->readCheckpoint(_fileset.refinementFile, k);
+			_frgCore->_multirate.reset();
+			active = true;
+		}
+		if (!active) continue;
 
-		int n = 0;
-		while (_frgCore->_flowingFunctional->readCheckpoint(_fileset.dataFile, n++))
+		for (int j = 1; j <= n; ++j)
 		{
-			Log::log << Log::LogLevel::Info << "Post-processing measurements at cutoff " + std::to_string(_frgCore->_flowingFunctional->cutoff) << Log::endl;
-			_frgCore->takeMeasurements();
+			_energyMeter->beginPhase(EnergyMeter::Phase::Flow);
+			_frgCore->computeStep();
+			_energyMeter->endPhase();
+			if (_frgCore->_flow->isDiverged())
+			{
+				Log::log << Log::LogLevel::Info << "Vertex has diverged. Stopping refinement of the current cutoff window." << Log::endl;
+				active = false;
+				break;
+			}
+
+			//the last substep reproduces the original cutoff value, which has been handled by the coarse pass; intermediate substeps are measured irrespective of the measurement schedule
+			_energyMeter->beginPhase(EnergyMeter::Phase::Integration);
+			_frgCore->finalizeStep((j == n) ? cutoffs[k + 1] : cutoffs[k] * powf(cutoffs[k + 1] / cutoffs[k], float(j) / float(n)));
+			_energyMeter->endPhase();
+			if (j < n)
+			{
+				Log::log << Log::LogLevel::Info << "Current cutoff is at " << std::fixed << std::setprecision(6) << _frgCore->_flowingFunctional->cutoff << Log::endl;
+				_energyMeter->beginPhase(EnergyMeter::Phase::Measurement);
+				_frgCore->takeMeasurements(true);
+				_energyMeter->endPhase();
+			}
+			_energyMeter->endStep(_isMasterRank);
 		}
+		++refinedSteps;
+	}
+	Log::log << Log::LogLevel::Info << "Refined " << refinedSteps << " of " << steps << " cutoff steps." << Log::endl;
 
-		_computationStatus.endTime = Timestamp::time();
-		_computationStatus.statusIdentifier = ComputationStatus::Identifier::Finished;
-		_taskFileParser->writeTaskFile(_computationStatus);
+	//restore the final state of the flow
+	_frgCore->_flowingFunctional->readCheckpoint(_fileset.refinementFile, steps);
 
-		Log::log << Log::LogLevel::Info << "Post-processing done." << Log::endl;
+	//merge measurements and clean up
+	#ifndef DISABLE_MPI
+	MPI_Barrier(MPI_COMM_WORLD);
+	#endif
+	if (_isMasterRank)
+	{
+		sortObservables();
+		boost::filesystem::remove(_fileset.refinementFile);
 	}
-	else if (_computationStatus.statusIdentifier == ComputationStatus::Identifier::Finished)
+}
+
+std::vector<float> SpinParser::collectObservables() const
+{
+	std::vector<float> observables;
+	if (_commandLineOptions->deferMeasurements()) return observables;
+
+	for (auto m : _frgCore->_measurements)
 	{
-		Log::log << Log::LogLevel::Info << "Nothing left to do. Task had been finished already." << Log::endl;
+		if (!m->isDeferred() && _frgCore->_flowingFunctional->cutoff <= m->maxCutoff() && _frgCore->_flowingFunctional->cutoff >= m->minCutoff())
+		{
+			std::vector<float> o = m->observables();
+			observables.insert(observables.end(), o.begin(), o.end());
+		}
 	}
+	return observables;
+}
+
+void SpinParser::sortObservables() const
+{
+	if (!_isMasterRank) return;
+	H5Eset_auto(H5E_DEFAULT, NULL, NULL);
+
+	std::set<std::string> outfiles;
+	for (auto m : _frgCore->_measurements) outfiles.insert(m->outfile());
+
+	for (auto outfile : outfiles)
+	{
+		if (H5Fis_hdf5(outfile.c_str()) <= 0) continue;
+		hid_t file = H5Fopen(outfile.c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
+		if (file < 0) throw Exception(Exception::Type::IOError, "Could not open observable file [" + outfile + "] for writing");
+
+		//sort the measurements of every observable group
+		hsize_t numGroups;
+		H5Gget_num_objs(file, &numGroups);
+		for (int g = 0; g < int(numGroups); ++g)
+		{
+			if (H5Gget_objtype_by_idx(file, g) != H5G_GROUP) continue;
+			const int nameMaxLength = 256;
+			char groupName[nameMaxLength];
+			H5Gget_objname_by_idx(file, g, groupName, nameMaxLength);
+			hid_t group = H5Gopen(file, groupName, H5P_DEFAULT);
+			if (H5Lexists(group, "data", H5P_DEFAULT) <= 0)
+			{
+				H5Gclose(group);
+				continue;
+			}
+			hid_t data = H5Gopen(group, "data", H5P_DEFAULT);
+
+			//collect cutoff values
+			std::vector<std::pair<float, std::string>> measurements;
+			hsize_t numMeasurements;
+			H5Gget_num_objs(data, &numMeasurements);
+			for (int i = 0; i < int(numMeasurements); ++i)
+			{
+				if (H5Gget_objtype_by_idx(data, i) != H5G_GROUP) continue;
+				char measurementName[nameMaxLength];
+				H5Gget_objname_by_idx(data, i, measurementName, nameMaxLength);
+				hid_t measurement = H5Gopen(data, measurementName, H5P_DEFAULT);
+				if (H5Aexists(measurement, "cutoff") > 0)
+				{
+					hid_t attr = H5Aopen(measurement, "cutoff", H5P_DEFAULT);
+					float c;
+					H5Aread(attr, H5T_NATIVE_FLOAT, &c);
+					H5Aclose(attr);
+					measurements.push_back(std::make_pair(c, std::string(measurementName)));
+				}
+				H5Gclose(measurement);
+			}
+
+			//rename measurements in order of descending cutoff; renaming is performed in two stages to avoid name collisions
+			std::sort(measurements.begin(), measurements.end(), [](const std::pair<float, std::string> &a, const std::pair<float, std::string> &b) { return a.first > b.first; });
+			for (int i = 0; i < int(measurements.size()); ++i) H5Lmove(data, measurements[i].second.c_str(), data, ("sorting_" + std::to_string(i)).c_str(), H5P_DEFAULT, H5P_DEFAULT);
+			for (int i = 0; i < int(measurements.size()); ++i) H5Lmove(data, ("sorting_" + std::to_string(i)).c_str(), data, ("measurement_" + std::to_string(i)).c_str(), H5P_DEFAULT, H5P_DEFAULT);
 
+			H5Gclose(data);
+			H5Gclose(group);
+		}
+
+		H5Fclose(file);
+	}
 }
 
 void SpinParser::writeCheckpoint()
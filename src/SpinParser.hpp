@@ -14,6 +14,10 @@
 #include "FrgCommon.hpp"
 #include "CommandLineOptions.hpp"
 #include "TaskFileParser.hpp"
+#include "FlowProfiler.hpp"
+#include "KernelTuner.hpp"
+#include "EnergyMeter.hpp"
+#include "StartupPipeline.hpp"
 
 class FrgCore;
 
@@ -45,6 +49,20 @@ struct Fileset
 	std::string obsFile; ///< Path to the observable file. 
 	std::string dataFile; ///< Path to the data file used for deferred measurements. 
 	std::string checkpointFile; ///< Path to the checkpoint file. 
+	std::string refinementFile; ///< Path to the file which stores intermediate states for the cutoff refinement pass. 
+	std::string profileFile; ///< Path to the profiling report. 
+};
+
+/**
+ * @brief State of the solution of the flow equations, which is carried between consecutive cutoff steps. 
+ */
+struct FlowState
+{
+	CutoffIterator cutoff = CutoffIterator(nullptr); ///< Current position in the cutoff discretization. 
+	bool refinement = false; ///< Set to true if intermediate states are stored for the refinement pass. 
+	bool diverged = false; ///< Set to true if the flow has diverged. 
+	std::vector<float> refinementCutoffs; ///< Cutoff values at which intermediate states have been stored. 
+	std::vector<std::vector<float>> refinementObservables; ///< Observables measured at each of the stored cutoff values. 
 };
 
 /**
@@ -56,6 +74,7 @@ struct Fileset
  */
 class SpinParser
 {
+	friend class Solver;
 public:
 	/**
 	 * @brief Retrieve the SpinParser singleton. 
@@ -113,6 +132,34 @@ public:
 	 */
 	HMP::LoadManager *getLoadManager() const;
 
+	/**
+	 * @brief Retrieve the internal flow profiler. 
+	 * 
+	 * @return FlowProfiler* Internal flow profiler. 
+	 */
+	FlowProfiler *getFlowProfiler() const;
+
+	/**
+	 * @brief Retrieve the internal kernel tuner. 
+	 * 
+	 * @return KernelTuner* Internal kernel tuner. 
+	 */
+	KernelTuner *getKernelTuner() const;
+
+	/**
+	 * @brief Retrieve the internal energy meter. 
+	 * 
+	 * @return EnergyMeter* Internal energy meter. 
+	 */
+	EnergyMeter *getEnergyMeter() const;
+
+	/**
+	 * @brief Retrieve the internal startup pipeline. 
+	 * 
+	 * @return StartupPipeline* Internal startup pipeline. 
+	 */
+	StartupPipeline *getStartupPipeline() const;
+
 	/**
 	 * @brief Retrieve the internal numerics core.
 	 * 
@@ -131,11 +178,66 @@ protected:
 	 */
 	~SpinParser();
 
+	/**
+	 * @brief Read the command line arguments and the task file, and set up the numerics core. 
+	 * 
+	 * @param argc Launch parameter argc, as provided by the operating system. 
+	 * @param argv Launch parameter argv, as provided by the operating system. 
+	 * @return bool Returns true if the numerics core should be launched, and false if the task is complete after initialization (help or lattice debug output). 
+	 */
+	bool initialize(int argc, char **argv);
+
+	/**
+	 * @brief Release the numerics core and all task-related objects, such that a new task can be initialized. 
+	 */
+	void release();
+
 	/**
 	 * @brief Run the numerics core and apply the differential equation solver. 
 	 */
 	void runCore();
 
+	/**
+	 * @brief Prepare the solution of the flow equations, and read the checkpoint if a previous calculation is continued. 
+	 */
+	void beginFlow();
+
+	/**
+	 * @brief Compute the flow and measurements at the current cutoff, and perform the integration step to the next cutoff. 
+	 * 
+	 * @return bool Returns true if the integration step has been performed, and false if the last cutoff has been reached or the flow has diverged. 
+	 */
+	bool stepFlow();
+
+	/**
+	 * @brief Complete the solution of the flow equations by taking the final measurement, performing the refinement pass, and writing the final checkpoint. 
+	 */
+	void endFlow();
+
+	/**
+	 * @brief Re-integrate those cutoff steps of a completed flow in which the observables change rapidly, using finer cutoff steps. 
+	 * @details A cutoff step is refined if the relative change of the observables per logarithmic cutoff step exceeds the median over all steps by CutoffDiscretization::refinementThreshold. 
+	 * Consecutive refined steps form a window, which is integrated starting from the intermediate state stored in Fileset::refinementFile, where each step is divided into CutoffDiscretization::refinement substeps. 
+	 * Measurements at the additional cutoff values are appended to the observable files, which are subsequently sorted by cutoff. 
+	 * 
+	 * @param cutoffs Cutoff values at which intermediate states have been stored, in the order of the flow. 
+	 * @param observables Observables measured at each of the cutoff values. 
+	 * @param diverged Indicates that the flow has diverged after the last cutoff value, in which case the last cutoff step is always refined. 
+	 */
+	void refineCore(const std::vector<float> &cutoffs, const std::vector<std::vector<float>> &observables, const bool diverged);
+
+	/**
+	 * @brief Collect the observables of all measurements which have been taken at the current cutoff. 
+	 * 
+	 * @return std::vector<float> Concatenation of the observables of all measurements. 
+	 */
+	std::vector<float> collectObservables() const;
+
+	/**
+	 * @brief Sort the measurements in all observable files by descending cutoff. 
+	 */
+	void sortObservables() const;
+
 	/**
 	 * @brief Write current state to checkpoint file. 
 	 */
@@ -149,5 +251,10 @@ protected:
 	CommandLineOptions *_commandLineOptions; ///< Internal command line parser. 
 	TaskFileParser *_taskFileParser; ///< Internal task file parser. 
 	HMP::LoadManager *_loadManager; ///< Internal load manager. 
+	FlowProfiler *_flowProfiler; ///< Internal flow profiler. 
+	KernelTuner *_kernelTuner; ///< Internal kernel tuner. 
+	EnergyMeter *_energyMeter; ///< Internal energy meter. 
+	StartupPipeline *_startupPipeline; ///< Internal startup pipeline. 
 	FrgCore *_frgCore; ///< Internal numerics core. 
+	FlowState _flowState; ///< State of the solution of the flow equations. 
 };
\ No newline at end of file
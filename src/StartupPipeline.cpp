@@ -0,0 +1,80 @@
+/**
+ * @file StartupPipeline.cpp
+ * @author Finn Lasse Buessen
+ * @brief Timed startup phases and concurrent startup tasks. 
+ * 
+ * @copyright Copyright (c) 2020
+ */
+
+#include <iomanip>
+#include "lib/Log.hpp"
+#include "StartupPipeline.hpp"
+
+StartupPipeline::StartupPipeline() : _begin(std::chrono::steady_clock::now()), _isFinished(false)
+{
+}
+
+StartupPipeline::~StartupPipeline()
+{
+	//tasks may still refer to data owned by the caller, so they must complete; their exceptions are discarded
+	for (auto &task : _tasks)
+	{
+		if (task.duration.valid()) task.duration.wait();
+	}
+}
+
+void StartupPipeline::beginPhase(const std::string &phase)
+{
+	endPhase();
+	_phase = phase;
+	_phaseBegin = std::chrono::steady_clock::now();
+}
+
+void StartupPipeline::endPhase()
+{
+	if (_phase == "") return;
+
+	double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - _phaseBegin).count();
+	Log::log << Log::LogLevel::Info << "Startup phase [" << _phase << "] took " << std::fixed << std::setprecision(2) << duration << " seconds." << Log::endl;
+	_phase = "";
+}
+
+void StartupPipeline::launch(const std::string &phase, const std::function<void()> &task)
+{
+	Task t;
+	t.phase = phase;
+	t.duration = std::async(std::launch::async, [task]()
+	{
+		auto begin = std::chrono::steady_clock::now();
+		task();
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+	});
+	_tasks.push_back(std::move(t));
+}
+
+void StartupPipeline::wait(const std::string &phase)
+{
+	for (auto task = _tasks.begin(); task != _tasks.end(); ++task)
+	{
+		if (task->phase != phase) continue;
+
+		auto waitBegin = std::chrono::steady_clock::now();
+		std::future<double> duration = std::move(task->duration);
+		_tasks.erase(task);
+		double d = duration.get();
+		double blocked = std::chrono::duration<double>(std::chrono::steady_clock::now() - waitBegin).count();
+		Log::log << Log::LogLevel::Info << "Startup phase [" << phase << "] took " << std::fixed << std::setprecision(2) << d << " seconds concurrently (waited " << blocked << " seconds)." << Log::endl;
+		return;
+	}
+}
+
+void StartupPipeline::finish()
+{
+	if (_isFinished) return;
+	_isFinished = true;
+
+	endPhase();
+	while (_tasks.size() > 0) wait(_tasks.front().phase);
+	double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - _begin).count();
+	Log::log << Log::LogLevel::Info << "Startup took " << std::fixed << std::setprecision(2) << duration << " seconds." << Log::endl;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file StartupPipeline.hpp
+ * @author Finn Lasse Buessen
+ * @brief Timed startup phases and concurrent startup tasks. 
+ * @details The startup of a calculation consists of a sequence of phases on the main thread, e.g. parsing the task file, constructing the lattice model, and allocating the FRG core. 
+ * Tasks which do not depend on these phases, e.g. reading checkpoint files, are launched concurrently and joined where their results are required. 
+ * 
+ * @copyright Copyright (c) 2020
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <future>
+#include <chrono>
+#include <functional>
+
+/**
+ * @brief Task graph of the startup of a calculation, which times and logs every phase. 
+ * @details Phases on the calling thread are enclosed in StartupPipeline::beginPhase() and StartupPipeline::endPhase(). 
+ * Concurrent tasks are started by StartupPipeline::launch() and joined by StartupPipeline::wait(), which expresses the dependency of the subsequent phases on the task. 
+ */
+class StartupPipeline
+{
+public:
+	/**
+	 * @brief Construct a new StartupPipeline object and start timing the startup. 
+	 */
+	StartupPipeline();
+
+	/**
+	 * @brief Destroy the StartupPipeline object. Waits for all concurrent tasks to complete. 
+	 */
+	~StartupPipeline();
+
+	/**
+	 * @brief Begin a phase on the calling thread. A previous phase which has not been ended is ended. 
+	 * 
+	 * @param phase Name of the phase. 
+	 */
+	void beginPhase(const std::string &phase);
+
+	/**
+	 * @brief End the current phase and log its duration. 
+	 */
+	void endPhase();
+
+	/**
+	 * @brief Launch a concurrent task. 
+	 * 
+	 * @param phase Name of the task. 
+	 * @param task Function to execute. 
+	 */
+	void launch(const std::string &phase, const std::function<void()> &task);
+
+	/**
+	 * @brief Wait for a concurrent task to complete and log its duration. Exceptions thrown by the task are rethrown. 
+	 * If no pending task of the specified name exists, do nothing. 
+	 * 
+	 * @param phase Name of the task. 
+	 */
+	void wait(const std::string &phase);
+
+	/**
+	 * @brief Wait for all concurrent tasks to complete and log the total duration of the startup. 
+	 */
+	void finish();
+
+private:
+	/**
+	 * @brief Concurrent task. 
+	 */
+	struct Task
+	{
+		std::string phase; ///< Name of the task.
+		std::future<double> duration; ///< Duration of the task in seconds.
+	};
+
+	std::chrono::steady_clock::time_point _begin; ///< Time at which the startup began.
+	std::string _phase; ///< Name of the current phase on the calling thread. Empty if no phase is active.
+	std::chrono::steady_clock::time_point _phaseBegin; ///< Time at which the current phase began.
+	std::vector<Task> _tasks; ///< Pending concurrent tasks.
+	bool _isFinished; ///< Set to true once the startup has finished.
+};
@@ -43,6 +43,9 @@ public:
 		//set initial value
 		this->cutoff = cutoff;
 
+		#ifndef DISABLE_OMP
+		#pragma omp parallel for schedule(static)
+		#endif
 		for (int linearIterator = 0; linearIterator < vertexTwoParticle->size; ++linearIterator)
 		{
 			float s, t, u;
@@ -53,7 +56,7 @@ public:
 			//skip initial conditions for density and spin/density interactions
 			if (static_cast<int>(s1) == 3 || static_cast<int>(s2) == 3) continue;
 			//set initial conditions for spin/spin interactions
-			for (auto i : spinModel.interactions)
+			for (const auto &i : spinModel.interactions)
 			{
 				if (i.first == i1)
 				{
@@ -164,7 +167,7 @@ public:
 		H5Eset_auto(H5E_DEFAULT, NULL, NULL);
 
 		//open file
-		hid_t file = H5Fopen(dataFilePath.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+		hid_t file = _openDataFile(dataFilePath);
 		if (file < 0) throw Exception(Exception::Type::IOError, "Could not open data file for reading");
 
 		//find desired dataset name
@@ -226,6 +229,54 @@ public:
 		return false;
 	}
 
+	/**
+	 * @brief Sample the frequency dependence of the effective action on the positive frequency mesh. 
+	 * @details Profiles comprise the single-particle vertex and the local two-particle vertex in the diagonal spin channels along each transfer frequency, where the remaining transfer frequencies are set to the smallest mesh point. 
+	 *
+	 * @return std::vector<std::vector<float>> List of frequency profiles. 
+	 */
+	std::vector<std::vector<float>> getFrequencyProfiles() const override
+	{
+		int n = FrgCommon::frequency().size;
+		float w0 = FrgCommon::frequency()._data[0];
+		LatticeIterator i0 = FrgCommon::lattice().zero();
+
+		std::vector<std::vector<float>> profiles;
+		profiles.push_back(std::vector<float>(vertexSingleParticle->_data, vertexSingleParticle->_data + n));
+		for (SpinComponent c : { SpinComponent::X, SpinComponent::Y, SpinComponent::Z })
+		{
+			std::vector<float> profileS(n), profileT(n), profileU(n);
+			for (int i = 0; i < n; ++i)
+			{
+				float w = FrgCommon::frequency()._data[i];
+				profileS[i] = vertexTwoParticle->getValue(i0, i0, w, w0, w0, c, c, TRIVertexTwoParticle::FrequencyChannel::All);
+				profileT[i] = vertexTwoParticle->getValue(i0, i0, w0, w, w0, c, c, TRIVertexTwoParticle::FrequencyChannel::All);
+				profileU[i] = vertexTwoParticle->getValue(i0, i0, w0, w0, w, c, c, TRIVertexTwoParticle::FrequencyChannel::All);
+			}
+			profiles.push_back(profileS);
+			profiles.push_back(profileT);
+			profiles.push_back(profileU);
+		}
+
+		return profiles;
+	}
+
+	std::vector<float> getTwoParticleMagnitudes() const override
+	{
+		//vertex data is stored as [frequency][spin component 1][spin component 2][lattice site]
+		int latticeSize = FrgCommon::lattice().size;
+		std::vector<float> magnitudes(vertexTwoParticle->sizeFrequency * latticeSize, 0.0f);
+		for (int f = 0; f < vertexTwoParticle->sizeFrequency; ++f)
+		{
+			for (int c = 0; c < 16; ++c)
+			{
+				for (int rid = 0; rid < latticeSize; ++rid) magnitudes[f * latticeSize + rid] += vertexTwoParticle->_data[(16 * f + c) * latticeSize + rid] * vertexTwoParticle->_data[(16 * f + c) * latticeSize + rid];
+			}
+		}
+		for (auto &m : magnitudes) m = sqrtf(m);
+		return magnitudes;
+	}
+
 	TRIVertexSingleParticle *vertexSingleParticle; ///< Single-particle vertex data. 
 	TRIVertexTwoParticle *vertexTwoParticle; ///< Two-particle vertex data. 
 };
\ No newline at end of file
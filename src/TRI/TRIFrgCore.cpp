@@ -1,7 +1,7 @@
 /**
  * @file TRIFrgCore.cpp
  * @author Finn Lasse Buessen
- * @brief FrgCore implementation for time reversal invariant models.
+ * @brief FrgCore implementation for time reversal invariant models. 
  * 
  * @copyright Copyright (c) 2020
  */
@@ -49,7 +49,12 @@ TRIFrgCore::TRIFrgCore(const SpinModel &spinModel, const std::vector<Measurement
 	dataStacks[3] = SpinParser::spinParser()->getLoadManager()->addMasterStackImplicit<float>(
 		&_flow->cutoff,
 		1,
-		[&](int) { _flow->cutoff = static_cast<TRIEffectiveAction *>(_flowingFunctional)->cutoff; });
+		[&](int) { _flow->cutoff = static_cast<TRIEffectiveAction *>(_flowingFunctional)->cutoff; },
+		1,
+		1,
+		10,
+		false,
+		true);
 	//stack4
 	dataStacks[4] = SpinParser::spinParser()->getLoadManager()->addMasterStackImplicit<float>(
 		static_cast<TRIEffectiveAction *>(_flow)->vertexSingleParticle->_data,
@@ -57,14 +62,19 @@ TRIFrgCore::TRIFrgCore(const SpinModel &spinModel, const std::vector<Measurement
 		[&](int x) { _calculateVertexSingleParticle(x); },
 		1,
 		1,
-		1);
+		1,
+		false,
+		true);
 	//stack5
 	dataStacks[5] = SpinParser::spinParser()->getLoadManager()->addMasterStackImplicit<float>(
 		static_cast<TRIEffectiveAction *>(_flow)->vertexTwoParticle->_data,
 		static_cast<TRIEffectiveAction *>(_flow)->vertexTwoParticle->sizeFrequency,
-		[&](int x) { _calculateVertexTwoParticle(x); },
+		[&](int x) { if (_multirate.isDue(x)) SpinParser::spinParser()->getFlowProfiler()->profile(x, [&]() { if (FrgCommon::frequency().interpolation == FrequencyDiscretization::Interpolation::Cubic) _calculateVertexTwoParticle<16>(x); else _calculateVertexTwoParticle<4>(x); }); },
 		16 * FrgCommon::lattice().size,
 		FrgCommon::frequency().size);
+
+	//blocks of the multi-rate evaluation are formed by the frequency iterators of the two-particle vertex flow
+	_multirate.setBlocks(static_cast<TRIEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->sizeFrequency, 16 * FrgCommon::lattice().size, { static_cast<TRIEffectiveAction *>(_flow)->vertexTwoParticle->_data });
 }
 
 TRIFrgCore::~TRIFrgCore()
@@ -92,7 +102,9 @@ void TRIFrgCore::computeStep()
 		}
 	}
 	managedMeasurementStacks.push_back(dataStacks[5]);
+	_multirate.beginStep(_flowingFunctional->cutoff, SpinParser::spinParser()->isMasterRank());
 	SpinParser::spinParser()->getLoadManager()->calculate(managedMeasurementStacks.data(), int(managedMeasurementStacks.size()));
+	_multirate.endStep(SpinParser::spinParser()->isMasterRank());
 }
 
 void TRIFrgCore::finalizeStep(float newCutoff)
@@ -110,15 +122,57 @@ void TRIFrgCore::finalizeStep(float newCutoff)
 	for (int i = 0; i < static_cast<TRIEffectiveAction *>(_flowingFunctional)->vertexSingleParticle->size; ++i) static_cast<TRIEffectiveAction *>(_flowingFunctional)->vertexSingleParticle->_data[i] += cutoffStep * static_cast<TRIEffectiveAction *>(_flow)->vertexSingleParticle->_data[i];
 
 	//add _flow to two particle vertex
-	#ifndef DISABLE_OMP
-	#pragma omp parallel for schedule(static)
-	#endif
-	for (int i = 0; i < static_cast<TRIEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->size; ++i) static_cast<TRIEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->_data[i] += cutoffStep * static_cast<TRIEffectiveAction *>(_flow)->vertexTwoParticle->_data[i];
+	integrateStep(static_cast<TRIEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->_data, static_cast<TRIEffectiveAction *>(_flow)->vertexTwoParticle->_data, static_cast<TRIEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->size, cutoffStep, FrgCommon::cutoff().integrator);
 
 	//broadcast updated effective action
 	SpinParser::spinParser()->getLoadManager()->broadcast({ dataStacks[0], dataStacks[1], dataStacks[2] });
 }
 
+void TRIFrgCore::tuneKernels(KernelTuner &tuner)
+{
+	_tuneKernels(tuner, "TRI", [&](int x) { if (FrgCommon::frequency().interpolation == FrequencyDiscretization::Interpolation::Cubic) _calculateVertexTwoParticle<16>(x); else _calculateVertexTwoParticle<4>(x); }, false);
+}
+
+void TRIFrgCore::_transformSites(ValueSuperbundle<float, 16> *vertexBuffers, ValueSuperbundle<float, 16> *transformedBuffers) const
+{
+	const LatticeSiteDescriptor *sites = FrgCommon::lattice().getTransformedSites();
+
+	for (int j = 0; j < FrgCommon::lattice().getTransformedSitesSize(); ++j)
+	{
+		//extend the spin transformation to the density component, which is invariant
+		float transformation[9];
+		FrgCommon::lattice().getSpinTransformation(sites[j].spinPermutation, sites[j].spinRotation, transformation);
+		float m[4][4] = { { 0.0f } };
+		for (int a = 0; a < 3; ++a) for (int c = 0; c < 3; ++c) m[a][c] = transformation[3 * a + c];
+		m[3][3] = 1.0f;
+
+		for (int k = 0; k < 4; ++k)
+		{
+			//v'^{ab}=M[a][c]*M[b][d]*v^{cd}, evaluated as v'=M*(v*M^T)
+			float v[16];
+			for (int e = 0; e < 16; ++e) v[e] = vertexBuffers[k].bundle(e)[sites[j].rid];
+			float w[16];
+			for (int c = 0; c < 4; ++c)
+			{
+				for (int b = 0; b < 4; ++b)
+				{
+					w[4 * c + b] = 0.0f;
+					for (int d = 0; d < 4; ++d) w[4 * c + b] += v[4 * c + d] * m[b][d];
+				}
+			}
+			for (int a = 0; a < 4; ++a)
+			{
+				for (int b = 0; b < 4; ++b)
+				{
+					float value = 0.0f;
+					for (int c = 0; c < 4; ++c) value += m[a][c] * w[4 * c + b];
+					transformedBuffers[k].bundle(4 * a + b)[j] = value;
+				}
+			}
+		}
+	}
+}
+
 void TRIFrgCore::_calculateVertexSingleParticle(const int iterator)
 {
 	float cutoff = _flowingFunctional->cutoff;
@@ -131,7 +185,7 @@ void TRIFrgCore::_calculateVertexSingleParticle(const int iterator)
 
 	//term1
 	float sum = 0;
-	for (auto j = FrgCommon::lattice().getRange(0); j != FrgCommon::lattice().end(); ++j)
+	for (int j : FrgCommon::lattice().getRangeIds(0))
 	{
 		sum += v4->getValue(FrgCommon::lattice().zero(), j, w + cutoff, 0.0f, w - cutoff, SpinComponent::None, SpinComponent::None, TRIVertexTwoParticle::FrequencyChannel::None);
 		sum -= v4->getValue(FrgCommon::lattice().zero(), j, w - cutoff, 0.0f, w + cutoff, SpinComponent::None, SpinComponent::None, TRIVertexTwoParticle::FrequencyChannel::None);
@@ -150,7 +204,7 @@ void TRIFrgCore::_calculateVertexSingleParticle(const int iterator)
 	static_cast<TRIEffectiveAction *>(_flow)->vertexSingleParticle->_data[iterator] = v2CurrentValue;
 }
 
-void TRIFrgCore::_calculateVertexTwoParticle(const int iterator)
+template <int n> void TRIFrgCore::_calculateVertexTwoParticle(const int iterator)
 {
 	float cutoff = _flowingFunctional->cutoff;
 	TRIVertexSingleParticle *v2 = static_cast<TRIEffectiveAction *>(_flowingFunctional)->vertexSingleParticle;
@@ -170,6 +224,12 @@ void TRIFrgCore::_calculateVertexTwoParticle(const int iterator)
 		ValueSuperbundle<float, 16>(FrgCommon::lattice().size),
 		ValueSuperbundle<float, 16>(FrgCommon::lattice().size)
 	};
+	ValueSuperbundle<float, 16> transformedBuffers[4] = {
+		ValueSuperbundle<float, 16>(FrgCommon::lattice().getTransformedSitesSize()),
+		ValueSuperbundle<float, 16>(FrgCommon::lattice().getTransformedSitesSize()),
+		ValueSuperbundle<float, 16>(FrgCommon::lattice().getTransformedSitesSize()),
+		ValueSuperbundle<float, 16>(FrgCommon::lattice().getTransformedSitesSize())
+	};
 
 	//transfer frequencies
 	float w1p = 0.5f * (s + t + u);
@@ -181,11 +241,11 @@ void TRIFrgCore::_calculateVertexTwoParticle(const int iterator)
 	auto integralKernelS = [&](const float wp, ValueSuperbundle<float, 16> &returnBuffer) -> void
 	{
 		//pp-ladder A and B (positive sign)
-		const TRIVertexTwoParticleAccessBuffer<4> ab0 = v4->generateAccessBuffer(s, w2 + wp, w1 + wp, TRIVertexTwoParticle::FrequencyChannel::S);
-		const TRIVertexTwoParticleAccessBuffer<4> ab1 = v4->generateAccessBuffer(s, -w2p - wp, w1p + wp, TRIVertexTwoParticle::FrequencyChannel::S);
+		const TRIVertexTwoParticleAccessBuffer<n> ab0 = v4->generateAccessBuffer<n>(s, w2 + wp, w1 + wp, TRIVertexTwoParticle::FrequencyChannel::S);
+		const TRIVertexTwoParticleAccessBuffer<n> ab1 = v4->generateAccessBuffer<n>(s, -w2p - wp, w1p + wp, TRIVertexTwoParticle::FrequencyChannel::S);
 		//pp-ladder A and B (positive sign)
-		const TRIVertexTwoParticleAccessBuffer<4> ab2 = v4->generateAccessBuffer(s, -w1 - wp, -w2 - wp, TRIVertexTwoParticle::FrequencyChannel::S);
-		const TRIVertexTwoParticleAccessBuffer<4> ab3 = v4->generateAccessBuffer(s, w1p + wp, -w2p - wp, TRIVertexTwoParticle::FrequencyChannel::S);
+		const TRIVertexTwoParticleAccessBuffer<n> ab2 = v4->generateAccessBuffer<n>(s, -w1 - wp, -w2 - wp, TRIVertexTwoParticle::FrequencyChannel::S);
+		const TRIVertexTwoParticleAccessBuffer<n> ab3 = v4->generateAccessBuffer<n>(s, w1p + wp, -w2p - wp, TRIVertexTwoParticle::FrequencyChannel::S);
 
 		v4->getValueSuperbundle(ab0, stackBuffers[0]);
 		v4->getValueSuperbundle(ab1, stackBuffers[1]);
@@ -711,552 +771,563 @@ void TRIFrgCore::_calculateVertexTwoParticle(const int iterator)
 		#pragma endregion
 	};
 
-	auto integralKernelT = [&](const float wp, ValueSuperbundle<float, 16> &returnBuffer) -> void
+	//rpa diagram on a single lattice site, evaluated from the vertex values on the overlap of the reference site with the lattice site rid
+	auto rpaKernel = [&](const int rid, const LatticeOverlap &overlap, ValueSuperbundle<float, 16> *vertexBuffers) -> void
 	{
-		//RPA diagram A and B equal chalice diagram A and inverse chalice diagram B, respectively (negative sign)
-		//chalice diagram A (negative sign)
-		const TRIVertexTwoParticleAccessBuffer<4> ab0 = v4->generateAccessBuffer(w1 - wp, t, w1p + wp, TRIVertexTwoParticle::FrequencyChannel::T);
-		//inverse chalice diagram B (negative sign)
-		const TRIVertexTwoParticleAccessBuffer<4> ab1 = v4->generateAccessBuffer(w2p - wp, t, -w2 - wp, TRIVertexTwoParticle::FrequencyChannel::T);
-		//chalice diagram A (negative sign)
-		const TRIVertexTwoParticleAccessBuffer<4> ab2 = v4->generateAccessBuffer(w1p + wp, t, w1 - wp, TRIVertexTwoParticle::FrequencyChannel::T);
-		//inverse chalice diagram B (negative sign)
-		const TRIVertexTwoParticleAccessBuffer<4> ab3 = v4->generateAccessBuffer(w2 + wp, t, -w2p + wp, TRIVertexTwoParticle::FrequencyChannel::T);
-
-		v4->getValueSuperbundle(ab0, stackBuffers[0]);
-		v4->getValueSuperbundle(ab1, stackBuffers[1]);
-		v4->getValueSuperbundle(ab2, stackBuffers[2]);
-		v4->getValueSuperbundle(ab3, stackBuffers[3]);
-
-		//calculate _flow
-		returnBuffer.reset();
-		bufferRPA.reset();
-		for (int rid = 0; rid < FrgCommon::lattice().size; ++rid)
+		#pragma region RPA
+		for (int i = 0; i < overlap.size; ++i)
 		{
-			//lattice bubble
-			const LatticeOverlap &overlap = FrgCommon::lattice().getOverlap(rid);
-
-			#pragma region RPA
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(15)[rid] += 2 * stackBuffers[0].bundle(15).data()[overlap.rid1[i]] * stackBuffers[1].bundle(15).data()[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(15)[rid] += 2 * stackBuffers[2].bundle(15).data()[overlap.rid1[i]] * stackBuffers[3].bundle(15).data()[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(15)[rid] -= 2 * stackBuffers[0].bundle(12 + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(15)[rid] -= 2 * stackBuffers[2].bundle(12 + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(15)[rid] -= 2 * stackBuffers[0].bundle(12 + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(15)[rid] -= 2 * stackBuffers[2].bundle(12 + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(15)[rid] -= 2 * stackBuffers[0].bundle(12 + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(15)[rid] -= 2 * stackBuffers[2].bundle(12 + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(12)[rid] += 2 * stackBuffers[0].bundle(15).data()[overlap.rid1[i]] * stackBuffers[1].bundle(12 + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(12)[rid] += 2 * stackBuffers[2].bundle(15).data()[overlap.rid1[i]] * stackBuffers[3].bundle(12 + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(12)[rid] += 2 * stackBuffers[0].bundle(12 + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(12)[rid] += 2 * stackBuffers[2].bundle(12 + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(12)[rid] += 2 * stackBuffers[0].bundle(12 + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(12)[rid] += 2 * stackBuffers[2].bundle(12 + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(12)[rid] += 2 * stackBuffers[0].bundle(12 + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(12)[rid] += 2 * stackBuffers[2].bundle(12 + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(13)[rid] += 2 * stackBuffers[0].bundle(15).data()[overlap.rid1[i]] * stackBuffers[1].bundle(12 + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(13)[rid] += 2 * stackBuffers[2].bundle(15).data()[overlap.rid1[i]] * stackBuffers[3].bundle(12 + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(13)[rid] += 2 * stackBuffers[0].bundle(12 + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(13)[rid] += 2 * stackBuffers[2].bundle(12 + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(13)[rid] += 2 * stackBuffers[0].bundle(12 + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(13)[rid] += 2 * stackBuffers[2].bundle(12 + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(13)[rid] += 2 * stackBuffers[0].bundle(12 + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(13)[rid] += 2 * stackBuffers[2].bundle(12 + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(14)[rid] += 2 * stackBuffers[0].bundle(15).data()[overlap.rid1[i]] * stackBuffers[1].bundle(12 + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(14)[rid] += 2 * stackBuffers[2].bundle(15).data()[overlap.rid1[i]] * stackBuffers[3].bundle(12 + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(14)[rid] += 2 * stackBuffers[0].bundle(12 + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(14)[rid] += 2 * stackBuffers[2].bundle(12 + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(14)[rid] += 2 * stackBuffers[0].bundle(12 + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(14)[rid] += 2 * stackBuffers[2].bundle(12 + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(14)[rid] += 2 * stackBuffers[0].bundle(12 + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(14)[rid] += 2 * stackBuffers[2].bundle(12 + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(3)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + 3)[overlap.rid1[i]] * stackBuffers[1].bundle(15).data()[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(3)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + 3)[overlap.rid1[i]] * stackBuffers[3].bundle(15).data()[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(3)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(3)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(3)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(3)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(3)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(3)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(0)[rid] -= 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + 3)[overlap.rid1[i]] * stackBuffers[1].bundle(12 + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(0)[rid] -= 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + 3)[overlap.rid1[i]] * stackBuffers[3].bundle(12 + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(0)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(0)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(0)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(0)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(0)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(0)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(1)[rid] -= 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + 3)[overlap.rid1[i]] * stackBuffers[1].bundle(12 + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(1)[rid] -= 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + 3)[overlap.rid1[i]] * stackBuffers[3].bundle(12 + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(1)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(1)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(1)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(1)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(1)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(1)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(2)[rid] -= 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + 3)[overlap.rid1[i]] * stackBuffers[1].bundle(12 + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(2)[rid] -= 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + 3)[overlap.rid1[i]] * stackBuffers[3].bundle(12 + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(2)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(2)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(2)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(2)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(2)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(2)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(7)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + 3)[overlap.rid1[i]] * stackBuffers[1].bundle(15).data()[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(7)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + 3)[overlap.rid1[i]] * stackBuffers[3].bundle(15).data()[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(7)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(7)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(7)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(7)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(7)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(7)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(4)[rid] -= 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + 3)[overlap.rid1[i]] * stackBuffers[1].bundle(12 + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(4)[rid] -= 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + 3)[overlap.rid1[i]] * stackBuffers[3].bundle(12 + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(4)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(4)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(4)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(4)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(4)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(4)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(5)[rid] -= 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + 3)[overlap.rid1[i]] * stackBuffers[1].bundle(12 + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(5)[rid] -= 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + 3)[overlap.rid1[i]] * stackBuffers[3].bundle(12 + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(5)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(5)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(5)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(5)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(5)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(5)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(6)[rid] -= 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + 3)[overlap.rid1[i]] * stackBuffers[1].bundle(12 + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(6)[rid] -= 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + 3)[overlap.rid1[i]] * stackBuffers[3].bundle(12 + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(6)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(6)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(6)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(6)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(6)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(6)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(11)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + 3)[overlap.rid1[i]] * stackBuffers[1].bundle(15).data()[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(11)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + 3)[overlap.rid1[i]] * stackBuffers[3].bundle(15).data()[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(11)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(11)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(11)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(11)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(11)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(11)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + 3)[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(8)[rid] -= 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + 3)[overlap.rid1[i]] * stackBuffers[1].bundle(12 + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(8)[rid] -= 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + 3)[overlap.rid1[i]] * stackBuffers[3].bundle(12 + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(8)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(8)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(8)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(8)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(8)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(8)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(9)[rid] -= 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + 3)[overlap.rid1[i]] * stackBuffers[1].bundle(12 + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(9)[rid] -= 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + 3)[overlap.rid1[i]] * stackBuffers[3].bundle(12 + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(9)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(9)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(9)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(9)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(9)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(9)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(10)[rid] -= 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + 3)[overlap.rid1[i]] * stackBuffers[1].bundle(12 + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(10)[rid] -= 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + 3)[overlap.rid1[i]] * stackBuffers[3].bundle(12 + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(10)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(10)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(10)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(10)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(10)[rid] += 2 * stackBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			for (int i = 0; i < overlap.size; ++i)
-			{
-				bufferRPA.bundle(10)[rid] += 2 * stackBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
-			}
-			#pragma endregion
+			bufferRPA.bundle(15)[rid] += 2 * vertexBuffers[0].bundle(15).data()[overlap.rid1[i]] * vertexBuffers[1].bundle(15).data()[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(15)[rid] += 2 * vertexBuffers[2].bundle(15).data()[overlap.rid1[i]] * vertexBuffers[3].bundle(15).data()[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(15)[rid] -= 2 * vertexBuffers[0].bundle(12 + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(15)[rid] -= 2 * vertexBuffers[2].bundle(12 + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(15)[rid] -= 2 * vertexBuffers[0].bundle(12 + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(15)[rid] -= 2 * vertexBuffers[2].bundle(12 + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(15)[rid] -= 2 * vertexBuffers[0].bundle(12 + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(15)[rid] -= 2 * vertexBuffers[2].bundle(12 + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(12)[rid] += 2 * vertexBuffers[0].bundle(15).data()[overlap.rid1[i]] * vertexBuffers[1].bundle(12 + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(12)[rid] += 2 * vertexBuffers[2].bundle(15).data()[overlap.rid1[i]] * vertexBuffers[3].bundle(12 + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(12)[rid] += 2 * vertexBuffers[0].bundle(12 + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(12)[rid] += 2 * vertexBuffers[2].bundle(12 + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(12)[rid] += 2 * vertexBuffers[0].bundle(12 + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(12)[rid] += 2 * vertexBuffers[2].bundle(12 + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(12)[rid] += 2 * vertexBuffers[0].bundle(12 + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(12)[rid] += 2 * vertexBuffers[2].bundle(12 + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(13)[rid] += 2 * vertexBuffers[0].bundle(15).data()[overlap.rid1[i]] * vertexBuffers[1].bundle(12 + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(13)[rid] += 2 * vertexBuffers[2].bundle(15).data()[overlap.rid1[i]] * vertexBuffers[3].bundle(12 + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(13)[rid] += 2 * vertexBuffers[0].bundle(12 + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(13)[rid] += 2 * vertexBuffers[2].bundle(12 + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(13)[rid] += 2 * vertexBuffers[0].bundle(12 + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(13)[rid] += 2 * vertexBuffers[2].bundle(12 + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(13)[rid] += 2 * vertexBuffers[0].bundle(12 + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(13)[rid] += 2 * vertexBuffers[2].bundle(12 + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(14)[rid] += 2 * vertexBuffers[0].bundle(15).data()[overlap.rid1[i]] * vertexBuffers[1].bundle(12 + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(14)[rid] += 2 * vertexBuffers[2].bundle(15).data()[overlap.rid1[i]] * vertexBuffers[3].bundle(12 + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(14)[rid] += 2 * vertexBuffers[0].bundle(12 + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(14)[rid] += 2 * vertexBuffers[2].bundle(12 + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(14)[rid] += 2 * vertexBuffers[0].bundle(12 + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(14)[rid] += 2 * vertexBuffers[2].bundle(12 + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(14)[rid] += 2 * vertexBuffers[0].bundle(12 + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(14)[rid] += 2 * vertexBuffers[2].bundle(12 + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(3)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[1].bundle(15).data()[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(3)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[3].bundle(15).data()[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(3)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(3)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(3)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(3)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(3)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(3)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(0)[rid] -= 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[1].bundle(12 + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(0)[rid] -= 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[3].bundle(12 + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(0)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(0)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(0)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(0)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(0)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(0)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(1)[rid] -= 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[1].bundle(12 + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(1)[rid] -= 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[3].bundle(12 + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(1)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(1)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(1)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(1)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(1)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(1)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(2)[rid] -= 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[1].bundle(12 + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(2)[rid] -= 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[3].bundle(12 + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(2)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(2)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(2)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(2)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(2)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(2)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedX1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(7)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[1].bundle(15).data()[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(7)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[3].bundle(15).data()[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(7)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(7)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(7)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(7)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(7)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(7)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(4)[rid] -= 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[1].bundle(12 + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(4)[rid] -= 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[3].bundle(12 + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(4)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(4)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(4)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(4)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(4)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(4)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(5)[rid] -= 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[1].bundle(12 + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(5)[rid] -= 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[3].bundle(12 + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(5)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(5)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(5)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(5)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(5)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(5)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(6)[rid] -= 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[1].bundle(12 + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(6)[rid] -= 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[3].bundle(12 + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(6)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(6)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(6)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(6)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(6)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(6)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedY1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(11)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[1].bundle(15).data()[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(11)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[3].bundle(15).data()[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(11)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(11)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(11)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(11)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(11)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(11)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + 3)[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(8)[rid] -= 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[1].bundle(12 + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(8)[rid] -= 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[3].bundle(12 + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(8)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(8)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(8)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(8)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(8)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(8)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(9)[rid] -= 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[1].bundle(12 + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(9)[rid] -= 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[3].bundle(12 + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(9)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(9)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(9)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(9)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(9)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(9)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(10)[rid] -= 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[1].bundle(12 + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(10)[rid] -= 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + 3)[overlap.rid1[i]] * vertexBuffers[3].bundle(12 + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(10)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(10)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedZ2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(10)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(10)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedY2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(10)[rid] += 2 * vertexBuffers[0].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[1].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			bufferRPA.bundle(10)[rid] += 2 * vertexBuffers[2].bundle(4 * static_cast<int>(overlap.transformedZ1[i]) + static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * vertexBuffers[3].bundle(4 * static_cast<int>(overlap.transformedX2[i]) + static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+		}
+		#pragma endregion
+	};
+
+	auto integralKernelT = [&](const float wp, ValueSuperbundle<float, 16> &returnBuffer) -> void
+	{
+		//RPA diagram A and B equal chalice diagram A and inverse chalice diagram B, respectively (negative sign)
+		//chalice diagram A (negative sign)
+		const TRIVertexTwoParticleAccessBuffer<n> ab0 = v4->generateAccessBuffer<n>(w1 - wp, t, w1p + wp, TRIVertexTwoParticle::FrequencyChannel::T);
+		//inverse chalice diagram B (negative sign)
+		const TRIVertexTwoParticleAccessBuffer<n> ab1 = v4->generateAccessBuffer<n>(w2p - wp, t, -w2 - wp, TRIVertexTwoParticle::FrequencyChannel::T);
+		//chalice diagram A (negative sign)
+		const TRIVertexTwoParticleAccessBuffer<n> ab2 = v4->generateAccessBuffer<n>(w1p + wp, t, w1 - wp, TRIVertexTwoParticle::FrequencyChannel::T);
+		//inverse chalice diagram B (negative sign)
+		const TRIVertexTwoParticleAccessBuffer<n> ab3 = v4->generateAccessBuffer<n>(w2 + wp, t, -w2p + wp, TRIVertexTwoParticle::FrequencyChannel::T);
+
+		v4->getValueSuperbundle(ab0, stackBuffers[0]);
+		v4->getValueSuperbundle(ab1, stackBuffers[1]);
+		v4->getValueSuperbundle(ab2, stackBuffers[2]);
+		v4->getValueSuperbundle(ab3, stackBuffers[3]);
+
+		//calculate _flow
+		returnBuffer.reset();
+		bufferRPA.reset();
+
+		//spin transformations other than plain permutations are applied explicitly to the vertex values on all transformed lattice sites
+		bool hasSpinRotations = FrgCommon::lattice().hasSpinRotations();
+		if (hasSpinRotations) _transformSites(stackBuffers, transformedBuffers);
+
+		for (int rid = 0; rid < FrgCommon::lattice().size; ++rid)
+		{
+			//lattice bubble; inactive sites remain at their bare vertex
+			if (!isSiteActive(rid)) continue;
+			if (hasSpinRotations) rpaKernel(rid, FrgCommon::lattice().getTransformedOverlap(rid), transformedBuffers);
+			else rpaKernel(rid, FrgCommon::lattice().getOverlap(rid), stackBuffers);
 		}
 		returnBuffer += bufferRPA;
 
 		//chalice diagram B (negative sign)
-		const TRIVertexTwoParticleAccessBuffer<4> ab4 = v4->generateAccessBuffer(w2p - wp, -w2 - wp, t, TRIVertexTwoParticle::FrequencyChannel::U);
+		const TRIVertexTwoParticleAccessBuffer<n> ab4 = v4->generateAccessBuffer<n>(w2p - wp, -w2 - wp, t, TRIVertexTwoParticle::FrequencyChannel::U);
 		//chalice diagram B (negative sign)
-		const TRIVertexTwoParticleAccessBuffer<4> ab5 = v4->generateAccessBuffer(w2 + wp, -w2p + wp, t, TRIVertexTwoParticle::FrequencyChannel::U);
+		const TRIVertexTwoParticleAccessBuffer<n> ab5 = v4->generateAccessBuffer<n>(w2 + wp, -w2p + wp, t, TRIVertexTwoParticle::FrequencyChannel::U);
 
 		const float valLocal4[16] = {
 			v4->getValueLocal(SpinComponent::X, SpinComponent::X, ab4),
@@ -1811,9 +1882,9 @@ void TRIFrgCore::_calculateVertexTwoParticle(const int iterator)
 		#pragma endregion
 
 		//inverse chalice diagram A (negative sign)
-		const TRIVertexTwoParticleAccessBuffer<4> ab6 = v4->generateAccessBuffer(w1 - wp, -w1p - wp, -t, TRIVertexTwoParticle::FrequencyChannel::U);
+		const TRIVertexTwoParticleAccessBuffer<n> ab6 = v4->generateAccessBuffer<n>(w1 - wp, -w1p - wp, -t, TRIVertexTwoParticle::FrequencyChannel::U);
 		//inverse chalice diagram A (negative sign)
-		const TRIVertexTwoParticleAccessBuffer<4> ab7 = v4->generateAccessBuffer(w1p + wp, -w1 + wp, -t, TRIVertexTwoParticle::FrequencyChannel::U);
+		const TRIVertexTwoParticleAccessBuffer<n> ab7 = v4->generateAccessBuffer<n>(w1p + wp, -w1 + wp, -t, TRIVertexTwoParticle::FrequencyChannel::U);
 
 		const float valLocal6[16] = {
 			v4->getValueLocal(SpinComponent::X, SpinComponent::X, ab6),
@@ -2372,11 +2443,11 @@ void TRIFrgCore::_calculateVertexTwoParticle(const int iterator)
 	{
 		//u-Channel, to be combined with P(wp, u + wp) + P(u + wp, wp)
 		//ph-ladder A and B, respectively (negative sign)
-		const TRIVertexTwoParticleAccessBuffer<4> ab0 = v4->generateAccessBuffer(w1 + wp, -w2p + wp, u, TRIVertexTwoParticle::FrequencyChannel::U);
-		const TRIVertexTwoParticleAccessBuffer<4> ab1 = v4->generateAccessBuffer(w1p + wp, w2 - wp, u, TRIVertexTwoParticle::FrequencyChannel::U);
+		const TRIVertexTwoParticleAccessBuffer<n> ab0 = v4->generateAccessBuffer<n>(w1 + wp, -w2p + wp, u, TRIVertexTwoParticle::FrequencyChannel::U);
+		const TRIVertexTwoParticleAccessBuffer<n> ab1 = v4->generateAccessBuffer<n>(w1p + wp, w2 - wp, u, TRIVertexTwoParticle::FrequencyChannel::U);
 		//ph-ladder A and B, respectively (negative sign)
-		const TRIVertexTwoParticleAccessBuffer<4> ab2 = v4->generateAccessBuffer(w2p - wp, -w1 - wp, u, TRIVertexTwoParticle::FrequencyChannel::U);
-		const TRIVertexTwoParticleAccessBuffer<4> ab3 = v4->generateAccessBuffer(w2 - wp, w1p + wp, u, TRIVertexTwoParticle::FrequencyChannel::U);
+		const TRIVertexTwoParticleAccessBuffer<n> ab2 = v4->generateAccessBuffer<n>(w2p - wp, -w1 - wp, u, TRIVertexTwoParticle::FrequencyChannel::U);
+		const TRIVertexTwoParticleAccessBuffer<n> ab3 = v4->generateAccessBuffer<n>(w2 - wp, w1p + wp, u, TRIVertexTwoParticle::FrequencyChannel::U);
 
 		v4->getValueSuperbundle(ab0, stackBuffers[0]);
 		v4->getValueSuperbundle(ab1, stackBuffers[1]);
@@ -2997,6 +3068,6 @@ void TRIFrgCore::_calculateVertexTwoParticle(const int iterator)
 
 	for (int b = 0; b < 16; ++b)
 	{
-		for (int rid = 0; rid < FrgCommon::lattice().size; ++rid) static_cast<TRIEffectiveAction *>(_flow)->vertexTwoParticle->_data[iterator * 16 * FrgCommon::lattice().size + b * FrgCommon::lattice().size + rid] = v4CurrentValue.bundle(b)[rid];
+		for (int rid = 0; rid < FrgCommon::lattice().size; ++rid) static_cast<TRIEffectiveAction *>(_flow)->vertexTwoParticle->_data[iterator * 16 * FrgCommon::lattice().size + b * FrgCommon::lattice().size + rid] = (isSiteActive(rid)) ? v4CurrentValue.bundle(b)[rid] : 0.0f;
 	}
 }
\ No newline at end of file
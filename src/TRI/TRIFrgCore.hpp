@@ -1,7 +1,7 @@
 /**
  * @file TRIFrgCore.hpp
  * @author Finn Lasse Buessen
- * @brief FrgCore implementation for time reversal invariant models.
+ * @brief FrgCore implementation for time reversal invariant models. 
  * 
  * @copyright Copyright (c) 2020
  */
@@ -10,7 +10,7 @@
 #include "FrgCore.hpp"
 
 /**
- * @brief FrgCore implementation for time reversal invariant models.
+ * @brief FrgCore implementation for time reversal invariant models. 
  */
 class TRIFrgCore : public FrgCore
 {
@@ -41,22 +41,39 @@ public:
 	 */
 	void finalizeStep(const float newCutoff) override;
 
+	/**
+	 * @brief Select the fastest variants of the kernels which compute the flow of the two-particle vertex. 
+	 * 
+	 * @param tuner Kernel tuner. 
+	 */
+	void tuneKernels(KernelTuner &tuner) override;
+
 	float normalization; ///< Energy normalization factor. 
 
 private:
 	int dataStacks[6]; ///< References to the LoadManager::DataStack. 
 
 	/**
-	 * @brief Calculate the single-particle vertex flow for a specific linear iterator, which is expanded via TRIVertexSingleParticle::expandIterator().
+	 * @brief Calculate the single-particle vertex flow for a specific linear iterator, which is expanded via TRIVertexSingleParticle::expandIterator(). 
 	 * 
 	 * @param iterator Linear iterator. 
 	 */
 	void _calculateVertexSingleParticle(const int iterator);
 
 	/**
-	 * @brief Calculate the two-particle vertex flow for a specific linear iterator, which is expanded via TRIVertexTwoParticle::expandIterator().
+	 * @brief Calculate the two-particle vertex flow for a specific linear iterator, which is expanded via TRIVertexTwoParticle::expandIterator(). 
 	 * 
+	 * @tparam n Number of support values in the frequency interpolation of vertices. Either 4 for linear or 16 for cubic interpolation. 
 	 * @param iterator Linear iterator. 
 	 */
-	void _calculateVertexTwoParticle(const int iterator);
+	template <int n> void _calculateVertexTwoParticle(const int iterator);
+
+	/**
+	 * @brief Apply spin transformations explicitly to the vertex values on all transformed lattice sites, see Lattice::getTransformedSites(). 
+	 * The transformed values can be combined via Lattice::getTransformedOverlap(). 
+	 * 
+	 * @param[in] vertexBuffers Vertex values on all representative lattice sites. 
+	 * @param[out] transformedBuffers Vertex values on all transformed lattice sites. 
+	 */
+	void _transformSites(ValueSuperbundle<float, 16> *vertexBuffers, ValueSuperbundle<float, 16> *transformedBuffers) const;
 };
\ No newline at end of file
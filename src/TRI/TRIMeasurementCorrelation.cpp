@@ -19,8 +19,7 @@
 TRIMeasurementCorrelation::TRIMeasurementCorrelation(const std::string &outfile, const float minCutoff, const float maxCutoff, const bool defer) : Measurement(outfile, minCutoff, maxCutoff, defer, true)
 {
 	_currentCutoff = -1.0f;
-	int latticeSizeExtended = 0;
-	for (auto i = FrgCommon::lattice().getRange(0); i != FrgCommon::lattice().end(); ++i) ++latticeSizeExtended;
+	int latticeSizeExtended = FrgCommon::lattice().getRangeIds(0).size();
 	int latticeSizeBasis = int(FrgCommon::lattice()._basis.size());
 	_memoryStepLattice = latticeSizeBasis * latticeSizeExtended;
 
@@ -144,6 +143,43 @@ void TRIMeasurementCorrelation::takeMeasurement(const EffectiveAction &state, co
 	}
 }
 
+std::vector<float> TRIMeasurementCorrelation::observables() const
+{
+	std::vector<float> correlations;
+	correlations.insert(correlations.end(), _correlationsXX, _correlationsXX + _memoryStepLattice);
+	correlations.insert(correlations.end(), _correlationsXY, _correlationsXY + _memoryStepLattice);
+	correlations.insert(correlations.end(), _correlationsXZ, _correlationsXZ + _memoryStepLattice);
+	correlations.insert(correlations.end(), _correlationsYX, _correlationsYX + _memoryStepLattice);
+	correlations.insert(correlations.end(), _correlationsYY, _correlationsYY + _memoryStepLattice);
+	correlations.insert(correlations.end(), _correlationsYZ, _correlationsYZ + _memoryStepLattice);
+	correlations.insert(correlations.end(), _correlationsZX, _correlationsZX + _memoryStepLattice);
+	correlations.insert(correlations.end(), _correlationsZY, _correlationsZY + _memoryStepLattice);
+	correlations.insert(correlations.end(), _correlationsZZ, _correlationsZZ + _memoryStepLattice);
+	correlations.insert(correlations.end(), _correlationsDD, _correlationsDD + _memoryStepLattice);
+	return correlations;
+}
+
+std::vector<Measurement::Observable> TRIMeasurementCorrelation::observableBuffers() const
+{
+	return {
+		{ "TRICorXX", _correlationsXX, _memoryStepLattice },
+		{ "TRICorXY", _correlationsXY, _memoryStepLattice },
+		{ "TRICorXZ", _correlationsXZ, _memoryStepLattice },
+		{ "TRICorYX", _correlationsYX, _memoryStepLattice },
+		{ "TRICorYY", _correlationsYY, _memoryStepLattice },
+		{ "TRICorYZ", _correlationsYZ, _memoryStepLattice },
+		{ "TRICorZX", _correlationsZX, _memoryStepLattice },
+		{ "TRICorZY", _correlationsZY, _memoryStepLattice },
+		{ "TRICorZZ", _correlationsZZ, _memoryStepLattice },
+		{ "TRICorDD", _correlationsDD, _memoryStepLattice }
+	};
+}
+
+bool TRIMeasurementCorrelation::isCalculated(const EffectiveAction &state) const
+{
+	return _currentCutoff == state.cutoff;
+}
+
 void TRIMeasurementCorrelation::_calculateCorrelation(const int iterator) const
 {
 	//calculate real space susceptibility
@@ -287,27 +323,36 @@ void TRIMeasurementCorrelation::_calculateCorrelation(const int iterator) const
 	}
 
 	int offset = iterator * _memoryStepLattice;
-	for (auto i = FrgCommon::lattice().getBasis(); i != FrgCommon::lattice().end(); ++i)
+	LatticeIdRange basis = FrgCommon::lattice().getBasisIds();
+	for (int nb = 0; nb < basis.size(); ++nb)
 	{
-		for (auto j = FrgCommon::lattice().getRange(i); j != FrgCommon::lattice().end(); ++j)
+		int i = basis[nb];
+		for (int j : FrgCommon::lattice().getRangeIds(nb))
 		{
-			int rid;
-            float sign =1.0f;
-			SpinComponent sx(SpinComponent::X);
-			SpinComponent sy(SpinComponent::Y);
-			SpinComponent sz(SpinComponent::Z);
-			rid = FrgCommon::lattice().symmetryTransform(i, j, sx, sy, sz,sign);
+			float m[9];
+			int rid = FrgCommon::lattice().symmetryTransform(i, j, m);
+
+			//correlations transform as chi^{ab}(i,j)=M[a][c]*M[b][d]*chi^{cd}(0,rid)
+			float correlations[3][3];
+			for (int a = 0; a < 3; ++a)
+			{
+				for (int b = 0; b < 3; ++b)
+				{
+					correlations[a][b] = 0.0f;
+					for (int c = 0; c < 3; ++c) for (int d = 0; d < 3; ++d) correlations[a][b] += m[3 * a + c] * m[3 * b + d] * susceptibility.bundle(4 * c + d)[rid];
+				}
+			}
 
 			_correlationsDD[offset] = susceptibility.bundle(15)[rid];
-			_correlationsXX[offset] = susceptibility.bundle(4 * static_cast<int>(sx) + static_cast<int>(sx))[rid];
-			_correlationsXY[offset] = susceptibility.bundle(4 * static_cast<int>(sx) + static_cast<int>(sy))[rid];
-			_correlationsXZ[offset] = susceptibility.bundle(4 * static_cast<int>(sx) + static_cast<int>(sz))[rid];
-			_correlationsYX[offset] = susceptibility.bundle(4 * static_cast<int>(sy) + static_cast<int>(sx))[rid];
-			_correlationsYY[offset] = susceptibility.bundle(4 * static_cast<int>(sy) + static_cast<int>(sy))[rid];
-			_correlationsYZ[offset] = susceptibility.bundle(4 * static_cast<int>(sy) + static_cast<int>(sz))[rid];
-			_correlationsZX[offset] = susceptibility.bundle(4 * static_cast<int>(sz) + static_cast<int>(sx))[rid];
-			_correlationsZY[offset] = susceptibility.bundle(4 * static_cast<int>(sz) + static_cast<int>(sy))[rid];
-			_correlationsZZ[offset] = susceptibility.bundle(4 * static_cast<int>(sz) + static_cast<int>(sz))[rid];
+			_correlationsXX[offset] = correlations[0][0];
+			_correlationsXY[offset] = correlations[0][1];
+			_correlationsXZ[offset] = correlations[0][2];
+			_correlationsYX[offset] = correlations[1][0];
+			_correlationsYY[offset] = correlations[1][1];
+			_correlationsYZ[offset] = correlations[1][2];
+			_correlationsZX[offset] = correlations[2][0];
+			_correlationsZY[offset] = correlations[2][1];
+			_correlationsZZ[offset] = correlations[2][2];
 
 			++offset;
 		}
@@ -357,7 +402,7 @@ void TRIMeasurementCorrelation::_writeOutfileHeader(const std::string &observabl
 		//write basis
 		float *basisBuffer = new float[3 * FrgCommon::lattice()._basis.size()];
 		i = 0;
-		for (auto b = FrgCommon::lattice().getBasis(); b != FrgCommon::lattice().end(); ++b)
+		for (int b : FrgCommon::lattice().getBasisIds())
 		{
 			basisBuffer[3 * i] = float(FrgCommon::lattice().getSitePosition(b).x);
 			basisBuffer[3 * i + 1] = float(FrgCommon::lattice().getSitePosition(b).y);
@@ -374,8 +419,7 @@ void TRIMeasurementCorrelation::_writeOutfileHeader(const std::string &observabl
 		delete[] basisBuffer;
 
 		//write sites
-		int inRangeCount = 0;
-		for (SublatticeIterator i = FrgCommon::lattice().getRange(0); i != FrgCommon::lattice().end(); ++i) ++inRangeCount;
+		int inRangeCount = FrgCommon::lattice().getRangeIds(0).size();
 
 		const int dataSpaceDimSitesReference = 2;
 		const hsize_t dataSpaceSizeSitesReference[dataSpaceDimSitesReference] = { FrgCommon::lattice()._basis.size(), hsize_t(inRangeCount) };
@@ -385,7 +429,7 @@ void TRIMeasurementCorrelation::_writeOutfileHeader(const std::string &observabl
 		int j = 0;
 		for (unsigned int b = 0; b < FrgCommon::lattice()._basis.size(); ++b)
 		{
-			for (SublatticeIterator i = FrgCommon::lattice().getRange(b); i != FrgCommon::lattice().end(); ++i)
+			for (int i : FrgCommon::lattice().getRangeIds(b))
 			{
 				*(SitesReferenceBuffer + 3 * j) = (float)FrgCommon::lattice().getSitePosition(i).x;
 				*(SitesReferenceBuffer + 3 * j + 1) = (float)FrgCommon::lattice().getSitePosition(i).y;
@@ -474,8 +518,7 @@ void TRIMeasurementCorrelation::_writeOutfileCorrelation(const std::string &obse
 	H5Sclose(attrSpace);
 
 	//write data
-	int inRangeCount = 0;
-	for (SublatticeIterator i = FrgCommon::lattice().getRange(0); i != FrgCommon::lattice().end(); ++i) ++inRangeCount;
+	int inRangeCount = FrgCommon::lattice().getRangeIds(0).size();
 	const int dataSpaceDim = 2;
 	const hsize_t dataSpaceSize[2] = { FrgCommon::lattice()._basis.size(), hsize_t(inRangeCount) };
 	hid_t dataSpace = H5Screate_simple(dataSpaceDim, dataSpaceSize, NULL);
@@ -1,7 +1,7 @@
 /**
  * @file TRIVertexTwoParticle.hpp
  * @author Finn Lasse Buessen
- * @brief Two-particle vertex implementation for time reversal invariant models.
+ * @brief Two-particle vertex implementation for time reversal invariant models. 
  * 
  * @copyright Copyright (c) 2020
  */
@@ -11,6 +11,7 @@
 #include "lib/ValueBundle.hpp"
 #include "lib/Assert.hpp"
 #include "FrgCommon.hpp"
+#include "KernelTuner.hpp"
 
 /**
  * @brief Buffer for frequency interpolation information. 
@@ -39,7 +40,7 @@ public:
 };
 
 /**
- * @brief Two-particle vertex implementation for time reversal invariant models.
+ * @brief Two-particle vertex implementation for time reversal invariant models. 
  */
 struct TRIVertexTwoParticle
 {
@@ -72,7 +73,11 @@ public:
 
 		//alloc and init memory
 		_data = new float[size];
-		memset(_data, 0, sizeof(float) * size);
+		//first touch in parallel, such that memory pages are placed close to the threads which compute the flow
+		#ifndef DISABLE_OMP
+		#pragma omp parallel for schedule(static)
+		#endif
+		for (int i = 0; i < size; ++i) _data[i] = 0.0f;
 	}
 
 	/**
@@ -189,6 +194,13 @@ public:
 	 */
 	float getValue(LatticeIterator i1, LatticeIterator i2, float s, float t, float u, SpinComponent s1, SpinComponent s2, const FrequencyChannel channel) const
 	{
+		//higher-order interpolation is performed via access buffers
+		if (FrgCommon::frequency().interpolation == FrequencyDiscretization::Interpolation::Cubic && channel != FrequencyChannel::All)
+		{
+			if (channel == FrequencyChannel::None) return getValue(i1, i2, s1, s2, generateAccessBuffer<64>(s, t, u));
+			else return getValue(i1, i2, s1, s2, generateAccessBuffer<16>(s, t, u, channel));
+		}
+
 		ASSERT(channel == FrequencyChannel::S || channel == FrequencyChannel::T || channel == FrequencyChannel::U || channel == FrequencyChannel::None || channel == FrequencyChannel::All);
 
 		//map to positive frequency sector
@@ -212,6 +224,27 @@ public:
 			sign *= _zeta(static_cast<int>(s1)) *_zeta(static_cast<int>(s2));
 		}
 
+		//transformations which are not plain permutations act as v^{s1s2}(i1,i2)=M[s1][c]*M[s2][d]*v^{cd}(0,i2') on the spin components
+		if (FrgCommon::lattice().hasSpinRotation(i1, i2))
+		{
+			float m[9];
+			LatticeIterator rid = FrgCommon::lattice().fromParametrization(FrgCommon::lattice().symmetryTransform(i1, i2, m));
+
+			float value = 0.0f;
+			for (int c = 0; c < 4; ++c)
+			{
+				float w1 = _spinTransformationWeight(m, static_cast<int>(s1), c);
+				if (w1 == 0.0f) continue;
+				for (int d = 0; d < 4; ++d)
+				{
+					float w2 = _spinTransformationWeight(m, static_cast<int>(s2), d);
+					if (w2 == 0.0f) continue;
+					value += w1 * w2 * getValue(FrgCommon::lattice().zero(), rid, s, t, u, static_cast<SpinComponent>(c), static_cast<SpinComponent>(d), channel);
+				}
+			}
+			return sign * value;
+		}
+
 		// int siteOffset = FrgCommon::lattice().symmetryTransform(i1, i2, s1, s2);   // Need to make changes here , update with sign
         
 		int siteOffset = FrgCommon::lattice().symmetryTransform(i1, i2, s1, s2,sign);
@@ -311,7 +344,7 @@ public:
 	}
 
 	/**
-	 * @brief Access vertex value at arbitrary lattice sites and spin components via a given access buffer.
+	 * @brief Access vertex value at arbitrary lattice sites and spin components via a given access buffer. 
 	 * 
 	 * @tparam n Number of support sites in the access buffer. 
 	 * @param i1 First lattice site argument. 
@@ -328,6 +361,28 @@ public:
 			std::swap(i1, i2);
 			std::swap(s1, s2);
 		}
+
+		//transformations which are not plain permutations act as v^{s1s2}(i1,i2)=M[s1][c]*M[s2][d]*v^{cd}(0,i2') on the spin components
+		if (FrgCommon::lattice().hasSpinRotation(i1, i2))
+		{
+			float m[9];
+			int siteOffset = FrgCommon::lattice().symmetryTransform(i1, i2, m);
+
+			float value = 0.0f;
+			for (int c = 0; c < 4; ++c)
+			{
+				float w1 = _spinTransformationWeight(m, static_cast<int>(s1), c);
+				if (w1 == 0.0f) continue;
+				for (int d = 0; d < 4; ++d)
+				{
+					float w2 = _spinTransformationWeight(m, static_cast<int>(s2), d);
+					if (w2 == 0.0f) continue;
+					int spinOffset = (4 * c + d) * FrgCommon::lattice().size;
+					for (int i = 0; i < n; ++i) value += w1 * w2 * accessBuffer.sign[i][c][d] * accessBuffer.frequencyWeights[i] * _data[accessBuffer.frequencyOffsets[i] + spinOffset + siteOffset];
+				}
+			}
+			return value;
+		}
 		
 		//int siteOffset = FrgCommon::lattice().symmetryTransform(i1, i2, s1, s2);   // update this with sign.
 		
@@ -375,6 +430,31 @@ public:
 		superbundle.reset();
 		const LatticeSiteDescriptor *sites = (accessBuffer.pairExchange) ? FrgCommon::lattice().getInvertedSites() : FrgCommon::lattice().getSites();
 
+		if (KernelTuner::gatherOrder == KernelTuner::GatherOrder::SiteMajor)
+		{
+			for (int j = 0; j < FrgCommon::lattice().size; ++j)
+			{
+				if (sites[j].spinRotation >= 0) continue;
+				for (int s1 = 0; s1 < 4; ++s1)
+				{
+					for (int s2 = 0; s2 < 4; ++s2)
+					{
+						int s1t = (accessBuffer.pairExchange) ? s2 : s1;
+						int s2t = (accessBuffer.pairExchange) ? s1 : s2;
+						if (s1t < 3) s1t = static_cast<int>(sites[j].spinPermutation[s1t]);
+						if (s2t < 3) s2t = static_cast<int>(sites[j].spinPermutation[s2t]);
+						const float *data = _data + (4 * s1t + s2t) * FrgCommon::lattice().size + sites[j].rid;
+
+						float value = 0.0f;
+						for (int i = 0; i < n; ++i) value += accessBuffer.sign[i][s1][s2] * accessBuffer.frequencyWeights[i] * data[accessBuffer.frequencyOffsets[i]];
+						superbundle.bundle(4 * s1 + s2)[j] = value;
+					}
+				}
+			}
+			if (FrgCommon::lattice().hasSpinRotations()) _getValueSuperbundleRotated(accessBuffer, sites, superbundle);
+			return;
+		}
+
 		for (int i = 0; i < n; ++i)
 		{
 			for (int s1 = 0; s1 < 4; ++s1)
@@ -383,6 +463,7 @@ public:
 				{
 					for (int j = 0; j < FrgCommon::lattice().size; ++j)
 					{
+						if (sites[j].spinRotation >= 0) continue;
 						int s1t = (accessBuffer.pairExchange) ? s2 : s1;
 						int s2t = (accessBuffer.pairExchange) ? s1 : s2;
 						if (s1t < 3) s1t = static_cast<int>(sites[j].spinPermutation[s1t]);
@@ -394,22 +475,27 @@ public:
 				}
 			}
 		}
+		if (FrgCommon::lattice().hasSpinRotations()) _getValueSuperbundleRotated(accessBuffer, sites, superbundle);
 	}
 
 	/**
 	 * @brief Generate an access buffer for a set of frequencies where one of them (specified by channel) exactly lies on the frequency mesh. 
 	 * 
+	 * @tparam n Number of support values. Either 4 for linear or 16 for cubic interpolation. 
 	 * @param s First frequency argument. 
 	 * @param t Second frequency argument. 
 	 * @param u Third frequency argument. 
 	 * @param channel Frequency channel. 
-	 * @return TRIVertexTwoParticleAccessBuffer<4> Access buffer. 
+	 * @return TRIVertexTwoParticleAccessBuffer<n> Access buffer. 
 	 */
-	TRIVertexTwoParticleAccessBuffer<4> generateAccessBuffer(float s, float t, float u, const FrequencyChannel channel) const
+	template <int n = 4> TRIVertexTwoParticleAccessBuffer<n> generateAccessBuffer(float s, float t, float u, const FrequencyChannel channel) const
 	{
 		ASSERT(channel == FrequencyChannel::S || channel == FrequencyChannel::T || channel == FrequencyChannel::U);
 
-		TRIVertexTwoParticleAccessBuffer<4> ab;
+		static_assert(n == 4 || n == 16, "Access buffer must hold either 4 or 16 support values");
+		constexpr int k = (n == 16) ? 4 : 2;
+
+		TRIVertexTwoParticleAccessBuffer<n> ab;
 
 		//map to positive frequency sector
 		if (s < 0)
@@ -420,7 +506,7 @@ public:
 		if (t < 0)
 		{
 			t = -t;
-			for (int i = 0; i < 4; ++i)
+			for (int i = 0; i < n; ++i)
 			{
 				for (int s1 = 0; s1 <= 3; ++s1)
 				{
@@ -435,7 +521,7 @@ public:
 		{
 			u = -u;
 			ab.pairExchange = !ab.pairExchange;
-			for (int i = 0; i < 4; ++i)
+			for (int i = 0; i < n; ++i)
 			{
 				for (int s1 = 0; s1 <= 3; ++s1)
 				{
@@ -451,60 +537,53 @@ public:
 		if (channel == FrequencyChannel::S)
 		{
 			int exactS = FrgCommon::frequency().offset(s);
-			int lowerT, upperT;
-			float biasT;
-			int lowerU, upperU;
-			float biasU;
-			FrgCommon::frequency().interpolateOffset(t, lowerT, upperT, biasT);
-			FrgCommon::frequency().interpolateOffset(u, lowerU, upperU, biasU);
+			int offsetsT[k], offsetsU[k];
+			float weightsT[k], weightsU[k];
+			FrgCommon::frequency().interpolateStencil<k>(t, offsetsT, weightsT);
+			FrgCommon::frequency().interpolateStencil<k>(u, offsetsU, weightsU);
 
-			ab.frequencyWeights[0] = (1 - biasU) * (1 - biasT);
-			_generateAccessBufferOffsetMapFrequencyExchange(exactS, lowerT, lowerU, 0, ab);
-			ab.frequencyWeights[1] = (1 - biasU) * biasT;
-			_generateAccessBufferOffsetMapFrequencyExchange(exactS, upperT, lowerU, 1, ab);
-			ab.frequencyWeights[2] = biasU * (1 - biasT);
-			_generateAccessBufferOffsetMapFrequencyExchange(exactS, lowerT, upperU, 2, ab);
-			ab.frequencyWeights[3] = biasU * biasT;
-			_generateAccessBufferOffsetMapFrequencyExchange(exactS, upperT, upperU, 3, ab);
+			for (int j = 0; j < k; ++j)
+			{
+				for (int i = 0; i < k; ++i)
+				{
+					ab.frequencyWeights[k * j + i] = weightsU[j] * weightsT[i];
+					_generateAccessBufferOffsetMapFrequencyExchange(exactS, offsetsT[i], offsetsU[j], k * j + i, ab);
+				}
+			}
 		}
 		else if (channel == FrequencyChannel::T)
 		{
 			int exactT = FrgCommon::frequency().offset(t);
-			int lowerS, upperS;
-			float biasS;
-			int lowerU, upperU;
-			float biasU;
-			FrgCommon::frequency().interpolateOffset(s, lowerS, upperS, biasS);
-			FrgCommon::frequency().interpolateOffset(u, lowerU, upperU, biasU);
-
-			ab.frequencyWeights[0] = (1 - biasU) * (1 - biasS);
-			_generateAccessBufferOffsetMapFrequencyExchange(lowerS, exactT, lowerU, 0, ab);
-			ab.frequencyWeights[1] = (1 - biasU) * biasS;
-			_generateAccessBufferOffsetMapFrequencyExchange(upperS, exactT, lowerU, 1, ab);
-			ab.frequencyWeights[2] = biasU * (1 - biasS);
-			_generateAccessBufferOffsetMapFrequencyExchange(lowerS, exactT, upperU, 2, ab);
-			ab.frequencyWeights[3] = biasU * biasS;
-			_generateAccessBufferOffsetMapFrequencyExchange(upperS, exactT, upperU, 3, ab);
+			int offsetsS[k], offsetsU[k];
+			float weightsS[k], weightsU[k];
+			FrgCommon::frequency().interpolateStencil<k>(s, offsetsS, weightsS);
+			FrgCommon::frequency().interpolateStencil<k>(u, offsetsU, weightsU);
 
+			for (int j = 0; j < k; ++j)
+			{
+				for (int i = 0; i < k; ++i)
+				{
+					ab.frequencyWeights[k * j + i] = weightsU[j] * weightsS[i];
+					_generateAccessBufferOffsetMapFrequencyExchange(offsetsS[i], exactT, offsetsU[j], k * j + i, ab);
+				}
+			}
 		}
 		else if (channel == FrequencyChannel::U)
 		{
 			int exactU = FrgCommon::frequency().offset(u);
-			int lowerS, upperS;
-			float biasS;
-			int lowerT, upperT;
-			float biasT;
-			FrgCommon::frequency().interpolateOffset(s, lowerS, upperS, biasS);
-			FrgCommon::frequency().interpolateOffset(t, lowerT, upperT, biasT);
+			int offsetsS[k], offsetsT[k];
+			float weightsS[k], weightsT[k];
+			FrgCommon::frequency().interpolateStencil<k>(s, offsetsS, weightsS);
+			FrgCommon::frequency().interpolateStencil<k>(t, offsetsT, weightsT);
 
-			ab.frequencyWeights[0] = (1 - biasT) * (1 - biasS);
-			_generateAccessBufferOffsetMapFrequencyExchange(lowerS, lowerT, exactU, 0, ab);
-			ab.frequencyWeights[1] = (1 - biasT) * biasS;
-			_generateAccessBufferOffsetMapFrequencyExchange(upperS, lowerT, exactU, 1, ab);
-			ab.frequencyWeights[2] = biasT * (1 - biasS);
-			_generateAccessBufferOffsetMapFrequencyExchange(lowerS, upperT, exactU, 2, ab);
-			ab.frequencyWeights[3] = biasT * biasS;
-			_generateAccessBufferOffsetMapFrequencyExchange(upperS, upperT, exactU, 3, ab);
+			for (int j = 0; j < k; ++j)
+			{
+				for (int i = 0; i < k; ++i)
+				{
+					ab.frequencyWeights[k * j + i] = weightsT[j] * weightsS[i];
+					_generateAccessBufferOffsetMapFrequencyExchange(offsetsS[i], offsetsT[j], exactU, k * j + i, ab);
+				}
+			}
 		}
 
 		return ab;
@@ -513,14 +592,18 @@ public:
 	/**
 	 * @brief Generate an access buffer for an arbitrary set of frequencies. 
 	 * 
+	 * @tparam n Number of support values. Either 8 for linear or 64 for cubic interpolation. 
 	 * @param s First frequency argument. 
 	 * @param t Second frequency argument. 
 	 * @param u Third frequency argument. 
-	 * @return TRIVertexTwoParticleAccessBuffer<8> Access buffer. 
+	 * @return TRIVertexTwoParticleAccessBuffer<n> Access buffer. 
 	 */
-	TRIVertexTwoParticleAccessBuffer<8> generateAccessBuffer(float s, float t, float u) const
+	template <int n = 8> TRIVertexTwoParticleAccessBuffer<n> generateAccessBuffer(float s, float t, float u) const
 	{
-		TRIVertexTwoParticleAccessBuffer<8> ab;
+		static_assert(n == 8 || n == 64, "Access buffer must hold either 8 or 64 support values");
+		constexpr int k = (n == 64) ? 4 : 2;
+
+		TRIVertexTwoParticleAccessBuffer<n> ab;
 
 		//map to positive frequency sector
 		if (s < 0)
@@ -531,7 +614,7 @@ public:
 		if (t < 0)
 		{
 			t = -t;
-			for (int i = 0; i < 8; ++i)
+			for (int i = 0; i < n; ++i)
 			{
 				for (int s1 = 0; s1 <= 3; ++s1)
 				{
@@ -547,7 +630,7 @@ public:
 		{
 			u = -u;
 			ab.pairExchange = !ab.pairExchange;
-			for (int i = 0; i < 8; ++i)
+			for (int i = 0; i < n; ++i)
 			{
 				for (int s1 = 0; s1 <= 3; ++s1)
 				{
@@ -560,45 +643,36 @@ public:
 			}
 		}
 
-		int lowerS, upperS;
-		float biasS;
-		int lowerT, upperT;
-		float biasT;
-		int lowerU, upperU;
-		float biasU;
-
-		FrgCommon::frequency().interpolateOffset(s, lowerS, upperS, biasS);
-		FrgCommon::frequency().interpolateOffset(t, lowerT, upperT, biasT);
-		FrgCommon::frequency().interpolateOffset(u, lowerU, upperU, biasU);
-
-		ab.frequencyWeights[0] = (1 - biasT) * (1 - biasS) * (1 - biasU);
-		_generateAccessBufferOffsetMapFrequencyExchange(lowerS, lowerT, lowerU, 0, ab);
-		ab.frequencyWeights[1] = (1 - biasT) * biasS * (1 - biasU);
-		_generateAccessBufferOffsetMapFrequencyExchange(upperS, lowerT, lowerU, 1, ab);
-		ab.frequencyWeights[2] = biasT * (1 - biasS) * (1 - biasU);
-		_generateAccessBufferOffsetMapFrequencyExchange(lowerS, upperT, lowerU, 2, ab);
-		ab.frequencyWeights[3] = biasT * biasS * (1 - biasU);
-		_generateAccessBufferOffsetMapFrequencyExchange(upperS, upperT, lowerU, 3, ab);
-		ab.frequencyWeights[4] = (1 - biasT) * (1 - biasS) * biasU;
-		_generateAccessBufferOffsetMapFrequencyExchange(lowerS, lowerT, upperU, 4, ab);
-		ab.frequencyWeights[5] = (1 - biasT) * biasS * biasU;
-		_generateAccessBufferOffsetMapFrequencyExchange(upperS, lowerT, upperU, 5, ab);
-		ab.frequencyWeights[6] = biasT * (1 - biasS) * biasU;
-		_generateAccessBufferOffsetMapFrequencyExchange(lowerS, upperT, upperU, 6, ab);
-		ab.frequencyWeights[7] = biasT * biasS * biasU;
-		_generateAccessBufferOffsetMapFrequencyExchange(upperS, upperT, upperU, 7, ab);
+		int offsetsS[k], offsetsT[k], offsetsU[k];
+		float weightsS[k], weightsT[k], weightsU[k];
+
+		FrgCommon::frequency().interpolateStencil<k>(s, offsetsS, weightsS);
+		FrgCommon::frequency().interpolateStencil<k>(t, offsetsT, weightsT);
+		FrgCommon::frequency().interpolateStencil<k>(u, offsetsU, weightsU);
+
+		for (int l = 0; l < k; ++l)
+		{
+			for (int j = 0; j < k; ++j)
+			{
+				for (int i = 0; i < k; ++i)
+				{
+					ab.frequencyWeights[k * k * l + k * j + i] = weightsT[j] * weightsS[i] * weightsU[l];
+					_generateAccessBufferOffsetMapFrequencyExchange(offsetsS[i], offsetsT[j], offsetsU[l], k * k * l + k * j + i, ab);
+				}
+			}
+		}
 
 		return ab;
 	}
 
 	/**
-	 * @brief Directly access a vertex via given spin components, frequency, and site offsets, where sOffset may be lesser than uOffset.
+	 * @brief Directly access a vertex via given spin components, frequency, and site offsets, where sOffset may be lesser than uOffset. 
 	 * 
 	 * @param siteOffset Lattice site offset (number of elements). 
 	 * @param sOffset First frequency offset (number of elements). 
 	 * @param tOffset Second frequency offset (number of elements). 
 	 * @param uOffset Third frequency offset (number of elements). 
-	 * @param s1 First vertex channel.
+	 * @param s1 First vertex channel. 
 	 * @param s2 Second vertex channel. 
 	 * @return float Vertex value. 
 	 */
@@ -614,13 +688,13 @@ public:
 	}
 
 	/**
-	 * @brief Directly access a vertex via given spin components, frequency, and site offsets, where sOffset >= uOffset.
+	 * @brief Directly access a vertex via given spin components, frequency, and site offsets, where sOffset >= uOffset. 
 	 * 
 	 * @param siteOffset Lattice site offset (number of elements). 
 	 * @param sOffset First frequency offset (number of elements). 
 	 * @param tOffset Second frequency offset (number of elements). 
 	 * @param uOffset Third frequency offset (number of elements). 
-	 * @param s1 First vertex channel.
+	 * @param s1 First vertex channel. 
 	 * @param s2 Second vertex channel. 
 	 * @return float Vertex value. 
 	 */
@@ -683,6 +757,62 @@ public:
 		return (s1 <= 2) ? -1.0f : 1.0f;
 	}
 
+	/**
+	 * @brief Helper function for spin transformations. Returns the matrix element M[s][c] of a spin transformation M, which is extended to the density component as the identity. 
+	 * 
+	 * @param m Spin transformation in row-major order, as obtained from Lattice::symmetryTransform(). 
+	 * @param s Transformed component. 
+	 * @param c Stored component. 
+	 * @return float Matrix element. 
+	 */
+	float _spinTransformationWeight(const float *m, const int s, const int c) const
+	{
+		if (s == 3 || c == 3) return (s == c) ? 1.0f : 0.0f;
+		return m[3 * s + c];
+	}
+
+	/**
+	 * @brief Bundled vertex access on all lattice sites whose symmetry transformation is not a plain permutation of spin components. 
+	 * The vertex is evaluated as v^{s1s2}=M[s1][c]*M[s2][d]*v^{cd} from its stored components. 
+	 * 
+	 * @tparam n Number of support sites in the access buffer. 
+	 * @param[in] accessBuffer Access buffer. 
+	 * @param[in] sites Site descriptors which correspond to the exchange state of the access buffer. 
+	 * @param[out] superbundle Vertex value bundle. 
+	 */
+	template <int n> void _getValueSuperbundleRotated(const TRIVertexTwoParticleAccessBuffer<n> &accessBuffer, const LatticeSiteDescriptor *sites, ValueSuperbundle<float, 16> &superbundle) const
+	{
+		for (int j = 0; j < FrgCommon::lattice().size; ++j)
+		{
+			if (sites[j].spinRotation < 0) continue;
+			const float *m = FrgCommon::lattice().getSpinRotation(sites[j].spinRotation);
+
+			for (int s1 = 0; s1 < 4; ++s1)
+			{
+				for (int s2 = 0; s2 < 4; ++s2)
+				{
+					int s1t = (accessBuffer.pairExchange) ? s2 : s1;
+					int s2t = (accessBuffer.pairExchange) ? s1 : s2;
+
+					float value = 0.0f;
+					for (int c = 0; c < 4; ++c)
+					{
+						float w1 = _spinTransformationWeight(m, s1t, c);
+						if (w1 == 0.0f) continue;
+						for (int d = 0; d < 4; ++d)
+						{
+							float w = w1 * _spinTransformationWeight(m, s2t, d);
+							if (w == 0.0f) continue;
+							const float *data = _data + (4 * c + d) * FrgCommon::lattice().size + sites[j].rid;
+							for (int i = 0; i < n; ++i) value += w * accessBuffer.sign[i][s1][s2] * accessBuffer.frequencyWeights[i] * data[accessBuffer.frequencyOffsets[i]];
+						}
+					}
+					superbundle.bundle(4 * s1 + s2)[j] = value;
+				}
+			}
+		}
+	}
+
 	//vertex internal data
 	int size; ///< Size of the vertex (number of elements). 
 	int sizeFrequency; ///< Size of the vertex in the frequency subspace (number of elements). 
@@ -9,18 +9,24 @@
 #include "TaskFileParser.hpp"
 #include <set>
 #include <string>
+#include <sstream>
+#include <iomanip>
 #include <boost/filesystem.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 #include "lib/InputParser.hpp"
 #include "lib/Timestamp.hpp"
 #include "LatticeModelFactory.hpp"
 #include "FrgCoreFactory.hpp"
+#include "FrequencyOptimizer.hpp"
 #include "SpinParser.hpp"
 
 
 TaskFileParser::TaskFileParser(const std::string &taskFilePath, FrequencyDiscretization *&frequency, CutoffDiscretization *&cutoff, Lattice *&lattice, FrgCore *&frgCore, ComputationStatus &computationStatus)
 {
+	StartupPipeline *startup = SpinParser::spinParser()->getStartupPipeline();
+
 	//parse xml document
+	startup->beginPhase("task file");
 	boost::property_tree::read_xml(taskFilePath, _taskFile, boost::property_tree::xml_parser::no_concat_text);
 
 	//validate global task file structure
@@ -98,15 +104,33 @@ TaskFileParser::TaskFileParser(const std::string &taskFilePath, FrequencyDiscret
 			}
 		}
 	}
+
+	//a continued calculation reads the checkpoint concurrently with the construction of the lattice model
+	if (computationStatus.statusIdentifier == ComputationStatus::Identifier::Running)
+	{
+		std::string checkpointFile = SpinParser::spinParser()->getFileset().checkpointFile;
+		startup->launch("checkpoint prefetch", [checkpointFile]() { EffectiveAction::prefetchDataFile(checkpointFile); });
+	}
 	#pragma endregion
 
 	//frequency
 	#pragma region frequency
-	_validateProperties(_taskFile, "task.parameters.frequency", {}, { "discretization" }, { "min", "max", "count", "value" });
+	_validateProperties(_taskFile, "task.parameters.frequency", {}, { "discretization" }, { "min", "max", "count", "value", "pilotRange", "pilotIterations" }, { "interpolation" });
+
+	FrequencyDiscretization::Interpolation interpolation = FrequencyDiscretization::Interpolation::Linear;
+	if (_taskFile.get_optional<std::string>("task.parameters.frequency.<xmlattr>.interpolation"))
+	{
+		std::string interpolationIdentifier = _taskFile.get<std::string>("task.parameters.frequency.<xmlattr>.interpolation");
+		if (interpolationIdentifier == "linear") interpolation = FrequencyDiscretization::Interpolation::Linear;
+		else if (interpolationIdentifier == "cubic") interpolation = FrequencyDiscretization::Interpolation::Cubic;
+		else throw Exception(Exception::Type::InitializationError, "Invalid task file. Unknown attribute value '" + interpolationIdentifier + "' (task.parameters.frequency.interpolation)");
+	}
 
-	if (_taskFile.get<std::string>("task.parameters.frequency.<xmlattr>.discretization") == "exponential")
+	if (_taskFile.get<std::string>("task.parameters.frequency.<xmlattr>.discretization") == "exponential" || _taskFile.get<std::string>("task.parameters.frequency.<xmlattr>.discretization") == "auto")
 	{
-		_validateProperties(_taskFile, "task.parameters.frequency", { "min", "max", "count" }, { "discretization" });
+		//automatic discretizations are seeded with an exponential discretization, which is optimized once the lattice model is known
+		if (_taskFile.get<std::string>("task.parameters.frequency.<xmlattr>.discretization") == "auto") _validateProperties(_taskFile, "task.parameters.frequency", { "min", "max", "count" }, { "discretization" }, { "pilotRange", "pilotIterations" }, { "interpolation" });
+		else _validateProperties(_taskFile, "task.parameters.frequency", { "min", "max", "count" }, { "discretization" }, {}, { "interpolation" });
 
 		//populate discretization automatically
 		float min = InputParser::stringToFloat(_taskFile.get<std::string>("task.parameters.frequency.min.<xmltext>"));
@@ -122,12 +146,12 @@ TaskFileParser::TaskFileParser(const std::string &taskFilePath, FrequencyDiscret
 		float step = powf(max / min, 1.0f/(count - 1));
 		for (int i = 0; i < count; ++i) frequencies.push_back(min*powf(step,float(i)));
 
-		frequency = new FrequencyDiscretization(frequencies);
+		frequency = new FrequencyDiscretization(frequencies, interpolation);
 		Log::log << Log::LogLevel::Info << "Generated exponential frequency discretization with " << frequencies.size() << " values" << Log::endl;
 	}
 	else if (_taskFile.get<std::string>("task.parameters.frequency.<xmlattr>.discretization") == "manual")
 	{
-		_validateProperties(_taskFile, "task.parameters.frequency", {}, { "discretization" }, { "value" });
+		_validateProperties(_taskFile, "task.parameters.frequency", {}, { "discretization" }, { "value" }, { "interpolation" });
 
 		std::vector<float> frequencies;
 		for (auto node : _taskFile.get_child("task.parameters.frequency"))
@@ -145,18 +169,18 @@ TaskFileParser::TaskFileParser(const std::string &taskFilePath, FrequencyDiscret
 		}
 
 		//set up frequency parametrization
-		frequency = new FrequencyDiscretization(frequencies);
+		frequency = new FrequencyDiscretization(frequencies, interpolation);
 	}
 	else throw Exception(Exception::Type::InitializationError, "Invalid task file. Unknown attribute value '" + _taskFile.get<std::string>("task.parameters.frequency.<xmlattr>.discretization") + "' (task.parameters.frequency.discretization)");
 	#pragma endregion
 
 	//cutoff
 	#pragma region cutoff
-	_validateProperties(_taskFile, "task.parameters.cutoff", {}, { "discretization" }, { "min", "max", "step", "value" });
+	_validateProperties(_taskFile, "task.parameters.cutoff", {}, { "discretization" }, { "min", "max", "step", "value" }, { "refinement", "refinementThreshold", "integrator", "multirate", "multirateTolerance" });
 
 	if (_taskFile.get<std::string>("task.parameters.cutoff.<xmlattr>.discretization") == "exponential")
 	{
-		_validateProperties(_taskFile, "task.parameters.cutoff", { "min", "max", "step" }, { "discretization" });
+		_validateProperties(_taskFile, "task.parameters.cutoff", { "min", "max", "step" }, { "discretization" }, {}, { "refinement", "refinementThreshold", "integrator", "multirate", "multirateTolerance" });
 
 		//populate discretization automatically
 		float min = InputParser::stringToFloat(_taskFile.get<std::string>("task.parameters.cutoff.min.<xmltext>"));
@@ -180,7 +204,7 @@ TaskFileParser::TaskFileParser(const std::string &taskFilePath, FrequencyDiscret
 	}
 	else if (_taskFile.get<std::string>("task.parameters.cutoff.<xmlattr>.discretization") == "manual")
 	{
-		_validateProperties(_taskFile, "task.parameters.cutoff", {}, { "discretization" }, { "value" });
+		_validateProperties(_taskFile, "task.parameters.cutoff", {}, { "discretization" }, { "value" }, { "refinement", "refinementThreshold", "integrator", "multirate", "multirateTolerance" });
 
 		//populate discretization manually
 		std::vector<float> cutoffValues;
@@ -196,11 +220,44 @@ TaskFileParser::TaskFileParser(const std::string &taskFilePath, FrequencyDiscret
 		cutoff = new CutoffDiscretization(cutoffValues);
 	}
 	else throw Exception(Exception::Type::InitializationError, "Invalid task file. Unknown attribute value '" + _taskFile.get<std::string>("task.parameters.cutoff.<xmlattr>.discretization") + "' (task.parameters.cutoff.discretization)");
+
+	//optional refinement pass
+	if (_taskFile.get_optional<std::string>("task.parameters.cutoff.<xmlattr>.refinement"))
+	{
+		cutoff->refinement = std::stoi(_taskFile.get<std::string>("task.parameters.cutoff.<xmlattr>.refinement"));
+		if (cutoff->refinement < 1) throw Exception(Exception::Type::InitializationError, "Invalid task file. Attribute 'task.parameters.cutoff.refinement' must be positive");
+	}
+	if (_taskFile.get_optional<std::string>("task.parameters.cutoff.<xmlattr>.refinementThreshold"))
+	{
+		cutoff->refinementThreshold = InputParser::stringToFloat(_taskFile.get<std::string>("task.parameters.cutoff.<xmlattr>.refinementThreshold"));
+		if (cutoff->refinementThreshold <= 0) throw Exception(Exception::Type::InitializationError, "Invalid task file. Attribute 'task.parameters.cutoff.refinementThreshold' must be positive");
+	}
+
+	//optional integration scheme
+	if (_taskFile.get_optional<std::string>("task.parameters.cutoff.<xmlattr>.integrator"))
+	{
+		std::string integrator = _taskFile.get<std::string>("task.parameters.cutoff.<xmlattr>.integrator");
+		if (integrator == "euler") cutoff->integrator = CutoffDiscretization::Integrator::Euler;
+		else if (integrator == "implicit") cutoff->integrator = CutoffDiscretization::Integrator::Implicit;
+		else throw Exception(Exception::Type::InitializationError, "Invalid task file. Unknown attribute value '" + integrator + "' (task.parameters.cutoff.integrator)");
+	}
+
+	//optional multi-rate evaluation of the flow
+	if (_taskFile.get_optional<std::string>("task.parameters.cutoff.<xmlattr>.multirate"))
+	{
+		cutoff->multirate = std::stoi(_taskFile.get<std::string>("task.parameters.cutoff.<xmlattr>.multirate"));
+		if (cutoff->multirate < 1) throw Exception(Exception::Type::InitializationError, "Invalid task file. Attribute 'task.parameters.cutoff.multirate' must be positive");
+	}
+	if (_taskFile.get_optional<std::string>("task.parameters.cutoff.<xmlattr>.multirateTolerance"))
+	{
+		cutoff->multirateTolerance = InputParser::stringToFloat(_taskFile.get<std::string>("task.parameters.cutoff.<xmlattr>.multirateTolerance"));
+		if (cutoff->multirateTolerance <= 0) throw Exception(Exception::Type::InitializationError, "Invalid task file. Attribute 'task.parameters.cutoff.multirateTolerance' must be positive");
+	}
 	#pragma endregion
 
 	//lattice model
 	#pragma region lattice model
-	_validateProperties(_taskFile, "task.parameters.lattice", {}, { "name", "range" });
+	_validateProperties(_taskFile, "task.parameters.lattice", {}, { "name", "range" }, {}, { "initialRange", "rangeThreshold" });
 	_validateRequiredAttributes(_taskFile, "task.parameters.model", { "name", "symmetry" });
 
 	int latticerange = std::stoi(_taskFile.get<std::string>("task.parameters.lattice.<xmlattr>.range"));
@@ -219,13 +276,130 @@ TaskFileParser::TaskFileParser(const std::string &taskFilePath, FrequencyDiscret
 		if (status.second == false) throw Exception(Exception::Type::InitializationError, "Invalid task file. Multiple definitions of parameter 'task.parameters.model." + optionName + "'");
 	}
 
+	startup->beginPhase("resources");
 	LatticeModelFactory::LatticeUnitCell factoryLatticeUC(latticeName, SpinParser::spinParser()->getCommandLineOptions()->resourcePath());
 	LatticeModelFactory::SpinModelUnitCell factorySpinUC(modelName, SpinParser::spinParser()->getCommandLineOptions()->resourcePath(), options);
-	std::pair<Lattice *, SpinModel *> factoryProduct = LatticeModelFactory::newLatticeModel(factoryLatticeUC, factorySpinUC, latticerange, boost::filesystem::path(taskFilePath).replace_extension("ldf").string());
+
+	//optionally map the spin model onto a cheaper FRG core by a sublattice-dependent spin rotation
+	std::string rotation = "none";
+	if (_taskFile.get_optional<std::string>("task.parameters.model.<xmlattr>.rotation")) rotation = _taskFile.get<std::string>("task.parameters.model.<xmlattr>.rotation");
+	if (rotation == "auto")
+	{
+		const std::vector<std::string> coreCost = { "SU2", "XYZ", "U1", "TRI" };
+		LatticeModelFactory::SpinModelUnitCell rotatedSpinUC = factorySpinUC;
+		std::string rotatedCoreIdentifier = LatticeModelFactory::rotateSpinModel(factoryLatticeUC, rotatedSpinUC);
+
+		auto requestedCost = std::find(coreCost.begin(), coreCost.end(), coreIdentifier);
+		auto rotatedCost = std::find(coreCost.begin(), coreCost.end(), rotatedCoreIdentifier);
+
+		if (requestedCost != coreCost.end() && rotatedCost < requestedCost)
+		{
+			factorySpinUC = rotatedSpinUC;
+			Log::log << Log::LogLevel::Info << "Mapped spin model onto FRG core " << rotatedCoreIdentifier << " by a sublattice spin rotation. Correlations are reported in the original frame." << Log::endl;
+			for (int b = 0; b < int(factorySpinUC.sublatticeRotation.size()); ++b)
+			{
+				const std::string componentNames[7] = { "x", "y", "z", "", "-x", "-y", "-z" };
+				Log::log << Log::LogLevel::Debug << "\tbasis site " << b << ": (x,y,z) -> (" << componentNames[static_cast<int>(factorySpinUC.sublatticeRotation[b][0])] << "," << componentNames[static_cast<int>(factorySpinUC.sublatticeRotation[b][1])] << "," << componentNames[static_cast<int>(factorySpinUC.sublatticeRotation[b][2])] << ")" << Log::endl;
+			}
+			coreIdentifier = rotatedCoreIdentifier;
+		}
+		else Log::log << Log::LogLevel::Info << "No sublattice spin rotation found which maps the spin model onto a cheaper FRG core." << Log::endl;
+	}
+	else if (rotation != "none") throw Exception(Exception::Type::InitializationError, "Invalid task file. Unknown attribute value '" + rotation + "' (task.parameters.model.rotation)");
+
+	//lattice symmetries may act on spin components by general rotations, which are supported by the SU2, XYZ, and TRI cores
+	std::string spinSymmetry = (coreIdentifier == "U1") ? "permutation" : "rotation";
+	if (_taskFile.get_optional<std::string>("task.parameters.model.<xmlattr>.spinSymmetry")) spinSymmetry = _taskFile.get<std::string>("task.parameters.model.<xmlattr>.spinSymmetry");
+	if (spinSymmetry == "rotation")
+	{
+		if (coreIdentifier == "U1") throw Exception(Exception::Type::InitializationError, "Invalid task file. General spin rotation symmetries are not supported by the U1 FRG core (task.parameters.model.spinSymmetry)");
+		factorySpinUC.spinRotationSymmetry = true;
+	}
+	else if (spinSymmetry != "permutation") throw Exception(Exception::Type::InitializationError, "Invalid task file. Unknown attribute value '" + spinSymmetry + "' (task.parameters.model.spinSymmetry)");
+
+	//only the master rank writes lattice debug information, such that ranks do not compete for the same files
+	startup->beginPhase("lattice model");
+	std::string ldfPath = SpinParser::spinParser()->isMasterRank() ? boost::filesystem::path(taskFilePath).replace_extension("ldf").string() : "";
+	std::pair<Lattice *, SpinModel *> factoryProduct = LatticeModelFactory::newLatticeModel(factoryLatticeUC, factorySpinUC, latticerange, ldfPath);
 	lattice = factoryProduct.first;
 	SpinModel *spinModel = factoryProduct.second;
 
 	Log::log << Log::LogLevel::Info << Log::LogLevel::Info << "Generated lattice model." << Log::endl;
+	startup->endPhase();
+	#pragma endregion
+
+	//automatic frequency discretization
+	#pragma region automatic frequency discretization
+	std::map<std::string, std::string> coreOptions;
+	for (auto option : options)
+	{
+		if (std::find(spinModel->interactionParameters.begin(), spinModel->interactionParameters.end(), option.first) == spinModel->interactionParameters.end()) coreOptions.insert(option);
+	}
+
+	if (_taskFile.get<std::string>("task.parameters.frequency.<xmlattr>.discretization") == "auto")
+	{
+		startup->beginPhase("frequency optimization");
+		int pilotRange = std::min(2, latticerange);
+		if (_taskFile.get_optional<std::string>("task.parameters.frequency.pilotRange.<xmltext>")) pilotRange = std::stoi(_taskFile.get<std::string>("task.parameters.frequency.pilotRange.<xmltext>"));
+		if (pilotRange < 0) throw Exception(Exception::Type::InitializationError, "Invalid task file. Parameter 'task.parameters.frequency.pilotRange' must not be negative");
+
+		int pilotIterations = 2;
+		if (_taskFile.get_optional<std::string>("task.parameters.frequency.pilotIterations.<xmltext>")) pilotIterations = std::stoi(_taskFile.get<std::string>("task.parameters.frequency.pilotIterations.<xmltext>"));
+		if (pilotIterations < 2) throw Exception(Exception::Type::InitializationError, "Invalid task file. Parameter 'task.parameters.frequency.pilotIterations' must be at least 2");
+
+		//temporarily replace the lattice by a small pilot lattice
+		Lattice *productionLattice = lattice;
+		std::pair<Lattice *, SpinModel *> pilotProduct = LatticeModelFactory::newLatticeModel(factoryLatticeUC, factorySpinUC, pilotRange);
+		lattice = pilotProduct.first;
+
+		//run pilot flows on successively optimized meshes and retain the mesh with the smallest error estimate
+		int count = frequency->size;
+		std::vector<float> frequencies(frequency->_data, frequency->_data + frequency->size);
+		std::vector<float> optimalFrequencies = frequencies;
+		float optimalError = INFINITY;
+		for (int iteration = 0; iteration < pilotIterations; ++iteration)
+		{
+			delete frequency;
+			frequency = new FrequencyDiscretization(frequencies, interpolation);
+
+			HMP::StackIdentifier firstPilotStack = SpinParser::spinParser()->getLoadManager()->stackCount();
+			FrgCore *pilotCore = FrgCoreFactory::newFrgCore(coreIdentifier, *pilotProduct.second, {}, coreOptions);
+			std::vector<float> curvature = FrequencyOptimizer::pilotFlow(pilotCore);
+			delete pilotCore;
+			SpinParser::spinParser()->getLoadManager()->releaseStacks(firstPilotStack);
+
+			float error = FrequencyOptimizer::error(frequencies, curvature);
+			Log::log << Log::LogLevel::Info << "Pilot flow " << iteration + 1 << "/" << pilotIterations << " on lattice range " << pilotRange << ": estimated relative discretization error " << error << Log::endl;
+			if (error < optimalError)
+			{
+				optimalError = error;
+				optimalFrequencies = frequencies;
+			}
+			frequencies = FrequencyOptimizer::equidistribute(frequencies, curvature, count);
+		}
+
+		delete pilotProduct.first;
+		delete pilotProduct.second;
+		lattice = productionLattice;
+		delete frequency;
+		frequency = new FrequencyDiscretization(optimalFrequencies, interpolation);
+
+		//report the discretization and replace the automatic discretization in the task file, such that the mesh is reused upon restart
+		boost::property_tree::ptree manualFrequency;
+		manualFrequency.put("<xmlattr>.discretization", "manual");
+		if (_taskFile.get_optional<std::string>("task.parameters.frequency.<xmlattr>.interpolation")) manualFrequency.put("<xmlattr>.interpolation", _taskFile.get<std::string>("task.parameters.frequency.<xmlattr>.interpolation"));
+
+		Log::log << Log::LogLevel::Info << "Generated automatic frequency discretization with " << optimalFrequencies.size() << " values:" << Log::endl;
+		for (float w : optimalFrequencies)
+		{
+			std::ostringstream value;
+			value << std::setprecision(9) << w;
+			manualFrequency.add("value", value.str());
+			Log::log << Log::LogLevel::Info << "\t" << value.str() << Log::endl;
+		}
+		_taskFile.get_child("task.parameters.frequency") = manualFrequency;
+		startup->endPhase();
+	}
 	#pragma endregion
 	
 	//measurements
@@ -241,7 +415,7 @@ TaskFileParser::TaskFileParser(const std::string &taskFilePath, FrequencyDiscret
 			auto measurementTask = node.second;
 
 			_validateRequiredAttributes(measurementTask, "", { "name" }, "task.measurements.measurement");
-			_validateOptionalAttributes(measurementTask, "", { "name", "output", "method", "minCutoff", "maxCutoff" }, "task.measurements.measurement");
+			_validateOptionalAttributes(measurementTask, "", { "name", "output", "method", "minCutoff", "maxCutoff", "schedule", "cadence", "tolerance", "library" }, "task.measurements.measurement");
 
 			//observable name
 			std::string measurementIdentifier = measurementTask.get<std::string>("<xmlattr>.name");
@@ -268,6 +442,16 @@ TaskFileParser::TaskFileParser(const std::string &taskFilePath, FrequencyDiscret
 				}
 			}
 
+			//plugin library, relative to the task file unless it is an absolute path or cannot be found
+			std::string library;
+			if (measurementIdentifier == "plugin")
+			{
+				if (!measurementTask.get_optional<std::string>("<xmlattr>.library")) throw Exception(Exception::Type::InitializationError, "Invalid task file. Plugin measurements require the attribute 'task.measurements.measurement.library'");
+				library = measurementTask.get<std::string>("<xmlattr>.library");
+				boost::filesystem::path libraryPath = boost::filesystem::path(taskFilePath).remove_filename().append(library);
+				if (boost::filesystem::path(library).is_relative() && boost::filesystem::exists(libraryPath)) library = libraryPath.string();
+			}
+
 			//deferred measurement
 			bool defer = false;
 			if (measurementTask.get_optional<std::string>("<xmlattr>.method"))
@@ -283,12 +467,37 @@ TaskFileParser::TaskFileParser(const std::string &taskFilePath, FrequencyDiscret
 			float maxCutoff = INFINITY;
 			if (measurementTask.get_optional<std::string>("<xmlattr>.maxCutoff")) maxCutoff = InputParser::stringToFloat(measurementTask.get<std::string>("<xmlattr>.maxCutoff"));
 
+			//measurement schedule
+			MeasurementScheduler::Policy schedulePolicy = MeasurementScheduler::Policy::Fixed;
+			if (measurementTask.get_optional<std::string>("<xmlattr>.schedule"))
+			{
+				std::string schedule = measurementTask.get<std::string>("<xmlattr>.schedule");
+				if (schedule == "adaptive") schedulePolicy = MeasurementScheduler::Policy::Adaptive;
+				else if (schedule != "fixed") throw Exception(Exception::Type::InitializationError, "Invalid task file. Attribute 'task.measurements.measurement.schedule' must be either 'fixed' or 'adaptive'");
+			}
+
+			int cadence = 1;
+			if (measurementTask.get_optional<std::string>("<xmlattr>.cadence")) cadence = std::stoi(measurementTask.get<std::string>("<xmlattr>.cadence"));
+			if (cadence < 1) throw Exception(Exception::Type::InitializationError, "Invalid task file. Attribute 'task.measurements.measurement.cadence' must be positive");
+
+			float tolerance = 0.05f;
+			if (measurementTask.get_optional<std::string>("<xmlattr>.tolerance")) tolerance = InputParser::stringToFloat(measurementTask.get<std::string>("<xmlattr>.tolerance"));
+			if (tolerance <= 0.0f) throw Exception(Exception::Type::InitializationError, "Invalid task file. Attribute 'task.measurements.measurement.tolerance' must be positive");
+
+			std::vector<float> scheduleCutoffs;
+			for (auto node : measurementTask)
+			{
+				if (node.first != "cutoff") continue;
+				if (!node.second.get_optional<std::string>("<xmltext>")) throw Exception(Exception::Type::InitializationError, "Invalid task file. Unspecified parameter value (task.measurements.measurement.cutoff)");
+				scheduleCutoffs.push_back(InputParser::stringToFloat(node.second.get<std::string>("<xmltext>")));
+			}
+
 			//read additional options
 			std::vector<std::pair<std::string, std::string>> measurementOptions;
 			for (auto node : measurementTask)
 			{
 				std::string optionName = node.first;
-				if (optionName == "<xmlattr>" || optionName == "<xmltext>" || optionName == "<xmlcomment>") continue;
+				if (optionName == "<xmlattr>" || optionName == "<xmltext>" || optionName == "<xmlcomment>" || optionName == "cutoff") continue;
 				if (!node.second.get_optional<std::string>("<xmltext>")) throw Exception(Exception::Type::InitializationError, "Invalid task file. Unspecified parameter value (task.measurements.measurement." + optionName + ")");
 				std::string optionValue = node.second.get<std::string>("<xmltext>");
 				measurementOptions.push_back(std::pair<std::string, std::string>(optionName, optionValue));
@@ -302,6 +511,8 @@ TaskFileParser::TaskFileParser(const std::string &taskFilePath, FrequencyDiscret
 			s.maxCutoff = maxCutoff;
 			s.defer = defer;
 			s.options = measurementOptions;
+			s.scheduler = MeasurementScheduler(schedulePolicy, cadence, tolerance, scheduleCutoffs);
+			s.library = library;
 			measurements.push_back(s);
 		}
 	}
@@ -310,15 +521,27 @@ TaskFileParser::TaskFileParser(const std::string &taskFilePath, FrequencyDiscret
 	//FRG core
 	#pragma region FRG core
 	//make frg core
-	std::map<std::string, std::string> coreOptions;
-	for (auto option : options)
+	startup->beginPhase("FRG core");
+	frgCore = FrgCoreFactory::newFrgCore(coreIdentifier, *spinModel, measurements, coreOptions);
+
+	//optionally start on a reduced lattice range, which is extended as the vertex at the boundary shell grows
+	if (_taskFile.get_optional<std::string>("task.parameters.lattice.<xmlattr>.initialRange"))
 	{
-		if (std::find(spinModel->interactionParameters.begin(), spinModel->interactionParameters.end(), option.first) == spinModel->interactionParameters.end()) coreOptions.insert(option);
+		frgCore->_activeRange = std::stoi(_taskFile.get<std::string>("task.parameters.lattice.<xmlattr>.initialRange"));
+		if (frgCore->_activeRange < 1 || frgCore->_activeRange > latticerange) throw Exception(Exception::Type::InitializationError, "Invalid task file. Attribute 'task.parameters.lattice.initialRange' must be positive and must not exceed the lattice range");
+		frgCore->_rangeThreshold = 0.01f;
+	}
+	if (_taskFile.get_optional<std::string>("task.parameters.lattice.<xmlattr>.rangeThreshold"))
+	{
+		frgCore->_rangeThreshold = InputParser::stringToFloat(_taskFile.get<std::string>("task.parameters.lattice.<xmlattr>.rangeThreshold"));
+		if (frgCore->_rangeThreshold <= 0) throw Exception(Exception::Type::InitializationError, "Invalid task file. Attribute 'task.parameters.lattice.rangeThreshold' must be positive");
 	}
 
-	frgCore = FrgCoreFactory::newFrgCore(coreIdentifier, *spinModel, measurements, coreOptions);
+	//continue with the active range of the checkpoint
+	if (computationStatus.statusIdentifier == ComputationStatus::Identifier::Running && _taskFile.get_optional<std::string>("task.calculation.<xmlattr>.activeRange")) frgCore->_activeRange = std::stoi(_taskFile.get<std::string>("task.calculation.<xmlattr>.activeRange"));
 
 	Log::log << Log::LogLevel::Info << Log::LogLevel::Info << "Generated FRG core with identifier " << coreIdentifier << "." << Log::endl;
+	startup->endPhase();
 	#pragma endregion
 
 	//debugLattice output
@@ -330,8 +553,7 @@ TaskFileParser::TaskFileParser(const std::string &taskFilePath, FrequencyDiscret
 		
 		Log::log << Log::LogLevel::Info << "\tNumber of basis sites per unit cell: " << FrgCommon::lattice()._basis.size() << Log::endl;
 		Log::log << Log::LogLevel::Info << "\tNumber of allocated sites: " << FrgCommon::lattice().end() - FrgCommon::lattice().begin() << " (" << (FrgCommon::lattice().end() - FrgCommon::lattice().begin()) * sizeof(int) << " bytes)" << Log::endl;
-		int inRangeCount = 0;
-		for (auto i1 = FrgCommon::lattice().getRange(0); i1 != FrgCommon::lattice().end(); ++i1) ++inRangeCount;
+		int inRangeCount = FrgCommon::lattice().getRangeIds(0).size();
 		Log::log << Log::LogLevel::Info << "\tNumber of sites within range of origin: " << inRangeCount << Log::endl;
 		Log::log << Log::LogLevel::Info << "\tNumber of parametrized sites: " << FrgCommon::lattice().size << Log::endl;
 
@@ -357,7 +579,11 @@ void TaskFileParser::writeTaskFile(const ComputationStatus &computationStatus)
 		_taskFile.put("task.calculation.<xmlattr>.startTime", Timestamp::timestamp(computationStatus.startTime));
 		_taskFile.put("task.calculation.<xmlattr>.checkpointTime", Timestamp::timestamp(computationStatus.checkpointTime));
 
-		if (computationStatus.statusIdentifier == ComputationStatus::Identifier::Running) _taskFile.put("task.calculation.<xmlattr>.status", "running");
+		if (computationStatus.statusIdentifier == ComputationStatus::Identifier::Running)
+		{
+			_taskFile.put("task.calculation.<xmlattr>.status", "running");
+			if (SpinParser::spinParser()->getFrgCore()->_activeRange < FrgCommon::lattice().range) _taskFile.put("task.calculation.<xmlattr>.activeRange", SpinParser::spinParser()->getFrgCore()->_activeRange);
+		}
 		else if (computationStatus.statusIdentifier == ComputationStatus::Identifier::Postprocessing) _taskFile.put("task.calculation.<xmlattr>.status", "postprocessing");
 		else if (computationStatus.statusIdentifier == ComputationStatus::Identifier::Finished)
 		{
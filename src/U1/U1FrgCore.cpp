@@ -0,0 +1,832 @@
+/**
+ * @file U1FrgCore.cpp
+ * @author Finn Lasse Buessen
+ * @brief FrgCore implementation for U(1)-symmetric models.
+ * 
+ * @copyright Copyright (c) 2020
+ */
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include "lib/InputParser.hpp"
+#include "lib/Integrator.hpp"
+#include "SpinParser.hpp"
+#include "U1FrgCore.hpp"
+#include "U1EffectiveAction.hpp"
+
+U1FrgCore::U1FrgCore(const SpinModel &spinModel, const std::vector<Measurement *> &measurements, const std::map<std::string, std::string> &options) : FrgCore(measurements)
+{
+	//init options
+	normalization = NAN;
+
+	for (auto option : options)
+	{
+		if (option.first == "normalization") normalization = InputParser::stringToFloat(option.second);
+		else throw Exception(Exception::Type::InitializationError, "Unknown spin model option '" + option.first + "'.");
+	}
+	if (std::isnan(normalization)) normalization = 1.0f;
+
+	Log::log << Log::LogLevel::Info << "FRG core energy normalization is set to " << normalization << "." << Log::endl;
+
+	//init data
+	_flowingFunctional = new U1EffectiveAction(*FrgCommon::cutoff().begin(), spinModel, this);
+	_flow = new U1EffectiveAction();
+
+	//init loadManager
+	//stack0
+	dataStacks[0] = SpinParser::spinParser()->getLoadManager()->addPassiveStack<float>(
+		&_flowingFunctional->cutoff,
+		1);
+	//stack1
+	dataStacks[1] = SpinParser::spinParser()->getLoadManager()->addPassiveStack<float>(
+		static_cast<U1EffectiveAction *>(_flowingFunctional)->vertexSingleParticle->_data,
+		static_cast<U1EffectiveAction *>(_flowingFunctional)->vertexSingleParticle->size);
+	//stack2
+	dataStacks[2] = SpinParser::spinParser()->getLoadManager()->addPassiveStack<float>(
+		static_cast<U1EffectiveAction *>(_flowingFunctional)->vertexTwoParticle->_data,
+		static_cast<U1EffectiveAction *>(_flowingFunctional)->vertexTwoParticle->size);
+	//stack3
+	dataStacks[3] = SpinParser::spinParser()->getLoadManager()->addMasterStackImplicit<float>(
+		&_flow->cutoff,
+		1,
+		[&](int) { _flow->cutoff = static_cast<U1EffectiveAction *>(_flowingFunctional)->cutoff; },
+		1,
+		1,
+		10,
+		false,
+		true);
+	//stack4
+	dataStacks[4] = SpinParser::spinParser()->getLoadManager()->addMasterStackImplicit<float>(
+		static_cast<U1EffectiveAction *>(_flow)->vertexSingleParticle->_data,
+		static_cast<U1EffectiveAction *>(_flow)->vertexSingleParticle->size,
+		[&](int x) { _calculateVertexSingleParticle(x); },
+		1,
+		1,
+		1,
+		false,
+		true);
+	//stack5
+	dataStacks[5] = SpinParser::spinParser()->getLoadManager()->addMasterStackImplicit<float>(
+		static_cast<U1EffectiveAction *>(_flow)->vertexTwoParticle->_data,
+		static_cast<U1EffectiveAction *>(_flow)->vertexTwoParticle->sizeFrequency,
+		[&](int x) { if (_multirate.isDue(x)) SpinParser::spinParser()->getFlowProfiler()->profile(x, [&]() { if (FrgCommon::frequency().interpolation == FrequencyDiscretization::Interpolation::Cubic) _calculateVertexTwoParticle<16>(x); else _calculateVertexTwoParticle<4>(x); }); },
+		6 * FrgCommon::lattice().size,
+		FrgCommon::frequency().size);
+
+	//buffer the stored vertex components and sign factors which are accessed in the lattice bubble
+	_overlapComponents1.resize(FrgCommon::lattice().size);
+	_overlapComponents2.resize(FrgCommon::lattice().size);
+	_overlapSigns1.resize(FrgCommon::lattice().size);
+	_overlapSigns2.resize(FrgCommon::lattice().size);
+	for (int rid = 0; rid < FrgCommon::lattice().size; ++rid)
+	{
+		const LatticeOverlap &overlap = FrgCommon::lattice().getOverlap(rid);
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			const SpinComponent spinPermutation1[3] = { overlap.transformedX1[i], overlap.transformedY1[i], overlap.transformedZ1[i] };
+			const SpinComponent spinPermutation2[3] = { overlap.transformedX2[i], overlap.transformedY2[i], overlap.transformedZ2[i] };
+			for (int c = 0; c < 6; ++c)
+			{
+				float sign1 = 1.0f;
+				int component1 = U1VertexTwoParticle::symmetryTransformComponent(c, spinPermutation1, sign1);
+				_overlapComponents1[rid].push_back((component1 < 0) ? 0 : component1);
+				_overlapSigns1[rid].push_back((component1 < 0) ? 0.0f : sign1);
+
+				float sign2 = 1.0f;
+				int component2 = U1VertexTwoParticle::symmetryTransformComponent(c, spinPermutation2, sign2);
+				_overlapComponents2[rid].push_back((component2 < 0) ? 0 : component2);
+				_overlapSigns2[rid].push_back((component2 < 0) ? 0.0f : sign2);
+			}
+		}
+	}
+
+	//blocks of the multi-rate evaluation are formed by the frequency iterators of the two-particle vertex flow
+	_multirate.setBlocks(static_cast<U1EffectiveAction *>(_flowingFunctional)->vertexTwoParticle->sizeFrequency, 6 * FrgCommon::lattice().size, { static_cast<U1EffectiveAction *>(_flow)->vertexTwoParticle->_data });
+}
+
+U1FrgCore::~U1FrgCore()
+{
+	delete _flowingFunctional;
+	delete _flow;
+}
+
+void U1FrgCore::computeStep()
+{
+	//update cutoff and broadcast
+	SpinParser::spinParser()->getLoadManager()->calculate(dataStacks[3]);
+	SpinParser::spinParser()->getLoadManager()->broadcast(dataStacks[3]);
+	//calculate 1-particle vertices and broadcast (required for Katanin calculation)
+	SpinParser::spinParser()->getLoadManager()->calculate(dataStacks[4]);
+	SpinParser::spinParser()->getLoadManager()->broadcast(dataStacks[4]);
+	//calculate 2-particle vertices and managed measurements
+	std::vector<int> managedMeasurementStacks;
+	for (auto m = _measurements.begin(); m != _measurements.end(); ++m)
+	{
+		if ((*m)->isLoadManaged())
+		{
+			auto s = (*m)->getLoadManagedStacks();
+			managedMeasurementStacks.insert(managedMeasurementStacks.end(), s.begin(), s.end());
+		}
+	}
+	managedMeasurementStacks.push_back(dataStacks[5]);
+	_multirate.beginStep(_flowingFunctional->cutoff, SpinParser::spinParser()->isMasterRank());
+	SpinParser::spinParser()->getLoadManager()->calculate(managedMeasurementStacks.data(), int(managedMeasurementStacks.size()));
+	_multirate.endStep(SpinParser::spinParser()->isMasterRank());
+}
+
+void U1FrgCore::finalizeStep(float newCutoff)
+{
+	//determine cutoff set
+	float cutoffStep = newCutoff - _flowingFunctional->cutoff;
+
+	//set new cutoff value
+	_flowingFunctional->cutoff = newCutoff;
+
+	//add _flow to single particle vertex
+	#ifndef DISABLE_OMP
+	#pragma omp parallel for schedule(static)
+	#endif
+	for (int i = 0; i < static_cast<U1EffectiveAction *>(_flowingFunctional)->vertexSingleParticle->size; ++i) static_cast<U1EffectiveAction *>(_flowingFunctional)->vertexSingleParticle->_data[i] += cutoffStep * static_cast<U1EffectiveAction *>(_flow)->vertexSingleParticle->_data[i];
+
+	//add _flow to two particle vertex
+	integrateStep(static_cast<U1EffectiveAction *>(_flowingFunctional)->vertexTwoParticle->_data, static_cast<U1EffectiveAction *>(_flow)->vertexTwoParticle->_data, static_cast<U1EffectiveAction *>(_flowingFunctional)->vertexTwoParticle->size, cutoffStep, FrgCommon::cutoff().integrator);
+
+	//broadcast updated effective action
+	SpinParser::spinParser()->getLoadManager()->broadcast({ dataStacks[0], dataStacks[1], dataStacks[2] });
+}
+
+void U1FrgCore::tuneKernels(KernelTuner &tuner)
+{
+	_tuneKernels(tuner, "U1", [&](int x) { if (FrgCommon::frequency().interpolation == FrequencyDiscretization::Interpolation::Cubic) _calculateVertexTwoParticle<16>(x); else _calculateVertexTwoParticle<4>(x); }, false);
+}
+
+void U1FrgCore::_calculateVertexSingleParticle(const int iterator)
+{
+	float cutoff = _flowingFunctional->cutoff;
+	U1VertexSingleParticle *v2 = static_cast<U1EffectiveAction *>(_flowingFunctional)->vertexSingleParticle;
+	U1VertexTwoParticle *v4 = static_cast<U1EffectiveAction *>(_flowingFunctional)->vertexTwoParticle;
+
+	float w;
+	v2->expandIterator(iterator, w);
+	float v2CurrentValue = 0;
+
+	//term1
+	float sum = 0;
+	for (int j : FrgCommon::lattice().getRangeIds(0))
+	{
+		sum += v4->getValue(FrgCommon::lattice().zero(), j, w + cutoff, 0.0f, w - cutoff, SpinComponent::None, SpinComponent::None, U1VertexTwoParticle::FrequencyChannel::None);
+		sum -= v4->getValue(FrgCommon::lattice().zero(), j, w - cutoff, 0.0f, w + cutoff, SpinComponent::None, SpinComponent::None, U1VertexTwoParticle::FrequencyChannel::None);
+	}
+	v2CurrentValue -= 2.0f * sum;
+
+	//term2
+	v2CurrentValue += v4->getValue(FrgCommon::lattice().zero(), FrgCommon::lattice().zero(), w + cutoff, w - cutoff, 0.0f, SpinComponent::X, SpinComponent::X, U1VertexTwoParticle::FrequencyChannel::None) - v4->getValue(FrgCommon::lattice().zero(), FrgCommon::lattice().zero(), w - cutoff, w + cutoff, 0.0f, SpinComponent::X, SpinComponent::X, U1VertexTwoParticle::FrequencyChannel::None);
+	v2CurrentValue += v4->getValue(FrgCommon::lattice().zero(), FrgCommon::lattice().zero(), w + cutoff, w - cutoff, 0.0f, SpinComponent::Y, SpinComponent::Y, U1VertexTwoParticle::FrequencyChannel::None) - v4->getValue(FrgCommon::lattice().zero(), FrgCommon::lattice().zero(), w - cutoff, w + cutoff, 0.0f, SpinComponent::Y, SpinComponent::Y, U1VertexTwoParticle::FrequencyChannel::None);
+	v2CurrentValue += v4->getValue(FrgCommon::lattice().zero(), FrgCommon::lattice().zero(), w + cutoff, w - cutoff, 0.0f, SpinComponent::Z, SpinComponent::Z, U1VertexTwoParticle::FrequencyChannel::None) - v4->getValue(FrgCommon::lattice().zero(), FrgCommon::lattice().zero(), w - cutoff, w + cutoff, 0.0f, SpinComponent::Z, SpinComponent::Z, U1VertexTwoParticle::FrequencyChannel::None);
+	v2CurrentValue += v4->getValue(FrgCommon::lattice().zero(), FrgCommon::lattice().zero(), w + cutoff, w - cutoff, 0.0f, SpinComponent::None, SpinComponent::None, U1VertexTwoParticle::FrequencyChannel::None) - v4->getValue(FrgCommon::lattice().zero(), FrgCommon::lattice().zero(), w - cutoff, w + cutoff, 0.0f, SpinComponent::None, SpinComponent::None, U1VertexTwoParticle::FrequencyChannel::None);
+
+	//prefactor
+	v2CurrentValue /= (2.0f * (float)M_PI * (cutoff + v2->getValue(cutoff)));
+
+	static_cast<U1EffectiveAction *>(_flow)->vertexSingleParticle->_data[iterator] = v2CurrentValue;
+}
+
+template <int n> void U1FrgCore::_calculateVertexTwoParticle(const int iterator)
+{
+	float cutoff = _flowingFunctional->cutoff;
+	U1VertexSingleParticle *v2 = static_cast<U1EffectiveAction *>(_flowingFunctional)->vertexSingleParticle;
+	U1VertexTwoParticle *v4 = static_cast<U1EffectiveAction *>(_flowingFunctional)->vertexTwoParticle;
+
+	float s, t, u;
+	v4->expandIterator(iterator, s, t, u);
+
+	//vertex buffers
+	ValueSuperbundle<float, 6> buffer1(FrgCommon::lattice().size);
+	ValueSuperbundle<float, 6> buffer2(FrgCommon::lattice().size);
+	ValueSuperbundle<float, 6> bufferRPA(FrgCommon::lattice().size);
+	ValueSuperbundle<float, 6> v4CurrentValue(FrgCommon::lattice().size);
+	ValueSuperbundle<float, 6> stackBuffers[4] = {
+		ValueSuperbundle<float, 6>(FrgCommon::lattice().size),
+		ValueSuperbundle<float, 6>(FrgCommon::lattice().size),
+		ValueSuperbundle<float, 6>(FrgCommon::lattice().size),
+		ValueSuperbundle<float, 6>(FrgCommon::lattice().size)
+	};
+
+	//transfer frequencies
+	float w1p = 0.5f * (s + t + u);
+	float w1 = 0.5f * (s - t + u);
+	float w2p = 0.5f * (s - t - u);
+	float w2 = 0.5f * (s + t - u);
+
+	//integrand of the ferquency integral
+	auto integralKernelS = [&](const float wp, ValueSuperbundle<float, 6> &returnBuffer) -> void
+	{
+		//pp-ladder A and B (positive sign)
+		const U1VertexTwoParticleAccessBuffer<n> ab0 = v4->generateAccessBuffer<n>(s, w2 + wp, w1 + wp, U1VertexTwoParticle::FrequencyChannel::S);
+		const U1VertexTwoParticleAccessBuffer<n> ab1 = v4->generateAccessBuffer<n>(s, -w2p - wp, w1p + wp, U1VertexTwoParticle::FrequencyChannel::S);
+		//pp-ladder A and B (positive sign)
+		const U1VertexTwoParticleAccessBuffer<n> ab2 = v4->generateAccessBuffer<n>(s, -w1 - wp, -w2 - wp, U1VertexTwoParticle::FrequencyChannel::S);
+		const U1VertexTwoParticleAccessBuffer<n> ab3 = v4->generateAccessBuffer<n>(s, w1p + wp, -w2p - wp, U1VertexTwoParticle::FrequencyChannel::S);
+
+		v4->getValueSuperbundle(ab0, stackBuffers[0]);
+		v4->getValueSuperbundle(ab1, stackBuffers[1]);
+		v4->getValueSuperbundle(ab2, stackBuffers[2]);
+		v4->getValueSuperbundle(ab3, stackBuffers[3]);
+
+		//calculate _flow
+		returnBuffer.reset();
+
+		#pragma region ppLadder
+		returnBuffer.bundle(5).multAdd(stackBuffers[0].bundle(5), stackBuffers[1].bundle(5));
+		returnBuffer.bundle(5).multAdd(stackBuffers[2].bundle(5), stackBuffers[3].bundle(5));
+		returnBuffer.bundle(5).multSub(stackBuffers[0].bundle(4), stackBuffers[1].bundle(4));
+		returnBuffer.bundle(5).multSub(stackBuffers[2].bundle(4), stackBuffers[3].bundle(4));
+		returnBuffer.bundle(5).multSub(stackBuffers[0].bundle(3), stackBuffers[1].bundle(3));
+		returnBuffer.bundle(5).multSub(stackBuffers[2].bundle(3), stackBuffers[3].bundle(3));
+		returnBuffer.bundle(5).multAdd(stackBuffers[0].bundle(2), stackBuffers[1].bundle(2));
+		returnBuffer.bundle(5).multAdd(stackBuffers[2].bundle(2), stackBuffers[3].bundle(2));
+		returnBuffer.bundle(5).multAdd(2.0f, stackBuffers[0].bundle(0), stackBuffers[1].bundle(0));
+		returnBuffer.bundle(5).multAdd(2.0f, stackBuffers[2].bundle(0), stackBuffers[3].bundle(0));
+		returnBuffer.bundle(5).multAdd(2.0f, stackBuffers[0].bundle(1), stackBuffers[1].bundle(1));
+		returnBuffer.bundle(5).multAdd(2.0f, stackBuffers[2].bundle(1), stackBuffers[3].bundle(1));
+		returnBuffer.bundle(4).multAdd(stackBuffers[0].bundle(5), stackBuffers[1].bundle(4));
+		returnBuffer.bundle(4).multAdd(stackBuffers[2].bundle(5), stackBuffers[3].bundle(4));
+		returnBuffer.bundle(4).multAdd(stackBuffers[0].bundle(4), stackBuffers[1].bundle(5));
+		returnBuffer.bundle(4).multAdd(stackBuffers[2].bundle(4), stackBuffers[3].bundle(5));
+		returnBuffer.bundle(4).multAdd(stackBuffers[0].bundle(3), stackBuffers[1].bundle(2));
+		returnBuffer.bundle(4).multAdd(stackBuffers[2].bundle(3), stackBuffers[3].bundle(2));
+		returnBuffer.bundle(4).multAdd(stackBuffers[0].bundle(2), stackBuffers[1].bundle(3));
+		returnBuffer.bundle(4).multAdd(stackBuffers[2].bundle(2), stackBuffers[3].bundle(3));
+		returnBuffer.bundle(4).multSub(2.0f, stackBuffers[0].bundle(0), stackBuffers[1].bundle(1));
+		returnBuffer.bundle(4).multSub(2.0f, stackBuffers[2].bundle(0), stackBuffers[3].bundle(1));
+		returnBuffer.bundle(4).multAdd(2.0f, stackBuffers[0].bundle(1), stackBuffers[1].bundle(0));
+		returnBuffer.bundle(4).multAdd(2.0f, stackBuffers[2].bundle(1), stackBuffers[3].bundle(0));
+		returnBuffer.bundle(0).multAdd(stackBuffers[0].bundle(5), stackBuffers[1].bundle(0));
+		returnBuffer.bundle(0).multAdd(stackBuffers[2].bundle(5), stackBuffers[3].bundle(0));
+		returnBuffer.bundle(0).multSub(stackBuffers[0].bundle(4), stackBuffers[1].bundle(1));
+		returnBuffer.bundle(0).multSub(stackBuffers[2].bundle(4), stackBuffers[3].bundle(1));
+		returnBuffer.bundle(0).multAdd(stackBuffers[0].bundle(3), stackBuffers[1].bundle(1));
+		returnBuffer.bundle(0).multAdd(stackBuffers[2].bundle(3), stackBuffers[3].bundle(1));
+		returnBuffer.bundle(0).multSub(stackBuffers[0].bundle(2), stackBuffers[1].bundle(0));
+		returnBuffer.bundle(0).multSub(stackBuffers[2].bundle(2), stackBuffers[3].bundle(0));
+		returnBuffer.bundle(0).multSub(stackBuffers[0].bundle(0), stackBuffers[1].bundle(2));
+		returnBuffer.bundle(0).multSub(stackBuffers[2].bundle(0), stackBuffers[3].bundle(2));
+		returnBuffer.bundle(0).multSub(stackBuffers[0].bundle(1), stackBuffers[1].bundle(3));
+		returnBuffer.bundle(0).multSub(stackBuffers[2].bundle(1), stackBuffers[3].bundle(3));
+		returnBuffer.bundle(0).multAdd(stackBuffers[0].bundle(1), stackBuffers[1].bundle(4));
+		returnBuffer.bundle(0).multAdd(stackBuffers[2].bundle(1), stackBuffers[3].bundle(4));
+		returnBuffer.bundle(0).multAdd(stackBuffers[0].bundle(0), stackBuffers[1].bundle(5));
+		returnBuffer.bundle(0).multAdd(stackBuffers[2].bundle(0), stackBuffers[3].bundle(5));
+		returnBuffer.bundle(1).multAdd(stackBuffers[0].bundle(5), stackBuffers[1].bundle(1));
+		returnBuffer.bundle(1).multAdd(stackBuffers[2].bundle(5), stackBuffers[3].bundle(1));
+		returnBuffer.bundle(1).multAdd(stackBuffers[0].bundle(4), stackBuffers[1].bundle(0));
+		returnBuffer.bundle(1).multAdd(stackBuffers[2].bundle(4), stackBuffers[3].bundle(0));
+		returnBuffer.bundle(1).multSub(stackBuffers[0].bundle(3), stackBuffers[1].bundle(0));
+		returnBuffer.bundle(1).multSub(stackBuffers[2].bundle(3), stackBuffers[3].bundle(0));
+		returnBuffer.bundle(1).multSub(stackBuffers[0].bundle(2), stackBuffers[1].bundle(1));
+		returnBuffer.bundle(1).multSub(stackBuffers[2].bundle(2), stackBuffers[3].bundle(1));
+		returnBuffer.bundle(1).multAdd(stackBuffers[0].bundle(0), stackBuffers[1].bundle(3));
+		returnBuffer.bundle(1).multAdd(stackBuffers[2].bundle(0), stackBuffers[3].bundle(3));
+		returnBuffer.bundle(1).multSub(stackBuffers[0].bundle(1), stackBuffers[1].bundle(2));
+		returnBuffer.bundle(1).multSub(stackBuffers[2].bundle(1), stackBuffers[3].bundle(2));
+		returnBuffer.bundle(1).multAdd(stackBuffers[0].bundle(1), stackBuffers[1].bundle(5));
+		returnBuffer.bundle(1).multAdd(stackBuffers[2].bundle(1), stackBuffers[3].bundle(5));
+		returnBuffer.bundle(1).multSub(stackBuffers[0].bundle(0), stackBuffers[1].bundle(4));
+		returnBuffer.bundle(1).multSub(stackBuffers[2].bundle(0), stackBuffers[3].bundle(4));
+		returnBuffer.bundle(3).multAdd(stackBuffers[0].bundle(5), stackBuffers[1].bundle(3));
+		returnBuffer.bundle(3).multAdd(stackBuffers[2].bundle(5), stackBuffers[3].bundle(3));
+		returnBuffer.bundle(3).multAdd(stackBuffers[0].bundle(4), stackBuffers[1].bundle(2));
+		returnBuffer.bundle(3).multAdd(stackBuffers[2].bundle(4), stackBuffers[3].bundle(2));
+		returnBuffer.bundle(3).multAdd(stackBuffers[0].bundle(3), stackBuffers[1].bundle(5));
+		returnBuffer.bundle(3).multAdd(stackBuffers[2].bundle(3), stackBuffers[3].bundle(5));
+		returnBuffer.bundle(3).multAdd(stackBuffers[0].bundle(2), stackBuffers[1].bundle(4));
+		returnBuffer.bundle(3).multAdd(stackBuffers[2].bundle(2), stackBuffers[3].bundle(4));
+		returnBuffer.bundle(3).multAdd(2.0f, stackBuffers[0].bundle(0), stackBuffers[1].bundle(1));
+		returnBuffer.bundle(3).multAdd(2.0f, stackBuffers[2].bundle(0), stackBuffers[3].bundle(1));
+		returnBuffer.bundle(3).multSub(2.0f, stackBuffers[0].bundle(1), stackBuffers[1].bundle(0));
+		returnBuffer.bundle(3).multSub(2.0f, stackBuffers[2].bundle(1), stackBuffers[3].bundle(0));
+		returnBuffer.bundle(2).multAdd(stackBuffers[0].bundle(5), stackBuffers[1].bundle(2));
+		returnBuffer.bundle(2).multAdd(stackBuffers[2].bundle(5), stackBuffers[3].bundle(2));
+		returnBuffer.bundle(2).multSub(stackBuffers[0].bundle(4), stackBuffers[1].bundle(3));
+		returnBuffer.bundle(2).multSub(stackBuffers[2].bundle(4), stackBuffers[3].bundle(3));
+		returnBuffer.bundle(2).multSub(stackBuffers[0].bundle(3), stackBuffers[1].bundle(4));
+		returnBuffer.bundle(2).multSub(stackBuffers[2].bundle(3), stackBuffers[3].bundle(4));
+		returnBuffer.bundle(2).multAdd(stackBuffers[0].bundle(2), stackBuffers[1].bundle(5));
+		returnBuffer.bundle(2).multAdd(stackBuffers[2].bundle(2), stackBuffers[3].bundle(5));
+		returnBuffer.bundle(2).multSub(2.0f, stackBuffers[0].bundle(0), stackBuffers[1].bundle(0));
+		returnBuffer.bundle(2).multSub(2.0f, stackBuffers[2].bundle(0), stackBuffers[3].bundle(0));
+		returnBuffer.bundle(2).multSub(2.0f, stackBuffers[0].bundle(1), stackBuffers[1].bundle(1));
+		returnBuffer.bundle(2).multSub(2.0f, stackBuffers[2].bundle(1), stackBuffers[3].bundle(1));
+		#pragma endregion
+	};
+
+	auto integralKernelT = [&](const float wp, ValueSuperbundle<float, 6> &returnBuffer) -> void
+	{
+		//RPA diagram A and B equal chalice diagram A and inverse chalice diagram B, respectively (negative sign)
+		//chalice diagram A (negative sign)
+		const U1VertexTwoParticleAccessBuffer<n> ab0 = v4->generateAccessBuffer<n>(w1 - wp, t, w1p + wp, U1VertexTwoParticle::FrequencyChannel::T);
+		//inverse chalice diagram B (negative sign)
+		const U1VertexTwoParticleAccessBuffer<n> ab1 = v4->generateAccessBuffer<n>(w2p - wp, t, -w2 - wp, U1VertexTwoParticle::FrequencyChannel::T);
+		//chalice diagram A (negative sign)
+		const U1VertexTwoParticleAccessBuffer<n> ab2 = v4->generateAccessBuffer<n>(w1p + wp, t, w1 - wp, U1VertexTwoParticle::FrequencyChannel::T);
+		//inverse chalice diagram B (negative sign)
+		const U1VertexTwoParticleAccessBuffer<n> ab3 = v4->generateAccessBuffer<n>(w2 + wp, t, -w2p + wp, U1VertexTwoParticle::FrequencyChannel::T);
+
+		v4->getValueSuperbundle(ab0, stackBuffers[0]);
+		v4->getValueSuperbundle(ab1, stackBuffers[1]);
+		v4->getValueSuperbundle(ab2, stackBuffers[2]);
+		v4->getValueSuperbundle(ab3, stackBuffers[3]);
+
+		//calculate _flow
+		returnBuffer.reset();
+		bufferRPA.reset();
+		for (int rid = 0; rid < FrgCommon::lattice().size; ++rid)
+		{
+			//lattice bubble; inactive sites remain at their bare vertex
+			if (!isSiteActive(rid)) continue;
+			const LatticeOverlap &overlap = FrgCommon::lattice().getOverlap(rid);
+			const int *overlapComponents1 = _overlapComponents1[rid].data();
+			const int *overlapComponents2 = _overlapComponents2[rid].data();
+			const float *overlapSigns1 = _overlapSigns1[rid].data();
+			const float *overlapSigns2 = _overlapSigns2[rid].data();
+
+			#pragma region RPA
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(5)[rid] += 2 * overlapSigns1[6 * i + 5] * stackBuffers[0].bundle(overlapComponents1[6 * i + 5])[overlap.rid1[i]] * overlapSigns2[6 * i + 5] * stackBuffers[1].bundle(overlapComponents2[6 * i + 5])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(5)[rid] += 2 * overlapSigns1[6 * i + 5] * stackBuffers[2].bundle(overlapComponents1[6 * i + 5])[overlap.rid1[i]] * overlapSigns2[6 * i + 5] * stackBuffers[3].bundle(overlapComponents2[6 * i + 5])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(5)[rid] -= 2 * overlapSigns1[6 * i + 4] * stackBuffers[0].bundle(overlapComponents1[6 * i + 4])[overlap.rid1[i]] * overlapSigns2[6 * i + 3] * stackBuffers[1].bundle(overlapComponents2[6 * i + 3])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(5)[rid] -= 2 * overlapSigns1[6 * i + 4] * stackBuffers[2].bundle(overlapComponents1[6 * i + 4])[overlap.rid1[i]] * overlapSigns2[6 * i + 3] * stackBuffers[3].bundle(overlapComponents2[6 * i + 3])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(4)[rid] += 2 * overlapSigns1[6 * i + 5] * stackBuffers[0].bundle(overlapComponents1[6 * i + 5])[overlap.rid1[i]] * overlapSigns2[6 * i + 4] * stackBuffers[1].bundle(overlapComponents2[6 * i + 4])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(4)[rid] += 2 * overlapSigns1[6 * i + 5] * stackBuffers[2].bundle(overlapComponents1[6 * i + 5])[overlap.rid1[i]] * overlapSigns2[6 * i + 4] * stackBuffers[3].bundle(overlapComponents2[6 * i + 4])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(4)[rid] += 2 * overlapSigns1[6 * i + 4] * stackBuffers[0].bundle(overlapComponents1[6 * i + 4])[overlap.rid1[i]] * overlapSigns2[6 * i + 2] * stackBuffers[1].bundle(overlapComponents2[6 * i + 2])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(4)[rid] += 2 * overlapSigns1[6 * i + 4] * stackBuffers[2].bundle(overlapComponents1[6 * i + 4])[overlap.rid1[i]] * overlapSigns2[6 * i + 2] * stackBuffers[3].bundle(overlapComponents2[6 * i + 2])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(0)[rid] -= 2 * overlapSigns1[6 * i + 1] * stackBuffers[0].bundle(overlapComponents1[6 * i + 1])[overlap.rid1[i]] * overlapSigns2[6 * i + 1] * stackBuffers[1].bundle(overlapComponents2[6 * i + 1])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(0)[rid] -= 2 * overlapSigns1[6 * i + 1] * stackBuffers[2].bundle(overlapComponents1[6 * i + 1])[overlap.rid1[i]] * overlapSigns2[6 * i + 1] * stackBuffers[3].bundle(overlapComponents2[6 * i + 1])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(0)[rid] += 2 * overlapSigns1[6 * i + 0] * stackBuffers[0].bundle(overlapComponents1[6 * i + 0])[overlap.rid1[i]] * overlapSigns2[6 * i + 0] * stackBuffers[1].bundle(overlapComponents2[6 * i + 0])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(0)[rid] += 2 * overlapSigns1[6 * i + 0] * stackBuffers[2].bundle(overlapComponents1[6 * i + 0])[overlap.rid1[i]] * overlapSigns2[6 * i + 0] * stackBuffers[3].bundle(overlapComponents2[6 * i + 0])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(1)[rid] += 2 * overlapSigns1[6 * i + 1] * stackBuffers[0].bundle(overlapComponents1[6 * i + 1])[overlap.rid1[i]] * overlapSigns2[6 * i + 0] * stackBuffers[1].bundle(overlapComponents2[6 * i + 0])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(1)[rid] += 2 * overlapSigns1[6 * i + 1] * stackBuffers[2].bundle(overlapComponents1[6 * i + 1])[overlap.rid1[i]] * overlapSigns2[6 * i + 0] * stackBuffers[3].bundle(overlapComponents2[6 * i + 0])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(1)[rid] += 2 * overlapSigns1[6 * i + 0] * stackBuffers[0].bundle(overlapComponents1[6 * i + 0])[overlap.rid1[i]] * overlapSigns2[6 * i + 1] * stackBuffers[1].bundle(overlapComponents2[6 * i + 1])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(1)[rid] += 2 * overlapSigns1[6 * i + 0] * stackBuffers[2].bundle(overlapComponents1[6 * i + 0])[overlap.rid1[i]] * overlapSigns2[6 * i + 1] * stackBuffers[3].bundle(overlapComponents2[6 * i + 1])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(3)[rid] += 2 * overlapSigns1[6 * i + 3] * stackBuffers[0].bundle(overlapComponents1[6 * i + 3])[overlap.rid1[i]] * overlapSigns2[6 * i + 5] * stackBuffers[1].bundle(overlapComponents2[6 * i + 5])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(3)[rid] += 2 * overlapSigns1[6 * i + 3] * stackBuffers[2].bundle(overlapComponents1[6 * i + 3])[overlap.rid1[i]] * overlapSigns2[6 * i + 5] * stackBuffers[3].bundle(overlapComponents2[6 * i + 5])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(3)[rid] += 2 * overlapSigns1[6 * i + 2] * stackBuffers[0].bundle(overlapComponents1[6 * i + 2])[overlap.rid1[i]] * overlapSigns2[6 * i + 3] * stackBuffers[1].bundle(overlapComponents2[6 * i + 3])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(3)[rid] += 2 * overlapSigns1[6 * i + 2] * stackBuffers[2].bundle(overlapComponents1[6 * i + 2])[overlap.rid1[i]] * overlapSigns2[6 * i + 3] * stackBuffers[3].bundle(overlapComponents2[6 * i + 3])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(2)[rid] -= 2 * overlapSigns1[6 * i + 3] * stackBuffers[0].bundle(overlapComponents1[6 * i + 3])[overlap.rid1[i]] * overlapSigns2[6 * i + 4] * stackBuffers[1].bundle(overlapComponents2[6 * i + 4])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(2)[rid] -= 2 * overlapSigns1[6 * i + 3] * stackBuffers[2].bundle(overlapComponents1[6 * i + 3])[overlap.rid1[i]] * overlapSigns2[6 * i + 4] * stackBuffers[3].bundle(overlapComponents2[6 * i + 4])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(2)[rid] += 2 * overlapSigns1[6 * i + 2] * stackBuffers[0].bundle(overlapComponents1[6 * i + 2])[overlap.rid1[i]] * overlapSigns2[6 * i + 2] * stackBuffers[1].bundle(overlapComponents2[6 * i + 2])[overlap.rid2[i]];
+			}
+			for (int i = 0; i < overlap.size; ++i)
+			{
+				bufferRPA.bundle(2)[rid] += 2 * overlapSigns1[6 * i + 2] * stackBuffers[2].bundle(overlapComponents1[6 * i + 2])[overlap.rid1[i]] * overlapSigns2[6 * i + 2] * stackBuffers[3].bundle(overlapComponents2[6 * i + 2])[overlap.rid2[i]];
+			}
+			#pragma endregion
+		}
+		returnBuffer += bufferRPA;
+
+		//chalice diagram B (negative sign)
+		const U1VertexTwoParticleAccessBuffer<n> ab4 = v4->generateAccessBuffer<n>(w2p - wp, -w2 - wp, t, U1VertexTwoParticle::FrequencyChannel::U);
+		//chalice diagram B (negative sign)
+		const U1VertexTwoParticleAccessBuffer<n> ab5 = v4->generateAccessBuffer<n>(w2 + wp, -w2p + wp, t, U1VertexTwoParticle::FrequencyChannel::U);
+
+		const float valLocal4[6] = {
+			v4->getValueLocal(SpinComponent::X, SpinComponent::X, ab4),
+			v4->getValueLocal(SpinComponent::X, SpinComponent::Y, ab4),
+			v4->getValueLocal(SpinComponent::Z, SpinComponent::Z, ab4),
+			v4->getValueLocal(SpinComponent::Z, SpinComponent::None, ab4),
+			v4->getValueLocal(SpinComponent::None, SpinComponent::Z, ab4),
+			v4->getValueLocal(SpinComponent::None, SpinComponent::None, ab4)
+		};
+		const float valLocal5[6] = {
+			v4->getValueLocal(SpinComponent::X, SpinComponent::X, ab5),
+			v4->getValueLocal(SpinComponent::X, SpinComponent::Y, ab5),
+			v4->getValueLocal(SpinComponent::Z, SpinComponent::Z, ab5),
+			v4->getValueLocal(SpinComponent::Z, SpinComponent::None, ab5),
+			v4->getValueLocal(SpinComponent::None, SpinComponent::Z, ab5),
+			v4->getValueLocal(SpinComponent::None, SpinComponent::None, ab5)
+		};
+
+		#pragma region chalice
+		returnBuffer.bundle(5).multSub(stackBuffers[0].bundle(5), valLocal4[5]);
+		returnBuffer.bundle(5).multSub(stackBuffers[2].bundle(5), valLocal5[5]);
+		returnBuffer.bundle(5).multSub(stackBuffers[0].bundle(5), valLocal4[2]);
+		returnBuffer.bundle(5).multSub(stackBuffers[2].bundle(5), valLocal5[2]);
+		returnBuffer.bundle(5).multSub(stackBuffers[0].bundle(5), 2.0f * valLocal4[0]);
+		returnBuffer.bundle(5).multSub(stackBuffers[2].bundle(5), 2.0f * valLocal5[0]);
+		returnBuffer.bundle(5).multAdd(stackBuffers[0].bundle(4), valLocal4[4]);
+		returnBuffer.bundle(5).multAdd(stackBuffers[2].bundle(4), valLocal5[4]);
+		returnBuffer.bundle(5).multAdd(stackBuffers[0].bundle(4), valLocal4[3]);
+		returnBuffer.bundle(5).multAdd(stackBuffers[2].bundle(4), valLocal5[3]);
+		returnBuffer.bundle(5).multAdd(stackBuffers[0].bundle(4), 2.0f * valLocal4[1]);
+		returnBuffer.bundle(5).multAdd(stackBuffers[2].bundle(4), 2.0f * valLocal5[1]);
+		returnBuffer.bundle(4).multSub(stackBuffers[0].bundle(5), valLocal4[4]);
+		returnBuffer.bundle(4).multSub(stackBuffers[2].bundle(5), valLocal5[4]);
+		returnBuffer.bundle(4).multSub(stackBuffers[0].bundle(5), valLocal4[3]);
+		returnBuffer.bundle(4).multSub(stackBuffers[2].bundle(5), valLocal5[3]);
+		returnBuffer.bundle(4).multAdd(stackBuffers[0].bundle(5), 2.0f * valLocal4[1]);
+		returnBuffer.bundle(4).multAdd(stackBuffers[2].bundle(5), 2.0f * valLocal5[1]);
+		returnBuffer.bundle(4).multSub(stackBuffers[0].bundle(4), valLocal4[5]);
+		returnBuffer.bundle(4).multSub(stackBuffers[2].bundle(4), valLocal5[5]);
+		returnBuffer.bundle(4).multSub(stackBuffers[0].bundle(4), valLocal4[2]);
+		returnBuffer.bundle(4).multSub(stackBuffers[2].bundle(4), valLocal5[2]);
+		returnBuffer.bundle(4).multAdd(stackBuffers[0].bundle(4), 2.0f * valLocal4[0]);
+		returnBuffer.bundle(4).multAdd(stackBuffers[2].bundle(4), 2.0f * valLocal5[0]);
+		returnBuffer.bundle(0).multSub(stackBuffers[0].bundle(1), valLocal4[4]);
+		returnBuffer.bundle(0).multSub(stackBuffers[2].bundle(1), valLocal5[4]);
+		returnBuffer.bundle(0).multAdd(stackBuffers[0].bundle(1), valLocal4[3]);
+		returnBuffer.bundle(0).multAdd(stackBuffers[2].bundle(1), valLocal5[3]);
+		returnBuffer.bundle(0).multSub(stackBuffers[0].bundle(0), valLocal4[5]);
+		returnBuffer.bundle(0).multSub(stackBuffers[2].bundle(0), valLocal5[5]);
+		returnBuffer.bundle(0).multAdd(stackBuffers[0].bundle(0), valLocal4[2]);
+		returnBuffer.bundle(0).multAdd(stackBuffers[2].bundle(0), valLocal5[2]);
+		returnBuffer.bundle(1).multSub(stackBuffers[0].bundle(1), valLocal4[5]);
+		returnBuffer.bundle(1).multSub(stackBuffers[2].bundle(1), valLocal5[5]);
+		returnBuffer.bundle(1).multAdd(stackBuffers[0].bundle(1), valLocal4[2]);
+		returnBuffer.bundle(1).multAdd(stackBuffers[2].bundle(1), valLocal5[2]);
+		returnBuffer.bundle(1).multAdd(stackBuffers[0].bundle(0), valLocal4[4]);
+		returnBuffer.bundle(1).multAdd(stackBuffers[2].bundle(0), valLocal5[4]);
+		returnBuffer.bundle(1).multSub(stackBuffers[0].bundle(0), valLocal4[3]);
+		returnBuffer.bundle(1).multSub(stackBuffers[2].bundle(0), valLocal5[3]);
+		returnBuffer.bundle(3).multSub(stackBuffers[0].bundle(3), valLocal4[5]);
+		returnBuffer.bundle(3).multSub(stackBuffers[2].bundle(3), valLocal5[5]);
+		returnBuffer.bundle(3).multSub(stackBuffers[0].bundle(3), valLocal4[2]);
+		returnBuffer.bundle(3).multSub(stackBuffers[2].bundle(3), valLocal5[2]);
+		returnBuffer.bundle(3).multSub(stackBuffers[0].bundle(3), 2.0f * valLocal4[0]);
+		returnBuffer.bundle(3).multSub(stackBuffers[2].bundle(3), 2.0f * valLocal5[0]);
+		returnBuffer.bundle(3).multSub(stackBuffers[0].bundle(2), valLocal4[4]);
+		returnBuffer.bundle(3).multSub(stackBuffers[2].bundle(2), valLocal5[4]);
+		returnBuffer.bundle(3).multSub(stackBuffers[0].bundle(2), valLocal4[3]);
+		returnBuffer.bundle(3).multSub(stackBuffers[2].bundle(2), valLocal5[3]);
+		returnBuffer.bundle(3).multSub(stackBuffers[0].bundle(2), 2.0f * valLocal4[1]);
+		returnBuffer.bundle(3).multSub(stackBuffers[2].bundle(2), 2.0f * valLocal5[1]);
+		returnBuffer.bundle(2).multAdd(stackBuffers[0].bundle(3), valLocal4[4]);
+		returnBuffer.bundle(2).multAdd(stackBuffers[2].bundle(3), valLocal5[4]);
+		returnBuffer.bundle(2).multAdd(stackBuffers[0].bundle(3), valLocal4[3]);
+		returnBuffer.bundle(2).multAdd(stackBuffers[2].bundle(3), valLocal5[3]);
+		returnBuffer.bundle(2).multSub(stackBuffers[0].bundle(3), 2.0f * valLocal4[1]);
+		returnBuffer.bundle(2).multSub(stackBuffers[2].bundle(3), 2.0f * valLocal5[1]);
+		returnBuffer.bundle(2).multSub(stackBuffers[0].bundle(2), valLocal4[5]);
+		returnBuffer.bundle(2).multSub(stackBuffers[2].bundle(2), valLocal5[5]);
+		returnBuffer.bundle(2).multSub(stackBuffers[0].bundle(2), valLocal4[2]);
+		returnBuffer.bundle(2).multSub(stackBuffers[2].bundle(2), valLocal5[2]);
+		returnBuffer.bundle(2).multAdd(stackBuffers[0].bundle(2), 2.0f * valLocal4[0]);
+		returnBuffer.bundle(2).multAdd(stackBuffers[2].bundle(2), 2.0f * valLocal5[0]);
+		#pragma endregion
+
+		//inverse chalice diagram A (negative sign)
+		const U1VertexTwoParticleAccessBuffer<n> ab6 = v4->generateAccessBuffer<n>(w1 - wp, -w1p - wp, -t, U1VertexTwoParticle::FrequencyChannel::U);
+		//inverse chalice diagram A (negative sign)
+		const U1VertexTwoParticleAccessBuffer<n> ab7 = v4->generateAccessBuffer<n>(w1p + wp, -w1 + wp, -t, U1VertexTwoParticle::FrequencyChannel::U);
+
+		const float valLocal6[6] = {
+			v4->getValueLocal(SpinComponent::X, SpinComponent::X, ab6),
+			v4->getValueLocal(SpinComponent::X, SpinComponent::Y, ab6),
+			v4->getValueLocal(SpinComponent::Z, SpinComponent::Z, ab6),
+			v4->getValueLocal(SpinComponent::Z, SpinComponent::None, ab6),
+			v4->getValueLocal(SpinComponent::None, SpinComponent::Z, ab6),
+			v4->getValueLocal(SpinComponent::None, SpinComponent::None, ab6)
+		};
+		const float valLocal7[6] = {
+			v4->getValueLocal(SpinComponent::X, SpinComponent::X, ab7),
+			v4->getValueLocal(SpinComponent::X, SpinComponent::Y, ab7),
+			v4->getValueLocal(SpinComponent::Z, SpinComponent::Z, ab7),
+			v4->getValueLocal(SpinComponent::Z, SpinComponent::None, ab7),
+			v4->getValueLocal(SpinComponent::None, SpinComponent::Z, ab7),
+			v4->getValueLocal(SpinComponent::None, SpinComponent::None, ab7)
+		};
+
+		#pragma region inverseChalice
+		returnBuffer.bundle(5).multSub(valLocal6[5], stackBuffers[1].bundle(5));
+		returnBuffer.bundle(5).multSub(valLocal7[5], stackBuffers[3].bundle(5));
+		returnBuffer.bundle(5).multAdd(valLocal6[4], stackBuffers[1].bundle(3));
+		returnBuffer.bundle(5).multAdd(valLocal7[4], stackBuffers[3].bundle(3));
+		returnBuffer.bundle(5).multAdd(valLocal6[3], stackBuffers[1].bundle(3));
+		returnBuffer.bundle(5).multAdd(valLocal7[3], stackBuffers[3].bundle(3));
+		returnBuffer.bundle(5).multSub(valLocal6[2], stackBuffers[1].bundle(5));
+		returnBuffer.bundle(5).multSub(valLocal7[2], stackBuffers[3].bundle(5));
+		returnBuffer.bundle(5).multSub(2.0f * valLocal6[0], stackBuffers[1].bundle(5));
+		returnBuffer.bundle(5).multSub(2.0f * valLocal7[0], stackBuffers[3].bundle(5));
+		returnBuffer.bundle(5).multAdd(2.0f * valLocal6[1], stackBuffers[1].bundle(3));
+		returnBuffer.bundle(5).multAdd(2.0f * valLocal7[1], stackBuffers[3].bundle(3));
+		returnBuffer.bundle(4).multSub(valLocal6[5], stackBuffers[1].bundle(4));
+		returnBuffer.bundle(4).multSub(valLocal7[5], stackBuffers[3].bundle(4));
+		returnBuffer.bundle(4).multSub(valLocal6[4], stackBuffers[1].bundle(2));
+		returnBuffer.bundle(4).multSub(valLocal7[4], stackBuffers[3].bundle(2));
+		returnBuffer.bundle(4).multSub(valLocal6[3], stackBuffers[1].bundle(2));
+		returnBuffer.bundle(4).multSub(valLocal7[3], stackBuffers[3].bundle(2));
+		returnBuffer.bundle(4).multSub(valLocal6[2], stackBuffers[1].bundle(4));
+		returnBuffer.bundle(4).multSub(valLocal7[2], stackBuffers[3].bundle(4));
+		returnBuffer.bundle(4).multSub(2.0f * valLocal6[0], stackBuffers[1].bundle(4));
+		returnBuffer.bundle(4).multSub(2.0f * valLocal7[0], stackBuffers[3].bundle(4));
+		returnBuffer.bundle(4).multSub(2.0f * valLocal6[1], stackBuffers[1].bundle(2));
+		returnBuffer.bundle(4).multSub(2.0f * valLocal7[1], stackBuffers[3].bundle(2));
+		returnBuffer.bundle(0).multSub(valLocal6[5], stackBuffers[1].bundle(0));
+		returnBuffer.bundle(0).multSub(valLocal7[5], stackBuffers[3].bundle(0));
+		returnBuffer.bundle(0).multAdd(valLocal6[4], stackBuffers[1].bundle(1));
+		returnBuffer.bundle(0).multAdd(valLocal7[4], stackBuffers[3].bundle(1));
+		returnBuffer.bundle(0).multSub(valLocal6[3], stackBuffers[1].bundle(1));
+		returnBuffer.bundle(0).multSub(valLocal7[3], stackBuffers[3].bundle(1));
+		returnBuffer.bundle(0).multAdd(valLocal6[2], stackBuffers[1].bundle(0));
+		returnBuffer.bundle(0).multAdd(valLocal7[2], stackBuffers[3].bundle(0));
+		returnBuffer.bundle(1).multSub(valLocal6[5], stackBuffers[1].bundle(1));
+		returnBuffer.bundle(1).multSub(valLocal7[5], stackBuffers[3].bundle(1));
+		returnBuffer.bundle(1).multSub(valLocal6[4], stackBuffers[1].bundle(0));
+		returnBuffer.bundle(1).multSub(valLocal7[4], stackBuffers[3].bundle(0));
+		returnBuffer.bundle(1).multAdd(valLocal6[3], stackBuffers[1].bundle(0));
+		returnBuffer.bundle(1).multAdd(valLocal7[3], stackBuffers[3].bundle(0));
+		returnBuffer.bundle(1).multAdd(valLocal6[2], stackBuffers[1].bundle(1));
+		returnBuffer.bundle(1).multAdd(valLocal7[2], stackBuffers[3].bundle(1));
+		returnBuffer.bundle(3).multSub(valLocal6[5], stackBuffers[1].bundle(3));
+		returnBuffer.bundle(3).multSub(valLocal7[5], stackBuffers[3].bundle(3));
+		returnBuffer.bundle(3).multSub(valLocal6[4], stackBuffers[1].bundle(5));
+		returnBuffer.bundle(3).multSub(valLocal7[4], stackBuffers[3].bundle(5));
+		returnBuffer.bundle(3).multSub(valLocal6[3], stackBuffers[1].bundle(5));
+		returnBuffer.bundle(3).multSub(valLocal7[3], stackBuffers[3].bundle(5));
+		returnBuffer.bundle(3).multSub(valLocal6[2], stackBuffers[1].bundle(3));
+		returnBuffer.bundle(3).multSub(valLocal7[2], stackBuffers[3].bundle(3));
+		returnBuffer.bundle(3).multAdd(2.0f * valLocal6[0], stackBuffers[1].bundle(3));
+		returnBuffer.bundle(3).multAdd(2.0f * valLocal7[0], stackBuffers[3].bundle(3));
+		returnBuffer.bundle(3).multAdd(2.0f * valLocal6[1], stackBuffers[1].bundle(5));
+		returnBuffer.bundle(3).multAdd(2.0f * valLocal7[1], stackBuffers[3].bundle(5));
+		returnBuffer.bundle(2).multSub(valLocal6[5], stackBuffers[1].bundle(2));
+		returnBuffer.bundle(2).multSub(valLocal7[5], stackBuffers[3].bundle(2));
+		returnBuffer.bundle(2).multAdd(valLocal6[4], stackBuffers[1].bundle(4));
+		returnBuffer.bundle(2).multAdd(valLocal7[4], stackBuffers[3].bundle(4));
+		returnBuffer.bundle(2).multAdd(valLocal6[3], stackBuffers[1].bundle(4));
+		returnBuffer.bundle(2).multAdd(valLocal7[3], stackBuffers[3].bundle(4));
+		returnBuffer.bundle(2).multSub(valLocal6[2], stackBuffers[1].bundle(2));
+		returnBuffer.bundle(2).multSub(valLocal7[2], stackBuffers[3].bundle(2));
+		returnBuffer.bundle(2).multAdd(2.0f * valLocal6[0], stackBuffers[1].bundle(2));
+		returnBuffer.bundle(2).multAdd(2.0f * valLocal7[0], stackBuffers[3].bundle(2));
+		returnBuffer.bundle(2).multSub(2.0f * valLocal6[1], stackBuffers[1].bundle(4));
+		returnBuffer.bundle(2).multSub(2.0f * valLocal7[1], stackBuffers[3].bundle(4));
+		#pragma endregion
+	};
+
+	auto integralKernelU = [&](const float wp, ValueSuperbundle<float, 6> &returnBuffer) -> void
+	{
+		//u-Channel, to be combined with P(wp, u + wp) + P(u + wp, wp)
+		//ph-ladder A and B, respectively (negative sign)
+		const U1VertexTwoParticleAccessBuffer<n> ab0 = v4->generateAccessBuffer<n>(w1 + wp, -w2p + wp, u, U1VertexTwoParticle::FrequencyChannel::U);
+		const U1VertexTwoParticleAccessBuffer<n> ab1 = v4->generateAccessBuffer<n>(w1p + wp, w2 - wp, u, U1VertexTwoParticle::FrequencyChannel::U);
+		//ph-ladder A and B, respectively (negative sign)
+		const U1VertexTwoParticleAccessBuffer<n> ab2 = v4->generateAccessBuffer<n>(w2p - wp, -w1 - wp, u, U1VertexTwoParticle::FrequencyChannel::U);
+		const U1VertexTwoParticleAccessBuffer<n> ab3 = v4->generateAccessBuffer<n>(w2 - wp, w1p + wp, u, U1VertexTwoParticle::FrequencyChannel::U);
+
+		v4->getValueSuperbundle(ab0, stackBuffers[0]);
+		v4->getValueSuperbundle(ab1, stackBuffers[1]);
+		v4->getValueSuperbundle(ab2, stackBuffers[2]);
+		v4->getValueSuperbundle(ab3, stackBuffers[3]);
+
+		//calculate _flow
+		returnBuffer.reset();
+
+		#pragma region phLadder
+		returnBuffer.bundle(5).multSub(stackBuffers[0].bundle(5), stackBuffers[1].bundle(5));
+		returnBuffer.bundle(5).multSub(stackBuffers[2].bundle(5), stackBuffers[3].bundle(5));
+		returnBuffer.bundle(5).multAdd(stackBuffers[0].bundle(4), stackBuffers[1].bundle(4));
+		returnBuffer.bundle(5).multAdd(stackBuffers[2].bundle(4), stackBuffers[3].bundle(4));
+		returnBuffer.bundle(5).multAdd(stackBuffers[0].bundle(3), stackBuffers[1].bundle(3));
+		returnBuffer.bundle(5).multAdd(stackBuffers[2].bundle(3), stackBuffers[3].bundle(3));
+		returnBuffer.bundle(5).multSub(stackBuffers[0].bundle(2), stackBuffers[1].bundle(2));
+		returnBuffer.bundle(5).multSub(stackBuffers[2].bundle(2), stackBuffers[3].bundle(2));
+		returnBuffer.bundle(5).multSub(2.0f, stackBuffers[0].bundle(0), stackBuffers[1].bundle(0));
+		returnBuffer.bundle(5).multSub(2.0f, stackBuffers[2].bundle(0), stackBuffers[3].bundle(0));
+		returnBuffer.bundle(5).multSub(2.0f, stackBuffers[0].bundle(1), stackBuffers[1].bundle(1));
+		returnBuffer.bundle(5).multSub(2.0f, stackBuffers[2].bundle(1), stackBuffers[3].bundle(1));
+		returnBuffer.bundle(4).multSub(stackBuffers[0].bundle(5), stackBuffers[1].bundle(4));
+		returnBuffer.bundle(4).multSub(stackBuffers[2].bundle(5), stackBuffers[3].bundle(4));
+		returnBuffer.bundle(4).multSub(stackBuffers[0].bundle(4), stackBuffers[1].bundle(5));
+		returnBuffer.bundle(4).multSub(stackBuffers[2].bundle(4), stackBuffers[3].bundle(5));
+		returnBuffer.bundle(4).multSub(stackBuffers[0].bundle(3), stackBuffers[1].bundle(2));
+		returnBuffer.bundle(4).multSub(stackBuffers[2].bundle(3), stackBuffers[3].bundle(2));
+		returnBuffer.bundle(4).multSub(stackBuffers[0].bundle(2), stackBuffers[1].bundle(3));
+		returnBuffer.bundle(4).multSub(stackBuffers[2].bundle(2), stackBuffers[3].bundle(3));
+		returnBuffer.bundle(4).multSub(2.0f, stackBuffers[0].bundle(0), stackBuffers[1].bundle(1));
+		returnBuffer.bundle(4).multSub(2.0f, stackBuffers[2].bundle(0), stackBuffers[3].bundle(1));
+		returnBuffer.bundle(4).multAdd(2.0f, stackBuffers[0].bundle(1), stackBuffers[1].bundle(0));
+		returnBuffer.bundle(4).multAdd(2.0f, stackBuffers[2].bundle(1), stackBuffers[3].bundle(0));
+		returnBuffer.bundle(0).multSub(stackBuffers[0].bundle(5), stackBuffers[1].bundle(0));
+		returnBuffer.bundle(0).multSub(stackBuffers[2].bundle(5), stackBuffers[3].bundle(0));
+		returnBuffer.bundle(0).multSub(stackBuffers[0].bundle(4), stackBuffers[1].bundle(1));
+		returnBuffer.bundle(0).multSub(stackBuffers[2].bundle(4), stackBuffers[3].bundle(1));
+		returnBuffer.bundle(0).multSub(stackBuffers[0].bundle(3), stackBuffers[1].bundle(1));
+		returnBuffer.bundle(0).multSub(stackBuffers[2].bundle(3), stackBuffers[3].bundle(1));
+		returnBuffer.bundle(0).multSub(stackBuffers[0].bundle(2), stackBuffers[1].bundle(0));
+		returnBuffer.bundle(0).multSub(stackBuffers[2].bundle(2), stackBuffers[3].bundle(0));
+		returnBuffer.bundle(0).multSub(stackBuffers[0].bundle(0), stackBuffers[1].bundle(2));
+		returnBuffer.bundle(0).multSub(stackBuffers[2].bundle(0), stackBuffers[3].bundle(2));
+		returnBuffer.bundle(0).multAdd(stackBuffers[0].bundle(1), stackBuffers[1].bundle(3));
+		returnBuffer.bundle(0).multAdd(stackBuffers[2].bundle(1), stackBuffers[3].bundle(3));
+		returnBuffer.bundle(0).multAdd(stackBuffers[0].bundle(1), stackBuffers[1].bundle(4));
+		returnBuffer.bundle(0).multAdd(stackBuffers[2].bundle(1), stackBuffers[3].bundle(4));
+		returnBuffer.bundle(0).multSub(stackBuffers[0].bundle(0), stackBuffers[1].bundle(5));
+		returnBuffer.bundle(0).multSub(stackBuffers[2].bundle(0), stackBuffers[3].bundle(5));
+		returnBuffer.bundle(1).multSub(stackBuffers[0].bundle(5), stackBuffers[1].bundle(1));
+		returnBuffer.bundle(1).multSub(stackBuffers[2].bundle(5), stackBuffers[3].bundle(1));
+		returnBuffer.bundle(1).multAdd(stackBuffers[0].bundle(4), stackBuffers[1].bundle(0));
+		returnBuffer.bundle(1).multAdd(stackBuffers[2].bundle(4), stackBuffers[3].bundle(0));
+		returnBuffer.bundle(1).multAdd(stackBuffers[0].bundle(3), stackBuffers[1].bundle(0));
+		returnBuffer.bundle(1).multAdd(stackBuffers[2].bundle(3), stackBuffers[3].bundle(0));
+		returnBuffer.bundle(1).multSub(stackBuffers[0].bundle(2), stackBuffers[1].bundle(1));
+		returnBuffer.bundle(1).multSub(stackBuffers[2].bundle(2), stackBuffers[3].bundle(1));
+		returnBuffer.bundle(1).multSub(stackBuffers[0].bundle(0), stackBuffers[1].bundle(3));
+		returnBuffer.bundle(1).multSub(stackBuffers[2].bundle(0), stackBuffers[3].bundle(3));
+		returnBuffer.bundle(1).multSub(stackBuffers[0].bundle(1), stackBuffers[1].bundle(2));
+		returnBuffer.bundle(1).multSub(stackBuffers[2].bundle(1), stackBuffers[3].bundle(2));
+		returnBuffer.bundle(1).multSub(stackBuffers[0].bundle(1), stackBuffers[1].bundle(5));
+		returnBuffer.bundle(1).multSub(stackBuffers[2].bundle(1), stackBuffers[3].bundle(5));
+		returnBuffer.bundle(1).multSub(stackBuffers[0].bundle(0), stackBuffers[1].bundle(4));
+		returnBuffer.bundle(1).multSub(stackBuffers[2].bundle(0), stackBuffers[3].bundle(4));
+		returnBuffer.bundle(3).multSub(stackBuffers[0].bundle(5), stackBuffers[1].bundle(3));
+		returnBuffer.bundle(3).multSub(stackBuffers[2].bundle(5), stackBuffers[3].bundle(3));
+		returnBuffer.bundle(3).multSub(stackBuffers[0].bundle(4), stackBuffers[1].bundle(2));
+		returnBuffer.bundle(3).multSub(stackBuffers[2].bundle(4), stackBuffers[3].bundle(2));
+		returnBuffer.bundle(3).multSub(stackBuffers[0].bundle(3), stackBuffers[1].bundle(5));
+		returnBuffer.bundle(3).multSub(stackBuffers[2].bundle(3), stackBuffers[3].bundle(5));
+		returnBuffer.bundle(3).multSub(stackBuffers[0].bundle(2), stackBuffers[1].bundle(4));
+		returnBuffer.bundle(3).multSub(stackBuffers[2].bundle(2), stackBuffers[3].bundle(4));
+		returnBuffer.bundle(3).multSub(2.0f, stackBuffers[0].bundle(0), stackBuffers[1].bundle(1));
+		returnBuffer.bundle(3).multSub(2.0f, stackBuffers[2].bundle(0), stackBuffers[3].bundle(1));
+		returnBuffer.bundle(3).multAdd(2.0f, stackBuffers[0].bundle(1), stackBuffers[1].bundle(0));
+		returnBuffer.bundle(3).multAdd(2.0f, stackBuffers[2].bundle(1), stackBuffers[3].bundle(0));
+		returnBuffer.bundle(2).multSub(stackBuffers[0].bundle(5), stackBuffers[1].bundle(2));
+		returnBuffer.bundle(2).multSub(stackBuffers[2].bundle(5), stackBuffers[3].bundle(2));
+		returnBuffer.bundle(2).multAdd(stackBuffers[0].bundle(4), stackBuffers[1].bundle(3));
+		returnBuffer.bundle(2).multAdd(stackBuffers[2].bundle(4), stackBuffers[3].bundle(3));
+		returnBuffer.bundle(2).multAdd(stackBuffers[0].bundle(3), stackBuffers[1].bundle(4));
+		returnBuffer.bundle(2).multAdd(stackBuffers[2].bundle(3), stackBuffers[3].bundle(4));
+		returnBuffer.bundle(2).multSub(stackBuffers[0].bundle(2), stackBuffers[1].bundle(5));
+		returnBuffer.bundle(2).multSub(stackBuffers[2].bundle(2), stackBuffers[3].bundle(5));
+		returnBuffer.bundle(2).multSub(2.0f, stackBuffers[0].bundle(0), stackBuffers[1].bundle(0));
+		returnBuffer.bundle(2).multSub(2.0f, stackBuffers[2].bundle(0), stackBuffers[3].bundle(0));
+		returnBuffer.bundle(2).multSub(2.0f, stackBuffers[0].bundle(1), stackBuffers[1].bundle(1));
+		returnBuffer.bundle(2).multSub(2.0f, stackBuffers[2].bundle(1), stackBuffers[3].bundle(1));
+		#pragma endregion
+	};
+
+	//propagator bubble
+	auto p = [&](const float w1, const float w2) -> float
+	{
+		return 1.0f / ((w1 + v2->getValue(w1)) *(w2 + v2->getValue(w2)));
+	};
+
+	//Katanin contribution, call only once the _flow has been fully calculated and broadcasted
+	auto pKataninContribution = [&](const float w1, const float w2) -> float
+	{
+		float denomW1 = w1 + v2->getValue(w1);
+		return static_cast<U1EffectiveAction *>(_flow)->vertexSingleParticle->getValue(w1) / (denomW1 * denomW1 * (w2 + v2->getValue(w2)));
+	};
+
+	//begin calculation of vertices here
+	//conventional contribution
+	integralKernelS(cutoff, buffer1);
+	v4CurrentValue.multAdd(p(cutoff, cutoff + s), buffer1);
+	if (s > 2.0f * cutoff)
+	{
+		integralKernelS(-cutoff, buffer1);
+		v4CurrentValue.multAdd(p(cutoff, cutoff - s), buffer1);
+	}
+	integralKernelT(cutoff, buffer1);
+	v4CurrentValue.multAdd(p(cutoff, cutoff + t), buffer1);
+	if (t > 2.0f * cutoff)
+	{
+		integralKernelT(-cutoff, buffer1);
+		v4CurrentValue.multAdd(p(cutoff, cutoff - t), buffer1);
+	}
+	integralKernelU(cutoff, buffer1);
+	v4CurrentValue.multAdd(p(cutoff, cutoff + u), buffer1);
+	if (u > 2.0f * cutoff)
+	{
+		integralKernelU(-cutoff, buffer1);
+		v4CurrentValue.multAdd(p(cutoff, cutoff - u), buffer1);
+	}
+
+	//Katanin contribution
+	std::function<void(float, ValueSuperbundle<float, 6> &)> integralKernelSKatanin = [&](float wp, ValueSuperbundle<float, 6> &returnBuffer)->void { integralKernelS(wp, returnBuffer); returnBuffer *= pKataninContribution(wp, s + wp); };
+	std::function<void(float, ValueSuperbundle<float, 6> &)> integralKernelTKatanin = [&](float wp, ValueSuperbundle<float, 6> &returnBuffer)->void { integralKernelT(wp, returnBuffer); returnBuffer *= pKataninContribution(wp, t + wp); };
+	std::function<void(float, ValueSuperbundle<float, 6> &)> integralKernelUKatanin = [&](float wp, ValueSuperbundle<float, 6> &returnBuffer)->void { integralKernelU(wp, returnBuffer); returnBuffer *= pKataninContribution(wp, u + wp); };
+
+	if (-(s + cutoff) > *FrgCommon::frequency().beginNegative())
+	{
+		ImplicitIntegrator::integrateWithObscureRightBoundary(FrgCommon::frequency().beginNegative(), -(s + cutoff), integralKernelSKatanin, buffer1, buffer2);
+		v4CurrentValue += buffer2;
+	}
+	if (s - cutoff > cutoff)
+	{
+		ImplicitIntegrator::integrateWithObscureBoundaries(cutoff - s, -cutoff, integralKernelSKatanin, buffer1, buffer2);
+		v4CurrentValue += buffer2;
+	}
+	if (cutoff < *FrgCommon::frequency().last())
+	{
+		ImplicitIntegrator::integrateWithObscureLeftBoundary(cutoff, FrgCommon::frequency().last(), integralKernelSKatanin, buffer1, buffer2);
+		v4CurrentValue += buffer2;
+	}
+
+	if (-(t + cutoff) > *FrgCommon::frequency().beginNegative())
+	{
+		ImplicitIntegrator::integrateWithObscureRightBoundary(FrgCommon::frequency().beginNegative(), -(t + cutoff), integralKernelTKatanin, buffer1, buffer2);
+		v4CurrentValue += buffer2;
+	}
+	if (t - cutoff > cutoff)
+	{
+		ImplicitIntegrator::integrateWithObscureBoundaries(cutoff - t, -cutoff, integralKernelTKatanin, buffer1, buffer2);
+		v4CurrentValue += buffer2;
+	}
+	if (cutoff < *FrgCommon::frequency().last())
+	{
+		ImplicitIntegrator::integrateWithObscureLeftBoundary(cutoff, FrgCommon::frequency().last(), integralKernelTKatanin, buffer1, buffer2);
+		v4CurrentValue += buffer2;
+	}
+
+	if (-(u + cutoff) > *FrgCommon::frequency().beginNegative())
+	{
+		ImplicitIntegrator::integrateWithObscureRightBoundary(FrgCommon::frequency().beginNegative(), -(u + cutoff), integralKernelUKatanin, buffer1, buffer2);
+		v4CurrentValue += buffer2;
+	}
+	if (u - cutoff > cutoff)
+	{
+		ImplicitIntegrator::integrateWithObscureBoundaries(cutoff - u, -cutoff, integralKernelUKatanin, buffer1, buffer2);
+		v4CurrentValue += buffer2;
+	}
+	if (cutoff < *FrgCommon::frequency().last())
+	{
+		ImplicitIntegrator::integrateWithObscureLeftBoundary(cutoff, FrgCommon::frequency().last(), integralKernelUKatanin, buffer1, buffer2);
+		v4CurrentValue += buffer2;
+	}
+
+	//prefactor
+	v4CurrentValue /= (2.0f * (float)M_PI);
+
+	for (int b = 0; b < 6; ++b)
+	{
+		for (int rid = 0; rid < FrgCommon::lattice().size; ++rid) static_cast<U1EffectiveAction *>(_flow)->vertexTwoParticle->_data[iterator * 6 * FrgCommon::lattice().size + b * FrgCommon::lattice().size + rid] = (isSiteActive(rid)) ? v4CurrentValue.bundle(b)[rid] : 0.0f;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+/**
+ * @file U1FrgCore.hpp
+ * @author Finn Lasse Buessen
+ * @brief FrgCore implementation for U(1)-symmetric models.
+ * 
+ * @copyright Copyright (c) 2020
+ */
+
+#pragma once
+#include <vector>
+#include "FrgCore.hpp"
+
+/**
+ * @brief FrgCore implementation for U(1)-symmetric models.
+ */
+class U1FrgCore : public FrgCore
+{
+public:
+	/**
+	 * @brief Construct a new U1FrgCore, initialize with the specified spin model and add measurements. 
+	 * 
+	 * @param spinModel Spin model to initialize the effective action with. 
+	 * @param measurements Measurements to add. 
+	 * @param options String-form list of core options as provided in the task file. 
+	 */
+	U1FrgCore(const SpinModel &spinModel, const std::vector<Measurement *> &measurements, const std::map<std::string, std::string> &options);
+	
+	/**
+	 * @brief Destroy the U1FrgCore object. 
+	 */
+	~U1FrgCore();
+
+	/**
+	 * @brief Compute flow equations. 
+	 */
+	void computeStep() override;
+
+	/**
+	 * @brief Finalize calculation of flow equations. 
+	 * 
+	 * @param newCutoff New cutoff to which to extrapolate flow. 
+	 */
+	void finalizeStep(const float newCutoff) override;
+
+	/**
+	 * @brief Select the fastest variants of the kernels which compute the flow of the two-particle vertex. 
+	 * 
+	 * @param tuner Kernel tuner. 
+	 */
+	void tuneKernels(KernelTuner &tuner) override;
+
+	float normalization; ///< Energy normalization factor. 
+
+private:
+	int dataStacks[6]; ///< References to the LoadManager::DataStack. 
+	std::vector<std::vector<int>> _overlapComponents1; ///< Stored vertex component of the first vertex for every overlap term and requested component, indexed as [rid][6 * i + component]. 
+	std::vector<std::vector<int>> _overlapComponents2; ///< Stored vertex component of the second vertex for every overlap term and requested component, indexed as [rid][6 * i + component]. 
+	std::vector<std::vector<float>> _overlapSigns1; ///< Sign factor of the first vertex for every overlap term and requested component, indexed as [rid][6 * i + component]. 
+	std::vector<std::vector<float>> _overlapSigns2; ///< Sign factor of the second vertex for every overlap term and requested component, indexed as [rid][6 * i + component]. 
+
+	/**
+	 * @brief Calculate the single-particle vertex flow for a specific linear iterator, which is expanded via U1VertexSingleParticle::expandIterator().
+	 * 
+	 * @param iterator Linear iterator. 
+	 */
+	void _calculateVertexSingleParticle(const int iterator);
+
+	/**
+	 * @brief Calculate the two-particle vertex flow for a specific linear iterator, which is expanded via U1VertexTwoParticle::expandIterator().
+	 * 
+	 * @tparam n Number of support values in the frequency interpolation of vertices. Either 4 for linear or 16 for cubic interpolation. 
+	 * @param iterator Linear iterator. 
+	 */
+	template <int n> void _calculateVertexTwoParticle(const int iterator);
+};
\ No newline at end of file
@@ -0,0 +1,112 @@
+/**
+ * @file U1VertexSingleParticle.hpp
+ * @author Finn Lasse Buessen
+ * @brief Single-particle vertex implementation for U(1)-symmetric models.
+ * 
+ * @copyright Copyright (c) 2020
+ */
+
+#pragma once
+#include <istream>
+#include "lib/Assert.hpp"
+#include "FrgCommon.hpp"
+
+/**
+ * @brief Single-particle vertex implementation for U(1)-symmetric models.
+ */
+struct U1VertexSingleParticle
+{
+public:
+	/**
+	 * @brief Construct a new U1VertexSingleParticle object and initialize all values to zero. 
+	 */
+	U1VertexSingleParticle()
+	{
+		//set size
+		size = FrgCommon::frequency().size;
+
+		//alloc and init memory
+		_data = new float[size];
+		for (int i = 0; i < size; ++i) _data[i] = 0.0f;
+	}
+
+	/**
+	 * @brief Destroy the U1VertexSingleParticle object. 
+	 */
+	~U1VertexSingleParticle()
+	{
+		delete[] _data;
+	}
+
+	/**
+	 * @brief Expand a linear iterator in the range [0,U1VertexSingleParticle::size).
+	 * 
+	 * @param[in] iterator Iterator to expand. 
+	 * @param[out] w Frequency argument described by the iterator. 
+	 */
+	void expandIterator(const int iterator, float &w) const
+	{
+		ASSERT(iterator >= 0 && iterator < size);
+
+		w = FrgCommon::frequency()._data[iterator];
+	}
+
+	/**
+	 * @brief Directly access a vertex value by reference via a linear iterator in the range [0,U1VertexSingleParticle::size). 
+	 * 
+	 * @param iterator Linear iterator. 
+	 * @return float& Vertex value. 
+	 */
+	float &getValueRef(const int iterator) const
+	{
+		ASSERT(iterator >= 0 && iterator < size);
+
+		return _data[iterator];
+	}
+
+	/**
+	 * @brief Access vertex value at arbitrary frequency value by performing an interpolation on the FrequencyDiscretization. 
+	 * 
+	 * @param w Frequency argument. 
+	 * @return float Vertex value. 
+	 */
+	float getValue(float w) const
+	{
+		int lower, upper;
+		float bias;
+		float sign = 1.0f;
+
+		if (w < 0)
+		{
+			w = -w;
+			sign = -1.0f;
+		}
+
+		if (FrgCommon::frequency().interpolation == FrequencyDiscretization::Interpolation::Cubic)
+		{
+			int offsets[4];
+			float weights[4];
+			FrgCommon::frequency().interpolateStencil<4>(w, offsets, weights);
+			return sign * (weights[0] * _directAccess(offsets[0]) + weights[1] * _directAccess(offsets[1]) + weights[2] * _directAccess(offsets[2]) + weights[3] * _directAccess(offsets[3]));
+		}
+
+		FrgCommon::frequency().interpolateOffset(w, lower, upper, bias);
+		return sign * ((1 - bias) * _directAccess(lower) + bias * _directAccess(upper));
+	}
+
+	/**
+	 * @brief Access vertex value at given frequency mesh point. 
+	 * 
+	 * @param wOffset Linear offset on the frequency mesh. 
+	 * @return float& Vertex value. 
+	 */
+	float &_directAccess(const int wOffset) const
+	{
+		ASSERT(wOffset >= 0 && wOffset < FrgCommon::frequency().size);
+
+		return _data[wOffset];
+	}
+
+	int size; ///< Total number of vertex elements. 
+	float *_data; ///< Vertex data. 
+};
\ No newline at end of file
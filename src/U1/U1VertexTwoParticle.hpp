@@ -0,0 +1,823 @@
+/**
+ * @file U1VertexTwoParticle.hpp
+ * @author Finn Lasse Buessen
+ * @brief Two-particle vertex implementation for U(1)-symmetric models.
+ *
+ * @copyright Copyright (c) 2020
+ */
+
+#pragma once
+#include <istream>
+#include "lib/ValueBundle.hpp"
+#include "lib/Assert.hpp"
+#include "lib/Exception.hpp"
+#include "FrgCommon.hpp"
+#include "KernelTuner.hpp"
+
+/**
+ * @brief Buffer for frequency interpolation information.
+ * @details The buffer contains a list of memory offsets (number of elements) in the frequency dimensions of the two-particle vertex that correspond to all the support values that are part of the interpolation.
+ * The memory offset in frequency space must be complemented with the linear memory offset in the lattice site dimension.
+ * Each support value is assigned a weight factor.
+ * Each support value is also complemented by a sign factor that is either +1 or -1 (and depends on the vertex component) and by the information whether a lattice site exchange should be performed upon accessing the support value.
+ *
+ * @tparam size Number of support sites for the interpolation.
+ */
+template <int size> struct U1VertexTwoParticleAccessBuffer
+{
+public:
+	/**
+	 * @brief Construct a new U1VertexTwoParticleAccessBuffer object and initialize the sign factors to plus one.
+	 */
+	U1VertexTwoParticleAccessBuffer() : pairExchange(false)
+	{
+		for (int i = 0; i < 6 * size; ++i) (&sign[0][0])[i] = 1.0f;
+	}
+
+	int frequencyOffsets[size]; ///< Linear memory offset (number of elements) in the frequency dimensions of the two-particle vertex.
+	float frequencyWeights[size]; ///< Weight factors of the support values.
+	float sign[size][6]; ///< Sign factors of the support values, indexed by the requested vertex component.
+	bool pairExchange; ///< Site exchange indicator.
+};
+
+/**
+ * @brief Two-particle vertex implementation for U(1)-symmetric models.
+ * @details Models which are invariant under spin rotations about the z-axis (e.g. XXZ models with z-axis DM interactions) only allow for six independent vertex components.
+ * The vertex stores the components xx (=yy), xy (=-yx), zz, zd, dz and dd, where d denotes the density channel, in that order.
+ * All remaining spin components vanish by symmetry.
+ * Accessors which take a pair of SpinComponent arguments transparently map them onto the stored components.
+ */
+struct U1VertexTwoParticle
+{
+public:
+	/**
+	 * @brief Indicator for frequency channels that exactly lie on frequency mesh points.
+	 */
+	enum struct FrequencyChannel
+	{
+		S, ///< s-channel.
+		T, ///< t-channel.
+		U, ///< u-channel.
+		All, ///< All channels.
+		None ///< No channel.
+	};
+
+	/**
+	 * @brief Construct a new U1VertexTwoParticle object and initialize all entries to zero.
+	 */
+	U1VertexTwoParticle()
+	{
+		//store width in all memory dimensions
+		_memoryStep[2] = FrgCommon::lattice().size;
+		_memoryStep[1] = 6 * _memoryStep[2];
+		_memoryStep[0] = FrgCommon::frequency().size * _memoryStep[1];
+
+		sizeFrequency = FrgCommon::frequency().size * FrgCommon::frequency().size * (FrgCommon::frequency().size + 1) / 2;
+		size = 6 * FrgCommon::lattice().size * sizeFrequency;
+
+		//alloc and init memory
+		_data = new float[size];
+		//first touch in parallel, such that memory pages are placed close to the threads which compute the flow
+		#ifndef DISABLE_OMP
+		#pragma omp parallel for schedule(static)
+		#endif
+		for (int i = 0; i < size; ++i) _data[i] = 0.0f;
+
+		//precompute component transformations of all representative sites
+		_siteComponents = new int[2 * 6 * FrgCommon::lattice().size];
+		_siteSigns = new float[2 * 6 * FrgCommon::lattice().size];
+		for (int exchange = 0; exchange <= 1; ++exchange)
+		{
+			const LatticeSiteDescriptor *sites = (exchange) ? FrgCommon::lattice().getInvertedSites() : FrgCommon::lattice().getSites();
+			for (int j = 0; j < FrgCommon::lattice().size; ++j)
+			{
+				for (int c = 0; c < 6; ++c)
+				{
+					float sign = 1.0f;
+					int storedComponent = c;
+					if (exchange) storedComponent = swapComponent(c, sign);
+					int transformedComponent = symmetryTransformComponent(storedComponent, sites[j].spinPermutation, sign);
+
+					int offset = (exchange * FrgCommon::lattice().size + j) * 6 + c;
+					_siteComponents[offset] = (transformedComponent < 0) ? 0 : transformedComponent;
+					_siteSigns[offset] = (transformedComponent < 0) ? 0.0f : sign;
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Destroy the U1VertexTwoParticle object.
+	 */
+	~U1VertexTwoParticle()
+	{
+		delete[] _data;
+		delete[] _siteComponents;
+		delete[] _siteSigns;
+	}
+
+	/**
+	 * @brief Map a pair of spin components onto the corresponding stored vertex component.
+	 *
+	 * @param[in] s1 First spin component (X, Y, Z or None).
+	 * @param[in] s2 Second spin component (X, Y, Z or None).
+	 * @param[out] sign Sign factor which is multiplied by the sign relating the requested and the stored component.
+	 * @return int Index of the stored vertex component in the range [0,6), or -1 if the component vanishes by symmetry.
+	 */
+	static int componentIndex(const SpinComponent s1, const SpinComponent s2, float &sign)
+	{
+		static const int index[4][4] = {
+			{ 0, 1, -1, -1 },
+			{ 1, 0, -1, -1 },
+			{ -1, -1, 2, 3 },
+			{ -1, -1, 4, 5 }
+		};
+		ASSERT(static_cast<int>(s1) >= 0 && static_cast<int>(s1) < 4);
+		ASSERT(static_cast<int>(s2) >= 0 && static_cast<int>(s2) < 4);
+
+		if (s1 == SpinComponent::Y && s2 == SpinComponent::X) sign = -sign;
+		return index[static_cast<int>(s1)][static_cast<int>(s2)];
+	}
+
+	/**
+	 * @brief Retrieve a representative pair of spin components for a stored vertex component.
+	 *
+	 * @param[in] component Stored vertex component in the range [0,6).
+	 * @param[out] s1 First spin component.
+	 * @param[out] s2 Second spin component.
+	 */
+	static void componentSpins(const int component, SpinComponent &s1, SpinComponent &s2)
+	{
+		static const SpinComponent spins[6][2] = {
+			{ SpinComponent::X, SpinComponent::X },
+			{ SpinComponent::X, SpinComponent::Y },
+			{ SpinComponent::Z, SpinComponent::Z },
+			{ SpinComponent::Z, SpinComponent::None },
+			{ SpinComponent::None, SpinComponent::Z },
+			{ SpinComponent::None, SpinComponent::None }
+		};
+		ASSERT(component >= 0 && component < 6);
+
+		s1 = spins[component][0];
+		s2 = spins[component][1];
+	}
+
+	/**
+	 * @brief Map a stored vertex component onto the component with exchanged spin arguments.
+	 *
+	 * @param[in] component Stored vertex component in the range [0,6).
+	 * @param[out] sign Sign factor which is multiplied by the sign relating both components.
+	 * @return int Index of the exchanged component.
+	 */
+	static int swapComponent(const int component, float &sign)
+	{
+		static const int swapped[6] = { 0, 1, 2, 4, 3, 5 };
+		ASSERT(component >= 0 && component < 6);
+
+		if (component == 1) sign = -sign;
+		return swapped[component];
+	}
+
+	/**
+	 * @brief Apply a spin permutation, as stored in a LatticeSiteDescriptor, to a stored vertex component.
+	 *
+	 * @param[in] component Stored vertex component in the range [0,6).
+	 * @param[in] spinPermutation Spin permutation, where transformedComponent=spinPermutation[originalComponent].
+	 * @param[out] sign Sign factor which is multiplied by the sign acquired under the transformation.
+	 * @return int Index of the transformed component, or -1 if the transformed component vanishes by symmetry.
+	 */
+	static int symmetryTransformComponent(const int component, const SpinComponent *spinPermutation, float &sign)
+	{
+		auto transform = [&](SpinComponent s)->SpinComponent
+		{
+			if (s == SpinComponent::None) return s;
+			s = spinPermutation[static_cast<int>(s)];
+			if (static_cast<int>(s) > static_cast<int>(SpinComponent::None))
+			{
+				sign = -sign;
+				s = static_cast<SpinComponent>(static_cast<int>(s) - static_cast<int>(SpinComponent::MinusX));
+			}
+			return s;
+		};
+
+		SpinComponent s1, s2;
+		componentSpins(component, s1, s2);
+		s1 = transform(s1);
+		s2 = transform(s2);
+		return componentIndex(s1, s2, sign);
+	}
+
+	/**
+	 * @brief Expand a linear iterator in the range [0,size) that iterates over all vertex entries.
+	 *
+	 * @param[in] iterator Linear iterator.
+	 * @param[out] i1 Lattice site iterator.
+	 * @param[out] s First frequency argument.
+	 * @param[out] t Second frequency argument.
+	 * @param[out] u Third frequency argument.
+	 * @param[out] s1 First vertex channel of a representative spin component pair.
+	 * @param[out] s2 Second vertex channel of a representative spin component pair.
+	 */
+	void expandIterator(int iterator, LatticeIterator &i1, float &s, float &t, float &u, SpinComponent &s1, SpinComponent &s2) const
+	{
+		ASSERT(iterator >= 0 && iterator < size);
+		ASSERT(&s != &t);
+		ASSERT(&t != &u);
+		ASSERT(&s != &u);
+		ASSERT(&s1 != &s2);
+
+		int it = iterator;
+
+		int su = it / _memoryStep[0];
+		it = it % _memoryStep[0];
+		t = FrgCommon::frequency()._data[it / _memoryStep[1]];
+		it = it % _memoryStep[1];
+		componentSpins(it / _memoryStep[2], s1, s2);
+		it = it % _memoryStep[2];
+		i1 = FrgCommon::lattice().fromParametrization(it);
+
+		for (int so = 0; so <= su; ++so)
+		{
+			for (int uo = 0; uo <= so; ++uo)
+			{
+				if (su == so * (so + 1) / 2 + uo)
+				{
+					s = FrgCommon::frequency()._data[so];
+					u = FrgCommon::frequency()._data[uo];
+					return;
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Expand a linear iterator in the range [0,sizeFrequency) that iterates over all paramtetrized frequency values.
+	 *
+	 * @param[in] iterator Linear iterator.
+	 * @param[out] s First frequency argument.
+	 * @param[out] t Second frequency argument.
+	 * @param[out] u Third frequency argument.
+	 */
+	void expandIterator(int iterator, float &s, float &t, float &u) const
+	{
+		ASSERT(iterator >= 0 && iterator < sizeFrequency);
+		ASSERT(&s != &t);
+		ASSERT(&t != &u);
+		ASSERT(&s != &u);
+
+		int su = iterator / FrgCommon::frequency().size;
+		t = FrgCommon::frequency()._data[iterator % FrgCommon::frequency().size];
+
+		for (int so = 0; so <= su; ++so)
+		{
+			for (int uo = 0; uo <= so; ++uo)
+			{
+				if (su == so * (so + 1) / 2 + uo)
+				{
+					s = FrgCommon::frequency()._data[so];
+					u = FrgCommon::frequency()._data[uo];
+					return;
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Directly access a vertex value via a linear iterator in the range [0,size).
+	 *
+	 * @param iterator Linear iterator.
+	 * @return float& Vertex value.
+	 */
+	float &getValueRef(const int iterator) const
+	{
+		ASSERT(iterator >= 0 && iterator < size);
+
+		return _data[iterator];
+	}
+
+	/**
+	 * @brief Access vertex value at arbitrary lattice sites, frequencies, and spin components.
+	 *
+	 * @param i1 First lattice site argument.
+	 * @param i2 Second lattice site argument.
+	 * @param s First frequency argument.
+	 * @param t Second frequency argument.
+	 * @param u Third frequency argument.
+	 * @param s1 First vertex channel.
+	 * @param s2 Second vertex channel.
+	 * @param channel Frequency channel.
+	 * @return float Vertex value.
+	 */
+	float getValue(LatticeIterator i1, LatticeIterator i2, float s, float t, float u, SpinComponent s1, SpinComponent s2, const FrequencyChannel channel) const
+	{
+		//higher-order interpolation is performed via access buffers
+		if (FrgCommon::frequency().interpolation == FrequencyDiscretization::Interpolation::Cubic && channel != FrequencyChannel::All)
+		{
+			if (channel == FrequencyChannel::None) return getValue(i1, i2, s1, s2, generateAccessBuffer<64>(s, t, u));
+			else return getValue(i1, i2, s1, s2, generateAccessBuffer<16>(s, t, u, channel));
+		}
+
+		ASSERT(channel == FrequencyChannel::S || channel == FrequencyChannel::T || channel == FrequencyChannel::U || channel == FrequencyChannel::None || channel == FrequencyChannel::All);
+
+		//map to positive frequency sector
+		float sign = 1.0f;
+		if (s < 0)
+		{
+			s = -s;
+			std::swap(s1, s2);
+			std::swap(i1, i2);
+		}
+		if (t < 0)
+		{
+			t = -t;
+			sign *= _zeta(static_cast<int>(s1)) * _zeta(static_cast<int>(s2));
+		}
+		if (u < 0)
+		{
+			u = -u;
+			std::swap(s1, s2);
+			std::swap(i1, i2);
+			sign *= _zeta(static_cast<int>(s1)) * _zeta(static_cast<int>(s2));
+		}
+
+		//map to stored component
+		int siteOffset = FrgCommon::lattice().symmetryTransform(i1, i2, s1, s2, sign);
+		int component = componentIndex(s1, s2, sign);
+		if (component < 0) return 0.0f;
+
+		if (channel == FrequencyChannel::S)
+		{
+			int exactS = FrgCommon::frequency().offset(s);
+
+			int lowerT, upperT;
+			float biasT;
+			int lowerU, upperU;
+			float biasU;
+
+			FrgCommon::frequency().interpolateOffset(t, lowerT, upperT, biasT);
+			FrgCommon::frequency().interpolateOffset(u, lowerU, upperU, biasU);
+
+			return sign * (
+				(1 - biasU) * (
+				(1 - biasT) * (_directAccessMapFrequencyExchange(siteOffset, exactS, lowerT, lowerU, component)) + biasT * (_directAccessMapFrequencyExchange(siteOffset, exactS, upperT, lowerU, component))
+					) + biasU * (
+					(1 - biasT) * (_directAccessMapFrequencyExchange(siteOffset, exactS, lowerT, upperU, component)) + biasT * (_directAccessMapFrequencyExchange(siteOffset, exactS, upperT, upperU, component))
+						));
+		}
+		else if (channel == FrequencyChannel::T)
+		{
+			int exactT = FrgCommon::frequency().offset(t);
+
+			int lowerS, upperS;
+			float biasS;
+			int lowerU, upperU;
+			float biasU;
+
+			FrgCommon::frequency().interpolateOffset(s, lowerS, upperS, biasS);
+			FrgCommon::frequency().interpolateOffset(u, lowerU, upperU, biasU);
+
+			return sign * (
+				(1 - biasU) * (
+				(1 - biasS) * (_directAccessMapFrequencyExchange(siteOffset, lowerS, exactT, lowerU, component)) + biasS * (_directAccessMapFrequencyExchange(siteOffset, upperS, exactT, lowerU, component))
+					) + biasU * (
+					(1 - biasS) * (_directAccessMapFrequencyExchange(siteOffset, lowerS, exactT, upperU, component)) + biasS * (_directAccessMapFrequencyExchange(siteOffset, upperS, exactT, upperU, component))
+						));
+		}
+		else if (channel == FrequencyChannel::U)
+		{
+			int exactU = FrgCommon::frequency().offset(u);
+
+			int lowerS, upperS;
+			float biasS;
+			int lowerT, upperT;
+			float biasT;
+
+			FrgCommon::frequency().interpolateOffset(s, lowerS, upperS, biasS);
+			FrgCommon::frequency().interpolateOffset(t, lowerT, upperT, biasT);
+
+			return sign * (
+				(1 - biasT) * (
+				(1 - biasS) * (_directAccessMapFrequencyExchange(siteOffset, lowerS, lowerT, exactU, component)) + biasS * (_directAccessMapFrequencyExchange(siteOffset, upperS, lowerT, exactU, component))
+					) + biasT * (
+					(1 - biasS) * (_directAccessMapFrequencyExchange(siteOffset, lowerS, upperT, exactU, component)) + biasS * (_directAccessMapFrequencyExchange(siteOffset, upperS, upperT, exactU, component))
+						));
+		}
+		else if (channel == FrequencyChannel::None)
+		{
+			int lowerS, upperS;
+			float biasS;
+			int lowerT, upperT;
+			float biasT;
+			int lowerU, upperU;
+			float biasU;
+
+			FrgCommon::frequency().interpolateOffset(s, lowerS, upperS, biasS);
+			FrgCommon::frequency().interpolateOffset(t, lowerT, upperT, biasT);
+			FrgCommon::frequency().interpolateOffset(u, lowerU, upperU, biasU);
+
+			return sign * (
+				(1 - biasU) * (
+				(1 - biasT) * (
+					(1 - biasS) * (_directAccessMapFrequencyExchange(siteOffset, lowerS, lowerT, lowerU, component)) + biasS * (_directAccessMapFrequencyExchange(siteOffset, upperS, lowerT, lowerU, component))
+					) + biasT * (
+					(1 - biasS) * (_directAccessMapFrequencyExchange(siteOffset, lowerS, upperT, lowerU, component)) + biasS * (_directAccessMapFrequencyExchange(siteOffset, upperS, upperT, lowerU, component))
+						)
+					) + biasU * (
+					(1 - biasT) * (
+						(1 - biasS) * (_directAccessMapFrequencyExchange(siteOffset, lowerS, lowerT, upperU, component)) + biasS * (_directAccessMapFrequencyExchange(siteOffset, upperS, lowerT, upperU, component))
+						) + biasT * (
+						(1 - biasS) * (_directAccessMapFrequencyExchange(siteOffset, lowerS, upperT, upperU, component)) + biasS * (_directAccessMapFrequencyExchange(siteOffset, upperS, upperT, upperU, component))
+							)
+						));
+		}
+		else if (channel == FrequencyChannel::All)
+		{
+			int exactS = FrgCommon::frequency().offset(s);
+			int exactT = FrgCommon::frequency().offset(t);
+			int exactU = FrgCommon::frequency().offset(u);
+			return sign * _directAccessMapFrequencyExchange(siteOffset, exactS, exactT, exactU, component);
+		}
+		else throw Exception(Exception::Type::ArgumentError, "Specified frequency channel does not exist");
+	}
+
+	/**
+	 * @brief Access vertex value at arbitrary lattice sites and spin components via a given access buffer.
+	 *
+	 * @tparam n Number of support sites in the access buffer.
+	 * @param i1 First lattice site argument.
+	 * @param i2 Second lattice site argument.
+	 * @param s1 First vertex channel.
+	 * @param s2 Second vertex channel.
+	 * @param accessBuffer Access buffer.
+	 * @return float Vertex value.
+	 */
+	template <int n> float getValue(LatticeIterator i1, LatticeIterator i2, SpinComponent s1, SpinComponent s2, const U1VertexTwoParticleAccessBuffer<n> &accessBuffer) const
+	{
+		float requestedSign = 1.0f;
+		int requestedComponent = componentIndex(s1, s2, requestedSign);
+		if (requestedComponent < 0) return 0.0f;
+
+		if (accessBuffer.pairExchange)
+		{
+			std::swap(i1, i2);
+			std::swap(s1, s2);
+		}
+
+		float sign = 1.0f;
+		int siteOffset = FrgCommon::lattice().symmetryTransform(i1, i2, s1, s2, sign);
+		int component = componentIndex(s1, s2, sign);
+		if (component < 0) return 0.0f;
+		int spinOffset = component * _memoryStep[2];
+
+		float value = 0.0f;
+		for (int i = 0; i < n; ++i) value += accessBuffer.sign[i][requestedComponent] * accessBuffer.frequencyWeights[i] * _data[accessBuffer.frequencyOffsets[i] + spinOffset + siteOffset];
+		return sign * value;
+	}
+
+	/**
+	 * @brief Access vertex value locally at arbitrary spin components via a given access buffer.
+	 *
+	 * @tparam n Number of support sites in the access buffer.
+	 * @param s1 First vertex channel.
+	 * @param s2 Second vertex channel.
+	 * @param accessBuffer Access buffer.
+	 * @return float Vertex value.
+	 */
+	template <int n> float getValueLocal(SpinComponent s1, SpinComponent s2, const U1VertexTwoParticleAccessBuffer<n> &accessBuffer) const
+	{
+		float sign = 1.0f;
+		int requestedComponent = componentIndex(s1, s2, sign);
+		if (requestedComponent < 0) return 0.0f;
+		int component = (accessBuffer.pairExchange) ? swapComponent(requestedComponent, sign) : requestedComponent;
+		int spinOffset = component * _memoryStep[2];
+
+		float value = 0.0f;
+		for (int i = 0; i < n; ++i) value += accessBuffer.sign[i][requestedComponent] * accessBuffer.frequencyWeights[i] * _data[accessBuffer.frequencyOffsets[i] + spinOffset];
+		return sign * value;
+	}
+
+	/**
+	 * @brief Bundled vertex access on all lattice sites and stored vertex components simultaneously via a given access buffer.
+	 *
+	 * @tparam n Number of support sites in the access buffer.
+	 * @param[in] accessBuffer Access buffer.
+	 * @param[out] superbundle Vertex value bundle.
+	 */
+	template <int n> void getValueSuperbundle(const U1VertexTwoParticleAccessBuffer<n> &accessBuffer, ValueSuperbundle<float, 6> &superbundle) const
+	{
+		ASSERT(superbundle.bundle(0).size() == FrgCommon::lattice().size);
+
+		superbundle.reset();
+		const LatticeSiteDescriptor *sites = (accessBuffer.pairExchange) ? FrgCommon::lattice().getInvertedSites() : FrgCommon::lattice().getSites();
+		const int *siteComponents = (accessBuffer.pairExchange) ? _siteComponents + 6 * FrgCommon::lattice().size : _siteComponents;
+		const float *siteSigns = (accessBuffer.pairExchange) ? _siteSigns + 6 * FrgCommon::lattice().size : _siteSigns;
+
+		if (KernelTuner::gatherOrder == KernelTuner::GatherOrder::SiteMajor)
+		{
+			for (int j = 0; j < FrgCommon::lattice().size; ++j)
+			{
+				for (int c = 0; c < 6; ++c)
+				{
+					const float *data = _data + siteComponents[6 * j + c] * _memoryStep[2] + sites[j].rid;
+
+					float value = 0.0f;
+					for (int i = 0; i < n; ++i) value += siteSigns[6 * j + c] * accessBuffer.sign[i][c] * accessBuffer.frequencyWeights[i] * data[accessBuffer.frequencyOffsets[i]];
+					superbundle.bundle(c)[j] = value;
+				}
+			}
+			return;
+		}
+
+		for (int i = 0; i < n; ++i)
+		{
+			for (int c = 0; c < 6; ++c)
+			{
+				for (int j = 0; j < FrgCommon::lattice().size; ++j)
+				{
+					int spinOffset = siteComponents[6 * j + c] * _memoryStep[2];
+					superbundle.bundle(c)[j] += siteSigns[6 * j + c] * accessBuffer.sign[i][c] * accessBuffer.frequencyWeights[i] * _data[accessBuffer.frequencyOffsets[i] + spinOffset + sites[j].rid];
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Generate an access buffer for a set of frequencies where one of them (specified by channel) exactly lies on the frequency mesh.
+	 *
+	 * @tparam n Number of support values. Either 4 for linear or 16 for cubic interpolation.
+	 * @param s First frequency argument.
+	 * @param t Second frequency argument.
+	 * @param u Third frequency argument.
+	 * @param channel Frequency channel.
+	 * @return U1VertexTwoParticleAccessBuffer<n> Access buffer.
+	 */
+	template <int n = 4> U1VertexTwoParticleAccessBuffer<n> generateAccessBuffer(float s, float t, float u, const FrequencyChannel channel) const
+	{
+		ASSERT(channel == FrequencyChannel::S || channel == FrequencyChannel::T || channel == FrequencyChannel::U);
+
+		static_assert(n == 4 || n == 16, "Access buffer must hold either 4 or 16 support values");
+		constexpr int k = (n == 16) ? 4 : 2;
+
+		U1VertexTwoParticleAccessBuffer<n> ab;
+
+		//map to positive frequency sector
+		if (s < 0)
+		{
+			s = -s;
+			ab.pairExchange = !ab.pairExchange;
+		}
+		if (t < 0)
+		{
+			t = -t;
+			for (int i = 0; i < n; ++i)
+			{
+				for (int c = 0; c < 6; ++c) ab.sign[i][c] *= _zetaProduct(c);
+			}
+		}
+		if (u < 0)
+		{
+			u = -u;
+			ab.pairExchange = !ab.pairExchange;
+			for (int i = 0; i < n; ++i)
+			{
+				for (int c = 0; c < 6; ++c) ab.sign[i][c] *= _zetaProduct(c);
+			}
+		}
+
+		//interpolate frequency
+		if (channel == FrequencyChannel::S)
+		{
+			int exactS = FrgCommon::frequency().offset(s);
+			int offsetsT[k], offsetsU[k];
+			float weightsT[k], weightsU[k];
+			FrgCommon::frequency().interpolateStencil<k>(t, offsetsT, weightsT);
+			FrgCommon::frequency().interpolateStencil<k>(u, offsetsU, weightsU);
+
+			for (int j = 0; j < k; ++j)
+			{
+				for (int i = 0; i < k; ++i)
+				{
+					ab.frequencyWeights[k * j + i] = weightsU[j] * weightsT[i];
+					_generateAccessBufferOffsetMapFrequencyExchange(exactS, offsetsT[i], offsetsU[j], k * j + i, ab);
+				}
+			}
+		}
+		else if (channel == FrequencyChannel::T)
+		{
+			int exactT = FrgCommon::frequency().offset(t);
+			int offsetsS[k], offsetsU[k];
+			float weightsS[k], weightsU[k];
+			FrgCommon::frequency().interpolateStencil<k>(s, offsetsS, weightsS);
+			FrgCommon::frequency().interpolateStencil<k>(u, offsetsU, weightsU);
+
+			for (int j = 0; j < k; ++j)
+			{
+				for (int i = 0; i < k; ++i)
+				{
+					ab.frequencyWeights[k * j + i] = weightsU[j] * weightsS[i];
+					_generateAccessBufferOffsetMapFrequencyExchange(offsetsS[i], exactT, offsetsU[j], k * j + i, ab);
+				}
+			}
+		}
+		else if (channel == FrequencyChannel::U)
+		{
+			int exactU = FrgCommon::frequency().offset(u);
+			int offsetsS[k], offsetsT[k];
+			float weightsS[k], weightsT[k];
+			FrgCommon::frequency().interpolateStencil<k>(s, offsetsS, weightsS);
+			FrgCommon::frequency().interpolateStencil<k>(t, offsetsT, weightsT);
+
+			for (int j = 0; j < k; ++j)
+			{
+				for (int i = 0; i < k; ++i)
+				{
+					ab.frequencyWeights[k * j + i] = weightsT[j] * weightsS[i];
+					_generateAccessBufferOffsetMapFrequencyExchange(offsetsS[i], offsetsT[j], exactU, k * j + i, ab);
+				}
+			}
+		}
+
+		return ab;
+	}
+
+	/**
+	 * @brief Generate an access buffer for an arbitrary set of frequencies.
+	 *
+	 * @tparam n Number of support values. Either 8 for linear or 64 for cubic interpolation.
+	 * @param s First frequency argument.
+	 * @param t Second frequency argument.
+	 * @param u Third frequency argument.
+	 * @return U1VertexTwoParticleAccessBuffer<n> Access buffer.
+	 */
+	template <int n = 8> U1VertexTwoParticleAccessBuffer<n> generateAccessBuffer(float s, float t, float u) const
+	{
+		static_assert(n == 8 || n == 64, "Access buffer must hold either 8 or 64 support values");
+		constexpr int k = (n == 64) ? 4 : 2;
+
+		U1VertexTwoParticleAccessBuffer<n> ab;
+
+		//map to positive frequency sector
+		if (s < 0)
+		{
+			s = -s;
+			ab.pairExchange = !ab.pairExchange;
+		}
+		if (t < 0)
+		{
+			t = -t;
+			for (int i = 0; i < n; ++i)
+			{
+				for (int c = 0; c < 6; ++c) ab.sign[i][c] *= _zetaProduct(c);
+			}
+		}
+		if (u < 0)
+		{
+			u = -u;
+			ab.pairExchange = !ab.pairExchange;
+			for (int i = 0; i < n; ++i)
+			{
+				for (int c = 0; c < 6; ++c) ab.sign[i][c] *= _zetaProduct(c);
+			}
+		}
+
+		int offsetsS[k], offsetsT[k], offsetsU[k];
+		float weightsS[k], weightsT[k], weightsU[k];
+
+		FrgCommon::frequency().interpolateStencil<k>(s, offsetsS, weightsS);
+		FrgCommon::frequency().interpolateStencil<k>(t, offsetsT, weightsT);
+		FrgCommon::frequency().interpolateStencil<k>(u, offsetsU, weightsU);
+
+		for (int l = 0; l < k; ++l)
+		{
+			for (int j = 0; j < k; ++j)
+			{
+				for (int i = 0; i < k; ++i)
+				{
+					ab.frequencyWeights[k * k * l + k * j + i] = weightsT[j] * weightsS[i] * weightsU[l];
+					_generateAccessBufferOffsetMapFrequencyExchange(offsetsS[i], offsetsT[j], offsetsU[l], k * k * l + k * j + i, ab);
+				}
+			}
+		}
+
+		return ab;
+	}
+
+	/**
+	 * @brief Directly access a vertex via given stored component, frequency, and site offsets, where sOffset may be lesser than uOffset.
+	 *
+	 * @param siteOffset Lattice site offset (number of elements).
+	 * @param sOffset First frequency offset (number of elements).
+	 * @param tOffset Second frequency offset (number of elements).
+	 * @param uOffset Third frequency offset (number of elements).
+	 * @param component Stored vertex component.
+	 * @return float Vertex value.
+	 */
+	float _directAccessMapFrequencyExchange(const int siteOffset, const int sOffset, const int tOffset, const int uOffset, const int component) const
+	{
+		ASSERT(siteOffset >= 0 && siteOffset < FrgCommon::lattice().size);
+		ASSERT(sOffset >= 0 && sOffset < FrgCommon::frequency().size);
+		ASSERT(tOffset >= 0 && tOffset < FrgCommon::frequency().size);
+		ASSERT(uOffset >= 0 && uOffset < FrgCommon::frequency().size);
+
+		if (sOffset < uOffset) return _frequencyExchangeSign(component) * _directAccess(siteOffset, uOffset, tOffset, sOffset, component);
+		else return _directAccess(siteOffset, sOffset, tOffset, uOffset, component);
+	}
+
+	/**
+	 * @brief Directly access a vertex via given stored component, frequency, and site offsets, where sOffset >= uOffset.
+	 *
+	 * @param siteOffset Lattice site offset (number of elements).
+	 * @param sOffset First frequency offset (number of elements).
+	 * @param tOffset Second frequency offset (number of elements).
+	 * @param uOffset Third frequency offset (number of elements).
+	 * @param component Stored vertex component.
+	 * @return float Vertex value.
+	 */
+	float _directAccess(const int siteOffset, const int sOffset, const int tOffset, const int uOffset, const int component) const
+	{
+		ASSERT(siteOffset >= 0 && siteOffset < FrgCommon::lattice().size);
+		ASSERT(sOffset >= 0 && sOffset < FrgCommon::frequency().size);
+		ASSERT(tOffset >= 0 && tOffset < FrgCommon::frequency().size);
+		ASSERT(uOffset >= 0 && uOffset < FrgCommon::frequency().size);
+		ASSERT(sOffset >= uOffset);
+		ASSERT(component >= 0 && component < 6);
+
+		int suOffset = sOffset * (sOffset + 1) / 2 + uOffset;
+		return _data[suOffset * _memoryStep[0] + tOffset * _memoryStep[1] + component * _memoryStep[2] + siteOffset];
+	}
+
+	/**
+	 * @brief Calculate the total memory offset from given frequency offsets, where sOffset may be lesser than uOffset.
+	 * Write the result to the specified entry in an access buffer.
+	 *
+	 * @tparam n Number of support sites in the access buffer.
+	 * @param[in] sOffset First frequency offset (number of elements).
+	 * @param[in] tOffset Second frequency offset (number of elements).
+	 * @param[in] uOffset Third frequency offset (number of elements).
+	 * @param[in] abIndex Index of the access buffer entry to write.
+	 * @param ab Access buffer.
+	 */
+	template <int n> void _generateAccessBufferOffsetMapFrequencyExchange(const int sOffset, const int tOffset, const int uOffset, const int abIndex, U1VertexTwoParticleAccessBuffer<n> &ab) const
+	{
+		ASSERT(sOffset >= 0 && sOffset < FrgCommon::frequency().size);
+		ASSERT(tOffset >= 0 && tOffset < FrgCommon::frequency().size);
+		ASSERT(uOffset >= 0 && uOffset < FrgCommon::frequency().size);
+		ASSERT(abIndex >= 0 && abIndex < n);
+
+		if (sOffset < uOffset)
+		{
+			for (int c = 0; c < 6; ++c)
+			{
+				float sign = 1.0f;
+				ab.sign[abIndex][c] *= (ab.pairExchange) ? _frequencyExchangeSign(swapComponent(c, sign)) : _frequencyExchangeSign(c);
+			}
+			ab.frequencyOffsets[abIndex] = (uOffset * (uOffset + 1) / 2 + sOffset) * _memoryStep[0] + tOffset * _memoryStep[1];
+		}
+		else
+		{
+			ab.frequencyOffsets[abIndex] = (sOffset * (sOffset + 1) / 2 + uOffset) * _memoryStep[0] + tOffset * _memoryStep[1];
+		}
+	}
+
+	/**
+	 * @brief Helper function for vertex symmetries. Returns -1 if the argument is spin-like and +1 if it is density-like.
+	 *
+	 * @param s1 Spin argument.
+	 * @return float Function value.
+	 */
+	float _zeta(const int s1) const
+	{
+		return (s1 <= 2) ? -1.0f : 1.0f;
+	}
+
+	/**
+	 * @brief Helper function for vertex symmetries. Returns the product of _zeta() over both spin arguments of a stored component.
+	 *
+	 * @param component Stored vertex component.
+	 * @return float Function value.
+	 */
+	float _zetaProduct(const int component) const
+	{
+		return (component == 3 || component == 4) ? -1.0f : 1.0f;
+	}
+
+	/**
+	 * @brief Helper function for vertex symmetries. Returns the sign factor -_zeta(s2) acquired by a stored component (s1,s2) under exchange of the frequency arguments s and u.
+	 *
+	 * @param component Stored vertex component.
+	 * @return float Function value.
+	 */
+	float _frequencyExchangeSign(const int component) const
+	{
+		return (component == 3 || component == 5) ? -1.0f : 1.0f;
+	}
+
+	//vertex internal data
+	int size; ///< Size of the vertex (number of elements).
+	int sizeFrequency; ///< Size of the vertex in the frequency subspace (number of elements).
+
+	float *_data; ///< Vertex data.
+	int _memoryStep[3]; ///< Memory stride width.
+	int *_siteComponents; ///< Stored component to access for every representative site and requested component, without and with pair exchange.
+	float *_siteSigns; ///< Sign factor for every representative site and requested component, without and with pair exchange.
+};
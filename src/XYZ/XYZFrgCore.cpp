@@ -1,7 +1,7 @@
 /**
  * @file XYZFrgCore.cpp
  * @author Finn Lasse Buessen
- * @brief FrgCore implementation for models with diagonal interactions.
+ * @brief FrgCore implementation for models with diagonal interactions. 
  * 
  * @copyright Copyright (c) 2020
  */
@@ -61,7 +61,12 @@ XYZFrgCore::XYZFrgCore(const SpinModel &spinModel, const std::vector<Measurement
 	dataStacks[6] = SpinParser::spinParser()->getLoadManager()->addMasterStackImplicit<float>(
 		&_flow->cutoff,
 		1,
-		[&](int) { _flow->cutoff = static_cast<XYZEffectiveAction *>(_flowingFunctional)->cutoff; });
+		[&](int) { _flow->cutoff = static_cast<XYZEffectiveAction *>(_flowingFunctional)->cutoff; },
+		1,
+		1,
+		10,
+		false,
+		true);
 	//stack7
 	dataStacks[7] = SpinParser::spinParser()->getLoadManager()->addMasterStackImplicit<float>(
 		static_cast<XYZEffectiveAction *>(_flow)->vertexSingleParticle->_data,
@@ -69,12 +74,14 @@ XYZFrgCore::XYZFrgCore(const SpinModel &spinModel, const std::vector<Measurement
 		[&](int x) { _calculateVertexSingleParticle(x); },
 		1,
 		1,
-		1);
+		1,
+		false,
+		true);
 	//stack8
 	dataStacks[8] = SpinParser::spinParser()->getLoadManager()->addMasterStackImplicit<float>(
 		static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataDD,
 		static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->sizeFrequency,
-		[&](int x) { _calculateVertexTwoParticle(x); },
+		[&](int x) { if (_multirate.isDue(x)) SpinParser::spinParser()->getFlowProfiler()->profile(x, [&]() { if (FrgCommon::frequency().interpolation == FrequencyDiscretization::Interpolation::Cubic) _calculateVertexTwoParticle<16>(x); else _calculateVertexTwoParticle<4>(x); }); },
 		FrgCommon::lattice().size,
 		FrgCommon::frequency().size);
 	//stack9
@@ -95,6 +102,35 @@ XYZFrgCore::XYZFrgCore(const SpinModel &spinModel, const std::vector<Measurement
 		static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->sizeFrequency,
 		dataStacks[8],
 		FrgCommon::lattice().size);
+
+	//blocks of the multi-rate evaluation are formed by the frequency iterators of the two-particle vertex flow
+	_multirate.setBlocks(static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->sizeFrequency, FrgCommon::lattice().size, { static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataDD, static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataXX, static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataYY, static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataZZ });
+
+	//overlaps which involve spin transformations other than plain permutations are evaluated with explicit weights
+	_overlapWeights1.resize(FrgCommon::lattice().size);
+	_overlapWeights2.resize(FrgCommon::lattice().size);
+	for (int rid = 0; rid < FrgCommon::lattice().size; ++rid)
+	{
+		const LatticeOverlap &overlap = FrgCommon::lattice().getOverlap(rid);
+		bool isPermutation = true;
+		for (int i = 0; i < overlap.size; ++i) if (overlap.spinRotation1[i] >= 0 || overlap.spinRotation2[i] >= 0) isPermutation = false;
+		if (isPermutation) continue;
+
+		for (int i = 0; i < overlap.size; ++i)
+		{
+			const SpinComponent permutation1[3] = { overlap.transformedX1[i], overlap.transformedY1[i], overlap.transformedZ1[i] };
+			const SpinComponent permutation2[3] = { overlap.transformedX2[i], overlap.transformedY2[i], overlap.transformedZ2[i] };
+			float transformation1[9];
+			float transformation2[9];
+			FrgCommon::lattice().getSpinTransformation(permutation1, overlap.spinRotation1[i], transformation1);
+			FrgCommon::lattice().getSpinTransformation(permutation2, overlap.spinRotation2[i], transformation2);
+			for (int k = 0; k < 9; ++k)
+			{
+				_overlapWeights1[rid].push_back(transformation1[k] * transformation1[k]);
+				_overlapWeights2[rid].push_back(transformation2[k] * transformation2[k]);
+			}
+		}
+	}
 }
 
 XYZFrgCore::~XYZFrgCore()
@@ -122,7 +158,9 @@ void XYZFrgCore::computeStep()
 		}
 	}
 	managedMeasurementStacks.push_back(dataStacks[8]);
+	_multirate.beginStep(_flowingFunctional->cutoff, SpinParser::spinParser()->isMasterRank());
 	SpinParser::spinParser()->getLoadManager()->calculate(managedMeasurementStacks.data(), int(managedMeasurementStacks.size()));
+	_multirate.endStep(SpinParser::spinParser()->isMasterRank());
 }
 
 void XYZFrgCore::finalizeStep(float newCutoff)
@@ -140,27 +178,20 @@ void XYZFrgCore::finalizeStep(float newCutoff)
 	for (int i = 0; i < static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexSingleParticle->size; ++i) static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexSingleParticle->_data[i] += cutoffStep * static_cast<XYZEffectiveAction *>(_flow)->vertexSingleParticle->_data[i];
 
 	//add flow to two particle vertex
-	#ifndef DISABLE_OMP
-	#pragma omp parallel for schedule(static)
-	#endif
-	for (int i = 0; i < static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->size; ++i) static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->_dataDD[i] += cutoffStep * static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataDD[i];
-	#ifndef DISABLE_OMP
-	#pragma omp parallel for schedule(static)
-	#endif
-	for (int i = 0; i < static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->size; ++i) static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->_dataXX[i] += cutoffStep * static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataXX[i];
-	#ifndef DISABLE_OMP
-	#pragma omp parallel for schedule(static)
-	#endif
-	for (int i = 0; i < static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->size; ++i) static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->_dataYY[i] += cutoffStep * static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataYY[i];
-	#ifndef DISABLE_OMP
-	#pragma omp parallel for schedule(static)
-	#endif
-	for (int i = 0; i < static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->size; ++i) static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->_dataZZ[i] += cutoffStep * static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataZZ[i];
+	integrateStep(static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->_dataDD, static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataDD, static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->size, cutoffStep, FrgCommon::cutoff().integrator);
+	integrateStep(static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->_dataXX, static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataXX, static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->size, cutoffStep, FrgCommon::cutoff().integrator);
+	integrateStep(static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->_dataYY, static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataYY, static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->size, cutoffStep, FrgCommon::cutoff().integrator);
+	integrateStep(static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->_dataZZ, static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataZZ, static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexTwoParticle->size, cutoffStep, FrgCommon::cutoff().integrator);
 
 	//broadcast updated effective action
 	SpinParser::spinParser()->getLoadManager()->broadcast({ dataStacks[0], dataStacks[1], dataStacks[2], dataStacks[3], dataStacks[4], dataStacks[5] });
 }
 
+void XYZFrgCore::tuneKernels(KernelTuner &tuner)
+{
+	_tuneKernels(tuner, "XYZ", [&](int x) { if (FrgCommon::frequency().interpolation == FrequencyDiscretization::Interpolation::Cubic) _calculateVertexTwoParticle<16>(x); else _calculateVertexTwoParticle<4>(x); }, true);
+}
+
 void XYZFrgCore::_calculateVertexSingleParticle(const int iterator)
 {
 	float cutoff = _flowingFunctional->cutoff;
@@ -173,7 +204,7 @@ void XYZFrgCore::_calculateVertexSingleParticle(const int iterator)
 
 	//term1
 	float sum = 0;
-	for (auto j = FrgCommon::lattice().getRange(0); j != FrgCommon::lattice().end(); ++j)
+	for (int j : FrgCommon::lattice().getRangeIds(0))
 	{
 		sum += v4->getValue(FrgCommon::lattice().zero(), j, w + cutoff, 0.0f, w - cutoff, SpinComponent::None, XYZVertexTwoParticle::FrequencyChannel::None);
 		sum -= v4->getValue(FrgCommon::lattice().zero(), j, w - cutoff, 0.0f, w + cutoff, SpinComponent::None, XYZVertexTwoParticle::FrequencyChannel::None);
@@ -192,7 +223,7 @@ void XYZFrgCore::_calculateVertexSingleParticle(const int iterator)
 	static_cast<XYZEffectiveAction *>(_flow)->vertexSingleParticle->_data[iterator] = v2CurrentValue;
 }
 
-void XYZFrgCore::_calculateVertexTwoParticle(const int iterator)
+template <int n> void XYZFrgCore::_calculateVertexTwoParticle(const int iterator)
 {
 	float cutoff = _flowingFunctional->cutoff;
 	XYZVertexSingleParticle *v2 = static_cast<XYZEffectiveAction *>(_flowingFunctional)->vertexSingleParticle;
@@ -223,11 +254,11 @@ void XYZFrgCore::_calculateVertexTwoParticle(const int iterator)
 	auto integralKernelS = [&](const float wp, ValueSuperbundle<float, 4> &returnBuffer) -> void
 	{
 		//pp-ladder A and B (positive sign)
-		const XYZVertexTwoParticleAccessBuffer<4> ab0 = v4->generateAccessBuffer(s, -w1 - wp, -w2 - wp, XYZVertexTwoParticle::FrequencyChannel::S);
-		const XYZVertexTwoParticleAccessBuffer<4> ab1 = v4->generateAccessBuffer(s, w1p + wp, -w2p - wp, XYZVertexTwoParticle::FrequencyChannel::S);
+		const XYZVertexTwoParticleAccessBuffer<n> ab0 = v4->generateAccessBuffer<n>(s, -w1 - wp, -w2 - wp, XYZVertexTwoParticle::FrequencyChannel::S);
+		const XYZVertexTwoParticleAccessBuffer<n> ab1 = v4->generateAccessBuffer<n>(s, w1p + wp, -w2p - wp, XYZVertexTwoParticle::FrequencyChannel::S);
 		//pp-ladder A and B (positive sign)
-		const XYZVertexTwoParticleAccessBuffer<4> ab2 = v4->generateAccessBuffer(s, w2 + wp, w1 + wp, XYZVertexTwoParticle::FrequencyChannel::S);
-		const XYZVertexTwoParticleAccessBuffer<4> ab3 = v4->generateAccessBuffer(s, -w2p - wp, w1p + wp, XYZVertexTwoParticle::FrequencyChannel::S);
+		const XYZVertexTwoParticleAccessBuffer<n> ab2 = v4->generateAccessBuffer<n>(s, w2 + wp, w1 + wp, XYZVertexTwoParticle::FrequencyChannel::S);
+		const XYZVertexTwoParticleAccessBuffer<n> ab3 = v4->generateAccessBuffer<n>(s, -w2p - wp, w1p + wp, XYZVertexTwoParticle::FrequencyChannel::S);
 
 		v4->getValueSuperbundle(ab0, stackBuffers[0]);
 		v4->getValueSuperbundle(ab1, stackBuffers[1]);
@@ -278,13 +309,13 @@ void XYZFrgCore::_calculateVertexTwoParticle(const int iterator)
 	{
 		//RPA diagram A and B equal chalice diagram A and inverse chalice diagram B, respectively (negative sign)
 		//chalice diagram A (negative sign)
-		const XYZVertexTwoParticleAccessBuffer<4> ab0 = v4->generateAccessBuffer(w1 - wp, t, w1p + wp, XYZVertexTwoParticle::FrequencyChannel::T);
+		const XYZVertexTwoParticleAccessBuffer<n> ab0 = v4->generateAccessBuffer<n>(w1 - wp, t, w1p + wp, XYZVertexTwoParticle::FrequencyChannel::T);
 		//inverse chalice diagram B (negative sign)
-		const XYZVertexTwoParticleAccessBuffer<4> ab1 = v4->generateAccessBuffer(w2p - wp, t, -w2 - wp, XYZVertexTwoParticle::FrequencyChannel::T);
+		const XYZVertexTwoParticleAccessBuffer<n> ab1 = v4->generateAccessBuffer<n>(w2p - wp, t, -w2 - wp, XYZVertexTwoParticle::FrequencyChannel::T);
 		//chalice diagram A (negative sign)
-		const XYZVertexTwoParticleAccessBuffer<4> ab2 = v4->generateAccessBuffer(w1p + wp, t, w1 - wp, XYZVertexTwoParticle::FrequencyChannel::T);
+		const XYZVertexTwoParticleAccessBuffer<n> ab2 = v4->generateAccessBuffer<n>(w1p + wp, t, w1 - wp, XYZVertexTwoParticle::FrequencyChannel::T);
 		//inverse chalice diagram B (negative sign)
-		const XYZVertexTwoParticleAccessBuffer<4> ab3 = v4->generateAccessBuffer(w2 + wp, t, wp - w2p, XYZVertexTwoParticle::FrequencyChannel::T);
+		const XYZVertexTwoParticleAccessBuffer<n> ab3 = v4->generateAccessBuffer<n>(w2 + wp, t, wp - w2p, XYZVertexTwoParticle::FrequencyChannel::T);
 
 		v4->getValueSuperbundle(ab0, stackBuffers[0]);
 		v4->getValueSuperbundle(ab1, stackBuffers[1]);
@@ -296,9 +327,48 @@ void XYZFrgCore::_calculateVertexTwoParticle(const int iterator)
 		bufferRPA.reset();
 		for (int rid = 0; rid < FrgCommon::lattice().size; ++rid)
 		{
-			//lattice bubble
+			//lattice bubble; inactive sites remain at their bare vertex
+			if (!isSiteActive(rid)) continue;
 			const LatticeOverlap &overlap = FrgCommon::lattice().getOverlap(rid);
 
+			//overlaps which involve spin transformations other than plain permutations are evaluated as v^{aa}=M[a][c]*M[a][c]*v^{cc}
+			if (_overlapWeights1[rid].size() > 0)
+			{
+				const float *weights1 = _overlapWeights1[rid].data();
+				const float *weights2 = _overlapWeights2[rid].data();
+				float value[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+				for (int i = 0; i < overlap.size; ++i)
+				{
+					float v1[3], v2[3];
+					for (int c = 0; c < 3; ++c)
+					{
+						v1[c] = stackBuffers[0].bundle(c)[overlap.rid1[i]];
+						v2[c] = stackBuffers[1].bundle(c)[overlap.rid2[i]];
+					}
+					for (int a = 0; a < 3; ++a) value[a] += (weights1[9 * i + 3 * a] * v1[0] + weights1[9 * i + 3 * a + 1] * v1[1] + weights1[9 * i + 3 * a + 2] * v1[2]) * (weights2[9 * i + 3 * a] * v2[0] + weights2[9 * i + 3 * a + 1] * v2[1] + weights2[9 * i + 3 * a + 2] * v2[2]);
+					value[3] += stackBuffers[0].bundle(3)[overlap.rid1[i]] * stackBuffers[1].bundle(3)[overlap.rid2[i]];
+				}
+				for (int a = 0; a < 4; ++a) bufferRPA.bundle(a)[rid] = value[a];
+				continue;
+			}
+
+			if (KernelTuner::overlapTraversal == KernelTuner::OverlapTraversal::Fused)
+			{
+				float valueX = 0.0f, valueY = 0.0f, valueZ = 0.0f, valueD = 0.0f;
+				for (int i = 0; i < overlap.size; ++i)
+				{
+					valueX += stackBuffers[0].bundle(static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
+					valueY += stackBuffers[0].bundle(static_cast<int>(overlap.transformedY1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(static_cast<int>(overlap.transformedY2[i]))[overlap.rid2[i]];
+					valueZ += stackBuffers[0].bundle(static_cast<int>(overlap.transformedZ1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(static_cast<int>(overlap.transformedZ2[i]))[overlap.rid2[i]];
+					valueD += stackBuffers[0].bundle(3)[overlap.rid1[i]] * stackBuffers[1].bundle(3)[overlap.rid2[i]];
+				}
+				bufferRPA.bundle(static_cast<int>(SpinComponent::X))[rid] = valueX;
+				bufferRPA.bundle(static_cast<int>(SpinComponent::Y))[rid] = valueY;
+				bufferRPA.bundle(static_cast<int>(SpinComponent::Z))[rid] = valueZ;
+				bufferRPA.bundle(static_cast<int>(SpinComponent::None))[rid] = valueD;
+				continue;
+			}
+
 			for (int i = 0; i < overlap.size; ++i)
 			{
 				bufferRPA.bundle(static_cast<int>(SpinComponent::X))[rid] += stackBuffers[0].bundle(static_cast<int>(overlap.transformedX1[i]))[overlap.rid1[i]] * stackBuffers[1].bundle(static_cast<int>(overlap.transformedX2[i]))[overlap.rid2[i]];
@@ -322,13 +392,13 @@ void XYZFrgCore::_calculateVertexTwoParticle(const int iterator)
 		returnBuffer.multAdd(4.0f, bufferRPA);
 
 		//chalice diagram B (negative sign)
-		const XYZVertexTwoParticleAccessBuffer<4> ab4 = v4->generateAccessBuffer(w2p - wp, -w2 - wp, t, XYZVertexTwoParticle::FrequencyChannel::U);
+		const XYZVertexTwoParticleAccessBuffer<n> ab4 = v4->generateAccessBuffer<n>(w2p - wp, -w2 - wp, t, XYZVertexTwoParticle::FrequencyChannel::U);
 		//inverse chalice diagram A (negative sign)
-		const XYZVertexTwoParticleAccessBuffer<4> ab5 = v4->generateAccessBuffer(w1 - wp, -w1p - wp, -t, XYZVertexTwoParticle::FrequencyChannel::U);
+		const XYZVertexTwoParticleAccessBuffer<n> ab5 = v4->generateAccessBuffer<n>(w1 - wp, -w1p - wp, -t, XYZVertexTwoParticle::FrequencyChannel::U);
 		//chalice diagram B (negative sign)
-		const XYZVertexTwoParticleAccessBuffer<4> ab6 = v4->generateAccessBuffer(w2 + wp, wp - w2p, t, XYZVertexTwoParticle::FrequencyChannel::U);
+		const XYZVertexTwoParticleAccessBuffer<n> ab6 = v4->generateAccessBuffer<n>(w2 + wp, wp - w2p, t, XYZVertexTwoParticle::FrequencyChannel::U);
 		//inverse chalice diagram A (negative sign)
-		const XYZVertexTwoParticleAccessBuffer<4> ab7 = v4->generateAccessBuffer(w1p + wp, wp - w1, -t, XYZVertexTwoParticle::FrequencyChannel::U);
+		const XYZVertexTwoParticleAccessBuffer<n> ab7 = v4->generateAccessBuffer<n>(w1p + wp, wp - w1, -t, XYZVertexTwoParticle::FrequencyChannel::U);
 
 		const float valCbx = v4->getValueLocal(SpinComponent::X, ab4);
 		const float valCby = v4->getValueLocal(SpinComponent::Y, ab4);
@@ -420,11 +490,11 @@ void XYZFrgCore::_calculateVertexTwoParticle(const int iterator)
 	{
 		//u-Channel, to be combined with P(wp, u + wp) + P(u + wp, wp)
 		//ph-ladder A and B, respectively (negative sign)
-		const XYZVertexTwoParticleAccessBuffer<4> ab0 = v4->generateAccessBuffer(w1 + wp, wp - w2p, u, XYZVertexTwoParticle::FrequencyChannel::U);
-		const XYZVertexTwoParticleAccessBuffer<4> ab1 = v4->generateAccessBuffer(w1p + wp, w2 - wp, u, XYZVertexTwoParticle::FrequencyChannel::U);
+		const XYZVertexTwoParticleAccessBuffer<n> ab0 = v4->generateAccessBuffer<n>(w1 + wp, wp - w2p, u, XYZVertexTwoParticle::FrequencyChannel::U);
+		const XYZVertexTwoParticleAccessBuffer<n> ab1 = v4->generateAccessBuffer<n>(w1p + wp, w2 - wp, u, XYZVertexTwoParticle::FrequencyChannel::U);
 		//ph-ladder A and B, respectively (negative sign)
-		const XYZVertexTwoParticleAccessBuffer<4> ab2 = v4->generateAccessBuffer(w2p - wp, -w1 - wp, u, XYZVertexTwoParticle::FrequencyChannel::U);
-		const XYZVertexTwoParticleAccessBuffer<4> ab3 = v4->generateAccessBuffer(w2 - wp, w1p + wp, u, XYZVertexTwoParticle::FrequencyChannel::U);
+		const XYZVertexTwoParticleAccessBuffer<n> ab2 = v4->generateAccessBuffer<n>(w2p - wp, -w1 - wp, u, XYZVertexTwoParticle::FrequencyChannel::U);
+		const XYZVertexTwoParticleAccessBuffer<n> ab3 = v4->generateAccessBuffer<n>(w2 - wp, w1p + wp, u, XYZVertexTwoParticle::FrequencyChannel::U);
 
 		v4->getValueSuperbundle(ab0, stackBuffers[0]);
 		v4->getValueSuperbundle(ab1, stackBuffers[1]);
@@ -564,8 +634,8 @@ void XYZFrgCore::_calculateVertexTwoParticle(const int iterator)
 	//prefactor
 	v4CurrentValue /= (2.0f * (float)M_PI);
 
-	for (int rid = 0; rid < FrgCommon::lattice().size; ++rid) static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataXX[iterator * FrgCommon::lattice().size + rid] = v4CurrentValue.bundle(static_cast<int>(SpinComponent::X))[rid];
-	for (int rid = 0; rid < FrgCommon::lattice().size; ++rid) static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataYY[iterator * FrgCommon::lattice().size + rid] = v4CurrentValue.bundle(static_cast<int>(SpinComponent::Y))[rid];
-	for (int rid = 0; rid < FrgCommon::lattice().size; ++rid) static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataZZ[iterator * FrgCommon::lattice().size + rid] = v4CurrentValue.bundle(static_cast<int>(SpinComponent::Z))[rid];
-	for (int rid = 0; rid < FrgCommon::lattice().size; ++rid) static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataDD[iterator * FrgCommon::lattice().size + rid] = v4CurrentValue.bundle(static_cast<int>(SpinComponent::None))[rid];
+	for (int rid = 0; rid < FrgCommon::lattice().size; ++rid) static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataXX[iterator * FrgCommon::lattice().size + rid] = (isSiteActive(rid)) ? v4CurrentValue.bundle(static_cast<int>(SpinComponent::X))[rid] : 0.0f;
+	for (int rid = 0; rid < FrgCommon::lattice().size; ++rid) static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataYY[iterator * FrgCommon::lattice().size + rid] = (isSiteActive(rid)) ? v4CurrentValue.bundle(static_cast<int>(SpinComponent::Y))[rid] : 0.0f;
+	for (int rid = 0; rid < FrgCommon::lattice().size; ++rid) static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataZZ[iterator * FrgCommon::lattice().size + rid] = (isSiteActive(rid)) ? v4CurrentValue.bundle(static_cast<int>(SpinComponent::Z))[rid] : 0.0f;
+	for (int rid = 0; rid < FrgCommon::lattice().size; ++rid) static_cast<XYZEffectiveAction *>(_flow)->vertexTwoParticle->_dataDD[iterator * FrgCommon::lattice().size + rid] = (isSiteActive(rid)) ? v4CurrentValue.bundle(static_cast<int>(SpinComponent::None))[rid] : 0.0f;
 }
\ No newline at end of file
@@ -1,16 +1,17 @@
 /**
  * @file XYZFrgCore.hpp
  * @author Finn Lasse Buessen
- * @brief FrgCore implementation for models with diagonal interactions.
+ * @brief FrgCore implementation for models with diagonal interactions. 
  * 
  * @copyright Copyright (c) 2020
  */
 
 #pragma once
+#include <vector>
 #include "FrgCore.hpp"
 
 /**
- * @brief FrgCore implementation for models with diagonal interactions.
+ * @brief FrgCore implementation for models with diagonal interactions. 
  */
 class XYZFrgCore : public FrgCore
 {
@@ -41,22 +42,32 @@ public:
 	 */
 	void finalizeStep(const float newCutoff) override;
 
+	/**
+	 * @brief Select the fastest variants of the kernels which compute the flow of the two-particle vertex. 
+	 * 
+	 * @param tuner Kernel tuner. 
+	 */
+	void tuneKernels(KernelTuner &tuner) override;
+
 	float normalization; ///< Energy normalization factor. 
 
 private:
 	int dataStacks[12]; ///< References to the LoadManager::DataStack. 
+	std::vector<std::vector<float>> _overlapWeights1; ///< Squared spin transformation of the first vertex for every overlap term, indexed as [rid][9 * i + 3 * a + c]. Empty if all terms of the overlap are plain spin permutations. 
+	std::vector<std::vector<float>> _overlapWeights2; ///< Squared spin transformation of the second vertex for every overlap term, indexed as [rid][9 * i + 3 * a + c]. Empty if all terms of the overlap are plain spin permutations. 
 
 	/**
-	 * @brief Calculate the single-particle vertex flow for a specific linear iterator, which is expanded via XYZVertexSingleParticle::expandIterator().
+	 * @brief Calculate the single-particle vertex flow for a specific linear iterator, which is expanded via XYZVertexSingleParticle::expandIterator(). 
 	 * 
 	 * @param iterator Linear iterator. 
 	 */
 	void _calculateVertexSingleParticle(const int iterator);
 
 	/**
-	 * @brief Calculate the two-particle vertex flow for a specific linear iterator, which is expanded via XYZVertexTwoParticle::expandIterator().
+	 * @brief Calculate the two-particle vertex flow for a specific linear iterator, which is expanded via XYZVertexTwoParticle::expandIterator(). 
 	 * 
+	 * @tparam n Number of support values in the frequency interpolation of vertices. Either 4 for linear or 16 for cubic interpolation. 
 	 * @param iterator Linear iterator. 
 	 */
-	void _calculateVertexTwoParticle(const int iterator);
+	template <int n> void _calculateVertexTwoParticle(const int iterator);
 };
\ No newline at end of file
@@ -19,8 +19,7 @@
 XYZMeasurementCorrelation::XYZMeasurementCorrelation(const std::string &outfile, const float minCutoff, const float maxCutoff, const bool defer) : Measurement(outfile, minCutoff, maxCutoff, defer, true)
 {
 	_currentCutoff = -1.0f;
-	int latticeSizeExtended = 0;
-	for (auto i = FrgCommon::lattice().getRange(0); i != FrgCommon::lattice().end(); ++i) ++latticeSizeExtended;
+	int latticeSizeExtended = FrgCommon::lattice().getRangeIds(0).size();
 	int latticeSizeBasis = int(FrgCommon::lattice()._basis.size());
 	_memoryStepLattice = latticeSizeBasis * latticeSizeExtended;
 
@@ -88,13 +87,71 @@ void XYZMeasurementCorrelation::takeMeasurement(const EffectiveAction &state, co
 
 	if (isMasterTask)
 	{
-		_writeOutfileCorrelation("XYZCorXX", _correlationsXX);
-		_writeOutfileCorrelation("XYZCorYY", _correlationsYY);
-		_writeOutfileCorrelation("XYZCorZZ", _correlationsZZ);
-		_writeOutfileCorrelation("XYZCorDD", _correlationsDD);
+		if (FrgCommon::lattice().hasSublatticeRotation())
+		{
+			//undo the sublattice spin rotation and write correlations in the frame of the original spin model
+			const float *correlations[3] = { _correlationsXX, _correlationsYY, _correlationsZZ };
+			const std::string componentNames[3] = { "X", "Y", "Z" };
+			float *buffer = new float[_memoryStepLattice];
+			for (int a = 0; a < 3; ++a)
+			{
+				for (int b = 0; b < 3; ++b)
+				{
+					int offset = 0;
+					LatticeIdRange basis = FrgCommon::lattice().getBasisIds();
+					for (int nb = 0; nb < basis.size(); ++nb)
+					{
+						int i = basis[nb];
+						for (int j : FrgCommon::lattice().getRangeIds(nb))
+						{
+							SpinComponent component1 = static_cast<SpinComponent>(a);
+							SpinComponent component2 = static_cast<SpinComponent>(b);
+							float sign = FrgCommon::lattice().sublatticeRotation(i, component1) * FrgCommon::lattice().sublatticeRotation(j, component2);
+							buffer[offset] = (component1 == component2) ? sign * correlations[static_cast<int>(component1)][offset] : 0.0f;
+							++offset;
+						}
+					}
+					_writeOutfileCorrelation("TRICor" + componentNames[a] + componentNames[b], buffer);
+				}
+			}
+			_writeOutfileCorrelation("TRICorDD", _correlationsDD);
+			delete[] buffer;
+		}
+		else
+		{
+			_writeOutfileCorrelation("XYZCorXX", _correlationsXX);
+			_writeOutfileCorrelation("XYZCorYY", _correlationsYY);
+			_writeOutfileCorrelation("XYZCorZZ", _correlationsZZ);
+			_writeOutfileCorrelation("XYZCorDD", _correlationsDD);
+		}
 	}
 }
 
+std::vector<float> XYZMeasurementCorrelation::observables() const
+{
+	std::vector<float> correlations;
+	correlations.insert(correlations.end(), _correlationsXX, _correlationsXX + _memoryStepLattice);
+	correlations.insert(correlations.end(), _correlationsYY, _correlationsYY + _memoryStepLattice);
+	correlations.insert(correlations.end(), _correlationsZZ, _correlationsZZ + _memoryStepLattice);
+	correlations.insert(correlations.end(), _correlationsDD, _correlationsDD + _memoryStepLattice);
+	return correlations;
+}
+
+std::vector<Measurement::Observable> XYZMeasurementCorrelation::observableBuffers() const
+{
+	return {
+		{ "XYZCorXX", _correlationsXX, _memoryStepLattice },
+		{ "XYZCorYY", _correlationsYY, _memoryStepLattice },
+		{ "XYZCorZZ", _correlationsZZ, _memoryStepLattice },
+		{ "XYZCorDD", _correlationsDD, _memoryStepLattice }
+	};
+}
+
+bool XYZMeasurementCorrelation::isCalculated(const EffectiveAction &state) const
+{
+	return _currentCutoff == state.cutoff;
+}
+
 void XYZMeasurementCorrelation::_calculateCorrelation(const int iterator) const
 {
 	//calculate real space susceptibility
@@ -183,28 +240,23 @@ void XYZMeasurementCorrelation::_calculateCorrelation(const int iterator) const
 	}
 
 	int offset = iterator * _memoryStepLattice;
-	for (auto i = FrgCommon::lattice().getBasis(); i != FrgCommon::lattice().end(); ++i)
+	LatticeIdRange basis = FrgCommon::lattice().getBasisIds();
+	for (int nb = 0; nb < basis.size(); ++nb)
 	{
-		for (auto j = FrgCommon::lattice().getRange(i); j != FrgCommon::lattice().end(); ++j)
+		int i = basis[nb];
+		for (int j : FrgCommon::lattice().getRangeIds(nb))
 		{
-			SpinComponent component;
-			int rid;
-            float sign =1.0f;
-			component = SpinComponent::X;
-			rid = FrgCommon::lattice().symmetryTransform(i, j, component,sign);
-			_correlationsXX[offset] = susceptibility.bundle(static_cast<int>(component))[rid];
-
-			component = SpinComponent::Y;
-			rid = FrgCommon::lattice().symmetryTransform(i, j, component,sign);
-			_correlationsYY[offset] = susceptibility.bundle(static_cast<int>(component))[rid];
+			float m[9];
+			int rid = FrgCommon::lattice().symmetryTransform(i, j, m);
 
-			component = SpinComponent::Z;
-			rid = FrgCommon::lattice().symmetryTransform(i, j, component,sign);
-			_correlationsZZ[offset] = susceptibility.bundle(static_cast<int>(component))[rid];
+			//diagonal correlations transform as chi^{aa}(i,j)=M[a][c]*M[a][c]*chi^{cc}(0,rid)
+			float correlations[3] = { 0.0f, 0.0f, 0.0f };
+			for (int a = 0; a < 3; ++a) for (int c = 0; c < 3; ++c) correlations[a] += m[3 * a + c] * m[3 * a + c] * susceptibility.bundle(c)[rid];
 
-			component = SpinComponent::None;
-			rid = FrgCommon::lattice().symmetryTransform(i, j, component,sign);
-			_correlationsDD[offset] = susceptibility.bundle(static_cast<int>(component))[rid];
+			_correlationsXX[offset] = correlations[0];
+			_correlationsYY[offset] = correlations[1];
+			_correlationsZZ[offset] = correlations[2];
+			_correlationsDD[offset] = susceptibility.bundle(static_cast<int>(SpinComponent::None))[rid];
 
 			++offset;
 		}
@@ -254,7 +306,7 @@ void XYZMeasurementCorrelation::_writeOutfileHeader(const std::string &observabl
 		//write basis
 		float *basisBuffer = new float[3 * FrgCommon::lattice()._basis.size()];
 		i = 0;
-		for (auto b = FrgCommon::lattice().getBasis(); b != FrgCommon::lattice().end(); ++b)
+		for (int b : FrgCommon::lattice().getBasisIds())
 		{
 			basisBuffer[3 * i] = float(FrgCommon::lattice().getSitePosition(b).x);
 			basisBuffer[3 * i + 1] = float(FrgCommon::lattice().getSitePosition(b).y);
@@ -271,8 +323,7 @@ void XYZMeasurementCorrelation::_writeOutfileHeader(const std::string &observabl
 		delete[] basisBuffer;
 
 		//write sites
-		int inRangeCount = 0;
-		for (SublatticeIterator i = FrgCommon::lattice().getRange(0); i != FrgCommon::lattice().end(); ++i) ++inRangeCount;
+		int inRangeCount = FrgCommon::lattice().getRangeIds(0).size();
 
 		const int dataSpaceDimSitesReference = 2;
 		const hsize_t dataSpaceSizeSitesReference[dataSpaceDimSitesReference] = { FrgCommon::lattice()._basis.size(), hsize_t(inRangeCount) };
@@ -282,7 +333,7 @@ void XYZMeasurementCorrelation::_writeOutfileHeader(const std::string &observabl
 		int j = 0;
 		for (unsigned int b = 0; b < FrgCommon::lattice()._basis.size(); ++b)
 		{
-			for (SublatticeIterator i = FrgCommon::lattice().getRange(b); i != FrgCommon::lattice().end(); ++i)
+			for (int i : FrgCommon::lattice().getRangeIds(b))
 			{
 				*(SitesReferenceBuffer + 3 * j) = (float)FrgCommon::lattice().getSitePosition(i).x;
 				*(SitesReferenceBuffer + 3 * j + 1) = (float)FrgCommon::lattice().getSitePosition(i).y;
@@ -371,8 +422,7 @@ void XYZMeasurementCorrelation::_writeOutfileCorrelation(const std::string &obse
 	H5Sclose(attrSpace);
 
 	//write data
-	int inRangeCount = 0;
-	for (SublatticeIterator i = FrgCommon::lattice().getRange(0); i != FrgCommon::lattice().end(); ++i) ++inRangeCount;
+	int inRangeCount = FrgCommon::lattice().getRangeIds(0).size();
 	const int dataSpaceDim = 2;
 	const hsize_t dataSpaceSize[2] = { FrgCommon::lattice()._basis.size(), hsize_t(inRangeCount) };
 	hid_t dataSpace = H5Screate_simple(dataSpaceDim, dataSpaceSize, NULL);
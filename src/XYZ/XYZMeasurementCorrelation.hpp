@@ -39,6 +39,31 @@ public:
 	 * @param isMasterTask If set to true, the function call should be responsible for writing the output file. 
 	 */
 	void takeMeasurement(const EffectiveAction &state, const bool isMasterTask) const override;
+
+	/**
+	 * @brief Retrieve the most recently measured correlations. 
+	 * @see Measurement::observables()
+	 *
+	 * @return std::vector<float> Concatenation of all correlation buffers. 
+	 */
+	std::vector<float> observables() const override;
+
+	/**
+	 * @brief Retrieve views of the correlation buffers, in the frame of the FRG core. 
+	 * @see Measurement::observableBuffers()
+	 * 
+	 * @return std::vector<Observable> List of correlation buffers. 
+	 */
+	std::vector<Observable> observableBuffers() const override;
+
+	/**
+	 * @brief Query whether the correlations have already been calculated at the cutoff of the specified effective action. 
+	 * @see Measurement::isCalculated()
+	 * 
+	 * @param state Effective action object to perform the measurement on. 
+	 * @return bool Return true if the correlations are up to date, return false otherwise. 
+	 */
+	bool isCalculated(const EffectiveAction &state) const override;
 	
 private:
 	/**
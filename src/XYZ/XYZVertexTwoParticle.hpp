@@ -1,7 +1,7 @@
 /**
  * @file XYZVertexTwoParticle.hpp
  * @author Finn Lasse Buessen
- * @brief Two-particle vertex implementation for models with diagonal interactions.
+ * @brief Two-particle vertex implementation for models with diagonal interactions. 
  * 
  * @copyright Copyright (c) 2020
  */
@@ -11,6 +11,7 @@
 #include "lib/ValueBundle.hpp"
 #include "lib/Assert.hpp"
 #include "FrgCommon.hpp"
+#include "KernelTuner.hpp"
 
 /**
  * @brief Buffer for frequency interpolation information. 
@@ -36,7 +37,7 @@ public:
 };
 
 /**
- * @brief Two-particle vertex implementation for models with diagonal interactions.
+ * @brief Two-particle vertex implementation for models with diagonal interactions. 
  */
 struct XYZVertexTwoParticle
 {
@@ -71,10 +72,17 @@ public:
 		_dataYY = new float[size];
 		_dataZZ = new float[size];
 		_dataDD = new float[size];
-		memset(_dataXX, 0, sizeof(float) * size);
-		memset(_dataYY, 0, sizeof(float) * size);
-		memset(_dataZZ, 0, sizeof(float) * size);
-		memset(_dataDD, 0, sizeof(float) * size);
+		//first touch in parallel, such that memory pages are placed close to the threads which compute the flow
+		#ifndef DISABLE_OMP
+		#pragma omp parallel for schedule(static)
+		#endif
+		for (int i = 0; i < size; ++i)
+		{
+			_dataXX[i] = 0.0f;
+			_dataYY[i] = 0.0f;
+			_dataZZ[i] = 0.0f;
+			_dataDD[i] = 0.0f;
+		}
 	}
 
 	/**
@@ -187,6 +195,13 @@ public:
 	 */
 	float getValue(LatticeIterator i1, LatticeIterator i2, float s, float t, float u, SpinComponent symmetry, const XYZVertexTwoParticle::FrequencyChannel channel) const
 	{
+		//higher-order interpolation is performed via access buffers
+		if (FrgCommon::frequency().interpolation == FrequencyDiscretization::Interpolation::Cubic && channel != FrequencyChannel::All)
+		{
+			if (channel == FrequencyChannel::None) return getValue(i1, i2, symmetry, generateAccessBuffer<64>(s, t, u));
+			else return getValue(i1, i2, symmetry, generateAccessBuffer<16>(s, t, u, channel));
+		}
+
 		//map to positive frequency sector
 		if (s < 0 && u < 0)
 		{
@@ -210,6 +225,21 @@ public:
 		{
 			t = -t;
 		}
+
+		//transformations which are not plain permutations act as v^{aa}(i1,i2)=M[a][c]*M[a][c]*v^{cc}(0,i2') on the diagonal spin components
+		if (symmetry != SpinComponent::None && FrgCommon::lattice().hasSpinRotation(i1, i2))
+		{
+			float m[9];
+			LatticeIterator rid = FrgCommon::lattice().fromParametrization(FrgCommon::lattice().symmetryTransform(i1, i2, m));
+
+			float value = 0.0f;
+			for (int c = 0; c < 3; ++c)
+			{
+				float w = m[3 * static_cast<int>(symmetry) + c] * m[3 * static_cast<int>(symmetry) + c];
+				if (w != 0.0f) value += w * getValue(FrgCommon::lattice().zero(), rid, s, t, u, static_cast<SpinComponent>(c), channel);
+			}
+			return value;
+		}
         
 		float sign =1.0f;
 		int siteOffset = FrgCommon::lattice().symmetryTransform(i1, i2, symmetry,sign);
@@ -322,6 +352,23 @@ public:
 	 */
 	template <int n> float getValue(const LatticeIterator i1, const LatticeIterator i2, SpinComponent symmetry, const XYZVertexTwoParticleAccessBuffer<n> &accessBuffer) const
 	{
+		//transformations which are not plain permutations act as v^{aa}(i1,i2)=M[a][c]*M[a][c]*v^{cc}(0,i2') on the diagonal spin components
+		if (symmetry != SpinComponent::None && ((accessBuffer.siteExchange) ? FrgCommon::lattice().hasSpinRotation(i2, i1) : FrgCommon::lattice().hasSpinRotation(i1, i2)))
+		{
+			float m[9];
+			int siteOffset = (accessBuffer.siteExchange) ? FrgCommon::lattice().symmetryTransform(i2, i1, m) : FrgCommon::lattice().symmetryTransform(i1, i2, m);
+			const float *data[3] = { _dataXX, _dataYY, _dataZZ };
+
+			float value = 0.0f;
+			for (int c = 0; c < 3; ++c)
+			{
+				float w = m[3 * static_cast<int>(symmetry) + c] * m[3 * static_cast<int>(symmetry) + c];
+				if (w == 0.0f) continue;
+				for (int i = 0; i < n; ++i) value += w * accessBuffer.frequencyWeights[i] * data[c][accessBuffer.frequencyOffsets[i] + siteOffset];
+			}
+			return value;
+		}
+
 		float sign =1.0f;
 		int siteOffset = (accessBuffer.siteExchange) ? FrgCommon::lattice().symmetryTransform(i2, i1, symmetry,sign) : FrgCommon::lattice().symmetryTransform(i1, i2, symmetry,sign);
 
@@ -347,7 +394,7 @@ public:
 	}
 
 	/**
-	 * @brief Access vertex value locally at arbitrary symmetry via a given access buffer
+	 * @brief Access vertex value locally at arbitrary symmetry via a given access buffer 
 	 * 
 	 * @tparam n Number of support sites in the access buffer. 
 	 * @param symmetry Vertex channel. 
@@ -391,6 +438,34 @@ public:
 
 		float *base[4] = { _dataXX, _dataYY, _dataZZ, _dataDD };
 
+		if (KernelTuner::gatherOrder == KernelTuner::GatherOrder::SiteMajor)
+		{
+			int size = FrgCommon::lattice().size;
+			for (int j = 0; j < size; ++j)
+			{
+				if (sites[j].spinRotation >= 0) continue;
+				const float *x = base[static_cast<int>(sites[j].spinPermutation[0])] + sites[j].rid;
+				const float *y = base[static_cast<int>(sites[j].spinPermutation[1])] + sites[j].rid;
+				const float *z = base[static_cast<int>(sites[j].spinPermutation[2])] + sites[j].rid;
+				const float *d = base[3] + sites[j].rid;
+
+				float valueX = 0.0f, valueY = 0.0f, valueZ = 0.0f, valueD = 0.0f;
+				for (int i = 0; i < n; ++i)
+				{
+					valueX += accessBuffer.frequencyWeights[i] * x[accessBuffer.frequencyOffsets[i]];
+					valueY += accessBuffer.frequencyWeights[i] * y[accessBuffer.frequencyOffsets[i]];
+					valueZ += accessBuffer.frequencyWeights[i] * z[accessBuffer.frequencyOffsets[i]];
+					valueD += accessBuffer.signFlag[i] * accessBuffer.frequencyWeights[i] * d[accessBuffer.frequencyOffsets[i]];
+				}
+				superbundle.bundle(0)[j] = valueX;
+				superbundle.bundle(1)[j] = valueY;
+				superbundle.bundle(2)[j] = valueZ;
+				superbundle.bundle(3)[j] = valueD;
+			}
+			if (FrgCommon::lattice().hasSpinRotations()) _getValueSuperbundleRotated(accessBuffer, sites, superbundle);
+			return;
+		}
+
 		for (int i = 0; i < n; ++i)
 		{
 			float weight = accessBuffer.frequencyWeights[i];
@@ -400,29 +475,35 @@ public:
 
 			for (int j = 0; j < size; ++j)
 			{
+				if (sites[j].spinRotation >= 0) continue;
 				superbundle.bundle(0)[j] += weight * base[static_cast<int>(sites[j].spinPermutation[0])][frequencyOffset + sites[j].rid];
 				superbundle.bundle(1)[j] += weight * base[static_cast<int>(sites[j].spinPermutation[1])][frequencyOffset + sites[j].rid];
 				superbundle.bundle(2)[j] += weight * base[static_cast<int>(sites[j].spinPermutation[2])][frequencyOffset + sites[j].rid];
 				superbundle.bundle(3)[j] += signedWeight * base[3][frequencyOffset + sites[j].rid];
 			}
 		}
+		if (FrgCommon::lattice().hasSpinRotations()) _getValueSuperbundleRotated(accessBuffer, sites, superbundle);
 	}
 
 	/**
 	 * @brief Generate an access buffer for a set of frequencies where one of them (specified by channel) exactly lies on the frequency mesh. 
 	 * Frequency channel must be either FrequencyChannel::S, FrequencyChannel::T, FrequencyChannel::U. 
 	 * 
+	 * @tparam n Number of support values. Either 4 for linear or 16 for cubic interpolation. 
 	 * @param s First frequency argument. 
 	 * @param t Second frequency argument. 
 	 * @param u Third frequency argument. 
 	 * @param channel Frequency channel. 
-	 * @return XYZVertexTwoParticleAccessBuffer<4> Access buffer. 
+	 * @return XYZVertexTwoParticleAccessBuffer<n> Access buffer. 
 	 */
-	XYZVertexTwoParticleAccessBuffer<4> generateAccessBuffer(float s, float t, float u, const XYZVertexTwoParticle::FrequencyChannel channel) const
+	template <int n = 4> XYZVertexTwoParticleAccessBuffer<n> generateAccessBuffer(float s, float t, float u, const XYZVertexTwoParticle::FrequencyChannel channel) const
 	{
 		ASSERT(channel == FrequencyChannel::S || channel == FrequencyChannel::T || channel == FrequencyChannel::U);
 
-		XYZVertexTwoParticleAccessBuffer<4> accessBuffer;
+		static_assert(n == 4 || n == 16, "Access buffer must hold either 4 or 16 support values");
+		constexpr int k = (n == 16) ? 4 : 2;
+
+		XYZVertexTwoParticleAccessBuffer<n> accessBuffer;
 
 		//map to positive frequency sector
 		if (s < 0 && u < 0)
@@ -452,60 +533,53 @@ public:
 		if (channel == FrequencyChannel::S)
 		{
 			int exactS = FrgCommon::frequency().offset(s);
-			int lowerT, upperT;
-			float biasT;
-			int lowerU, upperU;
-			float biasU;
-			FrgCommon::frequency().interpolateOffset(t, lowerT, upperT, biasT);
-			FrgCommon::frequency().interpolateOffset(u, lowerU, upperU, biasU);
+			int offsetsT[k], offsetsU[k];
+			float weightsT[k], weightsU[k];
+			FrgCommon::frequency().interpolateStencil<k>(t, offsetsT, weightsT);
+			FrgCommon::frequency().interpolateStencil<k>(u, offsetsU, weightsU);
 
-			accessBuffer.frequencyWeights[0] = (1 - biasU) * (1 - biasT);
-			accessBuffer.frequencyOffsets[0] = _generateAccessBufferOffset(exactS, lowerT, lowerU, accessBuffer.signFlag[0]);
-			accessBuffer.frequencyWeights[1] = (1 - biasU) * biasT;
-			accessBuffer.frequencyOffsets[1] = _generateAccessBufferOffset(exactS, upperT, lowerU, accessBuffer.signFlag[1]);
-			accessBuffer.frequencyWeights[2] = biasU * (1 - biasT);
-			accessBuffer.frequencyOffsets[2] = _generateAccessBufferOffset(exactS, lowerT, upperU, accessBuffer.signFlag[2]);
-			accessBuffer.frequencyWeights[3] = biasU * biasT;
-			accessBuffer.frequencyOffsets[3] = _generateAccessBufferOffset(exactS, upperT, upperU, accessBuffer.signFlag[3]);
+			for (int j = 0; j < k; ++j)
+			{
+				for (int i = 0; i < k; ++i)
+				{
+					accessBuffer.frequencyWeights[k * j + i] = weightsU[j] * weightsT[i];
+					accessBuffer.frequencyOffsets[k * j + i] = _generateAccessBufferOffset(exactS, offsetsT[i], offsetsU[j], accessBuffer.signFlag[k * j + i]);
+				}
+			}
 		}
 		else if (channel == FrequencyChannel::T)
 		{
 			int exactT = FrgCommon::frequency().offset(t);
-			int lowerS, upperS;
-			float biasS;
-			int lowerU, upperU;
-			float biasU;
-			FrgCommon::frequency().interpolateOffset(s, lowerS, upperS, biasS);
-			FrgCommon::frequency().interpolateOffset(u, lowerU, upperU, biasU);
-
-			accessBuffer.frequencyWeights[0] = (1 - biasU) * (1 - biasS);
-			accessBuffer.frequencyOffsets[0] = _generateAccessBufferOffset(lowerS, exactT, lowerU, accessBuffer.signFlag[0]);
-			accessBuffer.frequencyWeights[1] = (1 - biasU) * biasS;
-			accessBuffer.frequencyOffsets[1] = _generateAccessBufferOffset(upperS, exactT, lowerU, accessBuffer.signFlag[1]);
-			accessBuffer.frequencyWeights[2] = biasU * (1 - biasS);
-			accessBuffer.frequencyOffsets[2] = _generateAccessBufferOffset(lowerS, exactT, upperU, accessBuffer.signFlag[2]);
-			accessBuffer.frequencyWeights[3] = biasU * biasS;
-			accessBuffer.frequencyOffsets[3] = _generateAccessBufferOffset(upperS, exactT, upperU, accessBuffer.signFlag[3]);
+			int offsetsS[k], offsetsU[k];
+			float weightsS[k], weightsU[k];
+			FrgCommon::frequency().interpolateStencil<k>(s, offsetsS, weightsS);
+			FrgCommon::frequency().interpolateStencil<k>(u, offsetsU, weightsU);
 
+			for (int j = 0; j < k; ++j)
+			{
+				for (int i = 0; i < k; ++i)
+				{
+					accessBuffer.frequencyWeights[k * j + i] = weightsU[j] * weightsS[i];
+					accessBuffer.frequencyOffsets[k * j + i] = _generateAccessBufferOffset(offsetsS[i], exactT, offsetsU[j], accessBuffer.signFlag[k * j + i]);
+				}
+			}
 		}
 		else if (channel == FrequencyChannel::U)
 		{
 			int exactU = FrgCommon::frequency().offset(u);
-			int lowerS, upperS;
-			float biasS;
-			int lowerT, upperT;
-			float biasT;
-			FrgCommon::frequency().interpolateOffset(s, lowerS, upperS, biasS);
-			FrgCommon::frequency().interpolateOffset(t, lowerT, upperT, biasT);
+			int offsetsS[k], offsetsT[k];
+			float weightsS[k], weightsT[k];
+			FrgCommon::frequency().interpolateStencil<k>(s, offsetsS, weightsS);
+			FrgCommon::frequency().interpolateStencil<k>(t, offsetsT, weightsT);
 
-			accessBuffer.frequencyWeights[0] = (1 - biasT) * (1 - biasS);
-			accessBuffer.frequencyOffsets[0] = _generateAccessBufferOffset(lowerS, lowerT, exactU, accessBuffer.signFlag[0]);
-			accessBuffer.frequencyWeights[1] = (1 - biasT) * biasS;
-			accessBuffer.frequencyOffsets[1] = _generateAccessBufferOffset(upperS, lowerT, exactU, accessBuffer.signFlag[1]);
-			accessBuffer.frequencyWeights[2] = biasT * (1 - biasS);
-			accessBuffer.frequencyOffsets[2] = _generateAccessBufferOffset(lowerS, upperT, exactU, accessBuffer.signFlag[2]);
-			accessBuffer.frequencyWeights[3] = biasT * biasS;
-			accessBuffer.frequencyOffsets[3] = _generateAccessBufferOffset(upperS, upperT, exactU, accessBuffer.signFlag[3]);
+			for (int j = 0; j < k; ++j)
+			{
+				for (int i = 0; i < k; ++i)
+				{
+					accessBuffer.frequencyWeights[k * j + i] = weightsT[j] * weightsS[i];
+					accessBuffer.frequencyOffsets[k * j + i] = _generateAccessBufferOffset(offsetsS[i], offsetsT[j], exactU, accessBuffer.signFlag[k * j + i]);
+				}
+			}
 		}
 
 		return accessBuffer;
@@ -514,14 +588,18 @@ public:
 	/**
 	 * @brief Generate an access buffer for an arbitrary set of frequencies.  
 	 * 
+	 * @tparam n Number of support values. Either 8 for linear or 64 for cubic interpolation. 
 	 * @param s First frequency argument. 
 	 * @param t Second frequency argument. 
 	 * @param u Third frequency argument. 
-	 * @return XYZVertexTwoParticleAccessBuffer<8> Access buffer. 
+	 * @return XYZVertexTwoParticleAccessBuffer<n> Access buffer. 
 	 */
-	XYZVertexTwoParticleAccessBuffer<8> generateAccessBuffer(float s, float t, float u) const
+	template <int n = 8> XYZVertexTwoParticleAccessBuffer<n> generateAccessBuffer(float s, float t, float u) const
 	{
-		XYZVertexTwoParticleAccessBuffer<8> accessBuffer;
+		static_assert(n == 8 || n == 64, "Access buffer must hold either 8 or 64 support values");
+		constexpr int k = (n == 64) ? 4 : 2;
+
+		XYZVertexTwoParticleAccessBuffer<n> accessBuffer;
 
 		//map to positive frequency sector
 		if (s < 0 && u < 0)
@@ -547,33 +625,24 @@ public:
 			t = -t;
 		}
 
-		int lowerS, upperS;
-		float biasS;
-		int lowerT, upperT;
-		float biasT;
-		int lowerU, upperU;
-		float biasU;
-
-		FrgCommon::frequency().interpolateOffset(s, lowerS, upperS, biasS);
-		FrgCommon::frequency().interpolateOffset(t, lowerT, upperT, biasT);
-		FrgCommon::frequency().interpolateOffset(u, lowerU, upperU, biasU);
-
-		accessBuffer.frequencyWeights[0] = (1 - biasT) * (1 - biasS) * (1 - biasU);
-		accessBuffer.frequencyOffsets[0] = _generateAccessBufferOffset(lowerS, lowerT, lowerU, accessBuffer.signFlag[0]);
-		accessBuffer.frequencyWeights[1] = (1 - biasT) * biasS * (1 - biasU);
-		accessBuffer.frequencyOffsets[1] = _generateAccessBufferOffset(upperS, lowerT, lowerU, accessBuffer.signFlag[1]);
-		accessBuffer.frequencyWeights[2] = biasT * (1 - biasS) * (1 - biasU);
-		accessBuffer.frequencyOffsets[2] = _generateAccessBufferOffset(lowerS, upperT, lowerU, accessBuffer.signFlag[2]);
-		accessBuffer.frequencyWeights[3] = biasT * biasS * (1 - biasU);
-		accessBuffer.frequencyOffsets[3] = _generateAccessBufferOffset(upperS, upperT, lowerU, accessBuffer.signFlag[3]);
-		accessBuffer.frequencyWeights[4] = (1 - biasT) * (1 - biasS) * biasU;
-		accessBuffer.frequencyOffsets[4] = _generateAccessBufferOffset(lowerS, lowerT, upperU, accessBuffer.signFlag[4]);
-		accessBuffer.frequencyWeights[5] = (1 - biasT) * biasS * biasU;
-		accessBuffer.frequencyOffsets[5] = _generateAccessBufferOffset(upperS, lowerT, upperU, accessBuffer.signFlag[5]);
-		accessBuffer.frequencyWeights[6] = biasT * (1 - biasS) * biasU;
-		accessBuffer.frequencyOffsets[6] = _generateAccessBufferOffset(lowerS, upperT, upperU, accessBuffer.signFlag[6]);
-		accessBuffer.frequencyWeights[7] = biasT * biasS * biasU;
-		accessBuffer.frequencyOffsets[7] = _generateAccessBufferOffset(upperS, upperT, upperU, accessBuffer.signFlag[7]);
+		int offsetsS[k], offsetsT[k], offsetsU[k];
+		float weightsS[k], weightsT[k], weightsU[k];
+
+		FrgCommon::frequency().interpolateStencil<k>(s, offsetsS, weightsS);
+		FrgCommon::frequency().interpolateStencil<k>(t, offsetsT, weightsT);
+		FrgCommon::frequency().interpolateStencil<k>(u, offsetsU, weightsU);
+
+		for (int l = 0; l < k; ++l)
+		{
+			for (int j = 0; j < k; ++j)
+			{
+				for (int i = 0; i < k; ++i)
+				{
+					accessBuffer.frequencyWeights[k * k * l + k * j + i] = weightsT[j] * weightsS[i] * weightsU[l];
+					accessBuffer.frequencyOffsets[k * k * l + k * j + i] = _generateAccessBufferOffset(offsetsS[i], offsetsT[j], offsetsU[l], accessBuffer.signFlag[k * k * l + k * j + i]);
+				}
+			}
+		}
 
 		return accessBuffer;
 	}
@@ -654,6 +723,36 @@ public:
 		}
 	}
 
+	/**
+	 * @brief Bundled vertex access on all lattice sites whose symmetry transformation is not a plain permutation of spin components. 
+	 * The diagonal vertex components are evaluated as v^{aa}=M[a][c]*M[a][c]*v^{cc} from their stored counterparts. 
+	 * 
+	 * @tparam n Number of support sites in the access buffer. 
+	 * @param[in] accessBuffer Access buffer. 
+	 * @param[in] sites Site descriptors which correspond to the exchange state of the access buffer. 
+	 * @param[out] superbundle Vertex value bundle. 
+	 */
+	template <int n> void _getValueSuperbundleRotated(const XYZVertexTwoParticleAccessBuffer<n> &accessBuffer, const LatticeSiteDescriptor *sites, ValueSuperbundle<float, 4> &superbundle) const
+	{
+		const float *base[4] = { _dataXX, _dataYY, _dataZZ, _dataDD };
+
+		for (int j = 0; j < FrgCommon::lattice().size; ++j)
+		{
+			if (sites[j].spinRotation < 0) continue;
+			const float *m = FrgCommon::lattice().getSpinRotation(sites[j].spinRotation);
+
+			float value[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			for (int i = 0; i < n; ++i)
+			{
+				float stored[3];
+				for (int c = 0; c < 3; ++c) stored[c] = base[c][accessBuffer.frequencyOffsets[i] + sites[j].rid];
+				for (int a = 0; a < 3; ++a) value[a] += accessBuffer.frequencyWeights[i] * (m[3 * a] * m[3 * a] * stored[0] + m[3 * a + 1] * m[3 * a + 1] * stored[1] + m[3 * a + 2] * m[3 * a + 2] * stored[2]);
+				value[3] += accessBuffer.signFlag[i] * accessBuffer.frequencyWeights[i] * base[3][accessBuffer.frequencyOffsets[i] + sites[j].rid];
+			}
+			for (int a = 0; a < 4; ++a) superbundle.bundle(a)[j] = value[a];
+		}
+	}
+
 	int size; ///< Size of the vertex per vertex channel (number of elements). 
 	int sizeFrequency; ///< Size of the vertex per vertex channel in the frequency subspace (number of elements). 
 
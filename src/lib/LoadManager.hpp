@@ -9,6 +9,8 @@
 #pragma once
 #include <vector>
 #include <functional>
+#include <limits>
+#include <algorithm>
 #include <thread>
 #include <mutex>
 #include <boost/date_time.hpp>
@@ -25,6 +27,7 @@
 #define HMP_CHUNK_PROPERTY_STACK 0 ///< Memory offset of the stack id in the chunk properties. 
 #define HMP_CHUNK_PROPERTY_BEGIN 1 ///< Memory offset of the workload begin in the chunk properties. 
 #define HMP_CHUNK_PROPERTY_END 2 ///< Memory offset of the workload end in the chunk properties. 
+#define HMP_REPLICATION_TRIALS 3 ///< Number of timed calculate() calls in distributed and in replicated mode, respectively, before the faster mode is chosen for a replicable stack. 
 
 #ifndef DISABLE_MPI
 #define HMP_MPI_ENABLED ///< Defined, if MPI parallelization is enabled. 
@@ -119,6 +122,11 @@ namespace HMP
 				ChunkReturn, ///< MPI message contains the result of a chunk computation
 			};
 
+			/**
+			 * @brief Construct a new DataStackBase object and initialize the replication statistics. 
+			 */
+			DataStackBase() : replicable(false), replicated(false), replicationTrials(0), replicationSample(0.0f), distributedTime(std::numeric_limits<float>::infinity()), replicatedTime(std::numeric_limits<float>::infinity()) {};
+
 			/**
 			 * @brief Virtual destructor.
 			 */
@@ -169,6 +177,12 @@ namespace HMP
 			int recommendedChunkSizeMultiple; ///< When breaking the data stack down into smaller work chunks, attempt to form chunks whose size is a multiple of the given value. This is helpful if calculators vary in runtime, but can be joined to groups whose collective runtime is expected to be constant. 
 			int recommendedChunksPerRank; ///< When breaking the data stack down into smaller work chunks, attempt to form approximately the specified number of chunks per MPI rank. 
 			bool autoBroadcast; ///< If set to true, modifications to the stack's data that are a consequence of the onvication of calculators are automatically communicated across all MPI ranks. If set to false, they are only sent to the MPI server rank. 
+			bool replicable; ///< If set to true, the stack may be calculated redundantly on every MPI rank without communication, if this is found to be faster than distributing the workload. 
+			bool replicated; ///< Specifies whether the most recent calculation of the stack has been performed in replicated mode. In this case, the data is already available on all MPI ranks. 
+			int replicationTrials; ///< Number of timed calculate() calls which have been performed to decide on the replication mode. Exceeds 2*HMP_REPLICATION_TRIALS once the decision has been made. 
+			float replicationSample; ///< Runtime in milliseconds of the most recent timed calculation in distributed mode, including the subsequent broadcast. 
+			float distributedTime; ///< Minimal runtime in milliseconds of all timed calculations in distributed mode. 
+			float replicatedTime; ///< Minimal runtime in milliseconds of all timed calculations in replicated mode. 
 		};
 
 		/**
@@ -318,12 +332,13 @@ namespace HMP
 		 * @param recommendedChunkSizeMultiple Suggested quantization of elements per work chunk. 
 		 * @param recommendedChunksPerRank Suggested number of work chunks per MPI rank. 
 		 * @param autoBroadcast Enable or disable auto broadcast. 
+		 * @param replicable Allow the stack to be calculated redundantly on every MPI rank, if this is faster. Should only be enabled for small stacks whose calculators depend on data which is available on all MPI ranks. 
 		 * @return StackIdentifier Id of the newly generated stack as registered with the LoadManager. 
 		 * 
 		 * @see DataStackBase::StackType::Explicit
 		 * @see DataStack
 		 */
-		template <class StackT> StackIdentifier addMasterStackExplicit(StackT *const data, const int size, const std::function<StackT(int)> &calculator, const int recommendedChunkSizeMultiple = 1, const int recommendedChunksPerRank = 10, const bool autoBroadcast = false)
+		template <class StackT> StackIdentifier addMasterStackExplicit(StackT *const data, const int size, const std::function<StackT(int)> &calculator, const int recommendedChunkSizeMultiple = 1, const int recommendedChunksPerRank = 10, const bool autoBroadcast = false, const bool replicable = false)
 		{
 			DataStack<StackT> *ds = new DataStack<StackT>();
 			ds->type = DataStackBase::StackType::Explicit;
@@ -333,6 +348,7 @@ namespace HMP
 			ds->recommendedChunkSizeMultiple = recommendedChunkSizeMultiple;
 			ds->recommendedChunksPerRank = recommendedChunksPerRank;
 			ds->autoBroadcast = autoBroadcast;
+			ds->replicable = replicable;
 			ds->explicitCalculator = calculator;
 			ds->data = data;
 			return _registerStack(ds);
@@ -349,12 +365,13 @@ namespace HMP
 		 * @param recommendedChunkSizeMultiple Suggested quantization of elements per work chunk. 
 		 * @param recommendedChunksPerRank Suggested number of work chunks per MPI rank. 
 		 * @param autoBroadcast Enable or disable auto broadcast. 
+		 * @param replicable Allow the stack to be calculated redundantly on every MPI rank, if this is faster. Should only be enabled for small stacks whose calculators depend on data which is available on all MPI ranks. 
 		 * @return StackIdentifier Id of the newly generated stack as registered with the LoadManager. 
 		 * 
 		 * @see DataStackBase::StackType::Implicit
 		 * @see DataStack
 		 */
-		template <class StackT> StackIdentifier addMasterStackImplicit(StackT *const data, const int size, const std::function<void(int)> &calculator, const int typeMultiplicity = 1, const int recommendedChunkSizeMultiple = 1, const int recommendedChunksPerRank = 10, const bool autoBroadcast = false)
+		template <class StackT> StackIdentifier addMasterStackImplicit(StackT *const data, const int size, const std::function<void(int)> &calculator, const int typeMultiplicity = 1, const int recommendedChunkSizeMultiple = 1, const int recommendedChunksPerRank = 10, const bool autoBroadcast = false, const bool replicable = false)
 		{
 			DataStack<StackT> *ds = new DataStack<StackT>();
 			ds->type = DataStackBase::StackType::Implicit;
@@ -364,6 +381,7 @@ namespace HMP
 			ds->recommendedChunkSizeMultiple = recommendedChunkSizeMultiple;
 			ds->recommendedChunksPerRank = recommendedChunksPerRank;
 			ds->autoBroadcast = autoBroadcast;
+			ds->replicable = replicable;
 			ds->implicitCalculator = calculator;
 			ds->data = data;
 			return _registerStack(ds);
@@ -417,13 +435,80 @@ namespace HMP
 			return _registerStack(ds);
 		}
 
+		/**
+		 * @brief Retrieve the number of stacks which are currently registered with the LoadManager. 
+		 * 
+		 * @return StackIdentifier Number of registered stacks, which equals the identifier assigned to the next stack to be registered. 
+		 */
+		StackIdentifier stackCount() const
+		{
+			return StackIdentifier(_stacks.size());
+		}
+
+		/**
+		 * @brief Detach all stacks whose identifier is greater than or equal to the specified value. Identifiers of detached stacks are reassigned to stacks registered thereafter. 
+		 * @details The call must be issued on all MPI ranks. The data which the stacks operate on is not deallocated. 
+		 * 
+		 * @param firstStack Identifier of the first stack to detach. 
+		 */
+		void releaseStacks(const StackIdentifier firstStack)
+		{
+			while (StackIdentifier(_stacks.size()) > firstStack) _unregisterStack();
+		}
+
 		/**
 		 * @brief Calculate a list of stacks, where the stack identifiers are provided in list form. 
+		 * @details If a single replicable stack is calculated, the first 2*HMP_REPLICATION_TRIALS calls alternate between distributing the workload and calculating the stack redundantly on every MPI rank. 
+		 * Afterwards, the faster of the two modes is used consistently on all MPI ranks. 
 		 * 
 		 * @param stackIds Pointer to the first StackIdentifier. 
 		 * @param size Number of stacks. 
 		 */
-		virtual void calculate(const StackIdentifier *stackIds, const int size) = 0;
+		void calculate(const StackIdentifier *stackIds, const int size)
+		{
+			//replication is only considered for individual replicable stacks
+			if (size != 1 || !_stacks[stackIds[0]]->replicable)
+			{
+				for (int i = 0; i < size; ++i) _stacks[stackIds[i]]->replicated = false;
+				_calculateDistributed(stackIds, size);
+				return;
+			}
+			DataStackBase *stack = _stacks[stackIds[0]];
+
+			//determine replication mode
+			bool isTrial = stack->replicationTrials < 2 * HMP_REPLICATION_TRIALS;
+			if (isTrial)
+			{
+				//conclude previous trial in distributed mode, then alternate between both modes
+				if (stack->replicationTrials > 0 && !stack->replicated) stack->distributedTime = std::min(stack->distributedTime, stack->replicationSample);
+				stack->replicated = (stack->replicationTrials % 2 == 1);
+				++stack->replicationTrials;
+			}
+			else if (stack->replicationTrials == 2 * HMP_REPLICATION_TRIALS)
+			{
+				//choose the faster mode consistently across all ranks
+				float runtime[2] = { stack->distributedTime, stack->replicatedTime };
+				HMP_ENABLE_IF_MPI(MPI_Allreduce(MPI_IN_PLACE, runtime, 2, MPI_FLOAT, MPI_MAX, _communicator));
+				stack->replicated = runtime[1] < runtime[0];
+				++stack->replicationTrials;
+
+				Log::log << Log::LogLevel::Debug << "LoadManager chose " << ((stack->replicated) ? "replicated" : "distributed") << " mode for stack " << stackIds[0] << " (distributed " << runtime[0] << "ms, replicated " << runtime[1] << "ms)" << Log::endl;
+			}
+
+			//calculate stack
+			boost::posix_time::ptime tic = boost::posix_time::microsec_clock::local_time();
+			if (stack->replicated) _calculateChunk(Chunk(stackIds[0], 0, stack->size));
+			else _calculateDistributed(stackIds, size);
+			boost::posix_time::ptime toc = boost::posix_time::microsec_clock::local_time();
+
+			//record trial runtime
+			if (isTrial)
+			{
+				float runtime = float((toc - tic).total_microseconds()) / 1000.0f;
+				if (stack->replicated) stack->replicatedTime = std::min(stack->replicatedTime, runtime);
+				else stack->replicationSample = runtime;
+			}
+		}
 
 		/**
 		 * @brief Calculate a list of stacks, where the stack identifiers are provided in initializer list form. 
@@ -466,10 +551,19 @@ namespace HMP
 			#ifdef HMP_MPI_ENABLED
 			for (int i = 0; i < size; ++i)
 			{
+				//stacks which have been calculated in replicated mode are already synchronized
+				DataStackBase *stack = _stacks[stackIds[i]];
+				if (stack->replicated) continue;
+
+				boost::posix_time::ptime tic = boost::posix_time::microsec_clock::local_time();
 				for (StackIdentifier s = 0; s < StackIdentifier(_stacks.size()); ++s)
 				{
 					if (s == stackIds[i] || _stacks[s]->master == stackIds[i]) _stacks[s]->broadcast(_serverRank, _communicator);
 				}
+				boost::posix_time::ptime toc = boost::posix_time::microsec_clock::local_time();
+
+				//account for the broadcast in the runtime of trials in distributed mode
+				if (stack->replicable && stack->replicationTrials <= 2 * HMP_REPLICATION_TRIALS) stack->replicationSample += float((toc - tic).total_microseconds()) / 1000.0f;
 			}
 			#endif
 		}
@@ -543,6 +637,23 @@ namespace HMP
 			return StackIdentifier(_stacks.size() - 1);
 		}
 
+		/**
+		 * @brief Detach and delete the most recently registered DataStackBase. 
+		 */
+		virtual void _unregisterStack()
+		{
+			delete _stacks.back();
+			_stacks.pop_back();
+		}
+
+		/**
+		 * @brief Distribute the calculation of a list of stacks across all MPI ranks. 
+		 * 
+		 * @param stackIds Pointer to the first StackIdentifier. 
+		 * @param size Number of stacks. 
+		 */
+		virtual void _calculateDistributed(const StackIdentifier *stackIds, const int size) = 0;
+
 		/**
 		 * @brief Calculate the workload defined by a specific chunk. 
 		 * 
@@ -573,12 +684,29 @@ namespace HMP
 		friend LoadManager *newLoadManager(const int serverRank HMP_APPEND_IF_MPI(const MPI_Comm communicator));
 	public:
 		/**
-		 * @brief Calculate a list of stacks, where the stack identifiers are provided in list form. 
+		 * @brief Print runtime statistics, including information on the efficiency of LoadManager instances running on different MPI ranks. 
+		 */
+		void printRuntimeStatistics() const override
+		{
+			Log::log << Log::LogLevel::Debug << "LoadManager total time spent in calculate() calls is " << _totalCalculationTime << "ms" << Log::endl;
+			for (int i = 0; i < _commSize; ++i)
+			{
+				float timePerRank = 0.0;
+				for (StackIdentifier j = 0; j < StackIdentifier(_stacks.size()); ++j) timePerRank += _totalComputeTime[i][j];
+				Log::log << Log::LogLevel::Debug << "LoadManager (rank " << i << ") active computing time was " << std::setiosflags(std::ios::fixed) << std::setprecision(0) << timePerRank << "ms (Efficiency: " << std::setprecision(1) << 100.0f * timePerRank / _totalCalculationTime << "%)" << Log::endl;
+
+				for (StackIdentifier j = 0; j < StackIdentifier(_stacks.size()); ++j) Log::log << Log::LogLevel::Debug << "\t active computing time on stack " << j << " was " << _totalComputeTime[i][j] << "ms" << Log::endl;
+			}
+		}
+
+	protected:
+		/**
+		 * @brief Distribute the calculation of a list of stacks across all MPI ranks. 
 		 * 
 		 * @param stackIds Pointer to the first StackIdentifier. 
 		 * @param size Number of stacks. 
 		 */
-		virtual void calculate(const StackIdentifier *stackIds, const int size) override
+		virtual void _calculateDistributed(const StackIdentifier *stackIds, const int size) override
 		{
 			//reset calculation runtime statistics
 			for (int i = 0; i < _commSize; ++i)
@@ -648,23 +776,6 @@ namespace HMP
 			_totalCalculationTime += float((toc - tic).total_milliseconds());
 		}
 
-		/**
-		 * @brief Print runtime statistics, including information on the efficiency of LoadManager instances running on different MPI ranks. 
-		 */
-		void printRuntimeStatistics() const override
-		{
-			Log::log << Log::LogLevel::Debug << "LoadManager total time spent in calculate() calls is " << _totalCalculationTime << "ms" << Log::endl;
-			for (int i = 0; i < _commSize; ++i)
-			{
-				float timePerRank = 0.0;
-				for (StackIdentifier j = 0; j < StackIdentifier(_stacks.size()); ++j) timePerRank += _totalComputeTime[i][j];
-				Log::log << Log::LogLevel::Debug << "LoadManager (rank " << i << ") active computing time was " << std::setiosflags(std::ios::fixed) << std::setprecision(0) << timePerRank << "ms (Efficiency: " << std::setprecision(1) << 100.0f * timePerRank / _totalCalculationTime << "%)" << Log::endl;
-
-				for (StackIdentifier j = 0; j < StackIdentifier(_stacks.size()); ++j) Log::log << Log::LogLevel::Debug << "\t active computing time on stack " << j << " was " << _totalComputeTime[i][j] << "ms" << Log::endl;
-			}
-		}
-
-	protected:
 		/**
 		 * @brief Construct a new LoadManagerMaster object
 		 * 
@@ -724,6 +835,25 @@ namespace HMP
 			return identifier;
 		}
 
+		/**
+		 * @brief Detach and delete the most recently registered DataStackBase. 
+		 */
+		virtual void _unregisterStack() override
+		{
+			LoadManager::_unregisterStack();
+
+			for (int i = 0; i < _commSize; ++i)
+			{
+				_totalComputeTime[i].pop_back();
+				_currentCalculationWorkDone[i].pop_back();
+				_currentCalculationTime[i].pop_back();
+			}
+
+			_currentCalculationComputeTimeBuffer.resize(_commSize * _stacks.size());
+			_currentCalculationStackMask.resize(_stacks.size());
+			_currentCalculationStackProgress.resize(_stacks.size());
+		}
+
 		/**
 		 * @brief Worker loop to run calculators locally. 
 		 */
@@ -908,14 +1038,14 @@ namespace HMP
 	class LoadManagerSlave : public LoadManager
 	{
 		friend LoadManager *newLoadManager(const int serverRank HMP_APPEND_IF_MPI(const MPI_Comm communicator));
-	public:
+	protected:
 		/**
-		 * @brief Calculate a list of stacks, where the stack identifiers are provided in list form. 
+		 * @brief Receive and calculate workload chunks for a list of stacks, until the LoadManagerMaster signals completion. 
 		 * 
 		 * @param stackIds Pointer to the first StackIdentifier. 
 		 * @param size Number of stacks. 
 		 */
-		virtual void calculate(const StackIdentifier *stackIds, const int size) override
+		virtual void _calculateDistributed(const StackIdentifier *stackIds, const int size) override
 		{
 			#ifdef HMP_MPI_ENABLED
 			memset(_currentCalculationComputeTimeBuffer.data(), 0, _currentCalculationComputeTimeBuffer.size() * sizeof(float));
@@ -948,7 +1078,6 @@ namespace HMP
 			#endif
 		}
 
-	protected:
 		/**
 		 * @brief Construct a new LoadManagerSlave object
 		 * 
@@ -972,6 +1101,16 @@ namespace HMP
 			return identifier;
 		}
 
+		/**
+		 * @brief Detach and delete the most recently registered DataStackBase. 
+		 */
+		virtual void _unregisterStack() override
+		{
+			LoadManager::_unregisterStack();
+
+			_currentCalculationComputeTimeBuffer.resize(_stacks.size());
+		}
+
 		/**
 		 * @brief Wait until a workload chunk has been received from a LoadManagerMaster instance. 
 		 * 
@@ -1026,6 +1165,7 @@ namespace HMP
 #undef HMP_CHUNK_PROPERTY_STACK
 #undef HMP_CHUNK_PROPERTY_BEGIN
 #undef HMP_CHUNK_PROPERTY_END
+#undef HMP_REPLICATION_TRIALS
 
 #undef HMP_MPI_ENABLED
 #undef HMP_ENABLE_IF_MPI
@@ -8,6 +8,28 @@
 
 #pragma once
 #include <cstring>
+#include <memory>
+#include <algorithm>
+
+/**
+ * @brief Memory layout of the ValueBundles in a ValueSuperbundle. 
+ */
+struct ValueBundleLayout
+{
+	/**
+	 * @brief Access the bundle width. 
+	 * @details The ValueBundles of a ValueSuperbundle are stored in a single block of memory. 
+	 * The storage of each ValueBundle is aligned to, and padded to a multiple of, the bundle width, up to the size of a cache line. 
+	 * The layout only affects ValueSuperbundles which are constructed after the width has been changed. 
+	 * 
+	 * @return int& Reference to the bundle width in number of elements. 
+	 */
+	static int &width()
+	{
+		static int width = 1;
+		return width;
+	}
+};
 
 /**
  * @brief Value array implementation. The object does not hold ownership of its memory. 
@@ -247,7 +269,16 @@ public:
 	 */
 	ValueSuperbundle(const int bundleSize) : hasOwnership(true)
 	{
-		for (int i = 0; i < n; ++i) bundles[i] = ValueBundle<T>(new T[bundleSize], bundleSize);
+		//pad each bundle to a multiple of the bundle width and align the memory block to the bundle width
+		size_t width = size_t(ValueBundleLayout::width());
+		size_t alignment = std::min(width * sizeof(T), size_t(64));
+		size_t stride = (size_t(bundleSize) + width - 1) / width * width;
+		size_t space = (n * stride) * sizeof(T) + alignment;
+		memory = new char[space];
+		void *block = memory;
+		std::align(alignment, n * stride * sizeof(T), block, space);
+
+		for (int i = 0; i < n; ++i) bundles[i] = ValueBundle<T>(static_cast<T *>(block) + i * stride, bundleSize);
 		reset();
 	}
 
@@ -256,7 +287,7 @@ public:
 	 * 
 	 * @param rhs Right hand side operand. 
 	 */
-	ValueSuperbundle(const ValueSuperbundle &rhs) : hasOwnership(false)
+	ValueSuperbundle(const ValueSuperbundle &rhs) : hasOwnership(false), memory(nullptr)
 	{
 		for (int i = 0; i < n; ++i) bundles[i] = ValueBundle<T>(rhs.bundles[i].data(), rhs.bundles[i].size());
 	}
@@ -266,10 +297,7 @@ public:
 	 */
 	~ValueSuperbundle()
 	{
-		if (hasOwnership)
-		{
-			for (int i = 0; i < n; ++i) delete[] bundles[i].data();
-		}
+		if (hasOwnership) delete[] memory;
 	}
 
 	/**
@@ -346,4 +374,5 @@ public:
 private:
 	ValueBundle<T> bundles[n]; ///< List of member ValueBundles. 
 	bool hasOwnership; ///< If set to true, the ValueSuperbundle has membership of all SuperBundles' memory and deletes it upon destruction. 
+	char *memory; ///< Memory block which holds the storage of all ValueBundles. 
 };
@@ -0,0 +1,19 @@
+#set up pythonpath and import modules
+import sys
+pythonpath = sys.argv[1]
+sys.path.append(pythonpath)
+
+import numpy as np
+import spinparser.obs as o
+
+len(sys.argv) >= 4 and len(sys.argv) % 2 == 0 or sys.exit("Usage: benchmark_interpolation_eval.py pythonpath reference.obs runtime [file.obs runtime ...]")
+
+#read reference calculation
+reference = o.getCorrelation(sys.argv[2], verbose=False)
+
+#compare all calculations to the reference
+print("%-40s %12s %16s %16s" % ("calculation", "runtime [s]", "max deviation", "mean deviation"))
+for i in range(2, len(sys.argv), 2):
+    data = o.getCorrelation(sys.argv[i], verbose=False)
+    deviation = np.abs(data - reference)
+    print("%-40s %12.2f %16.8f %16.8f" % (sys.argv[i].split("/")[-1], float(sys.argv[i + 1]), np.max(deviation), np.mean(deviation)))
@@ -0,0 +1,76 @@
+#!/usr/bin/env bash
+BENCHMARK_NAME=benchmark_interpolation
+
+#before running this script, set the following environment variables:
+# BENCHMARK_ROOT_DIR [root directory of the project]
+[ -z "${BENCHMARK_ROOT_DIR}" ] && { echo "environment variable BENCHMARK_ROOT_DIR not defined"; exit 1; }
+# BENCHMARK_WORK_DIR [working directory to generate temporary output files]
+[ -z "${BENCHMARK_WORK_DIR}" ] && { echo "environment variable BENCHMARK_WORK_DIR not defined"; exit 1; }
+# BENCHMARK_EXECUTABLE [path to the executable to generate output]
+[ -z "${BENCHMARK_EXECUTABLE}" ] && { echo "environment variable BENCHMARK_EXECUTABLE not defined"; exit 1; }
+#optionally, set the following environment variables:
+# BENCHMARK_COUNTS [list of frequency counts to benchmark, defaults to "8 12 16 24"]
+# BENCHMARK_REFERENCE_COUNT [frequency count of the linearly interpolated reference calculation, defaults to 64]
+BENCHMARK_COUNTS=${BENCHMARK_COUNTS:-"8 12 16 24"}
+BENCHMARK_REFERENCE_COUNT=${BENCHMARK_REFERENCE_COUNT:-64}
+
+#init variables
+BENCHMARK_EVAL="python ${BENCHMARK_ROOT_DIR}/test/benchmark/assets/benchmark_interpolation_eval.py ${BENCHMARK_ROOT_DIR}/opt/python"
+
+#write task files
+function writeTask {
+cat > ${BENCHMARK_WORK_DIR}/${BENCHMARK_NAME}.$1.$2.xml <<- EOM
+<?xml version="1.0" encoding="utf-8"?>
+<task>
+    <parameters>
+        <frequency discretization="exponential" interpolation="$2">
+            <min>0.005</min>
+            <max>50.0</max>
+            <count>$1</count>
+        </frequency>
+        <cutoff discretization="exponential">
+            <max>50</max>
+            <min>0.3</min>
+            <step>0.95</step>
+        </cutoff>
+        <lattice name="square" range="3"/>
+        <model name="square-heisenberg" symmetry="SU2">
+            <j>1.0</j>
+        </model>
+    </parameters>
+    <measurements>
+        <measurement name="correlation" />
+    </measurements>
+</task>
+EOM
+}
+
+function cleanup {
+    for RUN in ${RUNS} ; do
+        for EXT in xml obs ldf checkpoint data ; do
+            rm -f ${BENCHMARK_WORK_DIR}/${BENCHMARK_NAME}.${RUN}.${EXT}
+        done
+    done
+}
+
+RUNS="${BENCHMARK_REFERENCE_COUNT}.linear"
+for COUNT in ${BENCHMARK_COUNTS} ; do
+    RUNS="${RUNS} ${COUNT}.linear ${COUNT}.cubic"
+done
+
+#run executable and record runtime
+trap 'cleanup ; exit 1' ERR
+RESULTS=""
+for RUN in ${RUNS} ; do
+    writeTask ${RUN%.*} ${RUN#*.}
+    START=$(date +%s.%N)
+    ${BENCHMARK_EXECUTABLE} -f ${BENCHMARK_WORK_DIR}/${BENCHMARK_NAME}.${RUN}.xml > /dev/null
+    END=$(date +%s.%N)
+    RESULTS="${RESULTS} ${BENCHMARK_WORK_DIR}/${BENCHMARK_NAME}.${RUN}.obs $(echo "${END} - ${START}" | bc)"
+done
+
+#evaluate accuracy relative to the reference calculation
+${BENCHMARK_EVAL} ${RESULTS}
+
+#cleanup
+cleanup
@@ -0,0 +1,123 @@
+/**
+ * @file benchmark_lattice.cpp
+ * @author Finn Lasse Buessen
+ * @brief Microbenchmark of lattice iteration via SublatticeIterator objects and via flat id lists.
+ * @details Usage: LatticeBenchmark [range] [repetitions]
+ *
+ * @copyright Copyright (c) 2020
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <boost/format.hpp>
+#include "lib/Log.hpp"
+#include "LatticeModelFactory.hpp"
+#include "SpinModel.hpp"
+
+//run a sweep for the given number of repetitions and print the time per visited site; each sweep returns the number of visited sites and adds to the checksum
+template <class T> void benchmark(const std::string &name, const int repetitions, T sweep)
+{
+	long long checksum = 0;
+	long long visits = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < repetitions; ++r) visits += sweep(checksum);
+	auto end = std::chrono::steady_clock::now();
+	double ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / double(visits);
+	std::cout << boost::format("%-28s %8.3f ns/site  (checksum %d)") % name % ns % checksum << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+	int range = (argc > 1) ? std::stoi(argv[1]) : 8;
+	int repetitions = (argc > 2) ? std::stoi(argv[2]) : 2000;
+
+	//honeycomb lattice, such that sublattice loops over two basis sites are exercised
+	LatticeModelFactory::LatticeUnitCell uc;
+	uc.basisSites.push_back(geometry::Vec3<double>(0.0, 0.0, 0.0));
+	uc.basisSites.push_back(geometry::Vec3<double>(1.0, 0.0, 0.0));
+	uc.latticeVectors.push_back(geometry::Vec3<double>(1.5, 0.5 * sqrt(3), 0.0));
+	uc.latticeVectors.push_back(geometry::Vec3<double>(1.5, -0.5 * sqrt(3), 0.0));
+	uc.latticeVectors.push_back(geometry::Vec3<double>(0.0, 0.0, 1.0));
+	uc.latticeBonds.push_back(LatticeModelFactory::LatticeBond(0, 1, 0, 0, 0));
+	uc.latticeBonds.push_back(LatticeModelFactory::LatticeBond(1, 0, 1, 0, 0));
+	uc.latticeBonds.push_back(LatticeModelFactory::LatticeBond(1, 0, 0, 1, 0));
+
+	LatticeModelFactory::SpinModelUnitCell model;
+	for (auto &bond : uc.latticeBonds)
+	{
+		LatticeModelFactory::SpinInteraction i(LatticeModelFactory::LatticeSite(0, 0, 0, bond.fromB), LatticeModelFactory::LatticeSite(bond.da0, bond.da1, bond.da2, bond.toB));
+		for (int s = 0; s < 3; ++s) i.interactionStrength[s][s] = 1.0f;
+		model.interactions.push_back(i);
+	}
+
+	Log::log << Log::setDisplayLogLevel(Log::LogLevel::None);
+	std::pair<Lattice *, SpinModel *> product = LatticeModelFactory::newLatticeModel(uc, model, range);
+	const Lattice &lattice = *product.first;
+	std::cout << boost::format("honeycomb lattice, range %d, %d representatives, %d sites in range, %d repetitions") % range % lattice.size % lattice.getRangeIds(0).size() % repetitions << std::endl;
+
+	//sweep over the neighborhood of the reference site, as in the single-particle flow
+	benchmark("iterator reference range", repetitions, [&](long long &checksum) -> long long
+	{
+		int visits = 0;
+		int sum = 0;
+		for (auto j = lattice.getRange(0); j != lattice.end(); ++j)
+		{
+			sum += lattice.symmetryTransform(lattice.zero(), j);
+			++visits;
+		}
+		checksum += sum;
+		return visits;
+	});
+	benchmark("flat reference range", repetitions, [&](long long &checksum) -> long long
+	{
+		int visits = 0;
+		int sum = 0;
+		for (int j : lattice.getRangeIds(0))
+		{
+			sum += lattice.symmetryTransform(lattice.zero(), j);
+			++visits;
+		}
+		checksum += sum;
+		return visits;
+	});
+
+	//sweep over the neighborhoods of all basis sites, as in the correlation measurements
+	benchmark("iterator basis ranges", repetitions, [&](long long &checksum) -> long long
+	{
+		int visits = 0;
+		int sum = 0;
+		for (auto i = lattice.getBasis(); i != lattice.end(); ++i)
+		{
+			for (auto j = lattice.getRange(i); j != lattice.end(); ++j)
+			{
+				sum += lattice.symmetryTransform(i, j);
+				++visits;
+			}
+		}
+		checksum += sum;
+		return visits;
+	});
+	benchmark("flat basis ranges", repetitions, [&](long long &checksum) -> long long
+	{
+		int visits = 0;
+		int sum = 0;
+		LatticeIdRange basis = lattice.getBasisIds();
+		for (int b = 0; b < basis.size(); ++b)
+		{
+			int i = basis[b];
+			for (int j : lattice.getRangeIds(b))
+			{
+				sum += lattice.symmetryTransform(i, j);
+				++visits;
+			}
+		}
+		checksum += sum;
+		return visits;
+	});
+
+	delete product.first;
+	delete product.second;
+	return 0;
+}
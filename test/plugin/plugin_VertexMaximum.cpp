@@ -0,0 +1,98 @@
+/**
+ * @file plugin_VertexMaximum.cpp
+ * @author Finn Lasse Buessen
+ * @brief Example measurement plugin which records the largest two-particle vertex magnitude at every frequency triplet of SU(2) models. 
+ * @details The plugin is used in a measurement as `<measurement name="plugin" library="libVertexMaximumPlugin.so"><group>VertexMaximum</group></measurement>`, where the optional parameter `group` specifies the observable group in the output file. 
+ * 
+ * @copyright Copyright (c) 2020
+ */
+
+#include <cmath>
+#include "MeasurementPlugin.hpp"
+#include "SpinParser.hpp"
+#include "FrgCore.hpp"
+#include "SU2/SU2EffectiveAction.hpp"
+
+class VertexMaximum : public Measurement
+{
+public:
+	VertexMaximum(const MeasurementPlugin::Specification &specification) : Measurement(specification.output, specification.minCutoff, specification.maxCutoff, specification.defer, true), _group("VertexMaximum"), _currentCutoff(-1.0f)
+	{
+		for (auto o : specification.options)
+		{
+			if (o.first == "group") _group = o.second;
+		}
+
+		//one value per frequency triplet; the effective action does not exist yet during construction
+		int n = FrgCommon::frequency().size;
+		_size = n * n * (n + 1) / 2;
+		_maximum = new float[_size];
+
+		//set up loadManager
+		HMP::StackIdentifier dataStack0 = SpinParser::spinParser()->getLoadManager()->addMasterStackExplicit<float>(
+			&_currentCutoff,
+			1,
+			[](int linearIterator)->float { return SpinParser::spinParser()->getFrgCore()->flowingFunctional()->cutoff; },
+			1,
+			1,
+			true
+		);
+		HMP::StackIdentifier dataStack1 = SpinParser::spinParser()->getLoadManager()->addMasterStackExplicit<float>(
+			_maximum,
+			_size,
+			[](int x)->float
+			{
+				const SU2VertexTwoParticle *v4 = _state()->vertexTwoParticle;
+				float maximum = 0.0f;
+				for (int rid = 0; rid < FrgCommon::lattice().size; ++rid)
+				{
+					int i = x * FrgCommon::lattice().size + rid;
+					maximum = std::max(maximum, sqrtf(v4->_dataSS[i] * v4->_dataSS[i] + v4->_dataDD[i] * v4->_dataDD[i]));
+				}
+				return maximum;
+			}
+		);
+		_loadManagedStacks.insert(_loadManagedStacks.end(), { dataStack0, dataStack1 });
+	}
+
+	~VertexMaximum()
+	{
+		delete[] _maximum;
+	}
+
+	void takeMeasurement(const EffectiveAction &state, const bool isMasterTask) const override
+	{
+		if (!isCalculated(state)) SpinParser::spinParser()->getLoadManager()->calculate(_loadManagedStacks.data(), int(_loadManagedStacks.size()));
+		if (isMasterTask) _writeOutfileData(_group, state.cutoff, _maximum, { _size });
+	}
+
+	std::vector<Observable> observableBuffers() const override
+	{
+		return { { _group, _maximum, _size } };
+	}
+
+	bool isCalculated(const EffectiveAction &state) const override
+	{
+		return _currentCutoff == state.cutoff;
+	}
+
+private:
+	//read-only view of the flowing effective action
+	static const SU2EffectiveAction *_state()
+	{
+		return static_cast<const SU2EffectiveAction *>(SpinParser::spinParser()->getFrgCore()->flowingFunctional());
+	}
+
+	std::string _group; ///< Name of the observable group in the output file. 
+	float _currentCutoff; ///< Cutoff at which the maxima have been computed. 
+	float *_maximum; ///< Largest vertex magnitude at every frequency triplet. 
+	int _size; ///< Number of frequency triplets. 
+};
+
+Measurement *newVertexMaximum(const MeasurementPlugin::Specification &specification)
+{
+	if (specification.symmetry != "SU2") return nullptr;
+	return new VertexMaximum(specification);
+}
+
+SPINPARSER_MEASUREMENT_PLUGIN(newVertexMaximum)
@@ -0,0 +1,53 @@
+#set up pythonpath and import modules
+import sys
+import types
+pythonpath = sys.argv[1]
+sys.path.append(pythonpath)
+
+#spinparser.ldf imports matplotlib for plotting, which is not required to read ldf files
+try:
+    import matplotlib
+except ImportError:
+    for module in ["matplotlib", "matplotlib.pyplot", "matplotlib.patches", "mpl_toolkits", "mpl_toolkits.mplot3d"]:
+        sys.modules[module] = types.ModuleType(module)
+    sys.modules["matplotlib.patches"].FancyArrowPatch = object
+    sys.modules["mpl_toolkits.mplot3d"].proj3d = None
+
+import numpy as np
+import spinparser.ldf as l
+
+#read arguments: ldf file, bond length, and interaction lengths
+file = sys.argv[2]
+bondLength = float(sys.argv[3])
+interactionLengths = [float(d) for d in sys.argv[4:]]
+
+#read both formats
+sites, bonds, interactions = l.read(file)
+sitesBinary, bondsBinary, interactionsBinary = l.read(file + ".h5")
+
+#run tests
+##test that both formats agree
+(len(sites) == len(sitesBinary) and all(s["id"] == t["id"] and s["parametrized"] == t["parametrized"] and np.isclose([s["x"], s["y"], s["z"]], [t["x"], t["y"], t["z"]], atol=1e-5).all() for s, t in zip(sites, sitesBinary))) or sys.exit("Test sites failed.")
+bonds == bondsBinary or sys.exit("Test bonds failed.")
+(len(interactions) == len(interactionsBinary) and all(i["from"] == j["from"] and i["to"] == j["to"] and np.isclose(i["value"], j["value"], atol=1e-5).all() for i, j in zip(interactions, interactionsBinary))) or sys.exit("Test interactions failed.")
+print("Test binary format passed.")
+
+##test that bonds and interactions connect all pairs of sites at the expected distances, by comparison to a search over all pairs of sites
+positions = np.array([[s["x"], s["y"], s["z"]] for s in sites])
+ids = np.array([s["id"] for s in sites])
+distances = np.linalg.norm(positions[:, None, :] - positions[None, :, :], axis=2)
+def pairsAtDistance(lengths):
+    pairs = set()
+    for d in lengths:
+        for n1, n2 in zip(*np.where(np.isclose(distances, d, atol=1e-4))):
+            if n1 < n2: pairs.add((ids[n1], ids[n2]))
+    return pairs
+def unorderedPairs(connections):
+    pairs = [tuple(sorted((c["from"], c["to"]))) for c in connections]
+    len(pairs) == len(set(pairs)) or sys.exit("Test duplicate connections failed.")
+    return set(pairs)
+
+unorderedPairs(bonds) == pairsAtDistance([bondLength]) or sys.exit("Test bond search failed.")
+print("Test bond search passed.")
+unorderedPairs(interactions) == pairsAtDistance(interactionLengths) or sys.exit("Test interaction search failed.")
+print("Test interaction search passed.")
@@ -0,0 +1,32 @@
+import sys
+import h5py
+import numpy as np
+
+len(sys.argv) == 5 or sys.exit("Usage: test_plugin_eval.py obsfile pluginobject referenceobject frequencies")
+
+#read measurements in the order of their identifiers
+def readMeasurements(filename, identifier):
+    with h5py.File(filename, "r") as f:
+        measurements = sorted(f[identifier + "/data"].keys(), key=lambda x:int(x.split("_")[1]))
+        cutoffs = np.array([ f[identifier + "/data/" + m].attrs["cutoff"][0] for m in measurements ])
+        data = [ f[identifier + "/data/" + m + "/data"][:] for m in measurements ]
+    return cutoffs, data
+
+pluginCutoffs, pluginData = readMeasurements(sys.argv[1], sys.argv[2])
+referenceCutoffs, referenceData = readMeasurements(sys.argv[1], sys.argv[3])
+n = int(sys.argv[4])
+
+#the plugin is invoked at the same cutoff steps as the built-in measurement
+np.array_equal(pluginCutoffs, referenceCutoffs) or sys.exit("Plugin measurements do not match the cutoff steps of the built-in measurements.")
+
+#one value per frequency triplet
+for c, d in zip(pluginCutoffs, pluginData):
+    d.shape == (n * n * (n + 1) // 2,) or sys.exit("Invalid shape of plugin measurement at cutoff %f." % c)
+    np.all(np.isfinite(d)) and np.all(d >= 0.0) or sys.exit("Invalid plugin measurement at cutoff %f." % c)
+
+#the bare vertex is finite at every frequency, and the vertex grows during the flow
+np.min(pluginData[0]) > 0.0 or sys.exit("Plugin did not measure the vertex.")
+np.max(pluginData[-1]) > np.max(pluginData[0]) or sys.exit("Plugin measurement did not follow the flow.")
+
+#success
+sys.exit(0)
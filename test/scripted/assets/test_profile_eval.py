@@ -0,0 +1,44 @@
+import sys
+import h5py
+import numpy as np
+
+len(sys.argv) == 3 or sys.exit("Usage: test_profile_eval.py profilefile interval")
+interval = int(sys.argv[2])
+
+with h5py.File(sys.argv[1], "r") as f:
+    shells = f["meta/shells"][:]
+    frequencies = f["meta/frequencies"][:]
+    count = f["meta/count"][:]
+    profiles = sorted(f["data"].keys(), key=lambda x:int(x.split("_")[1]))
+    cutoffs = np.array([ f["data/" + p].attrs["cutoff"][0] for p in profiles ])
+    vertex = [ f["data/" + p + "/vertex"][:] for p in profiles ]
+    flow = [ f["data/" + p + "/flow"][:] for p in profiles ]
+    time = [ f["data/" + p + "/time"][:] for p in profiles ]
+
+#distance shells start at the reference site and are sorted
+shells[0] == 0.0 or sys.exit("First distance shell is not the reference site.")
+np.all(np.diff(shells) > 0) or sys.exit("Distance shells are not sorted.")
+count.shape == (len(shells), len(frequencies)) or sys.exit("Invalid block layout.")
+
+#every frequency region r contains all triplets (s,t,u) with u <= s and max(s,t) = r
+triplets = np.array([ (r + 1) ** 2 * (r + 2) // 2 - r ** 2 * (r + 1) // 2 for r in range(len(frequencies)) ])
+sites = np.sum(count, axis=0) / triplets
+np.allclose(sites, sites[0]) or sys.exit("Invalid number of vertex entries per frequency region.")
+np.sum(count[0]) == np.sum(triplets) or sys.exit("Invalid number of vertex entries in the local shell.")
+
+#profiles are taken at every interval-th cutoff step
+len(profiles) > 1 or sys.exit("Not enough profiles have been written.")
+cutoffs[0] == 10.0 or sys.exit("First profile is not taken at the first cutoff.")
+np.allclose(cutoffs[1:] / cutoffs[:-1], 0.9 ** interval, rtol=1e-4) or sys.exit("Profiles are not taken at the specified interval.")
+
+#profiled quantities
+for v, d, t in zip(vertex, flow, time):
+    v.shape == count.shape or sys.exit("Invalid vertex profile.")
+    d.shape == count.shape or sys.exit("Invalid flow profile.")
+    np.all(v >= 0) and np.all(d >= 0) or sys.exit("Negative magnitude found.")
+    np.sum(d) > 0 or sys.exit("Flow profile is empty.")
+    np.all(t >= 0) and np.sum(t) > 0 or sys.exit("Invalid compute time profile.")
+np.sum(vertex[-1]) > 0 or sys.exit("Vertex profile is empty.")
+
+#success
+sys.exit(0)
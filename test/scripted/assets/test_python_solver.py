@@ -0,0 +1,62 @@
+#set up pythonpath and import modules
+import sys
+len(sys.argv) == 6 or sys.exit("Usage: test_python_solver.py pythonpath library resourcepath referencefile taskfile")
+sys.path.append(sys.argv[1])
+
+import h5py
+import numpy as np
+import spinparser.solver as s
+
+library = sys.argv[2]
+resourcePath = sys.argv[3]
+referenceFile = sys.argv[4]
+taskFile = sys.argv[5]
+
+#read reference measurements in the order of their identifiers
+def readMeasurements(filename, identifier):
+    with h5py.File(filename, "r") as f:
+        measurements = sorted(f[identifier + "/data"].keys(), key=lambda x:int(x.split("_")[1]))
+        cutoffs = np.array([ f[identifier + "/data/" + m].attrs["cutoff"][0] for m in measurements ])
+        data = [ f[identifier + "/data/" + m + "/data"][:].flatten() for m in measurements ]
+    return cutoffs, data
+
+referenceCutoffs, referenceData = readMeasurements(referenceFile, "XYZCorZZ")
+
+##test stepping and in-memory observables
+with s.Solver(taskFile, "-f", "-r", resourcePath, library=library) as solver:
+    #only a single solver may exist at any time
+    try:
+        s.Solver(taskFile, "-f", "-r", resourcePath, library=library)
+        sys.exit("Test single solver failed.")
+    except RuntimeError:
+        pass
+
+    n = 0
+    buffer = None
+    while True:
+        cutoff = solver.cutoff
+        running = solver.step()
+        if not running:
+            break
+        observables = solver.observables()
+        sorted(observables.keys()) == [ "XYZCorDD", "XYZCorXX", "XYZCorYY", "XYZCorZZ" ] or sys.exit("Test observable identifiers failed.")
+        cutoff == referenceCutoffs[n] or sys.exit("Test cutoff failed at step %d." % n)
+        np.allclose(observables["XYZCorZZ"], referenceData[n], atol=1e-6) or sys.exit("Test observables failed at cutoff %f." % cutoff)
+
+        #observables share memory with the solver
+        if buffer is None:
+            buffer = observables["XYZCorZZ"]
+        np.array_equal(buffer, observables["XYZCorZZ"]) or sys.exit("Test zero-copy observables failed.")
+        n += 1
+    solver.finished or sys.exit("Test finished failed.")
+    np.allclose(solver.observables()["XYZCorZZ"], referenceData[-1], atol=1e-6) or sys.exit("Test final observables failed.")
+print("Test stepping passed.")
+
+##test that a released solver can be followed by a new one
+with s.Solver(taskFile, "-f", "-r", resourcePath, library=library) as solver:
+    solver.run()
+    np.allclose(solver.observables()["XYZCorZZ"], referenceData[-1], atol=1e-6) or sys.exit("Test repeated solver failed.")
+print("Test repeated solver passed.")
+
+#success
+sys.exit(0)
@@ -0,0 +1,27 @@
+import sys
+import h5py
+import numpy as np
+
+len(sys.argv) == 4 or sys.exit("Usage: test_range_eval.py fullfile grownfile object")
+
+#read measurements in the order of their identifiers
+def readMeasurements(filename, identifier):
+    with h5py.File(filename, "r") as f:
+        measurements = sorted(f[identifier + "/data"].keys(), key=lambda x:int(x.split("_")[1]))
+        cutoffs = np.array([ f[identifier + "/data/" + m].attrs["cutoff"][0] for m in measurements ])
+        data = [ f[identifier + "/data/" + m + "/data"][:] for m in measurements ]
+    return cutoffs, data
+
+fullCutoffs, fullData = readMeasurements(sys.argv[1], sys.argv[3])
+grownCutoffs, grownData = readMeasurements(sys.argv[2], sys.argv[3])
+
+#both calculations measure at the same cutoffs
+np.array_equal(fullCutoffs, grownCutoffs) or sys.exit("Cutoffs differ.")
+
+#correlations of the grown calculation agree with the full calculation within a relative tolerance
+for c, f, g in zip(fullCutoffs, fullData, grownData):
+    eps = np.max(np.abs(f - g))
+    eps <= 0.02 * np.max(np.abs(f)) + 1e-5 or sys.exit("Deviation found at cutoff %f (deviation: %f)." % (c, eps))
+
+#success
+sys.exit(0)
@@ -0,0 +1,31 @@
+import sys
+import h5py
+import numpy as np
+
+len(sys.argv) == 4 or sys.exit("Usage: test_refinement_eval.py coarsefile refinedfile object")
+
+#read measurements in the order of their identifiers
+def readMeasurements(filename, identifier):
+    with h5py.File(filename, "r") as f:
+        measurements = sorted(f[identifier + "/data"].keys(), key=lambda x:int(x.split("_")[1]))
+        cutoffs = np.array([ f[identifier + "/data/" + m].attrs["cutoff"][0] for m in measurements ])
+        data = [ f[identifier + "/data/" + m + "/data"][:] for m in measurements ]
+    return cutoffs, data
+
+coarseCutoffs, coarseData = readMeasurements(sys.argv[1], sys.argv[3])
+refinedCutoffs, refinedData = readMeasurements(sys.argv[2], sys.argv[3])
+
+#the refinement pass adds measurements
+len(refinedCutoffs) > len(coarseCutoffs) or sys.exit("Refinement pass did not add any measurements.")
+
+#measurements are sorted by descending cutoff
+np.all(np.diff(refinedCutoffs) < 0) or sys.exit("Measurements are not sorted by descending cutoff.")
+
+#measurements of the coarse pass are retained
+for c, d in zip(coarseCutoffs, coarseData):
+    i = np.where(refinedCutoffs == c)[0]
+    len(i) == 1 or sys.exit("Cutoff %f of the coarse pass is missing." % c)
+    np.max(np.abs(refinedData[i[0]] - d)) < 1e-5 or sys.exit("Deviation found at cutoff %f." % c)
+
+#success
+sys.exit(0)
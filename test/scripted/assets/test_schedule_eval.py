@@ -0,0 +1,36 @@
+import sys
+import h5py
+import numpy as np
+
+len(sys.argv) == 5 or sys.exit("Usage: test_schedule_eval.py fullfile scheduledfile object guaranteedcutoff")
+
+#read measurements in the order of their identifiers
+def readMeasurements(filename, identifier):
+    with h5py.File(filename, "r") as f:
+        measurements = sorted(f[identifier + "/data"].keys(), key=lambda x:int(x.split("_")[1]))
+        cutoffs = np.array([ f[identifier + "/data/" + m].attrs["cutoff"][0] for m in measurements ])
+        data = [ f[identifier + "/data/" + m + "/data"][:] for m in measurements ]
+    return cutoffs, data
+
+fullCutoffs, fullData = readMeasurements(sys.argv[1], sys.argv[3])
+scheduledCutoffs, scheduledData = readMeasurements(sys.argv[2], sys.argv[3])
+guaranteedCutoff = float(sys.argv[4])
+
+#the schedule skips measurements
+len(scheduledCutoffs) < len(fullCutoffs) or sys.exit("Schedule did not skip any measurements.")
+
+#first and last cutoff are always measured
+scheduledCutoffs[0] == fullCutoffs[0] or sys.exit("First cutoff has not been measured.")
+scheduledCutoffs[-1] == fullCutoffs[-1] or sys.exit("Last cutoff has not been measured.")
+
+#guaranteed cutoff is measured at the first step which reaches it
+np.max(fullCutoffs[fullCutoffs <= guaranteedCutoff]) in scheduledCutoffs or sys.exit("Guaranteed cutoff has not been measured.")
+
+#scheduled measurements agree with the full measurements
+for c, d in zip(scheduledCutoffs, scheduledData):
+    i = np.where(fullCutoffs == c)[0]
+    len(i) == 1 or sys.exit("Cutoff %f is not part of the cutoff discretization." % c)
+    np.max(np.abs(fullData[i[0]] - d)) < 1e-5 or sys.exit("Deviation found at cutoff %f." % c)
+
+#success
+sys.exit(0)
@@ -0,0 +1,39 @@
+import sys
+import h5py
+import numpy as np
+
+len(sys.argv) == 4 or sys.exit("Usage: test_spin_symmetry_eval.py permutationfile rotationfile object")
+
+#read measurements in the order of their identifiers, together with the site positions
+def readMeasurements(filename, identifier):
+    with h5py.File(filename, "r") as f:
+        measurements = sorted(f[identifier + "/data"].keys(), key=lambda x:int(x.split("_")[1]))
+        cutoffs = np.array([ f[identifier + "/data/" + m].attrs["cutoff"][0] for m in measurements ])
+        data = [ f[identifier + "/data/" + m + "/data"][:] for m in measurements ]
+        sites = f[identifier + "/meta/sites"][:]
+    return cutoffs, data, sites
+
+permutationCutoffs, permutationData, permutationSites = readMeasurements(sys.argv[1], sys.argv[3])
+rotationCutoffs, rotationData, rotationSites = readMeasurements(sys.argv[2], sys.argv[3])
+
+#both calculations measure at the same cutoffs
+np.array_equal(permutationCutoffs, rotationCutoffs) or sys.exit("Cutoffs differ.")
+
+#the order of lattice sites depends on the symmetry reduction, so sites are matched by their position
+permutationSites.shape == rotationSites.shape or sys.exit("Number of lattice sites differs.")
+order = []
+for b in range(permutationSites.shape[0]):
+    indices = []
+    for s in rotationSites[b]:
+        index = np.where(np.max(np.abs(permutationSites[b] - s), axis=1) < 1e-4)[0]
+        len(index) == 1 or sys.exit("Lattice site %s could not be matched." % str(s))
+        indices.append(index[0])
+    order.append(indices)
+
+#correlations agree within a relative tolerance
+for c, p, r in zip(permutationCutoffs, permutationData, rotationData):
+    eps = max([ np.max(np.abs(p[b][order[b]] - r[b])) for b in range(len(order)) ])
+    eps <= 1e-3 * np.max(np.abs(p)) + 1e-5 or sys.exit("Deviation found at cutoff %f (deviation: %f)." % (c, eps))
+
+#success
+sys.exit(0)
@@ -0,0 +1,66 @@
+#!/usr/bin/env bash
+TEST_NAME=test_autoFrequency
+
+#before running this script, set the following environment variables:
+# TEST_WORK_DIR [working directory to generate temporary output files]
+[ -z "${TEST_WORK_DIR}" ] && { echo "environment variable TEST_WORK_DIR not defined"; exit 1; }
+# TEST_SCRIPT_DIR [directory where test scripts are stored]
+[ -z "${TEST_SCRIPT_DIR}" ] && { echo "environment variable TEST_SCRIPT_DIR not defined"; exit 1; }
+# TEST_EXECUTABLE [path to the executable to generate output]
+[ -z "${TEST_EXECUTABLE}" ] && { echo "environment variable TEST_EXECUTABLE not defined"; exit 1; }
+
+#init variables
+TEST_EVAL="python ${TEST_SCRIPT_DIR}/assets/test_eval.py"
+
+#write task file
+cat > ${TEST_WORK_DIR}/${TEST_NAME}.auto.xml <<- EOM
+<?xml version="1.0" encoding="utf-8"?>
+<task>
+    <parameters>
+        <frequency discretization="auto">
+            <min>0.05</min>
+            <max>50</max>
+            <count>10</count>
+            <pilotRange>1</pilotRange>
+        </frequency>
+        <cutoff discretization="exponential">
+            <max>10</max>
+            <min>0.5</min>
+            <step>0.9</step>
+        </cutoff>
+        <lattice name="square" range="3"/>
+        <model name="square-heisenberg" symmetry="SU2">
+            <j>1.0</j>
+        </model>
+    </parameters>
+    <measurements>
+        <measurement name="correlation" />
+    </measurements>
+</task>
+EOM
+
+function cleanup {
+    for MODE in auto reuse ; do 
+        for EXT in xml obs ldf checkpoint data ; do
+            rm -f ${TEST_WORK_DIR}/${TEST_NAME}.${MODE}.${EXT}
+        done
+    done
+}
+
+#run executable with automatic discretization
+trap 'cleanup ; exit 1' ERR
+${TEST_EXECUTABLE} -f ${TEST_WORK_DIR}/${TEST_NAME}.auto.xml
+
+#the generated discretization is stored in the task file
+grep -q 'discretization="manual"' ${TEST_WORK_DIR}/${TEST_NAME}.auto.xml
+[ $(grep -o '<value>' ${TEST_WORK_DIR}/${TEST_NAME}.auto.xml | wc -l) -eq 10 ]
+
+#rerun the generated task file and reproduce the result
+cp ${TEST_WORK_DIR}/${TEST_NAME}.auto.xml ${TEST_WORK_DIR}/${TEST_NAME}.reuse.xml
+${TEST_EXECUTABLE} -f ${TEST_WORK_DIR}/${TEST_NAME}.reuse.xml
+for COMPONENT in DD ZZ ; do
+    ${TEST_EVAL} OBJECT ${TEST_WORK_DIR}/${TEST_NAME}.auto.obs SU2Cor${COMPONENT} ${TEST_WORK_DIR}/${TEST_NAME}.reuse.obs SU2Cor${COMPONENT}
+done
+
+#cleanup
+cleanup
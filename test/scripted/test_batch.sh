@@ -0,0 +1,89 @@
+#!/usr/bin/env bash
+TEST_NAME=test_batch
+
+#before running this script, set the following environment variables:
+# TEST_WORK_DIR [working directory to generate temporary output files]
+[ -z "${TEST_WORK_DIR}" ] && { echo "environment variable TEST_WORK_DIR not defined"; exit 1; }
+# TEST_SCRIPT_DIR [directory where test scripts are stored]
+[ -z "${TEST_SCRIPT_DIR}" ] && { echo "environment variable TEST_SCRIPT_DIR not defined"; exit 1; }
+# TEST_EXECUTABLE [path to the executable to generate output]
+[ -z "${TEST_EXECUTABLE}" ] && { echo "environment variable TEST_EXECUTABLE not defined"; exit 1; }
+
+#init variables
+TEST_EVAL="python ${TEST_SCRIPT_DIR}/assets/test_eval.py"
+
+#write task files
+for CORE in SU2 XYZ ; do 
+    for MODE in SINGLE BATCH ; do 
+        if [ ${MODE} == BATCH ] ; then 
+            MEASUREMENTS="<measurement name=\"correlation\" output=\"${TEST_NAME}.${CORE}.BATCH.a.obs\" />
+        <measurement name=\"correlation\" output=\"${TEST_NAME}.${CORE}.BATCH.b.obs\" method=\"defer\" />
+        <measurement name=\"correlation\" output=\"${TEST_NAME}.${CORE}.BATCH.c.obs\" method=\"defer\" />"
+        else
+            MEASUREMENTS="<measurement name=\"correlation\" />"
+        fi
+        cat > ${TEST_WORK_DIR}/${TEST_NAME}.${CORE}.${MODE}.xml <<- EOM
+<?xml version="1.0" encoding="utf-8"?>
+<task>
+    <parameters>
+        <frequency discretization="manual">
+            <value>0.31812</value>
+            <value>0.36329</value>
+            <value>0.41812</value>
+            <value>0.46329</value>
+            <value>0.51334</value>
+            <value>0.56880</value>
+            <value>0.63024</value>
+            <value>0.69833</value>
+            <value>0.77378</value>
+            <value>0.85737</value>
+            <value>0.95</value>
+            <value>1.0</value>
+            <value>3.0</value>
+            <value>10.0</value>
+        </frequency>
+        <cutoff discretization="exponential">
+            <max>10</max>
+            <min>0.3</min>
+            <step>0.9</step>
+        </cutoff>
+        <lattice name="square" range="3"/>
+        <model name="square-heisenberg" symmetry="${CORE}">
+            <j>1.0</j>
+        </model>
+    </parameters>
+    <measurements>
+        ${MEASUREMENTS}
+    </measurements>
+</task>
+EOM
+    done
+done
+
+function cleanup {
+    for CORE in SU2 XYZ ; do
+        for MODE in SINGLE BATCH ; do 
+            for EXT in xml obs ldf checkpoint data a.obs b.obs c.obs ; do
+                rm -f ${TEST_WORK_DIR}/${TEST_NAME}.${CORE}.${MODE}.${EXT}
+            done
+        done
+    done
+}
+
+#run executable; the batch calculation takes the deferred measurements in the postprocessing phase
+for CORE in SU2 XYZ ; do 
+    ${TEST_EXECUTABLE} -f ${TEST_WORK_DIR}/${TEST_NAME}.${CORE}.SINGLE.xml
+    ${TEST_EXECUTABLE} -f ${TEST_WORK_DIR}/${TEST_NAME}.${CORE}.BATCH.xml
+    ${TEST_EXECUTABLE} ${TEST_WORK_DIR}/${TEST_NAME}.${CORE}.BATCH.xml
+done
+
+#evaluate test
+trap 'cleanup ; exit 1' ERR
+for CORE in SU2 XYZ ; do 
+    for OUTPUT in a b c ; do
+        ${TEST_EVAL} FILE ${TEST_WORK_DIR}/${TEST_NAME}.${CORE}.SINGLE.obs ${TEST_WORK_DIR}/${TEST_NAME}.${CORE}.BATCH.${OUTPUT}.obs
+    done
+done
+
+#cleanup
+cleanup
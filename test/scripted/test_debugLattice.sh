@@ -0,0 +1,67 @@
+#!/usr/bin/env bash
+TEST_NAME=test_debugLattice
+
+#before running this script, set the following environment variables:
+# TEST_ROOT_DIR [root directory of the project]
+[ -z "${TEST_ROOT_DIR}" ] && { echo "environment variable TEST_ROOT_DIR not defined"; exit 1; }
+# TEST_WORK_DIR [working directory to generate temporary output files]
+[ -z "${TEST_WORK_DIR}" ] && { echo "environment variable TEST_WORK_DIR not defined"; exit 1; }
+# TEST_SCRIPT_DIR [directory where test scripts are stored]
+[ -z "${TEST_SCRIPT_DIR}" ] && { echo "environment variable TEST_SCRIPT_DIR not defined"; exit 1; }
+# TEST_EXECUTABLE [path to the executable to generate output]
+[ -z "${TEST_EXECUTABLE}" ] && { echo "environment variable TEST_EXECUTABLE not defined"; exit 1; }
+
+#init variables
+TEST_PYTHONPATH="${TEST_ROOT_DIR}/opt/python"
+TEST_EVAL="python ${TEST_SCRIPT_DIR}/assets/test_debug_lattice_eval.py ${TEST_PYTHONPATH}"
+
+#write task files; the lattice, model, and model parameters are passed as arguments
+function writeTask {
+cat > ${TEST_WORK_DIR}/${TEST_NAME}.$2.xml <<- EOM
+<?xml version="1.0" encoding="utf-8"?>
+<task>
+    <parameters>
+        <frequency discretization="exponential">
+            <min>0.005</min>
+            <max>50.0</max>
+            <count>8</count>
+        </frequency>
+        <cutoff discretization="exponential">
+            <max>50</max>
+            <min>0.3</min>
+            <step>0.95</step>
+        </cutoff>
+        <lattice name="$1" range="4"/>
+        <model name="$2" symmetry="XYZ">
+            $3
+        </model>
+    </parameters>
+    <measurements>
+        <measurement name="correlation" />
+    </measurements>
+</task>
+EOM
+}
+writeTask cubic cubic-j1j2heisenberg "<j1>1.0</j1><j2>0.5</j2>"
+writeTask honeycomb honeycomb-kitaev "<j>0.5</j><k>1.0</k>"
+
+function cleanup {
+    for MODEL in cubic-j1j2heisenberg honeycomb-kitaev ; do
+        for EXT in xml ldf ldf.h5 ; do
+            rm -f ${TEST_WORK_DIR}/${TEST_NAME}.${MODEL}.${EXT}
+        done
+    done
+}
+
+#run executable
+trap 'cleanup ; exit 1' ERR
+for MODEL in cubic-j1j2heisenberg honeycomb-kitaev ; do
+    ${TEST_EXECUTABLE} --debugLattice ${TEST_WORK_DIR}/${TEST_NAME}.${MODEL}.xml
+done
+
+#evaluate test; bonds connect nearest neighbors, interactions connect sites at the specified distances
+${TEST_EVAL} ${TEST_WORK_DIR}/${TEST_NAME}.cubic-j1j2heisenberg.ldf 1.0 1.0 1.4142136
+${TEST_EVAL} ${TEST_WORK_DIR}/${TEST_NAME}.honeycomb-kitaev.ldf 1.0 1.0
+
+#cleanup
+cleanup
@@ -0,0 +1,86 @@
+#!/usr/bin/env bash
+TEST_NAME=test_plugin
+
+#before running this script, set the following environment variables:
+# TEST_WORK_DIR [working directory to generate temporary output files]
+[ -z "${TEST_WORK_DIR}" ] && { echo "environment variable TEST_WORK_DIR not defined"; exit 1; }
+# TEST_SCRIPT_DIR [directory where test scripts are stored]
+[ -z "${TEST_SCRIPT_DIR}" ] && { echo "environment variable TEST_SCRIPT_DIR not defined"; exit 1; }
+# TEST_EXECUTABLE [path to the executable to generate output]
+[ -z "${TEST_EXECUTABLE}" ] && { echo "environment variable TEST_EXECUTABLE not defined"; exit 1; }
+# TEST_PLUGIN [path to the example measurement plugin]
+[ -z "${TEST_PLUGIN}" ] && { echo "environment variable TEST_PLUGIN not defined"; exit 1; }
+
+#init variables
+TEST_EVAL="python ${TEST_SCRIPT_DIR}/assets/test_plugin_eval.py"
+
+#write task files
+for MODE in valid invalid ; do 
+    if [ ${MODE} == valid ] ; then
+        LIBRARY=${TEST_PLUGIN}
+    else
+        LIBRARY=${TEST_WORK_DIR}/${TEST_NAME}.missing.so
+    fi
+    cat > ${TEST_WORK_DIR}/${TEST_NAME}.${MODE}.xml <<- EOM
+<?xml version="1.0" encoding="utf-8"?>
+<task>
+    <parameters>
+        <frequency discretization="manual">
+            <value>0.31812</value>
+            <value>0.36329</value>
+            <value>0.41812</value>
+            <value>0.46329</value>
+            <value>0.51334</value>
+            <value>0.56880</value>
+            <value>0.63024</value>
+            <value>0.69833</value>
+            <value>0.77378</value>
+            <value>0.85737</value>
+            <value>0.95</value>
+            <value>1.0</value>
+            <value>3.0</value>
+            <value>10.0</value>
+        </frequency>
+        <cutoff discretization="exponential">
+            <max>10</max>
+            <min>1.0</min>
+            <step>0.9</step>
+        </cutoff>
+        <lattice name="square" range="3"/>
+        <model name="square-heisenberg" symmetry="SU2">
+            <j>1.0</j>
+        </model>
+    </parameters>
+    <measurements>
+        <measurement name="correlation"/>
+        <measurement name="plugin" library="${LIBRARY}">
+            <group>PluginVertexMaximum</group>
+        </measurement>
+    </measurements>
+</task>
+EOM
+done
+
+function cleanup {
+    for MODE in valid invalid ; do 
+        for EXT in xml obs ldf checkpoint data ; do
+            rm -f ${TEST_WORK_DIR}/${TEST_NAME}.${MODE}.${EXT}
+        done
+    done
+}
+
+#run executable
+trap 'cleanup ; exit 1' ERR
+${TEST_EXECUTABLE} -f ${TEST_WORK_DIR}/${TEST_NAME}.valid.xml
+
+#missing plugin libraries are reported as an error
+if ${TEST_EXECUTABLE} -f ${TEST_WORK_DIR}/${TEST_NAME}.invalid.xml ; then
+    cleanup
+    exit 1
+fi
+
+#evaluate test
+${TEST_EVAL} ${TEST_WORK_DIR}/${TEST_NAME}.valid.obs PluginVertexMaximum SU2CorZZ 14
+
+#cleanup
+cleanup
@@ -0,0 +1,77 @@
+#!/usr/bin/env bash
+TEST_NAME=test_pythonSolver
+
+#before running this script, set the following environment variables:
+# TEST_ROOT_DIR [root directory of the SpinParser source]
+[ -z "${TEST_ROOT_DIR}" ] && { echo "environment variable TEST_ROOT_DIR not defined"; exit 1; }
+# TEST_WORK_DIR [working directory to generate temporary output files]
+[ -z "${TEST_WORK_DIR}" ] && { echo "environment variable TEST_WORK_DIR not defined"; exit 1; }
+# TEST_SCRIPT_DIR [directory where test scripts are stored]
+[ -z "${TEST_SCRIPT_DIR}" ] && { echo "environment variable TEST_SCRIPT_DIR not defined"; exit 1; }
+# TEST_EXECUTABLE [path to the executable to generate output]
+[ -z "${TEST_EXECUTABLE}" ] && { echo "environment variable TEST_EXECUTABLE not defined"; exit 1; }
+# TEST_LIBRARY [path to the shared library]
+[ -z "${TEST_LIBRARY}" ] && { echo "environment variable TEST_LIBRARY not defined"; exit 1; }
+
+#init variables
+TEST_PYTHONPATH="${TEST_ROOT_DIR}/opt/python"
+TEST_EVAL="python ${TEST_SCRIPT_DIR}/assets/test_python_solver.py ${TEST_PYTHONPATH} ${TEST_LIBRARY} ${TEST_ROOT_DIR}/res"
+
+#write task files
+for MODE in executable library ; do 
+    cat > ${TEST_WORK_DIR}/${TEST_NAME}.${MODE}.xml <<- EOM
+<?xml version="1.0" encoding="utf-8"?>
+<task>
+    <parameters>
+        <frequency discretization="manual">
+            <value>0.31812</value>
+            <value>0.36329</value>
+            <value>0.41812</value>
+            <value>0.46329</value>
+            <value>0.51334</value>
+            <value>0.56880</value>
+            <value>0.63024</value>
+            <value>0.69833</value>
+            <value>0.77378</value>
+            <value>0.85737</value>
+            <value>0.95</value>
+            <value>1.0</value>
+            <value>3.0</value>
+            <value>10.0</value>
+        </frequency>
+        <cutoff discretization="exponential">
+            <max>10</max>
+            <min>0.3</min>
+            <step>0.9</step>
+        </cutoff>
+        <lattice name="square" range="3"/>
+        <model name="square-xxz" symmetry="XYZ">
+            <jx>1.0</jx>
+            <jz>0.5</jz>
+        </model>
+    </parameters>
+    <measurements>
+        <measurement name="correlation" />
+    </measurements>
+</task>
+EOM
+done
+
+function cleanup {
+    for MODE in executable library ; do 
+        for EXT in xml obs ldf checkpoint data ; do
+            rm -f ${TEST_WORK_DIR}/${TEST_NAME}.${MODE}.${EXT}
+        done
+    done
+}
+
+#run executable
+${TEST_EXECUTABLE} -f ${TEST_WORK_DIR}/${TEST_NAME}.executable.xml
+
+#evaluate test
+trap 'cleanup ; exit 1' ERR
+${TEST_EVAL} ${TEST_WORK_DIR}/${TEST_NAME}.executable.obs ${TEST_WORK_DIR}/${TEST_NAME}.library.xml
+python ${TEST_SCRIPT_DIR}/assets/test_eval.py FILE ${TEST_WORK_DIR}/${TEST_NAME}.executable.obs ${TEST_WORK_DIR}/${TEST_NAME}.library.obs
+
+#cleanup
+cleanup
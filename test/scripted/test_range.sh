@@ -0,0 +1,80 @@
+#!/usr/bin/env bash
+TEST_NAME=test_range
+
+#before running this script, set the following environment variables:
+# TEST_WORK_DIR [working directory to generate temporary output files]
+[ -z "${TEST_WORK_DIR}" ] && { echo "environment variable TEST_WORK_DIR not defined"; exit 1; }
+# TEST_SCRIPT_DIR [directory where test scripts are stored]
+[ -z "${TEST_SCRIPT_DIR}" ] && { echo "environment variable TEST_SCRIPT_DIR not defined"; exit 1; }
+# TEST_EXECUTABLE [path to the executable to generate output]
+[ -z "${TEST_EXECUTABLE}" ] && { echo "environment variable TEST_EXECUTABLE not defined"; exit 1; }
+
+#init variables
+TEST_EVAL="python ${TEST_SCRIPT_DIR}/assets/test_range_eval.py"
+
+#write task files
+for MODE in full grown ; do 
+    if [ ${MODE} == grown ] ; then
+        RANGE='initialRange="2"'
+    else
+        RANGE=''
+    fi
+    cat > ${TEST_WORK_DIR}/${TEST_NAME}.${MODE}.xml <<- EOM
+<?xml version="1.0" encoding="utf-8"?>
+<task>
+    <parameters>
+        <frequency discretization="manual">
+            <value>0.31812</value>
+            <value>0.36329</value>
+            <value>0.41812</value>
+            <value>0.46329</value>
+            <value>0.51334</value>
+            <value>0.56880</value>
+            <value>0.63024</value>
+            <value>0.69833</value>
+            <value>0.77378</value>
+            <value>0.85737</value>
+            <value>0.95</value>
+            <value>1.0</value>
+            <value>3.0</value>
+            <value>10.0</value>
+        </frequency>
+        <cutoff discretization="exponential">
+            <max>10</max>
+            <min>0.3</min>
+            <step>0.9</step>
+        </cutoff>
+        <lattice name="square" range="4" ${RANGE}/>
+        <model name="square-heisenberg" symmetry="SU2">
+            <j>1.0</j>
+        </model>
+    </parameters>
+    <measurements>
+        <measurement name="correlation" />
+    </measurements>
+</task>
+EOM
+done
+
+function cleanup {
+    for MODE in full grown ; do 
+        for EXT in xml obs ldf checkpoint data log ; do
+            rm -f ${TEST_WORK_DIR}/${TEST_NAME}.${MODE}.${EXT}
+        done
+    done
+}
+
+#run executable
+for MODE in full grown ; do 
+    ${TEST_EXECUTABLE} -f ${TEST_WORK_DIR}/${TEST_NAME}.${MODE}.xml | tee ${TEST_WORK_DIR}/${TEST_NAME}.${MODE}.log
+done
+
+#evaluate test
+trap 'cleanup ; exit 1' ERR
+grep -q "Extended active lattice range to 4" ${TEST_WORK_DIR}/${TEST_NAME}.grown.log
+for COMPONENT in DD ZZ ; do
+    ${TEST_EVAL} ${TEST_WORK_DIR}/${TEST_NAME}.full.obs ${TEST_WORK_DIR}/${TEST_NAME}.grown.obs SU2Cor${COMPONENT}
+done
+
+#cleanup
+cleanup
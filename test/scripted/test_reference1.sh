@@ -14,7 +14,7 @@ TEST_EVAL="python ${TEST_SCRIPT_DIR}/assets/test_eval.py"
 TEST_REF_DIR="${TEST_SCRIPT_DIR}/assets"
 
 #write task files
-for CORE in SU2 XYZ TRI ; do 
+for CORE in SU2 XYZ TRI U1 ; do 
 cat > ${TEST_WORK_DIR}/${TEST_NAME}.${CORE}.xml <<- EOM
 <?xml version="1.0" encoding="utf-8"?>
 <task>
@@ -53,7 +53,7 @@ EOM
 done
 
 function cleanup {
-    for CORE in SU2 XYZ TRI ; do
+    for CORE in SU2 XYZ TRI U1 ; do
         for EXT in xml obs ldf checkpoint data ; do
             rm -f ${TEST_WORK_DIR}/${TEST_NAME}.${CORE}.${EXT}
         done
@@ -61,7 +61,7 @@ function cleanup {
 }
 
 #run executable
-for CORE in SU2 XYZ TRI ; do 
+for CORE in SU2 XYZ TRI U1 ; do 
     ${TEST_EXECUTABLE} -f ${TEST_WORK_DIR}/${TEST_NAME}.${CORE}.xml
 done
 
@@ -76,6 +76,9 @@ ${TEST_EVAL} OBJECT ${TEST_WORK_DIR}/${TEST_NAME}.SU2.obs SU2CorDD ${TEST_WORK_D
 ${TEST_EVAL} OBJECT ${TEST_WORK_DIR}/${TEST_NAME}.SU2.obs SU2CorZZ ${TEST_WORK_DIR}/${TEST_NAME}.TRI.obs TRICorXX
 ${TEST_EVAL} OBJECT ${TEST_WORK_DIR}/${TEST_NAME}.SU2.obs SU2CorZZ ${TEST_WORK_DIR}/${TEST_NAME}.TRI.obs TRICorYY
 ${TEST_EVAL} OBJECT ${TEST_WORK_DIR}/${TEST_NAME}.SU2.obs SU2CorZZ ${TEST_WORK_DIR}/${TEST_NAME}.TRI.obs TRICorZZ
+${TEST_EVAL} OBJECT ${TEST_WORK_DIR}/${TEST_NAME}.SU2.obs SU2CorDD ${TEST_WORK_DIR}/${TEST_NAME}.U1.obs U1CorDD
+${TEST_EVAL} OBJECT ${TEST_WORK_DIR}/${TEST_NAME}.SU2.obs SU2CorZZ ${TEST_WORK_DIR}/${TEST_NAME}.U1.obs U1CorXX
+${TEST_EVAL} OBJECT ${TEST_WORK_DIR}/${TEST_NAME}.SU2.obs SU2CorZZ ${TEST_WORK_DIR}/${TEST_NAME}.U1.obs U1CorZZ
 
 #cleanup
 cleanup
@@ -0,0 +1,129 @@
+#define BOOST_TEST_MODULE "EnergyMeterTest"
+#include <fstream>
+#include <boost/test/included/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include "EnergyMeter.hpp"
+
+#ifndef DISABLE_MPI
+#include "mpi.h"
+#endif
+
+struct MPIFixture
+{
+	MPIFixture()
+	{
+		#ifndef DISABLE_MPI
+		int argc = boost::unit_test::framework::master_test_suite().argc;
+		char **argv = boost::unit_test::framework::master_test_suite().argv;
+		MPI_Init(&argc, &argv);
+		#endif
+	}
+
+	~MPIFixture()
+	{
+		#ifndef DISABLE_MPI
+		MPI_Finalize();
+		#endif
+	}
+};
+
+BOOST_GLOBAL_FIXTURE(MPIFixture);
+
+struct EnergyMeterFixture
+{
+	EnergyMeterFixture()
+	{
+		//mock powercap tree with one package, its core and DRAM subdomains, and an mmio interface to the same package
+		powercapPath = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("powercap-%%%%-%%%%");
+		addDomain("intel-rapl:0", "package-0", 1000000);
+		addDomain("intel-rapl:0:0", "core", 1000000);
+		addDomain("intel-rapl:0:1", "dram", 1000000);
+		addDomain("intel-rapl-mmio:0", "package-0", 1000000);
+	}
+
+	~EnergyMeterFixture()
+	{
+		boost::filesystem::remove_all(powercapPath);
+	}
+
+	void addDomain(const std::string &directory, const std::string &name, const unsigned long long energy)
+	{
+		boost::filesystem::create_directories(powercapPath / directory);
+		std::ofstream(boost::filesystem::path(powercapPath / directory / "name").string()) << name << std::endl;
+		std::ofstream(boost::filesystem::path(powercapPath / directory / "max_energy_range_uj").string()) << 262143328850ull << std::endl;
+		setEnergy(directory, energy);
+	}
+
+	void setEnergy(const std::string &directory, const unsigned long long energy)
+	{
+		std::ofstream(boost::filesystem::path(powercapPath / directory / "energy_uj").string()) << energy << std::endl;
+	}
+
+	boost::filesystem::path powercapPath;
+};
+
+BOOST_FIXTURE_TEST_SUITE(EnergyMeterTest, EnergyMeterFixture);
+
+BOOST_AUTO_TEST_CASE(disabled)
+{
+	EnergyMeter meter;
+	BOOST_CHECK(!meter.isEnabled());
+
+	meter.beginPhase(EnergyMeter::Phase::Flow);
+	meter.endPhase();
+	meter.endStep(true);
+	BOOST_CHECK_EQUAL(meter.energy(EnergyMeter::Phase::Flow, EnergyMeter::Domain::Package), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(unavailable)
+{
+	EnergyMeter meter(true, (powercapPath / "missing").string());
+	BOOST_CHECK(!meter.isEnabled());
+}
+
+BOOST_AUTO_TEST_CASE(attributePhases)
+{
+	EnergyMeter meter(true, powercapPath.string());
+	BOOST_CHECK(meter.isEnabled());
+
+	meter.beginPhase(EnergyMeter::Phase::Flow);
+	setEnergy("intel-rapl:0", 3500000);
+	setEnergy("intel-rapl:0:0", 3000000);
+	setEnergy("intel-rapl:0:1", 1500000);
+	setEnergy("intel-rapl-mmio:0", 3500000);
+	meter.endPhase();
+
+	//energy in between phases is not attributed
+	setEnergy("intel-rapl:0", 4000000);
+
+	meter.beginPhase(EnergyMeter::Phase::Checkpoint);
+	setEnergy("intel-rapl:0", 4250000);
+	meter.endPhase();
+	meter.endStep(true);
+
+	BOOST_CHECK_CLOSE(meter.energy(EnergyMeter::Phase::Flow, EnergyMeter::Domain::Package), 2.5, 1e-9);
+	BOOST_CHECK_CLOSE(meter.energy(EnergyMeter::Phase::Flow, EnergyMeter::Domain::Dram), 0.5, 1e-9);
+	BOOST_CHECK_CLOSE(meter.energy(EnergyMeter::Phase::Checkpoint, EnergyMeter::Domain::Package), 0.25, 1e-9);
+	BOOST_CHECK_EQUAL(meter.energy(EnergyMeter::Phase::Measurement, EnergyMeter::Domain::Package), 0.0);
+
+	//energies accumulate across cutoff steps
+	meter.beginPhase(EnergyMeter::Phase::Flow);
+	setEnergy("intel-rapl:0", 5250000);
+	meter.endPhase();
+	meter.endStep(true);
+	BOOST_CHECK_CLOSE(meter.energy(EnergyMeter::Phase::Flow, EnergyMeter::Domain::Package), 3.5, 1e-9);
+	meter.report(true);
+}
+
+BOOST_AUTO_TEST_CASE(counterWrapAround)
+{
+	setEnergy("intel-rapl:0", 262143328850ull - 1000000);
+	EnergyMeter meter(true, powercapPath.string());
+
+	meter.beginPhase(EnergyMeter::Phase::Measurement);
+	setEnergy("intel-rapl:0", 2000000);
+	meter.endPhase();
+	BOOST_CHECK_CLOSE(meter.energy(EnergyMeter::Phase::Measurement, EnergyMeter::Domain::Package), 3.0, 1e-9);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
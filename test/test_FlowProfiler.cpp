@@ -0,0 +1,39 @@
+#define BOOST_TEST_MODULE "FlowProfilerTest"
+#include <boost/test/included/unit_test.hpp>
+#include <algorithm>
+#include "FlowProfiler.hpp"
+
+BOOST_AUTO_TEST_SUITE(FlowProfilerTest);
+
+BOOST_AUTO_TEST_CASE(frequencyRegion)
+{
+	//the linear frequency iterator is (s * (s + 1) / 2 + u) * n + t, where u <= s
+	int n = 7;
+	int iterator = 0;
+	for (int s = 0; s < n; ++s)
+	{
+		for (int u = 0; u <= s; ++u)
+		{
+			for (int t = 0; t < n; ++t)
+			{
+				BOOST_CHECK_EQUAL(iterator, (s * (s + 1) / 2 + u) * n + t);
+				BOOST_CHECK_EQUAL(FlowProfiler::frequencyRegion(iterator, n), std::max(s, t));
+				++iterator;
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(disabled)
+{
+	FlowProfiler p;
+	BOOST_CHECK(!p.isEnabled());
+	p.beginStep();
+	BOOST_CHECK(!p.isActive());
+
+	int calls = 0;
+	p.profile(0, [&]() { ++calls; });
+	BOOST_CHECK_EQUAL(calls, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
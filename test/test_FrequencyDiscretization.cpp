@@ -120,4 +120,63 @@ BOOST_AUTO_TEST_CASE(interpolateOffset)
 }
 
 
+BOOST_AUTO_TEST_CASE(interpolateOffsetMeshPoints)
+{
+	//mesh points are resolved as the lower end of an interpolation interval
+	int lowerOffset, upperOffset;
+	float bias;
+	for (int i = 0; i < 4; ++i)
+	{
+		f->interpolateOffset(float(i + 1), lowerOffset, upperOffset, bias);
+		BOOST_CHECK_EQUAL(lowerOffset, i);
+		BOOST_CHECK_EQUAL(upperOffset, (i == 0) ? 0 : i + 1);
+		BOOST_CHECK_EQUAL(bias, 0.0f);
+	}
+
+	f->interpolateOffset(5.0f, lowerOffset, upperOffset, bias);
+	BOOST_CHECK_EQUAL(lowerOffset, 4);
+	BOOST_CHECK_EQUAL(upperOffset, 4);
+
+	BOOST_CHECK_EQUAL(f->offset(2.5f), 2);
+	BOOST_CHECK_EQUAL(f->offset(10.0f), 4);
+}
+
+
+BOOST_AUTO_TEST_CASE(interpolateStencil)
+{
+	int offsets[4];
+	float weights[4];
+	f->interpolateStencil<2>(4.5f, offsets, weights);
+	BOOST_CHECK_EQUAL(offsets[0], 3);
+	BOOST_CHECK_EQUAL(offsets[1], 4);
+	BOOST_CHECK_CLOSE(weights[0], 0.5f, 0.0001);
+	BOOST_CHECK_CLOSE(weights[1], 0.5f, 0.0001);
+
+	//cubic interpolation on a non-uniform mesh is exact for quadratic polynomials on inner mesh intervals
+	FrequencyDiscretization g(std::vector<float>({ 0.5f, 1.0f, 2.0f, 3.5f, 4.0f, 6.0f }), FrequencyDiscretization::Interpolation::Cubic);
+	for (float w : { 1.0f, 1.3f, 2.0f, 2.7f, 3.2f, 3.5f, 3.9f })
+	{
+		g.interpolateStencil<4>(w, offsets, weights);
+		float value = 0.0f;
+		float norm = 0.0f;
+		for (int i = 0; i < 4; ++i)
+		{
+			value += weights[i] * g._data[offsets[i]] * g._data[offsets[i]];
+			norm += weights[i];
+		}
+		BOOST_CHECK_CLOSE(value, w * w, 0.001);
+		BOOST_CHECK_CLOSE(norm, 1.0f, 0.001);
+	}
+
+	//values outside the mesh are clamped to the boundary
+	g.interpolateStencil<4>(10.0f, offsets, weights);
+	float value = 0.0f;
+	for (int i = 0; i < 4; ++i) value += weights[i] * g._data[offsets[i]];
+	BOOST_CHECK_CLOSE(value, 6.0f, 0.001);
+	g.interpolateStencil<4>(0.1f, offsets, weights);
+	value = 0.0f;
+	for (int i = 0; i < 4; ++i) value += weights[i] * g._data[offsets[i]];
+	BOOST_CHECK_CLOSE(value, 0.5f, 0.001);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
@@ -0,0 +1,57 @@
+#define BOOST_TEST_MODULE "FrequencyOptimizerTest"
+#include <boost/test/included/unit_test.hpp>
+#include <cmath>
+#include "FrequencyOptimizer.hpp"
+
+BOOST_AUTO_TEST_SUITE(FrequencyOptimizerTest);
+
+BOOST_AUTO_TEST_CASE(curvature)
+{
+	//quadratic profile in the logarithm of the frequency has constant curvature
+	std::vector<float> frequencies({ 0.1f, 0.2f, 0.5f, 1.0f, 3.0f, 10.0f });
+	std::vector<float> profile;
+	for (float w : frequencies) profile.push_back(logf(w) * logf(w));
+	float norm = 0.0f;
+	for (float f : profile) norm = std::max(norm, f);
+
+	std::vector<float> c = FrequencyOptimizer::curvature(frequencies, { profile, std::vector<float>(frequencies.size(), 0.0f) });
+	BOOST_REQUIRE_EQUAL(c.size(), frequencies.size() - 1);
+	for (float v : c) BOOST_CHECK_CLOSE(v, 2.0f / norm, 1e-2);
+}
+
+BOOST_AUTO_TEST_CASE(equidistributeConstant)
+{
+	//constant curvature yields an exponential mesh
+	std::vector<float> frequencies({ 0.1f, 0.2f, 0.5f, 1.0f, 3.0f, 10.0f });
+	std::vector<float> c(frequencies.size() - 1, 1.0f);
+
+	std::vector<float> mesh = FrequencyOptimizer::equidistribute(frequencies, c, 5);
+	BOOST_REQUIRE_EQUAL(mesh.size(), 5);
+	for (int i = 0; i < 5; ++i) BOOST_CHECK_CLOSE(mesh[i], 0.1f * powf(10.0f, 0.5f * i), 1e-3);
+}
+
+BOOST_AUTO_TEST_CASE(equidistributeLocalized)
+{
+	//mesh points accumulate in regions of large curvature
+	std::vector<float> frequencies;
+	for (int i = 0; i < 11; ++i) frequencies.push_back(0.01f * powf(10.0f, 0.4f * i));
+	std::vector<float> c(frequencies.size() - 1, 0.01f);
+	c[2] = 100.0f;
+
+	std::vector<float> mesh = FrequencyOptimizer::equidistribute(frequencies, c, 11);
+	int inside = 0;
+	for (float w : mesh) if (w > frequencies[2] && w < frequencies[3]) ++inside;
+	BOOST_CHECK_GT(inside, 1);
+	BOOST_CHECK_EQUAL(mesh.front(), frequencies.front());
+	BOOST_CHECK_EQUAL(mesh.back(), frequencies.back());
+	for (int i = 0; i < 10; ++i) BOOST_CHECK_LT(mesh[i], mesh[i + 1]);
+}
+
+BOOST_AUTO_TEST_CASE(error)
+{
+	std::vector<float> frequencies({ 0.1f, 1.0f, 10.0f, 100.0f });
+	std::vector<float> c({ 1.0f, 4.0f, 2.0f });
+	BOOST_CHECK_CLOSE(FrequencyOptimizer::error(frequencies, c), 0.5f * logf(10.0f) * logf(10.0f), 1e-3);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,58 @@
+#define BOOST_TEST_MODULE "FrgCoreTest"
+#include <boost/test/included/unit_test.hpp>
+#include "FrgCore.hpp"
+
+BOOST_AUTO_TEST_SUITE(FrgCoreTest);
+
+BOOST_AUTO_TEST_CASE(integrateEuler)
+{
+	std::vector<float> data({ 1.0f, -2.0f, 0.0f, 4.0f });
+	std::vector<float> flow({ 0.5f, 1.0f, -1.0f, 0.0f });
+	FrgCore::integrateStep(data.data(), flow.data(), int(data.size()), -0.1f, CutoffDiscretization::Integrator::Euler);
+
+	std::vector<float> expected({ 0.95f, -2.1f, 0.1f, 4.0f });
+	for (int i = 0; i < int(data.size()); ++i) BOOST_CHECK_CLOSE(data[i], expected[i], 1e-4);
+}
+
+BOOST_AUTO_TEST_CASE(integrateImplicitSmallValues)
+{
+	//components which are small compared to the largest component are integrated explicitly
+	std::vector<float> data({ 1.0f, 0.0f, 1e-5f });
+	std::vector<float> flow({ 0.0f, 2.0f, 3.0f });
+	FrgCore::integrateStep(data.data(), flow.data(), int(data.size()), -0.1f, CutoffDiscretization::Integrator::Implicit);
+
+	BOOST_CHECK_CLOSE(data[0], 1.0f, 1e-4);
+	BOOST_CHECK_CLOSE(data[1], -0.2f, 1e-4);
+	BOOST_CHECK_CLOSE(data[2], 1e-5f - 0.3f, 1e-4);
+}
+
+BOOST_AUTO_TEST_CASE(integrateImplicitGrowth)
+{
+	//y' = -y^2 integrated towards decreasing cutoff has the exact solution y = 1 / (x - x0), which diverges at x0
+	float x0 = 0.5f;
+	float h = -0.05f;
+	float yEuler = 1.0f / (2.0f - x0);
+	float yImplicit = yEuler;
+	for (int i = 0; i < 25; ++i)
+	{
+		float flowEuler = -yEuler * yEuler;
+		float flowImplicit = -yImplicit * yImplicit;
+		FrgCore::integrateStep(&yEuler, &flowEuler, 1, h, CutoffDiscretization::Integrator::Euler);
+		FrgCore::integrateStep(&yImplicit, &flowImplicit, 1, h, CutoffDiscretization::Integrator::Implicit);
+	}
+
+	float exact = 1.0f / (0.75f - x0);
+	BOOST_CHECK_LT(fabsf(yImplicit - exact), fabsf(yEuler - exact));
+	BOOST_CHECK_CLOSE(yImplicit, exact, 1e-2);
+}
+
+BOOST_AUTO_TEST_CASE(integrateImplicitDecay)
+{
+	//y' = y^2 integrated towards decreasing cutoff decays; large steps do not overshoot the fixed point at zero
+	float y = 10.0f;
+	float flow = y * y;
+	FrgCore::integrateStep(&y, &flow, 1, -1.0f, CutoffDiscretization::Integrator::Implicit);
+	BOOST_CHECK_CLOSE(y, 1.0f / 1.1f, 1e-3);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,146 @@
+#define BOOST_TEST_MODULE "KernelTunerTest"
+#include <chrono>
+#include <thread>
+#include <boost/test/included/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include "KernelTuner.hpp"
+
+#ifndef DISABLE_MPI
+#include "mpi.h"
+#endif
+
+struct MPIFixture
+{
+	MPIFixture()
+	{
+		#ifndef DISABLE_MPI
+		int argc = boost::unit_test::framework::master_test_suite().argc;
+		char **argv = boost::unit_test::framework::master_test_suite().argv;
+		MPI_Init(&argc, &argv);
+		#endif
+	}
+
+	~MPIFixture()
+	{
+		#ifndef DISABLE_MPI
+		MPI_Finalize();
+		#endif
+	}
+};
+
+BOOST_GLOBAL_FIXTURE(MPIFixture);
+
+struct KernelTunerFixture
+{
+	KernelTunerFixture()
+	{
+		cacheFile = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("kernels-%%%%-%%%%.cache")).string();
+		variant = 0;
+		samples = 0;
+		delays = { 6, 2, 4 };
+	}
+
+	~KernelTunerFixture()
+	{
+		boost::filesystem::remove(cacheFile);
+	}
+
+	void registerKernel(KernelTuner &tuner)
+	{
+		tuner.addKernel("sleep", { "slow", "fast", "medium" }, [&](int v) { variant = v; });
+	}
+
+	void sample()
+	{
+		++samples;
+		std::this_thread::sleep_for(std::chrono::milliseconds(delays[variant]));
+	}
+
+	std::string cacheFile;
+	int variant;
+	int samples;
+	std::vector<int> delays;
+};
+
+BOOST_FIXTURE_TEST_SUITE(KernelTunerTest, KernelTunerFixture);
+
+BOOST_AUTO_TEST_CASE(disabled)
+{
+	KernelTuner tuner;
+	BOOST_CHECK(!tuner.isEnabled());
+	BOOST_CHECK(!tuner.isPending());
+}
+
+BOOST_AUTO_TEST_CASE(selectFastestVariant)
+{
+	KernelTuner tuner(true);
+	BOOST_CHECK(tuner.isPending());
+	registerKernel(tuner);
+	tuner.tune("shape", [&]() { sample(); });
+
+	BOOST_CHECK(!tuner.isPending());
+	BOOST_CHECK_EQUAL(tuner.variant("sleep"), "fast");
+	BOOST_CHECK_EQUAL(variant, 1);
+	BOOST_CHECK_EQUAL(tuner.variant("unknown"), "");
+}
+
+BOOST_AUTO_TEST_CASE(cacheDecisions)
+{
+	{
+		KernelTuner tuner(true, cacheFile);
+		registerKernel(tuner);
+		tuner.tune("shape", [&]() { sample(); });
+		BOOST_CHECK_EQUAL(tuner.variant("sleep"), "fast");
+	}
+	BOOST_CHECK(boost::filesystem::exists(cacheFile));
+
+	//the same problem shape is not timed again, even if the timings have changed
+	delays = { 1, 6, 4 };
+	samples = 0;
+	{
+		KernelTuner tuner(true, cacheFile);
+		registerKernel(tuner);
+		tuner.tune("shape", [&]() { sample(); });
+		BOOST_CHECK_EQUAL(samples, 0);
+		BOOST_CHECK_EQUAL(tuner.variant("sleep"), "fast");
+		BOOST_CHECK_EQUAL(variant, 1);
+	}
+
+	//a different problem shape is timed
+	{
+		KernelTuner tuner(true, cacheFile);
+		registerKernel(tuner);
+		tuner.tune("other shape", [&]() { sample(); });
+		BOOST_CHECK(samples > 0);
+		BOOST_CHECK_EQUAL(tuner.variant("sleep"), "slow");
+	}
+
+	//both decisions remain cached
+	samples = 0;
+	for (std::string shape : { "shape", "other shape" })
+	{
+		KernelTuner tuner(true, cacheFile);
+		registerKernel(tuner);
+		tuner.tune(shape, [&]() { sample(); });
+		BOOST_CHECK_EQUAL(tuner.variant("sleep"), (shape == "shape") ? "fast" : "slow");
+	}
+	BOOST_CHECK_EQUAL(samples, 0);
+}
+
+BOOST_AUTO_TEST_CASE(restoreDefaultVariant)
+{
+	{
+		KernelTuner tuner(true);
+		registerKernel(tuner);
+		tuner.tune("shape", [&]() { sample(); });
+		BOOST_CHECK_EQUAL(variant, 1);
+	}
+	BOOST_CHECK_EQUAL(variant, 0);
+}
+
+BOOST_AUTO_TEST_CASE(cpuModel)
+{
+	BOOST_CHECK(KernelTuner::cpuModel() != "");
+}
+
+BOOST_AUTO_TEST_SUITE_END();
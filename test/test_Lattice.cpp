@@ -85,6 +85,62 @@ struct HoneycombLatticeFixture
 	Lattice *l;
 };
 
+struct TriangularAnisotropicLatticeFixture
+{
+	TriangularAnisotropicLatticeFixture()
+	{
+		LatticeModelFactory::LatticeUnitCell uc;
+		uc.basisSites.push_back(geometry::Vec3<double>(0.0, 0.0, 0.0));
+		uc.latticeVectors.push_back(geometry::Vec3<double>(0.5 * sqrt(3), -0.5, 0.0));
+		uc.latticeVectors.push_back(geometry::Vec3<double>(0.5 * sqrt(3), 0.5, 0.0));
+		uc.latticeVectors.push_back(geometry::Vec3<double>(0.0, 0.0, 1.0));
+		uc.latticeBonds.push_back(LatticeModelFactory::LatticeBond(0, 0, 0, -1, 0));
+		uc.latticeBonds.push_back(LatticeModelFactory::LatticeBond(0, 0, -1, 0, 0));
+		uc.latticeBonds.push_back(LatticeModelFactory::LatticeBond(0, 0, -1, 1, 0));
+
+		//heisenberg interaction and bond-dependent in-plane anisotropy, which is invariant under combined lattice and spin rotations by 120 degrees
+		LatticeModelFactory::SpinModelUnitCell model;
+		for (int b = 0; b < 3; ++b)
+		{
+			LatticeModelFactory::SpinInteraction i(LatticeModelFactory::LatticeSite(0, 0, 0, 0), LatticeModelFactory::LatticeSite(bonds[b][0], bonds[b][1], 0, 0));
+			getCoupling(b, i.interactionStrength);
+			model.interactions.push_back(i);
+		}
+
+		Log::log << Log::setDisplayLogLevel(Log::LogLevel::None);
+		std::pair<Lattice *, SpinModel *> product = LatticeModelFactory::newLatticeModel(uc, model, 3);
+		lp = product.first;
+		delete product.second;
+
+		model.spinRotationSymmetry = true;
+		product = LatticeModelFactory::newLatticeModel(uc, model, 3);
+		l = product.first;
+		m = product.second;
+	}
+
+	~TriangularAnisotropicLatticeFixture()
+	{
+		delete l;
+		delete lp;
+		delete m;
+	}
+
+	void getCoupling(const int b, float (&j)[3][3]) const
+	{
+		const double phi[3] = { -M_PI / 6, M_PI / 6, M_PI / 2 };
+		for (int a = 0; a < 3; ++a) for (int c = 0; c < 3; ++c) j[a][c] = (a == c) ? 1.0f : 0.0f;
+		j[0][0] += float(0.5 * cos(2 * phi[b]));
+		j[1][1] -= float(0.5 * cos(2 * phi[b]));
+		j[0][1] += float(0.5 * sin(2 * phi[b]));
+		j[1][0] += float(0.5 * sin(2 * phi[b]));
+	}
+
+	const int bonds[3][2] = { { 1, 0 }, { 0, 1 }, { -1, 1 } };
+	Lattice *l;
+	Lattice *lp;
+	SpinModel *m;
+};
+
 BOOST_AUTO_TEST_SUITE(LatticeTest);
 
 BOOST_FIXTURE_TEST_CASE(SquareLatticeIterate, SquareLatticeFixture)
@@ -171,6 +227,19 @@ BOOST_FIXTURE_TEST_CASE(SquareLatticeOverlap, SquareLatticeFixture)
 	}
 };
 
+BOOST_FIXTURE_TEST_CASE(SquareLatticeBondDistance, SquareLatticeFixture)
+{
+	BOOST_CHECK_EQUAL(l->range, 3);
+	BOOST_CHECK_EQUAL(l->getBondDistance(l->symmetryTransform(l->zero(), l->zero())), 0);
+
+	//on the square lattice, the bond distance is the Manhattan distance
+	for (auto i = l->getRange(l->getBasis()); i != l->end(); ++i)
+	{
+		SiteParameters p = l->getSiteParameters(i);
+		BOOST_CHECK_EQUAL(l->getBondDistance(l->symmetryTransform(l->zero(), i)), abs(std::get<0>(p)) + abs(std::get<1>(p)));
+	}
+};
+
 BOOST_FIXTURE_TEST_CASE(HoneycombLatticeIterate, HoneycombLatticeFixture)
 {
 	BOOST_CHECK_EQUAL((l->getSiteParameters(l->getBasis())), (SiteParameters(0, 0, 0, 0)));
@@ -184,6 +253,31 @@ BOOST_FIXTURE_TEST_CASE(HoneycombLatticeIterate, HoneycombLatticeFixture)
 	BOOST_CHECK_EQUAL(l->size, 11);
 };
 
+BOOST_FIXTURE_TEST_CASE(HoneycombLatticeFlatIterate, HoneycombLatticeFixture)
+{
+	LatticeIdRange basis = l->getBasisIds();
+	BOOST_CHECK_EQUAL(basis.size(), 2);
+
+	int b = 0;
+	for (auto i = l->getBasis(); i != l->end(); ++i)
+	{
+		BOOST_CHECK_EQUAL(basis[b], i - l->begin());
+		BOOST_CHECK_EQUAL((l->getSiteParameters(basis[b])), (SiteParameters(0, 0, 0, b)));
+
+		LatticeIdRange range = l->getRangeIds(b);
+		BOOST_CHECK_EQUAL(range.size(), 19);
+		const int *j = range.begin();
+		for (auto k = l->getRange(i); k != l->end(); ++k)
+		{
+			BOOST_REQUIRE(j != range.end());
+			BOOST_CHECK_EQUAL(*j, k - l->begin());
+			++j;
+		}
+		BOOST_CHECK(j == range.end());
+		++b;
+	}
+};
+
 BOOST_FIXTURE_TEST_CASE(HoneycombLatticeGeometry, HoneycombLatticeFixture)
 {
 	for (auto i = l->getRange(l->getBasis()); i != l->end(); ++i)
@@ -298,4 +392,50 @@ BOOST_FIXTURE_TEST_CASE(HoneycombLatticeOverlap, HoneycombLatticeFixture)
 	}
 };
 
+BOOST_FIXTURE_TEST_CASE(TriangularLatticeSpinRotation, TriangularAnisotropicLatticeFixture)
+{
+	//general spin rotations allow for a stronger symmetry reduction than signed permutations
+	BOOST_CHECK(l->hasSpinRotations());
+	BOOST_CHECK_LT(l->size, lp->size);
+
+	//nearest-neighbor couplings are obtained from their representatives as J(0,j)=M*J(0,rid)*M^T
+	int n = 0;
+	for (LatticeIterator j = l->begin(); j != l->end(); ++j)
+	{
+		SiteParameters p = l->getSiteParameters(j);
+		for (int b = 0; b < 3; ++b)
+		{
+			for (int direction = -1; direction <= 1; direction += 2)
+			{
+				if (p != SiteParameters(direction * bonds[b][0], direction * bonds[b][1], 0, 0)) continue;
+				++n;
+
+				float t[9];
+				LatticeIterator rid = l->fromParametrization(l->symmetryTransform(l->zero(), j, t));
+				auto interaction = std::find_if(m->interactions.begin(), m->interactions.end(), [&](const std::pair<LatticeIterator, SpinModel::SpinInteraction> &i) { return i.first == rid; });
+				BOOST_REQUIRE(interaction != m->interactions.end());
+
+				float coupling[3][3];
+				getCoupling(b, coupling);
+				for (int a1 = 0; a1 < 3; ++a1)
+				{
+					for (int a2 = 0; a2 < 3; ++a2)
+					{
+						float transformed = 0.0f;
+						float orthogonality = 0.0f;
+						for (int c1 = 0; c1 < 3; ++c1)
+						{
+							orthogonality += t[3 * a1 + c1] * t[3 * a2 + c1];
+							for (int c2 = 0; c2 < 3; ++c2) transformed += t[3 * a1 + c1] * t[3 * a2 + c2] * interaction->second.interactionStrength[c1][c2];
+						}
+						BOOST_CHECK_SMALL(transformed - coupling[a1][a2], 1e-5f);
+						BOOST_CHECK_SMALL(orthogonality - ((a1 == a2) ? 1.0f : 0.0f), 1e-5f);
+					}
+				}
+			}
+		}
+	}
+	BOOST_CHECK_EQUAL(n, 6);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
@@ -132,6 +132,46 @@ BOOST_AUTO_TEST_CASE(MasterStackImplicit)
 	for (int i = 0; i < dataLength; ++i) BOOST_CHECK_EQUAL(data1[i], float(i * i));
 }
 
+BOOST_AUTO_TEST_CASE(MasterStackImplicitReplicable)
+{
+	const int dataLength = 4;
+	float data1[dataLength];
+	float data2[dataLength];
+
+	auto resetdata = [&]()->void {
+		for (int i = 0; i < dataLength; ++i)
+		{
+			data1[i] = float(i);
+			data2[i] = -float(i);
+		}
+	};
+
+	int iteration = 0;
+	std::function<void(int)> calculator1 = [&data1, &iteration](int n)->void { data1[n] = float(n * n + iteration); };
+	std::function<void(int)> calculator2 = [&data2, &iteration](int n)->void { data2[n] = float(n * n * n + iteration); };
+
+	HMP::StackIdentifier stack1 = m->addMasterStackImplicit(&data1[0], dataLength, calculator1, 1, 1, 10, false, true);
+	HMP::StackIdentifier stack2 = m->addMasterStackImplicit(&data2[0], dataLength, calculator2, 1, 1, 10, true, true);
+
+	//cover the trial phase, the decision and the subsequent calls
+	for (iteration = 0; iteration < 10; ++iteration)
+	{
+		resetdata();
+		m->calculate(stack1);
+		m->broadcast(stack1);
+		m->calculate(stack2);
+		for (int i = 0; i < dataLength; ++i) BOOST_CHECK_EQUAL(data1[i], float(i * i + iteration));
+		for (int i = 0; i < dataLength; ++i) BOOST_CHECK_EQUAL(data2[i], float(i * i * i + iteration));
+	}
+
+	//joint calculation of several replicable stacks is always distributed
+	resetdata();
+	m->calculateAll();
+	m->broadcastAll();
+	for (int i = 0; i < dataLength; ++i) BOOST_CHECK_EQUAL(data1[i], float(i * i + iteration));
+	for (int i = 0; i < dataLength; ++i) BOOST_CHECK_EQUAL(data2[i], float(i * i * i + iteration));
+}
+
 BOOST_AUTO_TEST_CASE(MasterStackImplicitTyplemult)
 {
 	const int dataLength = 8;
@@ -0,0 +1,68 @@
+#define BOOST_TEST_MODULE "MeasurementSchedulerTest"
+#include <boost/test/included/unit_test.hpp>
+#include "MeasurementScheduler.hpp"
+
+BOOST_AUTO_TEST_SUITE(MeasurementSchedulerTest);
+
+BOOST_AUTO_TEST_CASE(everyStep)
+{
+	MeasurementScheduler s;
+	for (int i = 0; i < 10; ++i) BOOST_CHECK(s.isDue(10.0f - i));
+}
+
+BOOST_AUTO_TEST_CASE(fixedCadence)
+{
+	MeasurementScheduler s(MeasurementScheduler::Policy::Fixed, 3, 0.0f, {});
+	std::vector<bool> expected({ true, false, false, true, false, false, true });
+	for (int i = 0; i < int(expected.size()); ++i) BOOST_CHECK_EQUAL(s.isDue(10.0f - i), expected[i]);
+}
+
+BOOST_AUTO_TEST_CASE(guaranteedCutoffs)
+{
+	MeasurementScheduler s(MeasurementScheduler::Policy::Fixed, 100, 0.0f, { 5.5f, 8.0f });
+	int count = 0;
+	for (int i = 0; i < 10; ++i)
+	{
+		bool due = s.isDue(10.0f - i);
+		if (10.0f - i == 8.0f || 10.0f - i == 5.0f) BOOST_CHECK(due);
+		if (due) ++count;
+	}
+	BOOST_CHECK_EQUAL(count, 3);
+}
+
+BOOST_AUTO_TEST_CASE(forced)
+{
+	MeasurementScheduler s(MeasurementScheduler::Policy::Fixed, 100, 0.0f, {});
+	BOOST_CHECK(s.isDue(2.0f));
+	BOOST_CHECK(!s.isDue(1.0f));
+	BOOST_CHECK(s.isDue(1.0f, true));
+	BOOST_CHECK(!s.isDue(1.0f, true));
+}
+
+BOOST_AUTO_TEST_CASE(adaptive)
+{
+	MeasurementScheduler s(MeasurementScheduler::Policy::Adaptive, 8, 0.05f, {});
+	BOOST_CHECK_EQUAL(s.interval(), 1);
+
+	//slowly changing observables relax the interval up to the cadence
+	float cutoff = 100.0f;
+	float value = 1.0f;
+	for (int i = 0; i < 40; ++i)
+	{
+		cutoff *= 0.95f;
+		value *= 1.001f;
+		if (s.isDue(cutoff)) s.record({ value, value });
+	}
+	BOOST_CHECK_EQUAL(s.interval(), 8);
+
+	//rapid change leads to dense measurements
+	for (int i = 0; i < 8; ++i)
+	{
+		cutoff *= 0.95f;
+		value *= 1.2f;
+		if (s.isDue(cutoff)) s.record({ value, value });
+	}
+	BOOST_CHECK_EQUAL(s.interval(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,165 @@
+#define BOOST_TEST_MODULE "MultirateSchedulerTest"
+#include <cmath>
+#include <boost/test/included/unit_test.hpp>
+#include "MultirateScheduler.hpp"
+
+#ifndef DISABLE_MPI
+#include "mpi.h"
+#endif
+
+struct MPIFixture
+{
+	MPIFixture()
+	{
+		#ifndef DISABLE_MPI
+		int argc = boost::unit_test::framework::master_test_suite().argc;
+		char **argv = boost::unit_test::framework::master_test_suite().argv;
+		MPI_Init(&argc, &argv);
+		#endif
+	}
+
+	~MPIFixture()
+	{
+		#ifndef DISABLE_MPI
+		MPI_Finalize();
+		#endif
+	}
+};
+
+BOOST_GLOBAL_FIXTURE(MPIFixture);
+
+//two blocks of two elements in two data arrays; block 0 follows a power law in the cutoff, block 1 oscillates
+struct MultirateFixture
+{
+	MultirateFixture() : arrayA(4, 0.0f), arrayB(4, 0.0f)
+	{
+	}
+
+	float exact(const int block, const int element, const float cutoff, const int step) const
+	{
+		if (block == 0) return (element + 1.0f) * powf(cutoff, -2.0f);
+		return ((step % 2 == 0) ? 1.0f : -1.0f) * (element + 1.0f);
+	}
+
+	//compute the due blocks and return the number of evaluated blocks
+	int step(MultirateScheduler &scheduler, const float cutoff, const int step)
+	{
+		scheduler.beginStep(cutoff, true);
+		for (int b = 0; b < 2; ++b)
+		{
+			if (!scheduler.isDue(b)) continue;
+			for (int i = 0; i < 2; ++i)
+			{
+				arrayA[2 * b + i] = exact(b, i, cutoff, step);
+				arrayB[2 * b + i] = 2.0f * exact(b, i, cutoff, step);
+			}
+		}
+		scheduler.endStep(true);
+		return scheduler.evaluatedBlocks();
+	}
+
+	std::vector<float> arrayA;
+	std::vector<float> arrayB;
+};
+
+BOOST_FIXTURE_TEST_CASE(disabled, MultirateFixture)
+{
+	MultirateScheduler scheduler(1, 0.01f);
+	scheduler.setBlocks(2, 2, { arrayA.data(), arrayB.data() });
+	BOOST_TEST(!scheduler.isEnabled());
+
+	float cutoff = 10.0f;
+	for (int s = 0; s < 10; ++s)
+	{
+		BOOST_TEST(step(scheduler, cutoff, s) == 2);
+		cutoff *= 0.9f;
+	}
+	BOOST_TEST(scheduler.slowBlocks() == 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(extrapolateSlowBlocks, MultirateFixture)
+{
+	MultirateScheduler scheduler(4, 0.01f);
+	scheduler.setBlocks(2, 2, { arrayA.data(), arrayB.data() });
+	BOOST_TEST(scheduler.isEnabled());
+
+	float cutoff = 10.0f;
+	int skipped = 0;
+	for (int s = 0; s < 20; ++s)
+	{
+		skipped += 2 - step(scheduler, cutoff, s);
+
+		//the oscillating block is evaluated at every step
+		BOOST_TEST(scheduler.isDue(1));
+
+		//the power law block is either computed or extrapolated accurately
+		for (int i = 0; i < 2; ++i)
+		{
+			BOOST_TEST(arrayA[i] == exact(0, i, cutoff, s), boost::test_tools::tolerance(1e-3f));
+			BOOST_TEST(arrayB[i] == 2.0f * exact(0, i, cutoff, s), boost::test_tools::tolerance(1e-3f));
+		}
+		cutoff *= 0.9f;
+	}
+	BOOST_TEST(scheduler.slowBlocks() == 1);
+	BOOST_TEST(skipped > 10);
+}
+
+BOOST_FIXTURE_TEST_CASE(promoteBlocks, MultirateFixture)
+{
+	MultirateScheduler scheduler(4, 0.01f);
+	scheduler.setBlocks(2, 2, { arrayA.data(), arrayB.data() });
+
+	float cutoff = 10.0f;
+	for (int s = 0; s < 10; ++s)
+	{
+		step(scheduler, cutoff, s);
+		cutoff *= 0.9f;
+	}
+	BOOST_TEST(scheduler.slowBlocks() == 1);
+
+	//the flow of the slow block departs from its power law; the block is promoted once it is re-evaluated
+	int s = 10;
+	bool promoted = false;
+	for (; s < 20 && !promoted; ++s)
+	{
+		scheduler.beginStep(cutoff, true);
+		bool isDue = scheduler.isDue(0);
+		for (int b = 0; b < 2; ++b)
+		{
+			if (!scheduler.isDue(b)) continue;
+			for (int i = 0; i < 2; ++i)
+			{
+				arrayA[2 * b + i] = ((b == 0) ? 3.0f : 1.0f) * exact(b, i, cutoff, s);
+				arrayB[2 * b + i] = ((b == 0) ? 3.0f : 1.0f) * 2.0f * exact(b, i, cutoff, s);
+			}
+		}
+		scheduler.endStep(true);
+		if (isDue) promoted = (scheduler.slowBlocks() == 0);
+		cutoff *= 0.9f;
+	}
+	BOOST_TEST(promoted);
+	BOOST_TEST(s <= 15);
+
+	//the promoted block is evaluated at the next step
+	scheduler.beginStep(cutoff, true);
+	BOOST_TEST(scheduler.isDue(0));
+	scheduler.endStep(true);
+}
+
+BOOST_FIXTURE_TEST_CASE(reset, MultirateFixture)
+{
+	MultirateScheduler scheduler(4, 0.01f);
+	scheduler.setBlocks(2, 2, { arrayA.data(), arrayB.data() });
+
+	float cutoff = 10.0f;
+	for (int s = 0; s < 10; ++s)
+	{
+		step(scheduler, cutoff, s);
+		cutoff *= 0.9f;
+	}
+	BOOST_TEST(scheduler.slowBlocks() == 1);
+
+	scheduler.reset();
+	BOOST_TEST(scheduler.slowBlocks() == 0);
+	BOOST_TEST(step(scheduler, cutoff, 10) == 2);
+}
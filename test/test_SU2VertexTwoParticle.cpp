@@ -280,4 +280,31 @@ BOOST_AUTO_TEST_CASE(getValueSuperbundle)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(getValueSuperbundleGatherOrder)
+{
+	for (int i = 0; i < v->size; ++i)
+	{
+		v->getValueRef(i, SU2VertexTwoParticle::Symmetry::Spin) = float(i);
+		v->getValueRef(i, SU2VertexTwoParticle::Symmetry::Density) = float(i) + 1.0f;
+	}
+
+	for (float s : { 1.1f, -1.1f })
+	{
+		auto ab = v->generateAccessBuffer(s, 2.2f, 3.3f);
+		ValueSuperbundle<float, 2> frequencyMajor(FrgCommon::lattice().size);
+		ValueSuperbundle<float, 2> siteMajor(FrgCommon::lattice().size);
+		KernelTuner::gatherOrder = KernelTuner::GatherOrder::FrequencyMajor;
+		v->getValueSuperbundle(ab, frequencyMajor);
+		KernelTuner::gatherOrder = KernelTuner::GatherOrder::SiteMajor;
+		v->getValueSuperbundle(ab, siteMajor);
+		KernelTuner::gatherOrder = KernelTuner::GatherOrder::FrequencyMajor;
+
+		//both variants perform identical floating point operations
+		for (int i = 0; i < 2; ++i)
+		{
+			for (int rid = 0; rid < FrgCommon::lattice().size; ++rid) BOOST_CHECK_EQUAL(frequencyMajor.bundle(i)[rid], siteMajor.bundle(i)[rid]);
+		}
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
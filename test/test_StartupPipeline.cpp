@@ -0,0 +1,119 @@
+#define BOOST_TEST_MODULE "StartupPipelineTest"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <boost/test/included/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include "StartupPipeline.hpp"
+#include "EffectiveAction.hpp"
+
+#ifndef DISABLE_MPI
+#include "mpi.h"
+#endif
+
+struct MPIFixture
+{
+	MPIFixture()
+	{
+		#ifndef DISABLE_MPI
+		int argc = boost::unit_test::framework::master_test_suite().argc;
+		char **argv = boost::unit_test::framework::master_test_suite().argv;
+		MPI_Init(&argc, &argv);
+		#endif
+	}
+
+	~MPIFixture()
+	{
+		#ifndef DISABLE_MPI
+		MPI_Finalize();
+		#endif
+	}
+};
+
+BOOST_GLOBAL_FIXTURE(MPIFixture);
+
+//effective action which exposes the data file access
+struct TestEffectiveAction : public EffectiveAction
+{
+	int writeCheckpoint(const std::string &dataFilePath, const bool append = false) const override { return -1; }
+	bool readCheckpoint(const std::string &datafilePath, const int checkpointId = -1) override { return false; }
+	bool isDiverged() const override { return false; }
+	std::vector<std::vector<float>> getFrequencyProfiles() const override { return {}; }
+	std::vector<float> getTwoParticleMagnitudes() const override { return {}; }
+
+	static hid_t openDataFile(const std::string &dataFilePath) { return _openDataFile(dataFilePath); }
+};
+
+BOOST_AUTO_TEST_CASE(concurrentTasks)
+{
+	StartupPipeline pipeline;
+	std::atomic<bool> done(false);
+	pipeline.launch("task", [&done]() { std::this_thread::sleep_for(std::chrono::milliseconds(50)); done = true; });
+
+	//phases on the calling thread proceed while the task is running
+	pipeline.beginPhase("phase");
+	pipeline.endPhase();
+
+	pipeline.wait("task");
+	BOOST_TEST(done);
+
+	//waiting for a task which does not exist does nothing
+	pipeline.wait("task");
+	pipeline.wait("unknown");
+}
+
+BOOST_AUTO_TEST_CASE(finishWaitsForAllTasks)
+{
+	StartupPipeline pipeline;
+	std::atomic<int> count(0);
+	for (int i = 0; i < 3; ++i) pipeline.launch("task" + std::to_string(i), [&count]() { std::this_thread::sleep_for(std::chrono::milliseconds(10)); ++count; });
+	pipeline.finish();
+	BOOST_TEST(count == 3);
+}
+
+BOOST_AUTO_TEST_CASE(exceptionsAreRethrown)
+{
+	StartupPipeline pipeline;
+	pipeline.launch("task", []() { throw Exception(Exception::Type::IOError, "task failed"); });
+	BOOST_CHECK_THROW(pipeline.wait("task"), Exception);
+}
+
+BOOST_AUTO_TEST_CASE(prefetchDataFile)
+{
+	H5Eset_auto(H5E_DEFAULT, NULL, NULL);
+	std::string path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("prefetch-%%%%-%%%%.h5")).string();
+
+	//write data file
+	hid_t file = H5Fcreate(path.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+	hsize_t size = 4;
+	float data[4] = { 1.0f, 2.0f, 3.0f, 4.0f };
+	hid_t dataspace = H5Screate_simple(1, &size, NULL);
+	hid_t dataset = H5Dcreate(file, "data", H5T_NATIVE_FLOAT, dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+	H5Dwrite(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+	H5Dclose(dataset);
+	H5Sclose(dataspace);
+	H5Fclose(file);
+
+	//prefetch and remove the file, such that it can only be opened from memory
+	StartupPipeline pipeline;
+	pipeline.launch("prefetch", [path]() { EffectiveAction::prefetchDataFile(path); });
+	pipeline.wait("prefetch");
+	boost::filesystem::remove(path);
+
+	file = TestEffectiveAction::openDataFile(path);
+	BOOST_TEST(file >= 0);
+	float read[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	dataset = H5Dopen(file, "data", H5P_DEFAULT);
+	H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read);
+	H5Dclose(dataset);
+	H5Fclose(file);
+	for (int i = 0; i < 4; ++i) BOOST_TEST(read[i] == data[i]);
+
+	//the memory image is consumed by the first read
+	BOOST_TEST(TestEffectiveAction::openDataFile(path) < 0);
+
+	//discarded images are not read
+	EffectiveAction::prefetchDataFile(path);
+	EffectiveAction::discardPrefetchedDataFiles();
+	BOOST_TEST(TestEffectiveAction::openDataFile(path) < 0);
+}
@@ -70,6 +70,61 @@ struct TRIVertexTwoParticleFixture
 	SpinParser *spinParser;
 };
 
+struct TRIVertexTwoParticleSpinRotationFixture
+{
+	TRIVertexTwoParticleSpinRotationFixture()
+	{
+		//construct triangular lattice
+		LatticeModelFactory::LatticeUnitCell uc;
+		uc.basisSites.push_back(geometry::Vec3<double>(0.0, 0.0, 0.0));
+		uc.latticeVectors.push_back(geometry::Vec3<double>(0.5 * sqrt(3), -0.5, 0.0));
+		uc.latticeVectors.push_back(geometry::Vec3<double>(0.5 * sqrt(3), 0.5, 0.0));
+		uc.latticeVectors.push_back(geometry::Vec3<double>(0.0, 0.0, 1.0));
+		uc.latticeBonds.push_back(LatticeModelFactory::LatticeBond(0, 0, 0, -1, 0));
+		uc.latticeBonds.push_back(LatticeModelFactory::LatticeBond(0, 0, -1, 0, 0));
+		uc.latticeBonds.push_back(LatticeModelFactory::LatticeBond(0, 0, -1, 1, 0));
+
+		//bond-dependent in-plane anisotropy, which requires general spin rotations for symmetry reduction
+		LatticeModelFactory::SpinModelUnitCell model;
+		model.spinRotationSymmetry = true;
+		const int bonds[3][2] = { { 1, 0 }, { 0, 1 }, { -1, 1 } };
+		const double phi[3] = { -M_PI / 6, M_PI / 6, M_PI / 2 };
+		for (int b = 0; b < 3; ++b)
+		{
+			LatticeModelFactory::SpinInteraction i(LatticeModelFactory::LatticeSite(0, 0, 0, 0), LatticeModelFactory::LatticeSite(bonds[b][0], bonds[b][1], 0, 0));
+			i.interactionStrength[0][0] = float(1.0 + 0.5 * cos(2 * phi[b]));
+			i.interactionStrength[1][1] = float(1.0 - 0.5 * cos(2 * phi[b]));
+			i.interactionStrength[2][2] = 1.0f;
+			i.interactionStrength[0][1] = i.interactionStrength[1][0] = float(0.5 * sin(2 * phi[b]));
+			model.interactions.push_back(i);
+		}
+
+		Log::log << Log::setDisplayLogLevel(Log::LogLevel::None);
+		std::pair<Lattice *, SpinModel *> product = LatticeModelFactory::newLatticeModel(uc, model, 3);
+		Lattice *l = product.first;
+		delete product.second;
+
+		//construct frequency discretization
+		std::vector<float> values({ 1.0, 2.0, 3.0, 4.0, 5.0 });
+		FrequencyDiscretization *f = new FrequencyDiscretization(values);
+
+		//write lattice and frequency to FrgCommon
+		spinParser = new SpinParser(l, f);
+
+		//construct vertex
+		v = new TRIVertexTwoParticle;
+	}
+
+	~TRIVertexTwoParticleSpinRotationFixture()
+	{
+		delete spinParser;
+		delete v;
+	}
+
+	TRIVertexTwoParticle *v;
+	SpinParser *spinParser;
+};
+
 BOOST_FIXTURE_TEST_SUITE(TRIVertexTwoParticleTest, TRIVertexTwoParticleFixture);
 
 BOOST_AUTO_TEST_CASE(ExpandIteratorFull)
@@ -251,4 +306,68 @@ BOOST_AUTO_TEST_CASE(getValueSuperbundle)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(getValueSuperbundleGatherOrder)
+{
+	for (int i = 0; i < v->size; ++i) v->getValueRef(i) = float(i);
+
+	for (float s : { 1.1f, -1.1f })
+	{
+		auto ab = v->generateAccessBuffer(s, 2.2f, 3.3f);
+		ValueSuperbundle<float, 16> frequencyMajor(FrgCommon::lattice().size);
+		ValueSuperbundle<float, 16> siteMajor(FrgCommon::lattice().size);
+		KernelTuner::gatherOrder = KernelTuner::GatherOrder::FrequencyMajor;
+		v->getValueSuperbundle(ab, frequencyMajor);
+		KernelTuner::gatherOrder = KernelTuner::GatherOrder::SiteMajor;
+		v->getValueSuperbundle(ab, siteMajor);
+		KernelTuner::gatherOrder = KernelTuner::GatherOrder::FrequencyMajor;
+
+		//both variants perform identical floating point operations
+		for (int i = 0; i < 16; ++i)
+		{
+			for (int rid = 0; rid < FrgCommon::lattice().size; ++rid) BOOST_CHECK_EQUAL(frequencyMajor.bundle(i)[rid], siteMajor.bundle(i)[rid]);
+		}
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(getValueSpinRotation, TRIVertexTwoParticleSpinRotationFixture)
+{
+	BOOST_REQUIRE(FrgCommon::lattice().hasSpinRotations());
+	for (int i = 0; i < v->size; ++i) v->getValueRef(i) = float(i % 97) - 48.0f;
+
+	//superbundles with site exchange involve general spin rotations
+	for (float s : { 1.1f, -1.1f })
+	{
+		auto ab = v->generateAccessBuffer(s, 2.2f, 3.3f);
+		ValueSuperbundle<float, 16> b(FrgCommon::lattice().size);
+		v->getValueSuperbundle(ab, b);
+
+		for (int rid = 0; rid < FrgCommon::lattice().size; ++rid)
+		{
+			for (int s1 = 0; s1 < 4; ++s1)
+			{
+				for (int s2 = 0; s2 < 4; ++s2)
+				{
+					float value = v->getValue(FrgCommon::lattice().zero(), FrgCommon::lattice().fromParametrization(rid), s, 2.2f, 3.3f, static_cast<SpinComponent>(s1), static_cast<SpinComponent>(s2), TRIVertexTwoParticle::FrequencyChannel::None);
+					BOOST_CHECK_SMALL(b.bundle(4 * s1 + s2)[rid] - value, 0.001f);
+				}
+			}
+		}
+	}
+
+	//buffered access agrees with direct access on all transformed site pairs
+	SublatticeIterator i1 = FrgCommon::lattice().getBasis();
+	for (auto i2 = FrgCommon::lattice().getRange(i1); i2 != FrgCommon::lattice().end(); ++i2)
+	{
+		for (int s1 = 0; s1 < 4; ++s1)
+		{
+			for (int s2 = 0; s2 < 4; ++s2)
+			{
+				auto ab = v->generateAccessBuffer(2.5f, 3.0f, 4.5f, TRIVertexTwoParticle::FrequencyChannel::T);
+				float value = v->getValue(i2, i1, 2.5f, 3.0f, 4.5f, static_cast<SpinComponent>(s1), static_cast<SpinComponent>(s2), TRIVertexTwoParticle::FrequencyChannel::T);
+				BOOST_CHECK_SMALL(v->getValue(i2, i1, static_cast<SpinComponent>(s1), static_cast<SpinComponent>(s2), ab) - value, 0.001f);
+			}
+		}
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
@@ -1,4 +1,6 @@
 #define BOOST_TEST_MODULE "ValueBundleTest"
+#include <cstdint>
+#include <algorithm>
 #include <boost/test/included/unit_test.hpp>
 #include "lib/ValueBundle.hpp"
 
@@ -135,4 +137,39 @@ BOOST_AUTO_TEST_CASE(ValueSuperbundleArithmetic)
 	for (int i = 0; i < dataSize; ++i) BOOST_CHECK_EQUAL(s1.bundle(0)[i], float(2.0f * i));
 	for (int i = 0; i < dataSize; ++i) BOOST_CHECK_EQUAL(s1.bundle(1)[i], float(2.0f * i));
 }
+BOOST_AUTO_TEST_CASE(ValueSuperbundleWidth)
+{
+	const int dataSize = 13;
+
+	for (int width : { 1, 4, 16 })
+	{
+		ValueBundleLayout::width() = width;
+		ValueSuperbundle<float, 3> s1(dataSize);
+		ValueSuperbundle<float, 3> s2(dataSize);
+
+		for (int i = 0; i < 3; ++i)
+		{
+			//bundles are aligned and padded to the bundle width
+			BOOST_CHECK_EQUAL(s1.bundle(i).size(), dataSize);
+			BOOST_CHECK(reinterpret_cast<uintptr_t>(s1.bundle(i).data()) % std::min(width * sizeof(float), size_t(64)) == 0);
+			if (i > 0) BOOST_CHECK_EQUAL((s1.bundle(i).data() - s1.bundle(i - 1).data()) % width, 0);
+			if (i > 0) BOOST_CHECK(s1.bundle(i).data() - s1.bundle(i - 1).data() >= dataSize);
+
+			for (int j = 0; j < dataSize; ++j)
+			{
+				BOOST_CHECK_EQUAL(s1.bundle(i)[j], 0.0f);
+				s1.bundle(i)[j] = float(i * dataSize + j);
+				s2.bundle(i)[j] = 1.0f;
+			}
+		}
+
+		s1.multAdd(2.0f, s2);
+		for (int i = 0; i < 3; ++i)
+		{
+			for (int j = 0; j < dataSize; ++j) BOOST_CHECK_EQUAL(s1.bundle(i)[j], float(i * dataSize + j) + 2.0f);
+		}
+	}
+	ValueBundleLayout::width() = 1;
+}
+
 BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
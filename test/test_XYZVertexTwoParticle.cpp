@@ -269,4 +269,33 @@ BOOST_AUTO_TEST_CASE(getValueSuperbundle)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(getValueSuperbundleGatherOrder)
+{
+	for (int i = 0; i < v->size; ++i)
+	{
+		v->getValueRef(i, SpinComponent::X) = float(i);
+		v->getValueRef(i, SpinComponent::Y) = float(i + 1);
+		v->getValueRef(i, SpinComponent::Z) = float(i + 2);
+		v->getValueRef(i, SpinComponent::None) = float(i + 3);
+	}
+
+	for (float s : { 1.1f, -1.1f })
+	{
+		auto ab = v->generateAccessBuffer(s, 2.2f, 3.3f);
+		ValueSuperbundle<float, 4> frequencyMajor(FrgCommon::lattice().size);
+		ValueSuperbundle<float, 4> siteMajor(FrgCommon::lattice().size);
+		KernelTuner::gatherOrder = KernelTuner::GatherOrder::FrequencyMajor;
+		v->getValueSuperbundle(ab, frequencyMajor);
+		KernelTuner::gatherOrder = KernelTuner::GatherOrder::SiteMajor;
+		v->getValueSuperbundle(ab, siteMajor);
+		KernelTuner::gatherOrder = KernelTuner::GatherOrder::FrequencyMajor;
+
+		//both variants perform identical floating point operations
+		for (int i = 0; i < 4; ++i)
+		{
+			for (int rid = 0; rid < FrgCommon::lattice().size; ++rid) BOOST_CHECK_EQUAL(frequencyMajor.bundle(i)[rid], siteMajor.bundle(i)[rid]);
+		}
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file